@@ -16,6 +16,8 @@
 #define UXR_AGENT_ROOT_HPP_
 
 #include <uxr/agent/client/ProxyClient.hpp>
+#include <uxr/agent/utils/Conversion.hpp>
+#include <uxr/agent/utils/ShardedMap.hpp>
 
 #include <thread>
 #include <memory>
@@ -56,9 +58,22 @@ public:
     void reset();
 
 private:
+    struct ClientKeyHash
+    {
+        size_t operator()(const dds::xrce::ClientKey& client_key) const
+        {
+            return std::hash<uint32_t>()(conversion::clientkey_to_raw(client_key));
+        }
+    };
+
+    /*
+     * The ordered map, guarded by the mutex, owns the clients and is walked by get_next_client.
+     * get_client, on the path of every packet, only uses the sharded index.
+     */
     std::mutex mtx_;
     std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>> clients_;
     std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>>::iterator current_client_;
+    utils::ShardedMap<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>, ClientKeyHash> client_index_;
 };
 
 } // uxr
@@ -71,6 +71,8 @@ public:
 
     Session& session();
 
+    void reset_session(const std::unordered_map<std::string, std::string>& properties);
+
     State get_state();
 
     void update_state();
@@ -20,6 +20,7 @@
 #include <uxr/agent/client/session/stream/OutputStream.hpp>
 #include <uxr/agent/utils/SharedMutex.hpp>
 
+#include <functional>
 #include <unordered_map>
 #include <memory>
 
@@ -58,6 +59,9 @@ public:
 
     void reset();
 
+    /* Also renegotiates the selective-repeat window, for clients reconnecting with the same session. */
+    void reset(uint16_t nack_window);
+
     /* Input streams functions. */
     bool push_input_message(
             InputMessagePtr&& message,
@@ -68,6 +72,11 @@ public:
             dds::xrce::StreamId stream_id,
             InputMessagePtr& message);
 
+    /* Only the reliable streams hold messages back, the others drop them. */
+    bool hold_input_message(
+            dds::xrce::StreamId stream_id,
+            InputMessagePtr&& message);
+
     void update_from_heartbeat(
             dds::xrce::StreamId stream_id,
             SeqNum first_unacked,
@@ -77,6 +86,12 @@ public:
             dds::xrce::StreamId stream_id,
             dds::xrce::ACKNACK_Payload& acknack);
 
+    void fill_nack_ranges(
+            dds::xrce::StreamId stream_id,
+            std::vector<dds::xrce::ACKNACK_Payload>& nack_ranges);
+
+    uint16_t nack_window() const { return session_info_.nack_window; }
+
     void push_input_fragment(
             dds::xrce::StreamId stream_id,
             InputMessagePtr& message);
@@ -85,6 +100,14 @@ public:
             dds::xrce::StreamId stream_id,
             InputMessagePtr& message);
 
+    void hold_input_fragment_message(
+            dds::xrce::StreamId stream_id,
+            InputMessagePtr&& message);
+
+    bool pop_held_input_fragment_message(
+            dds::xrce::StreamId stream_id,
+            InputMessagePtr& message);
+
     /* Output streams functions. */
     std::vector<uint8_t> get_output_streams();
 
@@ -93,12 +116,17 @@ public:
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
             const T& submessage,
-            std::chrono::milliseconds timeout);
+            std::chrono::milliseconds timeout,
+            bool coalesce = false);
 
     bool get_next_output_message(
             dds::xrce::StreamId stream_id,
             OutputMessagePtr& output_message);
 
+    bool get_output_flush_time(
+            dds::xrce::StreamId stream_id,
+            std::chrono::steady_clock::time_point& flush_time);
+
     bool get_output_message(
             dds::xrce::StreamId stream_id,
             SeqNum seq_num,
@@ -108,17 +136,36 @@ public:
             dds::xrce::StreamId stream_id,
             SeqNum first_unacked);
 
+    /* Only the reliable streams keep the notifier, the others never wait for acknowledgements. */
+    void notify_when_writable(
+            dds::xrce::StreamId stream_id,
+            std::function<void ()> notifier);
+
     bool fill_heartbeat(
             dds::xrce::StreamId stream_id,
             dds::xrce::HEARTBEAT_Payload& heartbeat);
 
+    std::chrono::milliseconds get_retransmission_timeout(
+            dds::xrce::StreamId stream_id);
+
+    void back_off_retransmission(
+            dds::xrce::StreamId stream_id);
+
+    void set_congestion_controller(
+            dds::xrce::StreamId stream_id,
+            std::unique_ptr<CongestionController> congestion_controller);
+
+    bool get_output_stats(
+            dds::xrce::StreamId stream_id,
+            ReliableOutputStream::Stats& stats);
+
 private:
     ReliableOutputStream& get_reliable_output_stream(
             dds::xrce::StreamId stream_id,
             utils::SharedLock& shared_lock);
 
 private:
-    const SessionInfo session_info_;
+    SessionInfo session_info_;
 
     NoneInputStream none_istream_;
     std::unordered_map<dds::xrce::StreamId, BestEffortInputStream> best_effort_istreams_;
@@ -166,6 +213,15 @@ inline void Session::reset()
     reliable_olock.unlock();
 }
 
+inline void Session::reset(uint16_t nack_window)
+{
+    {
+        std::lock_guard<std::mutex> lock(reliable_imtx_);
+        session_info_.nack_window = nack_window;
+    }
+    reset();
+}
+
 /**************************************************************************************************
  * Input Stream Methods.
  **************************************************************************************************/
@@ -215,6 +271,20 @@ inline bool Session::pop_input_message(
     return rv;
 }
 
+inline bool Session::hold_input_message(
+        dds::xrce::StreamId stream_id,
+        InputMessagePtr&& message)
+{
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        std::lock_guard<std::mutex> lock(reliable_imtx_);
+        reliable_istreams_[stream_id].hold_message(std::move(message));
+        rv = true;
+    }
+    return rv;
+}
+
 inline void Session::update_from_heartbeat(
         dds::xrce::StreamId stream_id,
         SeqNum first_unacked,
@@ -238,6 +308,20 @@ inline void Session::fill_acknack(
     }
 }
 
+inline void Session::fill_nack_ranges(
+        dds::xrce::StreamId stream_id,
+        std::vector<dds::xrce::ACKNACK_Payload>& nack_ranges)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        std::lock_guard<std::mutex> lock(reliable_imtx_);
+        if (ACKNACK_BITMAP_WINDOW < session_info_.nack_window)
+        {
+            reliable_istreams_[stream_id].fill_nack_ranges(session_info_.nack_window, nack_ranges);
+        }
+    }
+}
+
 inline void Session::push_input_fragment(dds::xrce::StreamId stream_id, InputMessagePtr& message)
 {
     if (is_reliable_stream(stream_id))
@@ -253,6 +337,26 @@ inline bool Session::pop_input_fragment_message(dds::xrce::StreamId stream_id, I
     return reliable_istreams_[stream_id].pop_fragment_message(message);
 }
 
+inline void Session::hold_input_fragment_message(dds::xrce::StreamId stream_id, InputMessagePtr&& message)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        std::lock_guard<std::mutex> lock(reliable_imtx_);
+        reliable_istreams_[stream_id].hold_fragment_message(std::move(message));
+    }
+}
+
+inline bool Session::pop_held_input_fragment_message(dds::xrce::StreamId stream_id, InputMessagePtr& message)
+{
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        std::lock_guard<std::mutex> lock(reliable_imtx_);
+        rv = reliable_istreams_[stream_id].pop_held_fragment_message(message);
+    }
+    return rv;
+}
+
 /**************************************************************************************************
  * Output Stream Methods.
  **************************************************************************************************/
@@ -273,7 +377,8 @@ inline bool Session::push_output_submessage(
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
         const T& submessage,
-        std::chrono::milliseconds timeout)
+        std::chrono::milliseconds timeout,
+        bool coalesce)
 {
     bool rv = false;
     if (is_none_stream(stream_id))
@@ -283,13 +388,14 @@ inline bool Session::push_output_submessage(
     else if (is_besteffort_stream(stream_id))
     {
         std::lock_guard<std::mutex> lock(best_effort_omtx_);
-        rv = best_effort_ostreams_[stream_id].push_submessage(session_info_, stream_id, submessage_id, submessage);
+        rv = best_effort_ostreams_[stream_id].push_submessage(
+            session_info_, stream_id, submessage_id, submessage, coalesce);
     }
     else
     {
         utils::SharedLock shared_lock(reliable_omtx_);
         rv = get_reliable_output_stream(stream_id, shared_lock).push_submessage(
-            session_info_, stream_id, submessage_id, submessage, timeout);
+            session_info_, stream_id, submessage_id, submessage, timeout, coalesce);
     }
     return rv;
 }
@@ -316,6 +422,24 @@ inline bool Session::get_next_output_message(
     return rv;
 }
 
+inline bool Session::get_output_flush_time(
+        dds::xrce::StreamId stream_id,
+        std::chrono::steady_clock::time_point& flush_time)
+{
+    bool rv = false;
+    if (is_besteffort_stream(stream_id))
+    {
+        std::lock_guard<std::mutex> lock(best_effort_omtx_);
+        rv = best_effort_ostreams_[stream_id].get_flush_time(flush_time);
+    }
+    else if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        rv = get_reliable_output_stream(stream_id, shared_lock).get_flush_time(flush_time);
+    }
+    return rv;
+}
+
 inline bool Session::get_output_message(
         dds::xrce::StreamId stream_id,
         SeqNum seq_num,
@@ -341,6 +465,17 @@ inline void Session::update_from_acknack(
     }
 }
 
+inline void Session::notify_when_writable(
+        dds::xrce::StreamId stream_id,
+        std::function<void ()> notifier)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        get_reliable_output_stream(stream_id, shared_lock).notify_when_writable(std::move(notifier));
+    }
+}
+
 
 inline bool Session::fill_heartbeat(
         dds::xrce::StreamId stream_id,
@@ -356,6 +491,53 @@ inline bool Session::fill_heartbeat(
     return rv;
 }
 
+inline std::chrono::milliseconds Session::get_retransmission_timeout(
+        dds::xrce::StreamId stream_id)
+{
+    std::chrono::milliseconds rto(HEARTBEAT_PERIOD);
+    if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        rto = get_reliable_output_stream(stream_id, shared_lock).get_retransmission_timeout();
+    }
+    return rto;
+}
+
+inline void Session::back_off_retransmission(
+        dds::xrce::StreamId stream_id)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        get_reliable_output_stream(stream_id, shared_lock).back_off_retransmission();
+    }
+}
+
+inline void Session::set_congestion_controller(
+        dds::xrce::StreamId stream_id,
+        std::unique_ptr<CongestionController> congestion_controller)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        get_reliable_output_stream(stream_id, shared_lock).set_congestion_controller(std::move(congestion_controller));
+    }
+}
+
+inline bool Session::get_output_stats(
+        dds::xrce::StreamId stream_id,
+        ReliableOutputStream::Stats& stats)
+{
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        utils::SharedLock shared_lock(reliable_omtx_);
+        stats = get_reliable_output_stream(stream_id, shared_lock).get_stats();
+        rv = true;
+    }
+    return rv;
+}
+
 inline ReliableOutputStream& Session::get_reliable_output_stream(
         dds::xrce::StreamId stream_id,
         utils::SharedLock& shared_lock)
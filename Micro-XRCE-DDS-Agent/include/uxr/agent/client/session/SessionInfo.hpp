@@ -15,16 +15,51 @@
 #ifndef UXR_AGENT_CLIENT_SESSION_SESSION_INFO_HPP_
 #define UXR_AGENT_CLIENT_SESSION_SESSION_INFO_HPP_
 
+#include <uxr/agent/config.hpp>
 #include <uxr/agent/types/XRCETypes.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
 namespace eprosima {
 namespace uxr {
 
+/* Messages covered by the nack_bitmap of a single ACKNACK submessage. */
+const uint16_t ACKNACK_BITMAP_WINDOW = 16;
+
+/*
+ * CLIENT_Representation property carrying the selective-repeat window the client asks for.
+ * The agent answers with the agreed window in the AGENT_Representation properties.
+ */
+const char* const NACK_WINDOW_PROPERTY = "uxr_nack_window";
+
+/*
+ * The agreed window is the one asked by the client, bounded by the reliable stream depth
+ * and rounded down to whole ACKNACK bitmaps. Clients not asking for it keep the single bitmap.
+ */
+inline uint16_t negotiate_nack_window(
+        const std::unordered_map<std::string, std::string>& properties)
+{
+    uint16_t nack_window = ACKNACK_BITMAP_WINDOW;
+    auto it = properties.find(NACK_WINDOW_PROPERTY);
+    if (properties.end() != it)
+    {
+        unsigned long requested = std::strtoul(it->second.c_str(), nullptr, 10);
+        requested = std::min(requested, static_cast<unsigned long>(RELIABLE_STREAM_DEPTH));
+        requested -= requested % ACKNACK_BITMAP_WINDOW;
+        nack_window = std::max(nack_window, uint16_t(requested));
+    }
+    return nack_window;
+}
+
 struct SessionInfo
 {
     dds::xrce::ClientKey client_key;
     dds::xrce::SessionId session_id;
     size_t mtu;
+    uint16_t nack_window;
 };
 
 } // namespace uxr
@@ -0,0 +1,169 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_CLIENT_SESSION_STREAM_CONGESTION_CONTROLLER_HPP_
+#define UXR_AGENT_CLIENT_SESSION_STREAM_CONGESTION_CONTROLLER_HPP_
+
+#include <uxr/agent/utils/SeqNum.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Congestion control of a reliable output stream: it bounds the messages in flight and the rate at
+ * which they are sent, from the acknowledgements and losses reported by the client.
+ * Not thread-safe, the stream calls it under its own lock.
+ */
+class CongestionController
+{
+public:
+    virtual ~CongestionController() = default;
+
+    /**
+     * Number of messages that may be sent and not acknowledged yet.
+     */
+    virtual uint16_t window() const = 0;
+
+    /**
+     * Pacing rate in bytes per second for the given smoothed round-trip time, 0 for no pacing.
+     */
+    virtual size_t pacing_rate(
+            std::chrono::microseconds srtt,
+            size_t mtu) const = 0;
+
+    virtual void on_acknowledged(
+            uint16_t acked_messages) = 0;
+
+    /**
+     * A NACK reported the lost message, last_sent being the last message sent at that time.
+     */
+    virtual void on_loss(
+            SeqNum lost,
+            SeqNum last_sent) = 0;
+
+    virtual void on_timeout() = 0;
+};
+
+/**
+ * TCP-like AIMD: slow start up to the threshold, then one more message per window acknowledged.
+ * A loss halves the window once per window of data, a timeout restarts from the minimum window.
+ * Messages are paced at twice the window per round-trip time, which smooths the bursts without
+ * limiting the throughput allowed by the window.
+ */
+class AimdCongestionController : public CongestionController
+{
+public:
+    explicit AimdCongestionController(
+            uint16_t max_window,
+            uint16_t min_window = 1)
+        : max_window_(std::max(max_window, min_window))
+        , min_window_(min_window)
+        , window_(max_window_)
+        , threshold_(max_window_)
+        , credit_(0)
+        , recovery_(false)
+        , recovery_end_(0)
+    {}
+
+    uint16_t window() const override { return window_; }
+
+    size_t pacing_rate(
+            std::chrono::microseconds srtt,
+            size_t mtu) const override;
+
+    void on_acknowledged(
+            uint16_t acked_messages) override;
+
+    void on_loss(
+            SeqNum lost,
+            SeqNum last_sent) override;
+
+    void on_timeout() override;
+
+private:
+    static constexpr uint64_t pacing_gain = 2;
+
+    const uint16_t max_window_;
+    const uint16_t min_window_;
+    uint16_t window_;
+    uint16_t threshold_;
+    uint16_t credit_;
+    bool recovery_;
+    SeqNum recovery_end_;
+};
+
+inline size_t AimdCongestionController::pacing_rate(
+        std::chrono::microseconds srtt,
+        size_t mtu) const
+{
+    size_t rate = 0;
+    if (0 < srtt.count())
+    {
+        const uint64_t bytes_per_second =
+                (pacing_gain * window_ * uint64_t(mtu) * std::micro::den) / uint64_t(srtt.count());
+        rate = size_t(std::min(bytes_per_second, uint64_t(std::numeric_limits<size_t>::max())));
+    }
+    return rate;
+}
+
+inline void AimdCongestionController::on_acknowledged(
+        uint16_t acked_messages)
+{
+    if (window_ < threshold_)
+    {
+        window_ = uint16_t(std::min(uint32_t(window_) + acked_messages, uint32_t(threshold_)));
+    }
+    else
+    {
+        credit_ = uint16_t(std::min(uint32_t(credit_) + acked_messages, uint32_t(UINT16_MAX)));
+        while ((window_ < max_window_) && (credit_ >= window_))
+        {
+            credit_ = uint16_t(credit_ - window_);
+            ++window_;
+        }
+    }
+}
+
+inline void AimdCongestionController::on_loss(
+        SeqNum lost,
+        SeqNum last_sent)
+{
+    /* The losses of the messages sent before the last decrease belong to the same congestion event. */
+    if (!recovery_ || (lost > recovery_end_))
+    {
+        threshold_ = std::max(uint16_t(window_ / 2), min_window_);
+        window_ = threshold_;
+        credit_ = 0;
+        recovery_ = true;
+        recovery_end_ = last_sent;
+    }
+}
+
+inline void AimdCongestionController::on_timeout()
+{
+    threshold_ = std::max(uint16_t(window_ / 2), min_window_);
+    window_ = min_window_;
+    credit_ = 0;
+    recovery_ = false;
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_CLIENT_SESSION_STREAM_CONGESTION_CONTROLLER_HPP_
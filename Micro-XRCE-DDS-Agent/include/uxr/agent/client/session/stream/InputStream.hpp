@@ -20,9 +20,12 @@
 #include <uxr/agent/utils/SeqNum.hpp>
 #include <uxr/agent/client/session/SessionInfo.hpp>
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -200,8 +203,12 @@ public:
     ReliableInputStream()
         : last_handled_(UINT16_MAX),
           last_announced_(UINT16_MAX),
+          messages_{},
+          received_{},
+          head_(0),
           fragment_msg_{},
-          fragment_message_available_(false)
+          fragment_message_available_(false),
+          held_fragment_message_{}
     {}
 
     ~ReliableInputStream() = default;
@@ -222,49 +229,111 @@ public:
 
     bool pop_message(InputMessagePtr& message);
 
+    /**
+     * Puts back the message just popped, its processing being postponed. It is the next one popped
+     * and it is not acknowledged until then.
+     */
+    void hold_message(InputMessagePtr&& message);
+
     void update_from_heartbeat(
             SeqNum first_unacked,
             SeqNum last_unacked);
 
     void fill_acknack(dds::xrce::ACKNACK_Payload& acknack);
 
+    void fill_nack_ranges(
+            uint16_t nack_window,
+            std::vector<dds::xrce::ACKNACK_Payload>& nack_ranges);
+
     void push_fragment(InputMessagePtr& message);
 
     bool pop_fragment_message(InputMessagePtr& message);
 
+    /**
+     * Keeps the reassembled message, held along with the message of its last fragment.
+     */
+    void hold_fragment_message(InputMessagePtr&& message);
+
+    bool pop_held_fragment_message(InputMessagePtr& message);
+
     void reset();
 
 private:
+    bool in_window(
+            SeqNum seq_num) const;
+
+    size_t offset_of(
+            SeqNum seq_num) const { return uint16_t(seq_num - (last_handled_ + 1)); }
+
+    size_t slot_of(
+            size_t offset) const { return (head_ + offset) % RELIABLE_STREAM_DEPTH; }
+
+    void discard_messages(
+            size_t count);
+
+private:
+    /*
+     * Ring of RELIABLE_STREAM_DEPTH slots holding the window that starts at last_handled_ + 1,
+     * which lives in the head_ slot. Bit i of received_ tells whether last_handled_ + 1 + i is stored.
+     */
     SeqNum last_handled_;
     SeqNum last_announced_;
-    std::map<uint16_t, InputMessagePtr> messages_;
-    std::vector<uint8_t> fragment_msg_;
+    std::array<InputMessagePtr, RELIABLE_STREAM_DEPTH> messages_;
+    std::bitset<RELIABLE_STREAM_DEPTH> received_;
+    size_t head_;
+    PooledBuffer fragment_msg_;
     bool fragment_message_available_;
+    InputMessagePtr held_fragment_message_;
     std::mutex mtx_;
 };
 
+inline bool ReliableInputStream::in_window(
+        SeqNum seq_num) const
+{
+    return (seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH));
+}
+
+inline void ReliableInputStream::discard_messages(
+        size_t count)
+{
+    if (count < RELIABLE_STREAM_DEPTH)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            messages_[slot_of(i)].reset();
+        }
+        received_ >>= count;
+        head_ = slot_of(count);
+    }
+    else
+    {
+        for (auto& message : messages_)
+        {
+            message.reset();
+        }
+        received_.reset();
+        head_ = 0;
+    }
+}
+
 inline bool ReliableInputStream::push_message(
         SeqNum seq_num,
         InputMessagePtr&& message)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH)))
+    if (in_window(seq_num))
     {
-        if (seq_num > last_announced_)
+        size_t offset = offset_of(seq_num);
+        if (!received_.test(offset))
         {
-            last_announced_ = seq_num;
-            messages_.emplace(seq_num, std::move(message));
-            rv = true;
-        }
-        else
-        {
-            auto it = messages_.find(seq_num);
-            if (it == messages_.end())
+            messages_[slot_of(offset)] = std::move(message);
+            received_.set(offset);
+            if (seq_num > last_announced_)
             {
-                messages_.emplace(seq_num, std::move(message));
-                rv = true;
+                last_announced_ = seq_num;
             }
+            rv = true;
         }
     }
     return rv;
@@ -274,17 +343,29 @@ inline bool ReliableInputStream::pop_message(InputMessagePtr& message)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    auto it = messages_.find(last_handled_ + 1);
-    if (it != messages_.end())
+    if (received_.test(0))
     {
+        message = std::move(messages_[head_]);
+        received_ >>= 1;
+        head_ = slot_of(1);
         last_handled_ += 1;
-        message = std::move(messages_.at(last_handled_));
-        messages_.erase(last_handled_);
         rv = true;
     }
     return rv;
 }
 
+inline void ReliableInputStream::hold_message(InputMessagePtr&& message)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    /* The slot left behind the window is the one the message was popped from, nothing was pushed since. */
+    head_ = slot_of(RELIABLE_STREAM_DEPTH - 1);
+    messages_[head_] = std::move(message);
+    received_ <<= 1;
+    received_.set(0);
+    last_handled_ -= 1;
+}
+
 template<typename ... Args>
 inline bool ReliableInputStream::emplace_message(
         SeqNum seq_num,
@@ -292,25 +373,18 @@ inline bool ReliableInputStream::emplace_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH)))
+    if (in_window(seq_num))
     {
-        if (seq_num > last_announced_)
-        {
-            last_announced_ = seq_num;
-            // gcc5 doesn't not support raw pointer as argument in std::pair when std::unique_ptr is create.
-            messages_.emplace(seq_num,
-                              std::unique_ptr<InputMessage>(new InputMessage(std::forward<Args>(args)...)));
-            rv = true;
-        }
-        else
+        size_t offset = offset_of(seq_num);
+        if (!received_.test(offset))
         {
-            auto it = messages_.find(seq_num);
-            if (it == messages_.end())
+            messages_[slot_of(offset)].reset(new InputMessage(std::forward<Args>(args)...));
+            received_.set(offset);
+            if (seq_num > last_announced_)
             {
-                messages_.emplace(seq_num,
-                                  std::unique_ptr<InputMessage>(new InputMessage(std::forward<Args>(args)...)));
-                rv = true;
+                last_announced_ = seq_num;
             }
+            rv = true;
         }
     }
     return rv;
@@ -323,7 +397,10 @@ inline void ReliableInputStream::update_from_heartbeat(
     std::lock_guard<std::mutex> lock(mtx_);
     if (last_handled_ + 1 < first_unacked)
     {
+        /* The messages given up by the writer will never be popped. */
+        discard_messages(uint16_t(first_unacked - (last_handled_ + 1)));
         last_handled_ = first_unacked - 1;
+        held_fragment_message_.reset();
     }
     if (last_announced_ < last_unacked)
     {
@@ -333,26 +410,42 @@ inline void ReliableInputStream::update_from_heartbeat(
 
 inline void ReliableInputStream::fill_acknack(dds::xrce::ACKNACK_Payload& acknack)
 {
-    acknack.nack_bitmap() = {0, 0};
+    static const std::bitset<RELIABLE_STREAM_DEPTH> bitmap_mask{0xFFFF};
+
     std::lock_guard<std::mutex> lock(mtx_);
     acknack.first_unacked_seq_num(last_handled_ + 1);
-    for (uint16_t i = 0; i < 8; i++)
+
+    /* Missing are the announced messages not received yet, among the 16 that follow the last handled. */
+    uint32_t announced = (last_announced_ > last_handled_) ? uint16_t(last_announced_ - last_handled_) : 0;
+    uint32_t announced_mask = (uint32_t(1) << std::min(announced, uint32_t(16))) - 1;
+    uint32_t received = uint32_t((received_ & bitmap_mask).to_ullong());
+    uint32_t missing = announced_mask & ~received;
+    acknack.nack_bitmap() = {uint8_t(missing >> 8), uint8_t(missing)};
+}
+
+inline void ReliableInputStream::fill_nack_ranges(
+        uint16_t nack_window,
+        std::vector<dds::xrce::ACKNACK_Payload>& nack_ranges)
+{
+    static const std::bitset<RELIABLE_STREAM_DEPTH> bitmap_mask{0xFFFF};
+
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    /* Ranges of 16 messages beyond the ACKNACK bitmap, only those with missing messages are reported. */
+    size_t announced = (last_announced_ > last_handled_) ? uint16_t(last_announced_ - last_handled_) : 0;
+    size_t window = std::min(std::min(size_t(nack_window), size_t(RELIABLE_STREAM_DEPTH)), announced);
+    std::bitset<RELIABLE_STREAM_DEPTH> missing = ~received_;
+    for (size_t offset = ACKNACK_BITMAP_WINDOW; offset < window; offset += ACKNACK_BITMAP_WINDOW)
     {
-        if (last_handled_ + SeqNum(i) < last_announced_)
+        size_t range_size = std::min(window - offset, size_t(ACKNACK_BITMAP_WINDOW));
+        uint32_t range_mask = (uint32_t(1) << range_size) - 1;
+        uint32_t range_missing = uint32_t(((missing >> offset) & bitmap_mask).to_ullong()) & range_mask;
+        if (0 != range_missing)
         {
-            auto it = messages_.find(last_handled_ + SeqNum(i + 1));
-            if (it == messages_.end())
-            {
-                acknack.nack_bitmap().at(1) = acknack.nack_bitmap().at(1) | (0x01 << i);
-            }
-        }
-        if (last_handled_ + SeqNum(i + 8) < last_announced_)
-        {
-            auto it = messages_.find(last_handled_ + SeqNum(i + 9));
-            if (it == messages_.end())
-            {
-                acknack.nack_bitmap().at(0) = acknack.nack_bitmap().at(0) | (0x01 << i);
-            }
+            dds::xrce::ACKNACK_Payload nack_range;
+            nack_range.first_unacked_seq_num(last_handled_ + SeqNum(uint16_t(offset + 1)));
+            nack_range.nack_bitmap() = {uint8_t(range_missing >> 8), uint8_t(range_missing)};
+            nack_ranges.push_back(nack_range);
         }
     }
 }
@@ -362,24 +455,34 @@ inline void ReliableInputStream::reset()
     std::lock_guard<std::mutex> lock(mtx_);
     last_handled_ = UINT16_MAX;
     last_announced_ = UINT16_MAX;
-    messages_.clear();
+    discard_messages(RELIABLE_STREAM_DEPTH);
+    fragment_msg_.resize(0);
+    fragment_message_available_ = false;
+    held_fragment_message_.reset();
 }
 
 inline void ReliableInputStream::push_fragment(InputMessagePtr& message)
 {
     std::lock_guard<std::mutex> lock(mtx_);
 
-    /* Add header in case. */
-    if (fragment_msg_.empty())
+    size_t fragment_size = message->get_subheader().submessage_length();
+
+    /* Add header in case, the total size is unknown so room for a window of fragments is reserved. */
+    if (0 == fragment_msg_.size())
     {
         std::array<uint8_t, 8> raw_header;
         uint8_t header_size = message->get_raw_header(raw_header);
-        fragment_msg_.insert(fragment_msg_.begin(), std::begin(raw_header), std::begin(raw_header) + header_size);
+        fragment_msg_.reserve(header_size + (fragment_size * RELIABLE_STREAM_DEPTH));
+        fragment_msg_.resize(header_size);
+        memcpy(fragment_msg_.data(), raw_header.data(), header_size);
     }
 
-    /* Append fragment. */
+    /* Append fragment, growing geometrically so that every byte is moved a bounded number of times. */
     size_t position = fragment_msg_.size();
-    size_t fragment_size = message->get_subheader().submessage_length();
+    if (fragment_msg_.capacity() < (position + fragment_size))
+    {
+        fragment_msg_.reserve(std::max(position + fragment_size, 2 * fragment_msg_.capacity()));
+    }
     fragment_msg_.resize(position + fragment_size);
     message->get_raw_payload(fragment_msg_.data() + position, fragment_size);
 
@@ -393,10 +496,29 @@ inline bool ReliableInputStream::pop_fragment_message(InputMessagePtr& message)
     std::lock_guard<std::mutex> lock(mtx_);
     if (fragment_message_available_)
     {
-        message.reset(new InputMessage(fragment_msg_.data(), fragment_msg_.size()));
-        fragment_msg_.clear();
+        /* The reassembly block is handed over to the message, which leaves the buffer empty. */
+        size_t message_size = fragment_msg_.size();
+        message.reset(new InputMessage(std::move(fragment_msg_), message_size));
         fragment_message_available_ = false;
-        return true;
+        rv = true;
+    }
+    return rv;
+}
+
+inline void ReliableInputStream::hold_fragment_message(InputMessagePtr&& message)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    held_fragment_message_ = std::move(message);
+}
+
+inline bool ReliableInputStream::pop_held_fragment_message(InputMessagePtr& message)
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (held_fragment_message_)
+    {
+        message = std::move(held_fragment_message_);
+        rv = true;
     }
     return rv;
 }
@@ -18,15 +18,21 @@
 #include <uxr/agent/config.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/utils/SeqNum.hpp>
+#include <uxr/agent/utils/RttEstimator.hpp>
+#include <uxr/agent/utils/TokenBucket.hpp>
 #include <uxr/agent/client/session/SessionInfo.hpp>
+#include <uxr/agent/client/session/stream/CongestionController.hpp>
 #include <uxr/agent/logger/Logger.hpp>
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <queue>
 #include <mutex>
 #include <array>
 #include <map>
 #include <condition_variable>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -88,7 +94,7 @@ inline bool NoneOutputStream::push_submessage(
         message_header.client_key(session_info.client_key);
 
         /* Create message. */
-        OutputMessagePtr output_message(new OutputMessage(message_header, session_info.mtu));
+        OutputMessagePtr output_message = make_output_message(message_header, session_info.mtu);
         if (output_message->append_submessage(id, submessage))
         {
             /* Push message. */
@@ -120,6 +126,8 @@ class BestEffortOutputStream
 public:
     BestEffortOutputStream()
         : last_sent_(UINT16_MAX)
+        , lingering_(false)
+        , flush_time_()
     {}
 
     ~BestEffortOutputStream() = default;
@@ -133,18 +141,30 @@ public:
 //    void promote_stream() { last_sent_ += 1; }
     void reset();
 
+    /**
+     * With coalesce, the submessage is appended to the last message while it has room left,
+     * and that message is held back for OUTPUT_MAX_LINGER waiting for more submessages.
+     */
     template<class T>
     bool push_submessage(
             const SessionInfo& session_info,
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
-            const T& submessage);
+            const T& submessage,
+            bool coalesce = false);
 
     bool pop_message(OutputMessagePtr& output_message);
 
+    /**
+     * Returns true if a message is being held back, flush_time being the time at which it is released.
+     */
+    bool get_flush_time(std::chrono::steady_clock::time_point& flush_time);
+
 private:
     std::queue<OutputMessagePtr> messages_;
     SeqNum last_sent_;
+    bool lingering_;
+    std::chrono::steady_clock::time_point flush_time_;
     std::mutex mtx_;
 };
 
@@ -156,6 +176,7 @@ inline void BestEffortOutputStream::reset()
         messages_.pop();
     }
     last_sent_ = UINT16_MAX;
+    lingering_ = false;
 }
 
 template<class T>
@@ -163,11 +184,16 @@ inline bool BestEffortOutputStream::push_submessage(
         const SessionInfo& session_info,
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
-        const T& submessage)
+        const T& submessage,
+        bool coalesce)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if (BEST_EFFORT_STREAM_DEPTH > messages_.size())
+    if (coalesce && lingering_ && messages_.back()->can_append_submessage(raw_codec::encoded_size(submessage)))
+    {
+        rv = messages_.back()->append_submessage(submessage_id, submessage);
+    }
+    else if (BEST_EFFORT_STREAM_DEPTH > messages_.size())
     {
         /* Message header. */
         dds::xrce::MessageHeader message_header;
@@ -177,13 +203,13 @@ inline bool BestEffortOutputStream::push_submessage(
         message_header.client_key(session_info.client_key);
 
         /* Create message. */
-        OutputMessagePtr output_message(new OutputMessage(message_header, session_info.mtu));
-        if (session_info.mtu < submessage.getCdrSerializedSize())
+        OutputMessagePtr output_message = make_output_message(message_header, session_info.mtu);
+        if (session_info.mtu < raw_codec::encoded_size(submessage))
         {
             UXR_AGENT_LOG_WARN(
                 UXR_DECORATE_YELLOW("serialization warning"),
                 "Trying to serialize {:d} in {:d} MTU stream",
-                submessage.getCdrSerializedSize(),
+                raw_codec::encoded_size(submessage),
                 session_info.mtu);
             rv = true;
         }
@@ -192,6 +218,8 @@ inline bool BestEffortOutputStream::push_submessage(
             /* Push message. */
             messages_.push(std::move(output_message));
             last_sent_ += 1;
+            lingering_ = coalesce;
+            flush_time_ = std::chrono::steady_clock::now() + OUTPUT_MAX_LINGER;
             rv = true;
         }
     }
@@ -204,52 +232,156 @@ inline bool BestEffortOutputStream::pop_message(OutputMessagePtr& output_message
     bool rv = false;
     if (!messages_.empty())
     {
-        output_message = std::move(messages_.front());
-        messages_.pop();
-        rv = true;
+        /* The last message is held back while lingering, unless it is full or its time is up. */
+        const bool held_back =
+                lingering_ && (1 == messages_.size()) &&
+                messages_.back()->can_append_submessage(0) &&
+                (std::chrono::steady_clock::now() < flush_time_);
+        if (!held_back)
+        {
+            lingering_ = lingering_ && (1 < messages_.size());
+            output_message = std::move(messages_.front());
+            messages_.pop();
+            rv = true;
+        }
     }
     return rv;
 }
 
+inline bool BestEffortOutputStream::get_flush_time(std::chrono::steady_clock::time_point& flush_time)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    flush_time = flush_time_;
+    return lingering_;
+}
+
 /****************************************************************************************
  * Reliable Output Stream.
  ****************************************************************************************/
 class ReliableOutputStream
 {
 public:
+    struct Stats
+    {
+        uint16_t window;                    // Messages allowed in flight, RELIABLE_STREAM_DEPTH without congestion control.
+        uint16_t in_flight;                 // Messages sent and not acknowledged yet.
+        uint64_t sent;                      // Messages sent for the first time.
+        uint64_t retransmitted;             // Messages sent again, after a NACK or a timeout.
+        uint64_t loss_events;               // Window decreases due to NACKs.
+        uint64_t timeouts;                  // Retransmission timeouts.
+        uint64_t paced;                     // Times a message has been held back by the pacer.
+        size_t pacing_rate;                 // Bytes per second, 0 if not paced.
+        std::chrono::microseconds srtt;     // Smoothed round-trip time, 0 until measured.
+    };
+
     ReliableOutputStream()
         : last_unacked_(UINT16_MAX)
         , last_sent_(UINT16_MAX)
+        , last_handed_out_(UINT16_MAX)
         , first_unacked_(0x0000)
+        , lingering_(false)
+        , flush_time_()
+        , rtt_(
+            std::chrono::milliseconds(HEARTBEAT_PERIOD),
+            std::chrono::milliseconds(HEARTBEAT_MIN_PERIOD),
+            std::chrono::milliseconds(HEARTBEAT_MAX_PERIOD))
+        , congestion_controller_(CONGESTION_CONTROL ? new AimdCongestionController(RELIABLE_STREAM_DEPTH) : nullptr)
+        , pacer_()
+        , pacing_(false)
+        , pacing_time_()
+        , mtu_(0)
+        , stats_{}
+        , writable_notifiers_{}
     {}
 
 //    bool push_message(OutputMessagePtr& output_message);
 
     void reset();
 
+    /**
+     * With coalesce, the submessage is appended to the last message while it has room left,
+     * and that message is held back for OUTPUT_MAX_LINGER waiting for more submessages.
+     * Fragmented submessages are never coalesced.
+     */
     template<class T>
     bool push_submessage(
             const SessionInfo& session_info,
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
             const T& submessage,
-            std::chrono::milliseconds timeout);
+            std::chrono::milliseconds timeout,
+            bool coalesce = false);
 
     bool get_next_message(OutputMessagePtr& output_message);
 
+    /**
+     * Returns true if a message is being held back, flush_time being the time at which it is released.
+     */
+    bool get_flush_time(std::chrono::steady_clock::time_point& flush_time);
+
+    /**
+     * Returns the message to retransmit, unless it has already been retransmitted within the last
+     * round-trip time: the NACKs that follow a loss keep reporting it until the retransmission arrives.
+     */
     bool get_message(
             SeqNum seq_num,
             OutputMessagePtr& output_message);
 
+    /**
+     * Acknowledges up to first_unacked. Its previous message gives a round-trip time sample
+     * unless it has been retransmitted (Karn's algorithm).
+     */
     void update_from_acknack(SeqNum first_unacked);
 
+    /**
+     * Calls notifier once there is room for a new message, right away if there is already.
+     * Used by the writers that must not block when the stream is full.
+     */
+    void notify_when_writable(std::function<void ()> notifier);
+
     bool fill_heartbeat(dds::xrce::HEARTBEAT_Payload& heartbeat);
 
+    /**
+     * Time after which the unacknowledged messages are considered lost, derived from the measured round-trip time.
+     */
+    std::chrono::milliseconds get_retransmission_timeout();
+
+    /**
+     * Doubles the retransmission timeout, until the peer acknowledges again.
+     * The timeout is reported to the congestion controller when there are messages in flight.
+     */
+    void back_off_retransmission();
+
+    /**
+     * Replaces the congestion controller, nullptr disabling the congestion control.
+     */
+    void set_congestion_controller(std::unique_ptr<CongestionController> congestion_controller);
+
+    Stats get_stats();
+
+private:
+    void update_pacer();
+
+    bool writable() const { return last_unacked_ < first_unacked_ + SeqNum(RELIABLE_STREAM_DEPTH - 1); }
+
 private:
     std::map<uint16_t, OutputMessagePtr> messages_;
     SeqNum last_unacked_;
     SeqNum last_sent_;
+    SeqNum last_handed_out_;
     SeqNum first_unacked_;
+    bool lingering_;
+    std::chrono::steady_clock::time_point flush_time_;
+    std::map<uint16_t, std::chrono::steady_clock::time_point> send_times_;
+    std::map<uint16_t, std::chrono::steady_clock::time_point> retransmission_times_;
+    utils::RttEstimator rtt_;
+    std::unique_ptr<CongestionController> congestion_controller_;
+    std::unique_ptr<utils::TokenBucket> pacer_;
+    bool pacing_;
+    std::chrono::steady_clock::time_point pacing_time_;
+    size_t mtu_;
+    Stats stats_;
+    std::vector<std::function<void ()>> writable_notifiers_;
     std::mutex mtx_;
     std::condition_variable cv_;
 };
@@ -269,11 +401,26 @@ private:
 //
 inline void ReliableOutputStream::reset()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    last_unacked_ = UINT16_MAX;
-    last_sent_ = UINT16_MAX;
-    first_unacked_ = 0x0000;
-    messages_.clear();
+    std::vector<std::function<void ()>> notifiers;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        last_unacked_ = UINT16_MAX;
+        last_sent_ = UINT16_MAX;
+        last_handed_out_ = UINT16_MAX;
+        first_unacked_ = 0x0000;
+        lingering_ = false;
+        messages_.clear();
+        send_times_.clear();
+        retransmission_times_.clear();
+        rtt_.reset_back_off();
+        pacing_ = false;
+        notifiers.swap(writable_notifiers_);
+    }
+
+    for (auto& notifier : notifiers)
+    {
+        notifier();
+    }
 }
 
 template<class T>
@@ -282,15 +429,20 @@ inline bool ReliableOutputStream::push_submessage(
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
         const T& submessage,
-        std::chrono::milliseconds timeout)
+        std::chrono::milliseconds timeout,
+        bool coalesce)
 {
     bool rv = false;
     std::unique_lock<std::mutex> lock(mtx_);
     auto now = std::chrono::steady_clock::now();
+    mtu_ = session_info.mtu;
 
-    if (cv_.wait_until(
-            lock,
-            now + timeout, [&](){ return last_unacked_ < first_unacked_ + SeqNum(RELIABLE_STREAM_DEPTH - 1); }))
+    if (coalesce && lingering_ && messages_.at(last_unacked_)->can_append_submessage(raw_codec::encoded_size(submessage)))
+    {
+        /* Same sequence number, the window is not affected. */
+        rv = messages_.at(last_unacked_)->append_submessage(submessage_id, submessage);
+    }
+    else if (cv_.wait_until(lock, now + timeout, [&](){ return writable(); }))
     {
         /* Message header. */
         dds::xrce::MessageHeader message_header;
@@ -302,29 +454,34 @@ inline bool ReliableOutputStream::push_submessage(
         dds::xrce::SubmessageHeader submessage_header;
         submessage_header.submessage_id(submessage_id);
         submessage_header.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
-        submessage_header.submessage_length(uint16_t(submessage.getCdrSerializedSize()));
+        submessage_header.submessage_length(uint16_t(raw_codec::encoded_size(submessage)));
 
         /* Compute message size. */
-        const size_t header_size = message_header.getCdrSerializedSize();
-        const size_t subheader_size = submessage_header.getCdrSerializedSize();
-        const size_t submessage_size = subheader_size + submessage.getCdrSerializedSize();
+        const size_t header_size = raw_codec::encoded_size(message_header);
+        const size_t subheader_size = raw_codec::encoded_size(submessage_header);
+        const size_t submessage_size = subheader_size + raw_codec::encoded_size(submessage);
 
         /* Push submessage. */
         if ((header_size + submessage_size) <= session_info.mtu)
         {
-            /* Create message. */
+            /* Create message, with room for the following submessages if coalescing. */
             last_unacked_ += 1;
             message_header.sequence_nr(last_unacked_);
-            OutputMessagePtr output_message(new OutputMessage(message_header, header_size + submessage_size));
+            OutputMessagePtr output_message =
+                make_output_message(message_header, coalesce ? session_info.mtu : header_size + submessage_size);
             if (output_message->append_submessage(submessage_id, submessage))
             {
                 /* Push message. */
                 messages_.insert(std::make_pair(last_unacked_, std::move(output_message)));
+                lingering_ = coalesce;
+                flush_time_ = std::chrono::steady_clock::now() + OUTPUT_MAX_LINGER;
                 rv = true;
             }
         }
         else
         {
+            lingering_ = false;
+
             /* Serialize submessage. */
             std::unique_ptr<uint8_t[]> buf(new uint8_t[submessage_size]);
             fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(buf.get()), submessage_size);
@@ -358,7 +515,7 @@ inline bool ReliableOutputStream::push_submessage(
                 /* Create message. */
                 last_unacked_ += 1;
                 message_header.sequence_nr(last_unacked_);
-                OutputMessagePtr output_message(new OutputMessage(message_header, current_message_size));
+                OutputMessagePtr output_message = make_output_message(message_header, current_message_size);
                 if (output_message->append_fragment(fragment_subheader,  buf.get() + serialized_size, fragment_size))
                 {
                     /* Push message. */
@@ -381,15 +538,60 @@ inline bool ReliableOutputStream::get_next_message(OutputMessagePtr& output_mess
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
+    pacing_ = false;
     if (last_sent_ < last_unacked_)
     {
-        last_sent_ += 1;
-        output_message = messages_.at(last_sent_);
-        rv = true;
+        /* The last message is held back while lingering, unless it is full or its time is up. */
+        const bool last = (last_sent_ + 1 == last_unacked_);
+        const bool held_back =
+                lingering_ && last &&
+                messages_.at(last_unacked_)->can_append_submessage(0) &&
+                (std::chrono::steady_clock::now() < flush_time_);
+        /* Congestion control: no more than the window in flight, sent at the pacing rate.
+           A full window is already bounded by the depth of the stream, fragments exceeding it. */
+        const bool window_full =
+                congestion_controller_ &&
+                (congestion_controller_->window() < RELIABLE_STREAM_DEPTH) &&
+                (uint16_t(last_sent_ - first_unacked_ + 1) >= congestion_controller_->window());
+        if (!held_back && !window_full)
+        {
+            const OutputMessagePtr& next_message = messages_.at(last_sent_ + 1);
+            std::chrono::milliseconds wait_time;
+            pacing_ = pacer_ && !pacer_->try_consume_tokens(next_message->get_len(), wait_time);
+            if (pacing_)
+            {
+                pacing_time_ = std::chrono::steady_clock::now() + wait_time;
+                ++stats_.paced;
+            }
+            else
+            {
+                lingering_ = lingering_ && !last;
+                last_sent_ += 1;
+                last_handed_out_ = std::max(last_handed_out_, last_sent_);
+                output_message = next_message;
+                send_times_[last_sent_] = std::chrono::steady_clock::now();
+                ++stats_.sent;
+                rv = true;
+            }
+        }
     }
     return rv;
 }
 
+inline bool ReliableOutputStream::get_flush_time(std::chrono::steady_clock::time_point& flush_time)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (pacing_)
+    {
+        flush_time = lingering_ ? std::min(flush_time_, pacing_time_) : pacing_time_;
+    }
+    else
+    {
+        flush_time = flush_time_;
+    }
+    return lingering_ || pacing_;
+}
+
 inline bool ReliableOutputStream::get_message(
         SeqNum seq_num,
         OutputMessagePtr& output_message)
@@ -397,9 +599,36 @@ inline bool ReliableOutputStream::get_message(
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
     auto it = messages_.find(seq_num);
-    if (it != messages_.end())
+    auto now = std::chrono::steady_clock::now();
+    auto retransmission = retransmission_times_.find(seq_num);
+    if ((it != messages_.end()) &&
+        ((retransmission == retransmission_times_.end()) || (now - retransmission->second >= rtt_.srtt())))
     {
+        /* Once handed out, nothing else can be appended to the message. */
+        lingering_ = lingering_ && (seq_num != last_unacked_);
         output_message = it->second;
+        /* The heartbeat announces the messages held back too, a NACK of those is not a loss. */
+        const bool sent = (seq_num <= last_sent_);
+        /* An acknowledgement of a retransmitted message is ambiguous, and the messages in flight wait
+           for the retransmission to be acknowledged: none of them gives a round-trip time. */
+        if (sent)
+        {
+            send_times_.clear();
+        }
+        else
+        {
+            send_times_.erase(seq_num);
+        }
+        last_handed_out_ = std::max(last_handed_out_, seq_num);
+        retransmission_times_[seq_num] = now;
+        stats_.retransmitted += sent ? 1 : 0;
+        if (congestion_controller_ && sent)
+        {
+            const uint16_t window = congestion_controller_->window();
+            congestion_controller_->on_loss(seq_num, last_sent_);
+            stats_.loss_events += (congestion_controller_->window() < window) ? 1 : 0;
+            update_pacer();
+        }
         rv = true;
     }
     return rv;
@@ -407,16 +636,59 @@ inline bool ReliableOutputStream::get_message(
 
 inline void ReliableOutputStream::update_from_acknack(SeqNum first_unacked)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (first_unacked <= last_sent_ + 1)
+    std::vector<std::function<void ()>> notifiers;
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (first_unacked <= last_handed_out_ + 1)
     {
+        if (first_unacked > first_unacked_)
+        {
+            notifiers.swap(writable_notifiers_);
+            auto it = send_times_.find(first_unacked - 1);
+            if (it != send_times_.end())
+            {
+                rtt_.add_sample(std::chrono::steady_clock::now() - it->second);
+            }
+            rtt_.reset_back_off();
+            if (congestion_controller_)
+            {
+                congestion_controller_->on_acknowledged(uint16_t(first_unacked - first_unacked_));
+                update_pacer();
+            }
+        }
         while (first_unacked > first_unacked_)
         {
             messages_.erase(first_unacked_);
+            send_times_.erase(first_unacked_);
+            retransmission_times_.erase(first_unacked_);
             first_unacked_ += 1;
         }
+        /* The messages handed out by get_message before their first transmission are acknowledged too. */
+        if (last_sent_ < first_unacked_ - 1)
+        {
+            last_sent_ = first_unacked_ - 1;
+        }
         cv_.notify_one();
     }
+    lock.unlock();
+
+    for (auto& notifier : notifiers)
+    {
+        notifier();
+    }
+}
+
+inline void ReliableOutputStream::notify_when_writable(std::function<void ()> notifier)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (writable())
+    {
+        lock.unlock();
+        notifier();
+    }
+    else
+    {
+        writable_notifiers_.push_back(std::move(notifier));
+    }
 }
 
 inline bool ReliableOutputStream::fill_heartbeat(dds::xrce::HEARTBEAT_Payload& heartbeat)
@@ -427,6 +699,66 @@ inline bool ReliableOutputStream::fill_heartbeat(dds::xrce::HEARTBEAT_Payload& h
     return !messages_.empty();
 }
 
+inline std::chrono::milliseconds ReliableOutputStream::get_retransmission_timeout()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return rtt_.rto();
+}
+
+inline void ReliableOutputStream::back_off_retransmission()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    rtt_.back_off();
+    ++stats_.timeouts;
+    if (congestion_controller_ && (last_sent_ >= first_unacked_))
+    {
+        congestion_controller_->on_timeout();
+        update_pacer();
+    }
+}
+
+inline void ReliableOutputStream::set_congestion_controller(
+        std::unique_ptr<CongestionController> congestion_controller)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    congestion_controller_ = std::move(congestion_controller);
+    update_pacer();
+}
+
+inline ReliableOutputStream::Stats ReliableOutputStream::get_stats()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Stats stats = stats_;
+    stats.window = congestion_controller_ ? congestion_controller_->window() : RELIABLE_STREAM_DEPTH;
+    stats.in_flight = uint16_t(last_sent_ - first_unacked_ + 1);
+    stats.pacing_rate = pacer_ ? pacer_->get_rate() : 0;
+    stats.srtt = rtt_.srtt();
+    return stats;
+}
+
+inline void ReliableOutputStream::update_pacer()
+{
+    const size_t rate = congestion_controller_ ? congestion_controller_->pacing_rate(rtt_.srtt(), mtu_) : 0;
+    if (0 == rate)
+    {
+        pacer_.reset();
+        pacing_ = false;
+    }
+    else
+    {
+        /* Bursts of up to 2 ms, the bucket being refilled every millisecond. */
+        const size_t capacity = std::max(2 * mtu_, rate / 500);
+        if (pacer_)
+        {
+            pacer_->set_rate(rate, capacity);
+        }
+        else
+        {
+            pacer_.reset(new utils::TokenBucket(rate, capacity));
+        }
+    }
+}
+
 } // namespace uxr
 } // namespace eprosima
 
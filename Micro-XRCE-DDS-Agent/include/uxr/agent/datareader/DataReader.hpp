@@ -59,7 +59,7 @@ private:
 
     bool read_fn(
         bool,
-        std::vector<uint8_t>& data,
+        SharedData& data,
         std::chrono::milliseconds timeout);
 
 private:
@@ -47,6 +47,7 @@ public:
 
     bool write(dds::xrce::WRITE_DATA_Payload_Data& write_data);
     bool write(const std::vector<uint8_t>& data);
+    bool is_writable() const;
 
 private:
     DataWriter(const dds::xrce::ObjectId& object_id,
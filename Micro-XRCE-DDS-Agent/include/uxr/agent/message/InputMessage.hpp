@@ -17,6 +17,8 @@
 
 #include <uxr/agent/types/MessageHeader.hpp>
 #include <uxr/agent/types/SubMessageHeader.hpp>
+#include <uxr/agent/message/MessagePool.hpp>
+#include <uxr/agent/message/RawCodec.hpp>
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/Exception.h>
@@ -30,24 +32,76 @@ public:
     InputMessage(
             uint8_t* buf,
             size_t len)
-        : buf_(new uint8_t[len]),
+        : buf_(static_cast<uint8_t*>(MessagePool::instance().allocate(len))),
           len_(len),
+          capacity_(len),
           header_(),
           subheader_(),
           fastbuffer_(reinterpret_cast<char*>(buf_), len_),
-          deserializer_(fastbuffer_)
+          deserializer_(fastbuffer_),
+          submessage_offset_(0),
+          held_(false)
     {
         memcpy(buf_, buf, len);
         deserialize(header_);
     }
 
+    /**
+     * Takes the block of the buffer without copying it, the buffer is left empty.
+     */
+    InputMessage(
+            PooledBuffer&& buffer,
+            size_t len)
+        : buf_(buffer.data()),
+          len_(len),
+          capacity_(buffer.capacity()),
+          header_(),
+          subheader_(),
+          fastbuffer_(reinterpret_cast<char*>(buf_), len_),
+          deserializer_(fastbuffer_),
+          submessage_offset_(0),
+          held_(false)
+    {
+        buffer.release();
+        deserialize(header_);
+    }
+
+    /**
+     * Creates a message from a transport buffer. If the message fills at least half of the
+     * buffer the block is handed over (zero-copy), otherwise it is copied into a block of its size
+     * so that small messages do not pin large blocks while they wait in the streams.
+     */
+    static InputMessage* from_buffer(
+            PooledBuffer& buffer,
+            size_t len)
+    {
+        if ((len * 2) >= buffer.capacity())
+        {
+            size_t size = buffer.size();
+            InputMessage* input_message = new InputMessage(std::move(buffer), len);
+            buffer.resize(size);
+            return input_message;
+        }
+        return new InputMessage(buffer.data(), len);
+    }
+
     uint8_t* get_buf() const { return buf_; }
 
     size_t get_len() const { return len_; }
 
     ~InputMessage()
     {
-        delete[] buf_;
+        MessagePool::instance().deallocate(buf_, capacity_);
+    }
+
+    static void* operator new(size_t size)
+    {
+        return MessagePool::instance().allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        MessagePool::instance().deallocate(ptr, size);
     }
 
     InputMessage(InputMessage&&) = delete;
@@ -68,32 +122,84 @@ public:
 
     bool prepare_next_submessage();
 
+    /**
+     * Rewinds to the current submessage, whose processing is postponed: the message is held until
+     * prepare_next_submessage gets that submessage again.
+     */
+    void hold_submessage();
+
+    bool is_held() const { return held_; }
+
+    bool skip_payload();
+
 private:
     template<class T>
     bool deserialize(T& data);
 
+    bool deserialize(dds::xrce::MessageHeader& data)
+    {
+        return decode(data, ((0 < len_) && (128 > buf_[0])) ? 8 : 4);
+    }
+
+    bool deserialize(dds::xrce::SubmessageHeader& data) { return decode(data, raw_codec::SUBMESSAGE_HEADER_SIZE); }
+
+    bool deserialize(dds::xrce::ACKNACK_Payload& data) { return decode(data, raw_codec::ACKNACK_PAYLOAD_SIZE); }
+
+    bool deserialize(dds::xrce::HEARTBEAT_Payload& data) { return decode(data, raw_codec::HEARTBEAT_PAYLOAD_SIZE); }
+
+    bool deserialize(dds::xrce::WRITE_DATA_Payload_Data& data)
+    {
+        return decode(data, raw_codec::OBJECT_REQUEST_SIZE + data.data().serialized_data().size());
+    }
+
+    template<class T>
+    bool decode(T& data, size_t size);
+
     void log_error();
 
 private:
     uint8_t* buf_;
     size_t len_;
+    size_t capacity_;
     dds::xrce::MessageHeader header_;
     dds::xrce::SubmessageHeader subheader_;
     fastcdr::FastBuffer fastbuffer_;
     fastcdr::Cdr deserializer_;
+    size_t submessage_offset_;
+    bool held_;
 };
 
 inline bool InputMessage::prepare_next_submessage()
 {
     bool rv = false;
     deserializer_.jump((4 - ((deserializer_.getCurrentPosition() - deserializer_.getBufferPointer()) & 3)) & 3);
+    held_ = false;
     if (fastbuffer_.getBufferSize() > deserializer_.getSerializedDataLength())
     {
+        submessage_offset_ = deserializer_.getSerializedDataLength();
         rv = deserialize(subheader_);
     }
     return rv;
 }
 
+inline void InputMessage::hold_submessage()
+{
+    deserializer_.reset();
+    deserializer_.jump(submessage_offset_);
+    held_ = true;
+}
+
+inline bool InputMessage::skip_payload()
+{
+    bool rv = false;
+    if (subheader_.submessage_length() <= (len_ - deserializer_.getSerializedDataLength()))
+    {
+        deserializer_.jump(subheader_.submessage_length());
+        rv = true;
+    }
+    return rv;
+}
+
 template<class T>
 inline bool InputMessage::get_payload(T& data)
 {
@@ -151,6 +257,27 @@ inline bool InputMessage::deserialize(T& data)
     return rv;
 }
 
+/**
+ * Fast path for the fixed-layout types, read straight from the buffer (see RawCodec.hpp).
+ * The deserializer is moved past them so that the following fastcdr calls stay in sync.
+ **/
+template<class T>
+inline bool InputMessage::decode(T& data, size_t size)
+{
+    bool rv = false;
+    if (size <= (len_ - deserializer_.getSerializedDataLength()))
+    {
+        raw_codec::decode(data, reinterpret_cast<const uint8_t*>(deserializer_.getCurrentPosition()));
+        deserializer_.jump(size);
+        rv = true;
+    }
+    else
+    {
+        log_error();
+    }
+    return rv;
+}
+
 } // namespace uxr
 } // namespace eprosima
 
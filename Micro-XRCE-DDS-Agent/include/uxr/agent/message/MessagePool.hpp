@@ -0,0 +1,209 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_MESSAGE_MESSAGE_POOL_HPP_
+#define UXR_AGENT_MESSAGE_MESSAGE_POOL_HPP_
+
+#include <uxr/agent/visibility.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Slab allocator backing the message buffers and objects.
+ * Blocks are grouped in power of two size classes, from 64 bytes up to the server buffer size,
+ * and released blocks are cached per class, up to MESSAGE_POOL_CACHED_BYTES each, so that once
+ * the pool is warm the hot path does not reach the heap. It is shared by every transport since messages cross the receiver, processing
+ * and sender threads.
+ */
+class MessagePool
+{
+public:
+    struct Stats
+    {
+        uint64_t allocations;       // Blocks handed out.
+        uint64_t heap_allocations;  // Blocks that had to be taken from the heap.
+    };
+
+    UXR_AGENT_EXPORT static MessagePool& instance();
+
+    UXR_AGENT_EXPORT void* allocate(
+            size_t size);
+
+    UXR_AGENT_EXPORT void deallocate(
+            void* ptr,
+            size_t size);
+
+    UXR_AGENT_EXPORT Stats get_stats() const;
+
+private:
+    MessagePool();
+
+    static constexpr size_t min_block_size = 64;
+    static constexpr size_t class_count = 11; // 64 B ... 64 KiB.
+
+    static size_t size_class(
+            size_t size);
+
+    static size_t cached_blocks(
+            size_t index);
+
+    struct SizeClass
+    {
+        std::mutex mtx;
+        std::vector<void*> free_blocks;
+    };
+
+    std::array<SizeClass, class_count> classes_;
+    std::atomic<uint64_t> allocations_;
+    std::atomic<uint64_t> heap_allocations_;
+};
+
+/**
+ * Byte buffer owning a MessagePool block. Transports receive into it so that the block can be
+ * handed over to an InputMessage without copying.
+ */
+class PooledBuffer
+{
+public:
+    PooledBuffer()
+        : data_(nullptr)
+        , size_(0)
+        , capacity_(0)
+    {}
+
+    explicit PooledBuffer(size_t size)
+        : PooledBuffer()
+    {
+        resize(size);
+    }
+
+    ~PooledBuffer()
+    {
+        MessagePool::instance().deallocate(data_, capacity_);
+    }
+
+    PooledBuffer(PooledBuffer&& other)
+        : data_(other.data_)
+        , size_(other.size_)
+        , capacity_(other.capacity_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(PooledBuffer&&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    /**
+     * Unlike std::vector, the content is not preserved when the buffer has to grow.
+     */
+    void resize(size_t size)
+    {
+        if (capacity_ < size)
+        {
+            MessagePool::instance().deallocate(data_, capacity_);
+            data_ = static_cast<uint8_t*>(MessagePool::instance().allocate(size));
+            capacity_ = size;
+        }
+        size_ = size;
+    }
+
+    /**
+     * Grows the block to at least capacity bytes, keeping the content.
+     */
+    void reserve(size_t capacity)
+    {
+        if (capacity_ < capacity)
+        {
+            uint8_t* data = static_cast<uint8_t*>(MessagePool::instance().allocate(capacity));
+            if (0 < size_)
+            {
+                memcpy(data, data_, size_);
+            }
+            MessagePool::instance().deallocate(data_, capacity_);
+            data_ = data;
+            capacity_ = capacity;
+        }
+    }
+
+    uint8_t* data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * Hands the block over to the caller, which becomes responsible for deallocating capacity() bytes.
+     */
+    uint8_t* release()
+    {
+        uint8_t* data = data_;
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        return data;
+    }
+
+private:
+    uint8_t* data_;
+    size_t size_;
+    size_t capacity_;
+};
+
+/**
+ * Standard allocator over the MessagePool, used to pool shared_ptr control blocks.
+ */
+template<typename T>
+class MessagePoolAllocator
+{
+public:
+    typedef T value_type;
+
+    MessagePoolAllocator() = default;
+
+    template<typename U>
+    MessagePoolAllocator(const MessagePoolAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(MessagePool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        MessagePool::instance().deallocate(ptr, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const MessagePoolAllocator<U>&) const { return true; }
+
+    template<typename U>
+    bool operator!=(const MessagePoolAllocator<U>&) const { return false; }
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_MESSAGE_MESSAGE_POOL_HPP_
@@ -18,6 +18,8 @@
 #include <uxr/agent/types/MessageHeader.hpp>
 #include <uxr/agent/types/SubMessageHeader.hpp>
 #include <uxr/agent/utils/Functions.hpp>
+#include <uxr/agent/message/MessagePool.hpp>
+#include <uxr/agent/message/RawCodec.hpp>
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/Exception.h>
@@ -31,7 +33,7 @@ public:
     OutputMessage(
             const dds::xrce::MessageHeader& header,
             size_t len)
-        : buf_(new uint8_t[len]{0}),
+        : buf_(static_cast<uint8_t*>(MessagePool::instance().allocate(len))),
           len_(len),
           fastbuffer_(reinterpret_cast<char*>(buf_), len_),
           serializer_(fastbuffer_)
@@ -41,7 +43,17 @@ public:
 
     ~OutputMessage()
     {
-        delete[] buf_;
+        MessagePool::instance().deallocate(buf_, len_);
+    }
+
+    static void* operator new(size_t size)
+    {
+        return MessagePool::instance().allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        MessagePool::instance().deallocate(ptr, size);
     }
 
     OutputMessage(OutputMessage&&) = delete;
@@ -53,6 +65,17 @@ public:
 
     size_t get_len() const { return serializer_.getSerializedDataLength(); }
 
+    /**
+     * Checks whether a submessage with a payload of submessage_len bytes can still be appended,
+     * accounting for its alignment and header.
+     **/
+    bool can_append_submessage(size_t submessage_len) const
+    {
+        return (((get_len() + 3) & ~size_t(3))
+                + raw_codec::SUBMESSAGE_HEADER_SIZE
+                + submessage_len) <= len_;
+    }
+
     template<class T>
     bool append_submessage(
             dds::xrce::SubmessageId submessage_id,
@@ -76,9 +99,24 @@ private:
             uint8_t flags,
             size_t submessage_len);
 
+    void align_to_4();
+
     template<class T>
     bool serialize(const T& data);
 
+    bool serialize(const dds::xrce::MessageHeader& data) { return encode(data); }
+
+    bool serialize(const dds::xrce::SubmessageHeader& data) { return encode(data); }
+
+    bool serialize(const dds::xrce::ACKNACK_Payload& data) { return encode(data); }
+
+    bool serialize(const dds::xrce::HEARTBEAT_Payload& data) { return encode(data); }
+
+    bool serialize(const SharedDataPayload& data) { return encode(data); }
+
+    template<class T>
+    bool encode(const T& data);
+
     void log_error();
 
 private:
@@ -95,7 +133,7 @@ inline bool OutputMessage::append_submessage(
         uint8_t flags)
 {
     bool rv = false;
-    if (append_subheader(submessage_id, flags, data.getCdrSerializedSize()))
+    if (append_subheader(submessage_id, flags, raw_codec::encoded_size(data)))
     {
         rv = serialize(data);
     }
@@ -134,7 +172,7 @@ inline bool OutputMessage::append_fragment(
         size_t len)
 {
     bool rv = false;
-    serializer_.jump((4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3);
+    align_to_4();
     if (serialize(subheader))
     {
         try
@@ -161,10 +199,22 @@ inline bool OutputMessage::append_subheader(
     subheader.flags(flags);
     subheader.submessage_length(uint16_t(submessage_len));
 
-    serializer_.jump((4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3);
+    align_to_4();
     return serialize(subheader);
 }
 
+/**
+ * Pooled buffers are not zero-filled, so the alignment padding is written explicitly.
+ **/
+inline void OutputMessage::align_to_4()
+{
+    size_t padding = (4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3;
+    for (size_t i = 0; i < padding; ++i)
+    {
+        serializer_.serialize(uint8_t(0));
+    }
+}
+
 template<class T>
 inline bool OutputMessage::serialize(const T& data)
 {
@@ -181,6 +231,28 @@ inline bool OutputMessage::serialize(const T& data)
     return rv;
 }
 
+/**
+ * Fast path for the fixed-layout types, written straight into the buffer (see RawCodec.hpp).
+ * The serializer is moved past them so that the following fastcdr calls stay in sync.
+ **/
+template<class T>
+inline bool OutputMessage::encode(const T& data)
+{
+    bool rv = false;
+    const size_t size = raw_codec::encoded_size(data);
+    if (size <= (len_ - get_len()))
+    {
+        raw_codec::encode(data, reinterpret_cast<uint8_t*>(serializer_.getCurrentPosition()));
+        serializer_.jump(size);
+        rv = true;
+    }
+    else
+    {
+        log_error();
+    }
+    return rv;
+}
+
 } // namespace uxr
 } // namespace eprosima
 
@@ -33,6 +33,16 @@ struct InputPacket
 
 typedef std::shared_ptr<OutputMessage> OutputMessagePtr;
 
+/**
+ * Creates an OutputMessage whose object, control block and buffer come from the MessagePool.
+ */
+template<typename ... Args>
+inline OutputMessagePtr make_output_message(
+        Args&& ... args)
+{
+    return std::allocate_shared<OutputMessage>(MessagePoolAllocator<OutputMessage>(), std::forward<Args>(args)...);
+}
+
 template<typename EndPoint>
 struct OutputPacket
 {
@@ -0,0 +1,226 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_MESSAGE_RAW_CODEC_HPP_
+#define UXR_AGENT_MESSAGE_RAW_CODEC_HPP_
+
+#include <uxr/agent/types/MessageHeader.hpp>
+#include <uxr/agent/types/SubMessageHeader.hpp>
+#include <uxr/agent/types/XRCETypes.hpp>
+#include <uxr/agent/types/SharedDataPayload.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace eprosima {
+namespace uxr {
+namespace raw_codec {
+
+/*
+ * Encoders and decoders for the fixed-layout types exchanged on every packet, which read and write the
+ * message buffer directly instead of going through fastcdr. They produce the same bytes as the generated
+ * serialize/deserialize methods: the header sequence number and the submessage length are little endian,
+ * the payload fields use the default fastcdr endianness (the host one), and every payload starts 4-aligned,
+ * so none of these layouts has padding. Variable-shape payloads (CREATE, INFO, ...) keep using fastcdr.
+ */
+constexpr size_t SUBMESSAGE_HEADER_SIZE = 4;
+constexpr size_t ACKNACK_PAYLOAD_SIZE = 5;
+constexpr size_t HEARTBEAT_PAYLOAD_SIZE = 5;
+constexpr size_t OBJECT_REQUEST_SIZE = 4;
+
+inline void store_le16(
+        uint8_t* buf,
+        uint16_t value)
+{
+    buf[0] = uint8_t(value & 0xFF);
+    buf[1] = uint8_t(value >> 8);
+}
+
+inline uint16_t load_le16(
+        const uint8_t* buf)
+{
+    return uint16_t(buf[0] | (buf[1] << 8));
+}
+
+/*
+ * Fallback for the types without a fixed layout.
+ */
+template<class T>
+inline size_t encoded_size(
+        const T& data)
+{
+    return data.getCdrSerializedSize();
+}
+
+inline size_t encoded_size(
+        const dds::xrce::MessageHeader& data)
+{
+    return (128 > data.session_id()) ? 8 : 4;
+}
+
+inline size_t encoded_size(
+        const dds::xrce::SubmessageHeader& /*data*/)
+{
+    return SUBMESSAGE_HEADER_SIZE;
+}
+
+inline size_t encoded_size(
+        const dds::xrce::ACKNACK_Payload& /*data*/)
+{
+    return ACKNACK_PAYLOAD_SIZE;
+}
+
+inline size_t encoded_size(
+        const dds::xrce::HEARTBEAT_Payload& /*data*/)
+{
+    return HEARTBEAT_PAYLOAD_SIZE;
+}
+
+inline size_t encoded_size(
+        const SharedDataPayload& data)
+{
+    return OBJECT_REQUEST_SIZE + data.data().size();
+}
+
+inline void encode(
+        const dds::xrce::MessageHeader& data,
+        uint8_t* buf)
+{
+    /* Read once, the stores through buf may alias data as far as the compiler knows. */
+    const uint8_t session_id = data.session_id();
+    buf[0] = session_id;
+    buf[1] = data.stream_id();
+    store_le16(buf + 2, data.sequence_nr());
+    if (128 > session_id)
+    {
+        memcpy(buf + 4, data.client_key().data(), 4);
+    }
+}
+
+inline void decode(
+        dds::xrce::MessageHeader& data,
+        const uint8_t* buf)
+{
+    data.session_id(buf[0]);
+    data.stream_id(buf[1]);
+    data.sequence_nr(load_le16(buf + 2));
+    if (128 > buf[0])
+    {
+        memcpy(data.client_key().data(), buf + 4, 4);
+    }
+}
+
+inline void encode(
+        const dds::xrce::SubmessageHeader& data,
+        uint8_t* buf)
+{
+    buf[0] = uint8_t(data.submessage_id());
+    buf[1] = data.flags();
+    store_le16(buf + 2, data.submessage_length());
+}
+
+inline void decode(
+        dds::xrce::SubmessageHeader& data,
+        const uint8_t* buf)
+{
+    data.submessage_id(dds::xrce::SubmessageId(buf[0]));
+    data.flags(buf[1]);
+    data.submessage_length(load_le16(buf + 2));
+}
+
+inline void encode(
+        const dds::xrce::ACKNACK_Payload& data,
+        uint8_t* buf)
+{
+    uint16_t first_unacked_seq_num = data.first_unacked_seq_num();
+    memcpy(buf, &first_unacked_seq_num, 2);
+    buf[2] = data.nack_bitmap()[0];
+    buf[3] = data.nack_bitmap()[1];
+    buf[4] = data.stream_id();
+}
+
+inline void decode(
+        dds::xrce::ACKNACK_Payload& data,
+        const uint8_t* buf)
+{
+    uint16_t first_unacked_seq_num;
+    memcpy(&first_unacked_seq_num, buf, 2);
+    data.first_unacked_seq_num(first_unacked_seq_num);
+    data.nack_bitmap({{buf[2], buf[3]}});
+    data.stream_id(buf[4]);
+}
+
+inline void encode(
+        const dds::xrce::HEARTBEAT_Payload& data,
+        uint8_t* buf)
+{
+    uint16_t seq_nrs[2] = {data.first_unacked_seq_nr(), data.last_unacked_seq_nr()};
+    memcpy(buf, seq_nrs, 4);
+    buf[4] = data.stream_id();
+}
+
+inline void decode(
+        dds::xrce::HEARTBEAT_Payload& data,
+        const uint8_t* buf)
+{
+    uint16_t seq_nrs[2];
+    memcpy(seq_nrs, buf, 4);
+    data.first_unacked_seq_nr(seq_nrs[0]);
+    data.last_unacked_seq_nr(seq_nrs[1]);
+    data.stream_id(buf[4]);
+}
+
+inline void encode(
+        const dds::xrce::BaseObjectRequest& data,
+        uint8_t* buf)
+{
+    memcpy(buf, data.request_id().data(), 2);
+    memcpy(buf + 2, data.object_id().data(), 2);
+}
+
+inline void decode(
+        dds::xrce::BaseObjectRequest& data,
+        const uint8_t* buf)
+{
+    memcpy(data.request_id().data(), buf, 2);
+    memcpy(data.object_id().data(), buf + 2, 2);
+}
+
+/*
+ * The data is read into the current size of the sample, as the generated deserializer does:
+ * the caller sizes it from the submessage length.
+ */
+inline void decode(
+        dds::xrce::WRITE_DATA_Payload_Data& data,
+        const uint8_t* buf)
+{
+    decode(static_cast<dds::xrce::BaseObjectRequest&>(data), buf);
+    std::vector<uint8_t>& serialized_data = data.data().serialized_data();
+    memcpy(serialized_data.data(), buf + OBJECT_REQUEST_SIZE, serialized_data.size());
+}
+
+inline void encode(
+        const SharedDataPayload& data,
+        uint8_t* buf)
+{
+    encode(data.request(), buf);
+    memcpy(buf + OBJECT_REQUEST_SIZE, data.data().data(), data.data().size());
+}
+
+} // namespace raw_codec
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_MESSAGE_RAW_CODEC_HPP_
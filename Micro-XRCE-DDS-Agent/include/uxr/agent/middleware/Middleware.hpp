@@ -16,6 +16,7 @@
 #define UXR_AGENT_MIDDLEWARE_MIDDLEWARE_HPP_
 
 #include <uxr/agent/config.hpp>
+#include <uxr/agent/types/SharedData.hpp>
 
 #include <string>
 #include <cstdint>
@@ -23,6 +24,7 @@
 #include <vector>
 #include <functional>
 #include <chrono>
+#include <memory>
 
 namespace eprosima {
 namespace uxr {
@@ -164,6 +166,44 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) = 0;
 
+    /**
+     * Writes data the middleware may keep without copying it. By default it is written as a vector.
+     */
+    virtual bool write_data(
+            uint16_t datawriter_id,
+            const SharedData& data)
+    {
+        return write_data(datawriter_id, *data);
+    }
+
+    /**
+     * Tells whether the DataWriter can write a sample right away. A DataWriter which cannot is not written,
+     * its sample is held back by the reliable streams until it can. By default it always can.
+     */
+    virtual bool is_writable(
+            uint16_t /*datawriter_id*/)
+    {
+        return true;
+    }
+
+    /**
+     * Reads data which may be shared with the other readers of the sample instead of copied for each one.
+     * By default it is read as a vector into a new buffer.
+     */
+    virtual bool read_data(
+            uint16_t datareader_id,
+            SharedData& data,
+            std::chrono::milliseconds timeout)
+    {
+        std::shared_ptr<std::vector<uint8_t>> read_buffer = std::make_shared<std::vector<uint8_t>>();
+        bool rv = read_data(datareader_id, *read_buffer, timeout);
+        if (rv)
+        {
+            data = std::move(read_buffer);
+        }
+        return rv;
+    }
+
     virtual bool read_request(
             uint16_t replier_id,
             std::vector<uint8_t>& data,
@@ -175,6 +215,20 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) = 0;
 
+/**********************************************************************************************************************
+ * Notification functions.
+ **********************************************************************************************************************/
+    /**
+     * Sets the function called when new data may be available for the DataReader.
+     * Returns false if the middleware does not support it, the DataReader shall then be polled.
+     */
+    virtual bool set_data_available_callback(
+            uint16_t /*datareader_id*/,
+            const std::function<void ()>& /*callback*/)
+    {
+        return false;
+    }
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
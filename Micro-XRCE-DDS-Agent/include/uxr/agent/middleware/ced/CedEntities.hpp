@@ -15,10 +15,12 @@
 #ifndef UXR_AGENT_MIDDLEWARE_CED_CED_ENTITIES_HPP_
 #define UXR_AGENT_MIDDLEWARE_CED_CED_ENTITIES_HPP_
 
-#include <uxr/agent/utils/SeqNum.hpp>
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/types/SharedData.hpp>
 
 #include <string>
-#include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
@@ -58,10 +60,56 @@ enum class ReadAccess : uint8_t
     COMPLETE = 3
 };
 
+enum class HistoryKind : uint8_t
+{
+    KEEP_LAST = 0,
+    KEEP_ALL = 1
+};
+
+/**
+ * History of a topic. KEEP_LAST overwrites the oldest sample, which the readers falling behind lose,
+ * whereas KEEP_ALL refuses the samples that would overwrite an unread one, see CedGlobalTopic::is_writable.
+ */
+struct HistoryQos
+{
+    HistoryQos(
+            HistoryKind history_kind = HistoryKind::KEEP_LAST,
+            size_t history_depth = CED_HISTORY_DEPTH)
+        : kind(history_kind)
+        , depth(history_depth)
+    {}
+
+    HistoryKind kind;
+    size_t depth;
+};
+
+/**********************************************************************************************************************
+ * CedSample
+ **********************************************************************************************************************/
+/**
+ * Sample written to a topic. It is immutable once written, the history and every reader share it,
+ * as well as its data, which comes from the writer without being copied.
+ */
+struct CedSample
+{
+    CedSample(
+            const SharedData& sample_data,
+            TopicSource sample_src)
+        : data(sample_data)
+        , src(sample_src)
+    {}
+
+    const SharedData data;
+    const TopicSource src;
+};
+
+typedef std::shared_ptr<const CedSample> CedSamplePtr;
+
 /**********************************************************************************************************************
  * CedTopicManager
  **********************************************************************************************************************/
 class CedGlobalTopic;
+class CedDataReader;
 typedef const std::function<void (int16_t)> OnNewDomain;
 typedef const std::function<void (int16_t, const std::string&)> OnNewTopic;
 
@@ -83,9 +131,14 @@ public:
     static void unregister_on_new_topic_cb(
             uint32_t key);
 
+    /**
+     * Gets the topic, creating it with the given history if it does not exist yet.
+     * Fails if it exists with a different history.
+     */
     static bool register_topic(
             const std::string& topic_name,
             int16_t domain_id,
+            const HistoryQos& history_qos,
             std::shared_ptr<CedGlobalTopic>& topic);
 
 private:
@@ -111,49 +164,103 @@ class CedGlobalTopic
     friend class CedDataReader;
     friend class CedDataWriter;
 public:
+    /**
+     * The history keeps history_qos.depth samples, rounded up to a power of two.
+     */
     CedGlobalTopic(
             const std::string& topic_name,
-            int16_t domain_id);
+            int16_t domain_id,
+            const HistoryQos& history_qos = HistoryQos());
 
     ~CedGlobalTopic();
 
     const std::string& name() const;
 
+    size_t history_depth() const { return history_mask_ + 1; }
+
+    HistoryKind history_kind() const { return history_kind_; }
+
+    bool has_history(
+            const HistoryQos& history_qos) const;
+
 private:
     bool write(
-            const std::vector<uint8_t>& data,
+            const SharedData& data,
             WriteAccess write_access,
             TopicSource topic_src,
             uint8_t& errcode);
 
     bool read(
-            std::vector<uint8_t>& data,
+            CedSamplePtr& sample,
             std::chrono::milliseconds timeout,
-            SeqNum& last_read,
+            std::atomic<uint64_t>& last_read,
             ReadAccess read_access,
             uint8_t& errcode);
 
+    /**
+     * Whether the next sample can be written without overwriting an unread one of a KEEP_ALL history.
+     * The writers check it beforehand to hold their samples back instead of failing.
+     */
+    bool is_writable();
+
+    /**
+     * Whether the next sample does not overwrite an unread one. Must be called with write_mtx_ held.
+     */
+    bool has_room() const;
+
+    void update_last_read(
+            std::atomic<uint64_t>& last_read,
+            uint64_t read_until);
+
+    void register_reader(
+            std::atomic<uint64_t>& last_read);
+
+    void unregister_reader(
+            const std::atomic<uint64_t>& last_read);
+
     bool check_write_access(
             WriteAccess write_access,
             TopicSource topic_src);
 
     bool check_read_access(
             ReadAccess read_access,
-            size_t index);
+            TopicSource topic_src);
 
-    bool get_data(
-            std::vector<uint8_t>& data,
-            SeqNum& last_read,
+    bool get_sample(
+            CedSamplePtr& sample,
+            uint64_t& last_read,
             ReadAccess read_access);
 
+    void set_on_data_available(
+            const CedDataReader* datareader,
+            const std::function<void ()>& on_data_available);
+
 private:
+    /**
+     * Seqlock slot: sequence is the number of the sample held, busy while the writer replaces it.
+     * The sample is only accessed through the std::atomic_load/std::atomic_store overloads.
+     */
+    struct HistorySlot
+    {
+        static constexpr uint64_t busy = UINT64_MAX;
+
+        std::atomic<uint64_t> sequence{0};
+        CedSamplePtr sample;
+    };
+
     const std::string name_;
     int16_t domain_id_;
-    SeqNum last_write_;
-    std::mutex mtx_;
+    const HistoryKind history_kind_;
+    const size_t history_mask_;
+    std::unique_ptr<HistorySlot[]> history_;
+    std::atomic<uint64_t> last_write_;
+    std::mutex write_mtx_;
+    std::set<const std::atomic<uint64_t>*> readers_;
+    std::atomic<uint32_t> waiting_readers_;
+    std::mutex wait_mtx_;
     std::condition_variable cv_;
-    std::array<std::vector<uint8_t>, 16> history_; // TODO (review history size)
-    std::array<TopicSource, 16> srcs_; // TODO (review history size)
+    std::mutex on_data_available_mtx_;
+    std::unordered_map<const CedDataReader*, std::function<void ()>> on_data_available_map_;
 };
 
 /**********************************************************************************************************************
@@ -266,6 +373,12 @@ public:
         const std::vector<uint8_t>& data,
         uint8_t& errcode) const;
 
+    bool write(
+        const SharedData& data,
+        uint8_t& errcode) const;
+
+    bool is_writable() const { return topic_->get_global_topic()->is_writable(); }
+
     const std::string& topic_name() const { return topic_->get_global_topic()->name(); }
 
 private:
@@ -287,22 +400,35 @@ public:
             const ReadAccess read_access)
         : subscriber_(subscriber)
         , topic_(topic)
-        , last_read_(UINT16_MAX)
+        , last_read_(0)
         , read_access_(read_access)
-    {}
-    ~CedDataReader() = default;
+    {
+        topic_->get_global_topic()->register_reader(last_read_);
+    }
+    ~CedDataReader();
 
     bool read(
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout,
             uint8_t& errcode);
 
+    /**
+     * Reads the data of the next sample, shared with the history and the other readers.
+     */
+    bool read(
+            SharedData& data,
+            std::chrono::milliseconds timeout,
+            uint8_t& errcode);
+
+    void set_on_data_available(
+            const std::function<void ()>& on_data_available);
+
     const std::string& topic_name() const { return topic_->get_global_topic()->name(); }
 
 private:
     const std::shared_ptr<CedSubscriber> subscriber_;
     const std::shared_ptr<CedTopic> topic_;
-    SeqNum last_read_;
+    std::atomic<uint64_t> last_read_;
     const ReadAccess read_access_;
 };
 
@@ -76,6 +76,7 @@ public:
      * @param topic_id          The CedTopic identifier.
      * @param participant_id    The CedParticipant identifier to which the CedTopic is associated.
      * @param ref               The CedTopic reference. Currently, it is used as the topic name.
+     *                          The topic has the default history, KEEP_LAST of CED_HISTORY_DEPTH samples.
      * @return  true in case of creation and false in other case.
      */
     bool create_topic_by_ref(
@@ -85,14 +86,14 @@ public:
 
     /**
      * @brief Creates a CedTopic associated to a CedParticipant from an XML.
-     *        Currently, the xml paramenter is used as topic name.
-     *        In a near future, the Middleware interface should change the xml parameter by an "attributes" one.
-     *        For this purpose an XML parser and a reference data base are needed in the XRCE Core.
-     *        With the aforementioned modification the topic name will be extracted from the "attributes".
+     *        The topic name and its history are taken from the <topic> element, as in the Fast DDS profiles:
+     *        <dds><topic><name>Topic</name><historyQos><kind>KEEP_ALL</kind><depth>64</depth></historyQos></topic></dds>
+     *        The history defaults to KEEP_LAST of CED_HISTORY_DEPTH samples.
+     *        Without a <topic> element, the xml paramenter is used as a reference.
      * @param topic_id          The CedTopic identifier.
      * @param participant_id    The CedParticipant identifier to which the CedTopic is associated.
-     * @param xml               The XML that describes the CedTopic. Currently, it is used as the topic name.
-     * @return  true in case of creation and false in other case.
+     * @param xml               The XML that describes the CedTopic.
+     * @return  true in case of creation and false in other case, as an existing topic with a different history.
      */
     bool create_topic_by_xml(
             uint16_t topic_id,
@@ -149,7 +150,8 @@ public:
      * @brief Creates a CedDataWriter associated to a CedPublisher from an XML.
      * @param datawriter_id         The CedDataWriter identifier.
      * @param publisher_id          The CedPublisher identifier.
-     * @param xml                   The XML that describes the CedDataWriter. Currently, it is used as the topic name.
+     * @param xml                   The XML that describes the CedDataWriter, the topic name being taken from
+     *                              its <topic> element. Without it, the xml paramenter is used as a reference.
      * @return  true in case of creation and false in other case.
      */
     bool create_datawriter_by_xml(
@@ -177,7 +179,8 @@ public:
      * @brief Creates a CedDataReader associated to a CedSubscriber from an XML.
      * @param datareader_id         The CedDataReader identifier.
      * @param subscriber_id         The CedSubscriber identifier.
-     * @param xml                   The XML that describes the CedDataReader. Currently, it is used as the topic name.
+     * @param xml                   The XML that describes the CedDataReader, the topic name being taken from
+     *                              its <topic> element. Without it, the xml paramenter is used as a reference.
      * @return  true in case of creation and false in other case.
      */
     bool create_datareader_by_xml(
@@ -311,6 +314,25 @@ public:
             uint16_t datawriter_id,
             const std::vector<uint8_t>& data) override;
 
+    /**
+     * @brief Writes data using the CedDataWriter identified by the datawriter_id parameter.
+     *        The topic keeps the data itself, it is shared with the readers without being copied.
+     * @param datawriter_id The CedDataWriter identifier.
+     * @param data          The data to be written.
+     * @return  true in case of successful writing and false in other case.
+     */
+    bool write_data(
+            uint16_t datawriter_id,
+            const SharedData& data) override;
+
+    /**
+     * @brief Checks whether the CedDataWriter can write without overwriting an unread sample of a KEEP_ALL topic.
+     * @param datawriter_id The CedDataWriter identifier.
+     * @return  false in case of a KEEP_ALL topic whose history is full of unread samples, true in other case.
+     */
+    bool is_writable(
+            uint16_t datawriter_id) override;
+
     /**
      * @brief Not implemented.
      */
@@ -339,6 +361,30 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) override;
 
+    /**
+     * @brief Read data using the CedDataReader identified by the datareader_id paramenter.
+     *        The data is the one written, shared with the other readers without being copied.
+     *        This is a blocking function that will block at most "timeout" milleseconds.
+     * @param datareader_id The CedDataReader's identifier.
+     * @param data          The data read.
+     * @param timeout       The timeout (milliseconds) of the reading.
+     * @return  true in case of successful reading and false in other case.
+     */
+    bool read_data(
+            uint16_t datareader_id,
+            SharedData& data,
+            std::chrono::milliseconds timeout) override;
+
+    /**
+     * @brief Sets the function called each time a sample is written in the topic of the CedDataReader.
+     * @param datareader_id The CedDataReader's identifier.
+     * @param callback      The function to call.
+     * @return  true in case of an existing CedDataReader and false in other case.
+     */
+    bool set_data_available_callback(
+            uint16_t datareader_id,
+            const std::function<void ()>& callback) override;
+
     /**
      * @brief Not implemented.
      */
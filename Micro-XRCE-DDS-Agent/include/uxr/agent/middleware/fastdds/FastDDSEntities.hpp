@@ -22,10 +22,13 @@
 #include <fastdds/dds/publisher/DataWriter.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 #include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/DataReaderListener.hpp>
 #include <fastrtps/attributes/all_attributes.h>
 #include <uxr/agent/types/TopicPubSubType.hpp>
 #include <uxr/agent/types/XRCETypes.hpp>
 
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace eprosima {
@@ -275,12 +278,14 @@ private:
 /**********************************************************************************************************************
  * FastDataReader
  **********************************************************************************************************************/
-class FastDDSDataReader
+class FastDDSDataReader : public fastdds::dds::DataReaderListener
 {
 public:
     FastDDSDataReader(const std::shared_ptr<FastDDSSubscriber>& subscriber)
         : subscriber_{subscriber}
         , ptr_{nullptr}
+        , on_data_available_mtx_{}
+        , on_data_available_{}
     {}
 
     ~FastDDSDataReader();
@@ -295,13 +300,18 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout,
             fastdds::dds::SampleInfo& sample_info);
+    void set_on_data_available(const std::function<void ()>& on_data_available);
     const fastdds::dds::DataReader* ptr() const;
     const fastdds::dds::DomainParticipant* participant() const;
 
+    void on_data_available(fastdds::dds::DataReader* reader) override;
+
 private:
     std::shared_ptr<FastDDSSubscriber> subscriber_;
     std::shared_ptr<FastDDSTopic> topic_;
     fastdds::dds::DataReader* ptr_;
+    std::mutex on_data_available_mtx_;
+    std::function<void ()> on_data_available_;
 };
 
 /**********************************************************************************************************************
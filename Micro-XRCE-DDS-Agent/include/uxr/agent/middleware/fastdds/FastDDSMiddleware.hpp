@@ -153,6 +153,10 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) override;
 
+    bool set_data_available_callback(
+            uint16_t datareader_id,
+            const std::function<void ()>& callback) override;
+
     bool read_reply(
             uint16_t reply_id,
             uint32_t& sequence_number,
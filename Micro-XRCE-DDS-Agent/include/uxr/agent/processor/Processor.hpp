@@ -16,8 +16,16 @@
 #define UXR_AGENT_PROCESSOR_PROCESSOR_HPP_
 
 #include <uxr/agent/middleware/Middleware.hpp>
+#include <uxr/agent/types/XRCETypes.hpp>
+#include <uxr/agent/utils/TimerWheel.hpp>
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <mutex>
 
@@ -71,9 +79,23 @@ public:
             std::vector<dds::xrce::TransportAddress>& address,
             OutputPacket<IPv4EndPoint>& output_packet) const;
 
-    void check_heartbeats();
+    /**
+     * Waits until the next heartbeat or flush timer expires, at most max_wait,
+     * then sends the expired heartbeats and the coalesced messages that are due.
+     */
+    void check_output_timers(
+            std::chrono::milliseconds max_wait);
 
 private:
+    /**
+     * Processes the messages of the stream in order. A message held back, by a DataWriter which cannot
+     * write yet, is put back into the stream and the following ones wait for it.
+     */
+    void process_input_stream(
+            ProxyClient& client,
+            dds::xrce::StreamId stream_id,
+            InputPacket<EndPoint>& input_packet);
+
     void process_input_message(
             ProxyClient& client,
             InputPacket<EndPoint>& input_packet);
@@ -121,15 +143,66 @@ private:
             ProxyClient& client,
             InputPacket<EndPoint>& input_packet);
 
+    bool process_performance_submessage(
+            ProxyClient& client,
+            InputPacket<EndPoint>& input_packet);
+
     bool read_data_callback(
             const WriteFnArgs& write_args,
             const std::vector<uint8_t>& buffer,
             std::chrono::milliseconds timeout);
 
+    void send_output_messages(
+            ProxyClient& client,
+            dds::xrce::StreamId stream_id,
+            OutputPacket<EndPoint>& output_packet);
+
+    void schedule_flush(
+            ProxyClient& client,
+            dds::xrce::StreamId stream_id,
+            std::chrono::steady_clock::time_point flush_time);
+
+    /**
+     * Gets the earliest pending flush deadline. Must be called with timers_mtx_ held.
+     */
+    bool next_flush_deadline(
+            std::chrono::steady_clock::time_point& deadline);
+
+    void flush_output_messages(
+            uint64_t output_key);
+
+    void arm_heartbeat(
+            ProxyClient& client,
+            dds::xrce::StreamId stream_id);
+
+    void update_heartbeat(
+            ProxyClient& client,
+            dds::xrce::StreamId stream_id,
+            bool unacked_data,
+            bool acked_data);
+
+    void send_heartbeat(
+            uint64_t heartbeat_key);
+
 private:
     Server<EndPoint>& server_;
     Middleware::Kind middleware_kind_;
     Root& root_;
+
+    /*
+     * Output timers, keyed by client and stream. Heartbeats are only armed for the reliable output streams
+     * with unacknowledged messages, at their retransmission timeout, flushes for the streams holding back
+     * a coalesced message. The flush deadlines are kept in a min-heap as well, its entries
+     * superseded by an earlier deadline being dropped when they reach the top.
+     */
+    static constexpr std::chrono::milliseconds heartbeat_tick{10};
+    std::mutex timers_mtx_;
+    std::condition_variable timers_cv_;
+    std::chrono::steady_clock::time_point timers_wakeup_;
+    utils::TimerWheel<uint64_t> heartbeat_wheel_;
+    std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> flush_times_;
+    typedef std::pair<std::chrono::steady_clock::time_point, uint64_t> FlushDeadline;
+    std::priority_queue<FlushDeadline, std::vector<FlushDeadline>, std::greater<FlushDeadline>> flush_deadlines_;
 };
 
 } // namespace uxr
@@ -0,0 +1,114 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_READER_DELIVERY_POOL_HPP_
+#define UXR_AGENT_READER_DELIVERY_POOL_HPP_
+
+#include <uxr/agent/visibility.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Unit of work of the DeliveryPool. A task runs on a worker when it is notified or when the
+ * time it asked for is reached, and it shall never block.
+ */
+class DeliveryTask
+{
+    friend class DeliveryPool;
+public:
+    DeliveryTask()
+        : active_(false)
+        , queued_(false)
+        , running_(false)
+        , notified_(false)
+        , next_run_()
+    {}
+
+    virtual ~DeliveryTask() = default;
+
+protected:
+    /**
+     * Returns false once the task is done. Otherwise next_run is set to the time at which it
+     * shall run again if it is not notified before, time_point::max() to wait for a notification.
+     */
+    virtual bool run(
+            std::chrono::steady_clock::time_point& next_run) = 0;
+
+private:
+    bool active_;
+    bool queued_;
+    bool running_;
+    bool notified_;
+    std::chrono::steady_clock::time_point next_run_;
+};
+
+/**
+ * Worker pool shared by every reader of the agent.
+ * Readers are driven by the data available notifications of the middleware and by timers
+ * (polling, rate limiting and deadlines) instead of holding a thread each.
+ */
+class DeliveryPool
+{
+public:
+    UXR_AGENT_EXPORT static DeliveryPool& instance();
+
+    /**
+     * Activates the task and schedules it as soon as possible.
+     */
+    UXR_AGENT_EXPORT void start_task(
+            const std::shared_ptr<DeliveryTask>& task);
+
+    /**
+     * Deactivates the task, waiting for its current run to finish if any.
+     */
+    UXR_AGENT_EXPORT void stop_task(
+            const std::shared_ptr<DeliveryTask>& task);
+
+    /**
+     * Schedules an active task, it is ignored by inactive ones.
+     */
+    UXR_AGENT_EXPORT void notify(
+            const std::shared_ptr<DeliveryTask>& task);
+
+private:
+    DeliveryPool();
+
+    void worker_loop();
+
+    void schedule(
+            const std::shared_ptr<DeliveryTask>& task);
+
+private:
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+    std::condition_variable idle_cond_var_;
+    std::deque<std::shared_ptr<DeliveryTask>> ready_tasks_;
+    std::multimap<std::chrono::steady_clock::time_point, std::weak_ptr<DeliveryTask>> timers_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_READER_DELIVERY_POOL_HPP_
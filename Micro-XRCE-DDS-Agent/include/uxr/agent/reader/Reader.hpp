@@ -16,10 +16,14 @@
 #define UXR_AGENT_READER_READER_HPP_
 
 #include <uxr/agent/types/XRCETypes.hpp>
+#include <uxr/agent/types/SharedData.hpp>
 #include <uxr/agent/utils/TokenBucket.hpp>
+#include <uxr/agent/reader/DeliveryPool.hpp>
+#include <uxr/agent/config.hpp>
 
 #include <atomic>
-#include <thread>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <chrono>
 #include <type_traits>
@@ -36,47 +40,88 @@ struct WriteFnArgs
     dds::xrce::StreamId stream_id;
     dds::xrce::ObjectId object_id;
     dds::xrce::RequestId request_id;
+    std::function<void ()> writable_notifier;  // Wakes the reader up once its output stream has room again.
 };
 
 template<typename RA, typename WA = const WriteFnArgs&>
 class Reader
 {
 public:
-    typedef const std::function<bool (RA, std::vector<uint8_t>&, std::chrono::milliseconds)> ReadFn;
+    typedef const std::function<bool (RA, SharedData&, std::chrono::milliseconds)> ReadFn;
     typedef const std::function<bool (WA, const std::vector<uint8_t>&, std::chrono::milliseconds)> WriteFn;
 
 public:
+    Reader();
+
     ~Reader();
 
+    /**
+     * Starts delivering samples on the DeliveryPool. If event_driven is true, the reader only reads
+     * when notified (see get_notifier), otherwise it polls every READER_POLL_PERIOD.
+     */
     bool start_reading(
         const dds::xrce::DataDeliveryControl& delivery_control,
         ReadFn read_fn,
         RA read_args,
         WriteFn write_fn,
-        WA write_args);
+        WA write_args,
+        bool event_driven = false);
 
     bool stop_reading();
 
+    /**
+     * Returns the function to call when new data is available, it may outlive the reader.
+     */
+    std::function<void ()> get_notifier() const;
+
 private:
-    void read_task(
-        ReadFn read_fn,
-        WriteFn write_fn);
+    class ReadTask : public DeliveryTask
+    {
+    public:
+        ReadTask()
+            : running_cond{false}
+        {}
+
+        bool run(
+            std::chrono::steady_clock::time_point& next_run) final;
+
+        dds::xrce::DataDeliveryControl delivery_control;
+        std::function<bool (RA, SharedData&, std::chrono::milliseconds)> read_fn;
+        std::function<bool (WA, const std::vector<uint8_t>&, std::chrono::milliseconds)> write_fn;
+        typename std::decay<RA>::type read_args;
+        typename std::decay<WA>::type write_args;
+        bool event_driven;
+        std::atomic<bool> running_cond;
+        std::unique_ptr<utils::TokenBucket> token_bucket;
+        uint16_t message_count;
+        std::chrono::steady_clock::time_point final_time;
+        SharedData data;
+        bool sample_pending;
+        bool sample_paid;
+    };
 
 private:
-    dds::xrce::DataDeliveryControl delivery_control_;
-    typename std::decay<RA>::type read_args_;
-    typename std::decay<WA>::type write_args_;
-    std::atomic<bool> running_cond_;
-    std::thread thread_;
+    std::shared_ptr<ReadTask> task_;
     std::mutex mtx_;
 
-    static constexpr uint8_t rw_timeout = 100;
+    static constexpr uint16_t max_samples_per_run = 16;
+    /* Fallback only, the reader is notified when an acknowledgement makes room in the output stream. */
+    static constexpr std::chrono::milliseconds write_retry_period{HEARTBEAT_PERIOD};
     static constexpr uint16_t max_samples_zero = 0;
     static constexpr uint16_t max_samples_unlimited = 0xFFFF;
     static constexpr uint16_t max_elapsed_time_unlimited = 0;
     static constexpr uint16_t max_bytes_per_second_unlimited = 0;
 };
 
+template<typename RA, typename WA>
+constexpr std::chrono::milliseconds Reader<RA, WA>::write_retry_period;
+
+template<typename RA, typename WA>
+inline Reader<RA, WA>::Reader()
+    : task_{std::make_shared<ReadTask>()}
+    , mtx_{}
+{}
+
 template<typename RA, typename WA>
 inline Reader<RA, WA>::~Reader()
 {
@@ -89,17 +134,38 @@ inline bool Reader<RA, WA>::start_reading(
         ReadFn read_fn,
         RA read_args,
         WriteFn write_fn,
-        WA write_args)
+        WA write_args,
+        bool event_driven)
 {
+    using namespace std::chrono;
+
     std::lock_guard<std::mutex> lock(mtx_);
     bool rv = false;
-    if (!running_cond_)
+    if (!task_->running_cond)
     {
-        delivery_control_ = delivery_control;
-        read_args_ = read_args;
-        write_args_ = write_args;
-        running_cond_ = true;
-        thread_ = std::thread(&Reader<RA, WA>::read_task, this, read_fn, write_fn);
+        /* The task may still be finishing a run that ended the previous reading. */
+        DeliveryPool::instance().stop_task(task_);
+
+        size_t rate = (max_bytes_per_second_unlimited == delivery_control.max_bytes_per_second())
+            ? SIZE_MAX
+            : delivery_control.max_bytes_per_second();
+
+        task_->delivery_control = delivery_control;
+        task_->read_fn = read_fn;
+        task_->read_args = read_args;
+        task_->write_fn = write_fn;
+        task_->write_args = write_args;
+        task_->event_driven = event_driven;
+        task_->token_bucket.reset(new utils::TokenBucket{rate});
+        task_->message_count = 0;
+        task_->final_time = (max_elapsed_time_unlimited == delivery_control.max_elapsed_time())
+            ? steady_clock::time_point::max()
+            : steady_clock::now() + seconds(delivery_control.max_elapsed_time());
+        task_->data.reset();
+        task_->sample_pending = false;
+        task_->sample_paid = false;
+        task_->running_cond = true;
+        DeliveryPool::instance().start_task(task_);
         rv = true;
     }
     return rv;
@@ -109,71 +175,95 @@ template<typename RA, typename WA>
 inline bool Reader<RA, WA>::stop_reading()
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    bool rv = true;
-    if (running_cond_)
+    if (task_->running_cond)
     {
-        running_cond_ = false;
-        if (thread_.joinable())
-        {
-            thread_.join();
-        }
-        else
+        task_->running_cond = false;
+        DeliveryPool::instance().stop_task(task_);
+    }
+    return true;
+}
+
+template<typename RA, typename WA>
+inline std::function<void ()> Reader<RA, WA>::get_notifier() const
+{
+    std::weak_ptr<DeliveryTask> task = task_;
+    return [task]()
+    {
+        std::shared_ptr<DeliveryTask> locked_task = task.lock();
+        if (locked_task)
         {
-            rv = false;
+            DeliveryPool::instance().notify(locked_task);
         }
-    }
-    return rv;
+    };
 }
 
 template<typename RA, typename WA>
-inline void Reader<RA, WA>::read_task(
-        ReadFn read_fn,
-        WriteFn write_fn)
+inline bool Reader<RA, WA>::ReadTask::run(
+        std::chrono::steady_clock::time_point& next_run)
 {
-    using namespace eprosima::uxr::utils;
     using namespace std::chrono;
 
-    constexpr std::chrono::milliseconds max_timeout{rw_timeout};
-
-    size_t rate = (max_bytes_per_second_unlimited == delivery_control_.max_bytes_per_second())
-        ? SIZE_MAX
-        : delivery_control_.max_bytes_per_second();
-    TokenBucket token_bucket{rate};
-    bool stop_cond = false;
-    uint16_t message_count = 0;
-    std::vector<uint8_t> data;
-    time_point<steady_clock> init_time = steady_clock::now();
-    time_point<steady_clock> final_time = (max_elapsed_time_unlimited == delivery_control_.max_elapsed_time()) 
-        ? time_point<steady_clock>::max()
-        : init_time + seconds(delivery_control_.max_elapsed_time());
-
-    milliseconds timeout;
-    while (running_cond_ && !stop_cond)
+    constexpr milliseconds no_wait{0};
+
+    for (uint16_t i = 0; i < max_samples_per_run; ++i)
     {
-        timeout = std::min(max_timeout, duration_cast<milliseconds>(final_time - steady_clock::now()));
-        if (read_fn(read_args_, data, timeout))
+        steady_clock::time_point now = steady_clock::now();
+        if (now > final_time)
+        {
+            running_cond = false;
+            return false;
+        }
+
+        if (!sample_pending)
         {
-            bool submessage_pushed = false;
-            do {
-                if (token_bucket.consume_tokens(data.size(), timeout))
+            if (!read_fn(read_args, data, no_wait))
+            {
+                next_run = event_driven ? final_time : std::min(final_time, now + READER_POLL_PERIOD);
+                return true;
+            }
+            sample_pending = true;
+        }
+
+        if (!sample_paid)
+        {
+            milliseconds wait_time;
+            if (!token_bucket->try_consume_tokens(data->size(), wait_time))
+            {
+                if (milliseconds::max() == wait_time)
                 {
-                    do {
-                        timeout = std::min(max_timeout, duration_cast<milliseconds>(final_time - steady_clock::now()));
-                        submessage_pushed = write_fn(write_args_, data, timeout);
-                    } while (running_cond_ && !submessage_pushed);
-
-                    if (submessage_pushed)
-                    {
-                        ++message_count;
-                    }
+                    /* Bigger than the tokens of a whole second, it would never be delivered. */
+                    data.reset();
+                    sample_pending = false;
+                    continue;
                 }
-            } while(running_cond_ && !submessage_pushed);
+                next_run = now + wait_time;
+                return true;
+            }
+            sample_paid = true;
         }
 
-        stop_cond = ((max_samples_unlimited != delivery_control_.max_samples()) &&
-                     (message_count == delivery_control_.max_samples())) || 
-                    (std::chrono::steady_clock::now() > final_time);
+        if (!write_fn(write_args, *data, no_wait))
+        {
+            next_run = now + write_retry_period;
+            return true;
+        }
+        /* Release the sample, its buffer may be shared with the history of the middleware. */
+        data.reset();
+        sample_pending = false;
+        sample_paid = false;
+
+        ++message_count;
+        if ((max_samples_unlimited != delivery_control.max_samples()) &&
+            (message_count == delivery_control.max_samples()))
+        {
+            running_cond = false;
+            return false;
+        }
     }
+
+    /* Let the other readers run before going on. */
+    next_run = steady_clock::now();
+    return true;
 }
 
 } // namespace uxr
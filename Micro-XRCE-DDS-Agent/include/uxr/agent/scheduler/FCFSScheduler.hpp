@@ -18,6 +18,7 @@
 #include <uxr/agent/scheduler/Scheduler.hpp>
 
 #include <deque>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
@@ -49,9 +50,17 @@ public:
     void push_front(
             T&& element);
 
+    void push_batch(
+            std::vector<T>& elements,
+            uint8_t priority) final;
+
     bool pop(
             T& element) final;
 
+    bool pop_batch(
+            std::vector<T>& elements,
+            size_t max_elements) final;
+
 private:
     std::deque<T> deque_;   // 双端对列
     std::mutex mtx_;        // 互斥锁
@@ -97,6 +106,29 @@ inline void FCFSScheduler<T>::push_front(
     std::lock_guard<std::mutex> lock(mtx_);     // 加锁
     deque_.push_front(std::forward<T>(element));    // 放入队列
 }
+/**
+ * Moves every element of the batch into the queue taking the lock once,
+ * the batch is left empty so the caller could reuse its storage.
+ **/
+template<class T>
+inline void FCFSScheduler<T>::push_batch(
+        std::vector<T>& elements,
+        uint8_t priority)
+{
+    (void) priority;
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& element : elements)
+    {
+        if (max_size_ <= deque_.size())
+        {
+            deque_.pop_front();
+        }
+        deque_.push_back(std::move(element));
+    }
+    elements.clear();
+    cond_var_.notify_one();
+}
+
 /**
  * element会获取双端队列队首任务
  **/
@@ -118,6 +150,31 @@ inline bool FCFSScheduler<T>::pop(
     return rv;
 }
 
+/**
+ * Blocks until at least one element is available and then moves up to max_elements
+ * elements into the batch taking the lock once.
+ **/
+template<class T>
+inline bool FCFSScheduler<T>::pop_batch(
+        std::vector<T>& elements,
+        size_t max_elements)
+{
+    bool rv = false;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cond_var_.wait(lock, [this] { return !(deque_.empty() && running_cond_); });
+    if (running_cond_)
+    {
+        while (!deque_.empty() && (elements.size() < max_elements))
+        {
+            elements.push_back(std::move(deque_.front()));
+            deque_.pop_front();
+        }
+        rv = true;
+        cond_var_.notify_one();
+    }
+    return rv;
+}
+
 } // namespace uxr
 } // namespace eprosima
 
@@ -0,0 +1,288 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_SCHEDULER_LOCK_FREE_SCHEDULER_HPP_
+#define UXR_AGENT_SCHEDULER_LOCK_FREE_SCHEDULER_HPP_
+
+#include <uxr/agent/scheduler/Scheduler.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Bounded multi-producer single-consumer ring buffer.
+ * Producers reserve a cell with a CAS on the enqueue position and publish it through the
+ * cell sequence number, the consumer never takes a lock in the fast path.
+ * When the consumer finds the ring empty it spins spin_count times and then parks on a
+ * condition variable; producers only touch the mutex when the consumer is parked.
+ * Unlike FCFSScheduler, a push on a full ring drops the new element.
+ **/
+template<class T>
+class LockFreeScheduler : public Scheduler<T>
+{
+public:
+    LockFreeScheduler(
+            size_t max_size,
+            size_t spin_count)
+        : capacity_{round_up_power_of_two(max_size)}
+        , mask_{capacity_ - 1}
+        , cells_{new Cell[capacity_]}
+        , enqueue_pos_{0}
+        , dequeue_pos_{0}
+        , spin_count_{spin_count}
+        , parked_{false}
+        , running_cond_{false}
+        , mtx_()
+        , cond_var_()
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void init() final;
+
+    void deinit() final;
+
+    void push(
+            T&& element,
+            uint8_t priority) final;
+
+    void push_batch(
+            std::vector<T>& elements,
+            uint8_t priority) final;
+
+    bool pop(
+            T& element) final;
+
+    bool pop_batch(
+            std::vector<T>& elements,
+            size_t max_elements) final;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_power_of_two(
+            size_t value);
+
+    bool try_push(
+            T&& element);
+
+    bool try_pop(
+            T& element);
+
+    bool wait_for_elements();
+
+    void wake_consumer();
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    /* Padding keeps producer and consumer positions in different cache lines. */
+    char enqueue_padding_[64];
+    std::atomic<size_t> enqueue_pos_;
+    char dequeue_padding_[64];
+    size_t dequeue_pos_;
+    const size_t spin_count_;
+    std::atomic<bool> parked_;
+    std::atomic<bool> running_cond_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+};
+
+template<class T>
+inline size_t LockFreeScheduler<T>::round_up_power_of_two(
+        size_t value)
+{
+    size_t rv = 2;
+    while (rv < value)
+    {
+        rv <<= 1;
+    }
+    return rv;
+}
+
+template<class T>
+inline void LockFreeScheduler<T>::init()
+{
+    running_cond_.store(true);
+}
+
+template<class T>
+inline void LockFreeScheduler<T>::deinit()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_.store(false);
+    cond_var_.notify_one();
+}
+
+template<class T>
+inline bool LockFreeScheduler<T>::try_push(
+        T&& element)
+{
+    Cell* cell;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell = &cells_[pos & mask_];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (0 == diff)
+        {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (0 > diff)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->data = std::move(element);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T>
+inline bool LockFreeScheduler<T>::try_pop(
+        T& element)
+{
+    Cell& cell = cells_[dequeue_pos_ & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+    {
+        return false;
+    }
+    element = std::move(cell.data);
+    cell.sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+    ++dequeue_pos_;
+    return true;
+}
+
+template<class T>
+inline void LockFreeScheduler<T>::wake_consumer()
+{
+    /* Pairs with the fence in wait_for_elements, either the consumer sees the element or we see it parked. */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        cond_var_.notify_one();
+    }
+}
+
+template<class T>
+inline bool LockFreeScheduler<T>::wait_for_elements()
+{
+    auto ready = [this]
+    {
+        return cells_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+    };
+
+    for (size_t i = 0; i < spin_count_; ++i)
+    {
+        if (ready())
+        {
+            return running_cond_.load(std::memory_order_relaxed);
+        }
+        if (!running_cond_.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cond_var_.wait(lock, [&] { return ready() || !running_cond_.load(std::memory_order_relaxed); });
+    parked_.store(false, std::memory_order_relaxed);
+    return running_cond_.load(std::memory_order_relaxed);
+}
+
+template<class T>
+inline void LockFreeScheduler<T>::push(
+        T&& element,
+        uint8_t priority)
+{
+    (void) priority;
+    if (try_push(std::move(element)))
+    {
+        wake_consumer();
+    }
+}
+
+template<class T>
+inline void LockFreeScheduler<T>::push_batch(
+        std::vector<T>& elements,
+        uint8_t priority)
+{
+    (void) priority;
+    bool pushed = false;
+    for (auto& element : elements)
+    {
+        pushed = try_push(std::move(element)) || pushed;
+    }
+    elements.clear();
+    if (pushed)
+    {
+        wake_consumer();
+    }
+}
+
+template<class T>
+inline bool LockFreeScheduler<T>::pop(
+        T& element)
+{
+    return wait_for_elements() && try_pop(element);
+}
+
+template<class T>
+inline bool LockFreeScheduler<T>::pop_batch(
+        std::vector<T>& elements,
+        size_t max_elements)
+{
+    bool rv = false;
+    if (wait_for_elements())
+    {
+        T element;
+        while ((elements.size() < max_elements) && try_pop(element))
+        {
+            elements.push_back(std::move(element));
+        }
+        rv = true;
+    }
+    return rv;
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_SCHEDULER_LOCK_FREE_SCHEDULER_HPP_
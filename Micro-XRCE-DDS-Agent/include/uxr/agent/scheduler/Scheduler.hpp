@@ -15,7 +15,9 @@
 #ifndef _UXR_AGENT_SCHEDULER_SCHEDULER_HPP_
 #define _UXR_AGENT_SCHEDULER_SCHEDULER_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -31,6 +33,8 @@ public:
     virtual void deinit() = 0;  // 
     virtual void push(T&& element, uint8_t priority) = 0;   // 加入元素和优先级
     virtual bool pop(T& element) = 0;   // 放出元素
+    virtual void push_batch(std::vector<T>& elements, uint8_t priority) = 0;
+    virtual bool pop_batch(std::vector<T>& elements, size_t max_elements) = 0;
 };
 
 } // namespace uxr
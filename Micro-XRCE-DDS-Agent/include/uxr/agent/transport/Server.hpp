@@ -18,11 +18,16 @@
 #include <uxr/agent/Agent.hpp>
 #include <uxr/agent/transport/TransportRc.hpp>
 #include <uxr/agent/transport/SessionManager.hpp>
-#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/Scheduler.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/processor/Processor.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 namespace eprosima {  
 namespace uxr {
@@ -42,6 +47,15 @@ public:
     UXR_AGENT_EXPORT bool start();
     UXR_AGENT_EXPORT bool stop();
 
+    /**
+     * @brief Sets the number of processing workers. Each worker owns an input queue and input
+     *        packets are routed by source endpoint, so the packets of a client keep their order.
+     *        It only takes effect if called before start().
+     * @param processing_workers Number of processing workers, greater than 0.
+     * @return true if the number was set, false if the server is running or the number is 0.
+     */
+    UXR_AGENT_EXPORT bool set_processing_workers(uint16_t processing_workers);
+
 #ifdef UAGENT_DISCOVERY_PROFILE
     UXR_AGENT_EXPORT bool enable_discovery(uint16_t discovery_port = DISCOVERY_PORT);
     UXR_AGENT_EXPORT bool disable_discovery();
@@ -87,25 +101,53 @@ private:
 
     void sender_loop();
 
-    void processing_loop();
+    void processing_loop(
+            size_t worker_id);
 
     void heartbeat_loop();
 
     void error_handler_loop();
 
 protected:
+    /**
+     * @brief Receives as many packets as the transport has ready in a single wakeup.
+     *        By default it falls back to a single recv_message call, transports able to
+     *        drain several messages per system call shall override it.
+     * @param input_packets Vector where the received packets are appended.
+     * @param timeout Receive timeout in milliseconds.
+     * @param transport_rc Return code of the receive operation.
+     * @return true if at least one packet was received, false otherwise.
+     */
+    virtual bool recv_messages(
+            std::vector<InputPacket<EndPoint>>& input_packets,
+            int timeout,
+            TransportRc& transport_rc);
+
+    /**
+     * @brief Sends a batch of packets. By default it calls send_message for each packet,
+     *        transports able to flush several messages per system call shall override it.
+     * @param output_packets Packets to send.
+     * @param transport_rc Return code of the send operation.
+     * @return Number of packets consumed from the front of the batch. When it is lower than the
+     *         batch size the transport_rc reports the error that stopped the sending.
+     */
+    virtual size_t send_messages(
+            std::vector<OutputPacket<EndPoint>>& output_packets,
+            TransportRc& transport_rc);
+
     Processor<EndPoint>* processor_;
 
 private:
     std::mutex mtx_;                // 互斥量
     std::thread receiver_thread_;   // 接受者线程
     std::thread sender_thread_;     // 发送者线程
-    std::thread processing_thread_; // 处理器线程
+    std::vector<std::thread> processing_threads_; // 处理器线程
     std::thread heartbeat_thread_;  // 心跳线程
     std::thread error_handler_thread_;  // 错误管理 线程
     std::atomic<bool> running_cond_;    // 原子变量 运行条件  std::atomic实例化全特化定义一个原子类型，对原子对象的访问可以建立线程间的同步
-    FCFSScheduler<InputPacket<EndPoint>> input_scheduler_;  // 输入 先来先服务调度器
-    FCFSScheduler<OutputPacket<EndPoint>> output_scheduler_;    // 输出 先来先服务调度器
+    uint16_t processing_workers_;
+    std::vector<std::unique_ptr<Scheduler<InputPacket<EndPoint>>>> input_schedulers_;  // 输入 先来先服务调度器
+    std::unique_ptr<Scheduler<OutputPacket<EndPoint>>> output_scheduler_;    // 输出 先来先服务调度器
     TransportRc transport_rc_;          // 传输状态信号
     std::mutex error_mtx_;          // 错误互斥量
     std::condition_variable error_cv_;  // 错误的条件变量
@@ -15,6 +15,7 @@
 #ifndef UXR_AGENT_TRANSPORT_ENDPOINT_CUSTOM_ENDPOINT_HPP_
 #define UXR_AGENT_TRANSPORT_ENDPOINT_CUSTOM_ENDPOINT_HPP_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -348,6 +349,71 @@ public:
         return false;
     }
 
+    /**
+     * @brief Operator == overload, consistent with operator <.
+     * @param other The CustomEndPoint to be checked against this one.
+     * @return True if neither endpoint is less than the other.
+     */
+    bool operator ==(
+            const CustomEndPoint& other) const
+    {
+        return !(*this < other) && !(other < *this);
+    }
+
+    /**
+     * @brief Computes a hash combining the value of every member.
+     * @return The hash value.
+     */
+    size_t hash() const
+    {
+        size_t rv = 0;
+        for (const auto& member : members_)
+        {
+            size_t member_hash = 0;
+            if (nullptr != member.second.data.get())
+            {
+                switch (member.second.kind)
+                {
+                    case MemberKind::UINT8:
+                    {
+                        member_hash = std::hash<uint8_t>()(*static_cast<uint8_t *>(member.second.data.get()));
+                        break;
+                    }
+                    case MemberKind::UINT16:
+                    {
+                        member_hash = std::hash<uint16_t>()(*static_cast<uint16_t *>(member.second.data.get()));
+                        break;
+                    }
+                    case MemberKind::UINT32:
+                    {
+                        member_hash = std::hash<uint32_t>()(*static_cast<uint32_t *>(member.second.data.get()));
+                        break;
+                    }
+                    case MemberKind::UINT64:
+                    {
+                        member_hash = std::hash<uint64_t>()(*static_cast<uint64_t *>(member.second.data.get()));
+                        break;
+                    }
+#ifdef __SIZEOF_UINT128__
+                    case MemberKind::UINT128:
+                    {
+                        uint128_t value = *static_cast<uint128_t *>(member.second.data.get());
+                        member_hash = std::hash<uint64_t>()(uint64_t(value) ^ uint64_t(value >> 64));
+                        break;
+                    }
+#endif // __SIZEOF_UINT128__
+                    case MemberKind::STRING:
+                    {
+                        member_hash = std::hash<std::string>()(*static_cast<std::string *>(member.second.data.get()));
+                        break;
+                    }
+                }
+            }
+            rv ^= member_hash + 0x9e3779b9 + (rv << 6) + (rv >> 2);
+        }
+        return rv;
+    }
+
     /**
      * @brief Operator << overload for ostream operations.
      * @param os The ostream object to which the output is sent.
@@ -504,4 +570,17 @@ inline bool CustomEndPoint::add_member<std::string>(
 } // namespace uxr
 } // namespace eprosima
 
+namespace std {
+
+template<>
+struct hash<eprosima::uxr::CustomEndPoint>
+{
+    size_t operator()(const eprosima::uxr::CustomEndPoint& endpoint) const
+    {
+        return endpoint.hash();
+    }
+};
+
+} // namespace std
+
 #endif // UXR_AGENT_TRANSPORT_ENDPOINT_IPV4_ENDPOINT_HPP_
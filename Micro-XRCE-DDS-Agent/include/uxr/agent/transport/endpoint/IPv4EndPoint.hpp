@@ -16,6 +16,7 @@
 #define UXR_AGENT_TRANSPORT_ENDPOINT_IPV4_ENDPOINT_HPP_
 
 #include <stdint.h>
+#include <functional>
 #include <iostream>
 
 namespace eprosima {
@@ -40,6 +41,11 @@ public:
         return (addr_ < other.addr_) || ((addr_ == other.addr_) && (port_ < other.port_));
     }
 
+    bool operator==(const IPv4EndPoint& other) const
+    {
+        return (addr_ == other.addr_) && (port_ == other.port_);
+    }
+
    friend std::ostream& operator<<(std::ostream& os, const IPv4EndPoint& endpoint)
    {
        os << static_cast<int>(static_cast<uint8_t>(endpoint.addr_)) << "."
@@ -62,4 +68,17 @@ private:
 } // namespace uxr
 } // namespace eprosima
 
+namespace std {
+
+template<>
+struct hash<eprosima::uxr::IPv4EndPoint>
+{
+    size_t operator()(const eprosima::uxr::IPv4EndPoint& endpoint) const
+    {
+        return hash<uint64_t>()((uint64_t(endpoint.get_addr()) << 16) | endpoint.get_port());
+    }
+};
+
+} // namespace std
+
 #endif // UXR_AGENT_TRANSPORT_ENDPOINT_IPV4_ENDPOINT_HPP_
@@ -16,6 +16,7 @@
 #define UXR_AGENT_TRANSPORT_ENDPOINT_IPV6_ENDPOINT_HPP_
 
 #include <stdint.h>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <array>
@@ -42,6 +43,11 @@ public:
         return (addr_ < other.addr_) || ((addr_ == other.addr_) && (port_ < other.port_));
     }
 
+    bool operator==(const IPv6EndPoint& other) const
+    {
+        return (addr_ == other.addr_) && (port_ == other.port_);
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const IPv6EndPoint& endpoint)
     {
         os << std::setfill('0') << std::setw(2) << std::hex << int(endpoint.addr_.at(0))
@@ -83,4 +89,24 @@ private:
 } // namespace uxr
 } // namespace eprosima
 
+namespace std {
+
+template<>
+struct hash<eprosima::uxr::IPv6EndPoint>
+{
+    size_t operator()(const eprosima::uxr::IPv6EndPoint& endpoint) const
+    {
+        uint64_t rv = 14695981039346656037ULL;
+        for (uint8_t byte : endpoint.get_addr())
+        {
+            rv = (rv ^ byte) * 1099511628211ULL;
+        }
+        rv = (rv ^ uint8_t(endpoint.get_port())) * 1099511628211ULL;
+        rv = (rv ^ uint8_t(endpoint.get_port() >> 8)) * 1099511628211ULL;
+        return size_t(rv);
+    }
+};
+
+} // namespace std
+
 #endif // UXR_AGENT_TRANSPORT_ENDPOINT_IPV6_ENDPOINT_HPP_
@@ -16,6 +16,7 @@
 #define _UXR_AGENT_TRANSPORT_SERIAL_ENDPOINT_HPP_
 
 #include <stdint.h>
+#include <functional>
 
 namespace eprosima {
 namespace uxr {
@@ -37,6 +38,11 @@ public:
         return (addr_ < other.addr_);
     }
 
+    bool operator==(const SerialEndPoint& other) const
+    {
+        return (addr_ == other.addr_);
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const SerialEndPoint& endpoint)
     {
         os << static_cast<int>(endpoint.addr_);
@@ -52,4 +58,17 @@ private:
 } // namespace uxr
 } // namespace eprosima
 
+namespace std {
+
+template<>
+struct hash<eprosima::uxr::SerialEndPoint>
+{
+    size_t operator()(const eprosima::uxr::SerialEndPoint& endpoint) const
+    {
+        return hash<uint8_t>()(endpoint.get_addr());
+    }
+};
+
+} // namespace std
+
 #endif //_UXR_AGENT_TRANSPORT_SERIAL_ENDPOINT_HPP_
@@ -0,0 +1,74 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _UXR_AGENT_TRANSPORT_SHARED_MEMORY_ENDPOINT_HPP_
+#define _UXR_AGENT_TRANSPORT_SHARED_MEMORY_ENDPOINT_HPP_
+
+#include <stdint.h>
+#include <functional>
+
+namespace eprosima {
+namespace uxr {
+
+class SharedMemoryEndPoint
+{
+public:
+    SharedMemoryEndPoint() = default;
+
+    SharedMemoryEndPoint(
+            uint16_t slot)
+        : slot_{slot}
+    {}
+
+    ~SharedMemoryEndPoint() {}
+
+    bool operator<(const SharedMemoryEndPoint& other) const
+    {
+        return (slot_ < other.slot_);
+    }
+
+    bool operator==(const SharedMemoryEndPoint& other) const
+    {
+        return (slot_ == other.slot_);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const SharedMemoryEndPoint& endpoint)
+    {
+        os << endpoint.slot_;
+        return os;
+    }
+
+    uint16_t get_slot() const { return slot_; }
+
+private:
+    uint16_t slot_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+namespace std {
+
+template<>
+struct hash<eprosima::uxr::SharedMemoryEndPoint>
+{
+    size_t operator()(const eprosima::uxr::SharedMemoryEndPoint& endpoint) const
+    {
+        return hash<uint16_t>()(endpoint.get_slot());
+    }
+};
+
+} // namespace std
+
+#endif //_UXR_AGENT_TRANSPORT_SHARED_MEMORY_ENDPOINT_HPP_
@@ -0,0 +1,94 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYAGENTLINUX_HPP_
+#define UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYAGENTLINUX_HPP_
+
+#include <uxr/agent/transport/Server.hpp>
+#include <uxr/agent/transport/endpoint/SharedMemoryEndPoint.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace eprosima {
+namespace uxr {
+
+extern template class Server<SharedMemoryEndPoint>; // Explicit instantiation declaration.
+
+/**
+ * Server for clients running on the same host. The agent creates a POSIX shared memory segment
+ * with one slot per client, each slot holding a pair of single-producer single-consumer rings,
+ * and the peers wake each other up through futexes placed in the segment.
+ */
+class SharedMemoryAgent : public Server<SharedMemoryEndPoint>
+{
+public:
+    SharedMemoryAgent(
+            const std::string& name,
+            Middleware::Kind middleware_kind);
+
+    ~SharedMemoryAgent() final;
+
+private:
+    bool init() final;
+
+    bool fini() final;
+
+#ifdef UAGENT_DISCOVERY_PROFILE
+    bool init_discovery(
+            uint16_t /*discovery_port*/) final { return false; }
+
+    bool fini_discovery() final { return false; }
+#endif
+
+#ifdef UAGENT_P2P_PROFILE
+    bool init_p2p(
+            uint16_t /*p2p_port*/) final { return false; }
+
+    bool fini_p2p() final { return false; }
+#endif
+
+    bool recv_message(
+            InputPacket<SharedMemoryEndPoint>& input_packet,
+            int timeout,
+            TransportRc& transport_rc) final;
+
+    bool recv_messages(
+            std::vector<InputPacket<SharedMemoryEndPoint>>& input_packets,
+            int timeout,
+            TransportRc& transport_rc) final;
+
+    bool send_message(
+            OutputPacket<SharedMemoryEndPoint> output_packet,
+            TransportRc& transport_rc) final;
+
+    bool handle_error(
+            TransportRc transport_rc) final;
+
+    bool read_next(
+            InputPacket<SharedMemoryEndPoint>& input_packet);
+
+private:
+    const std::string name_;
+    uint8_t* segment_;
+    size_t segment_size_;
+    uint16_t next_slot_;
+    PooledBuffer buffer_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYAGENTLINUX_HPP_
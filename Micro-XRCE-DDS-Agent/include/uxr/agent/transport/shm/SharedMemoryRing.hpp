@@ -0,0 +1,239 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYRING_HPP_
+#define UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYRING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <climits>
+#include <ctime>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace eprosima {
+namespace uxr {
+namespace shm {
+
+/*
+ * Layout of the shared memory segment. It is also defined by the client in
+ * src/c/profile/transport/shm/shm_transport_posix.c, both sides shall be kept in sync.
+ *
+ *  +----------------+------------------------------------------------------------+-----
+ *  | SegmentHeader  | slot 0: SlotHeader | to_agent Ring + data | to_client Ring + data | slot 1 ...
+ *  +----------------+------------------------------------------------------------+-----
+ *
+ * Every ring has a single producer and a single consumer. The agent receiver thread consumes all the
+ * to_agent rings and the agent sender thread produces into all the to_client rings. A record is a
+ * 4-byte length followed by the payload, padded to 4 bytes, and it may wrap around the end of the data.
+ */
+constexpr uint32_t SEGMENT_MAGIC = 0x4D535855; // "UXSM"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t CACHELINE_SIZE = 64;
+constexpr size_t RECORD_HEADER_SIZE = 4;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "shared memory words shall be plain 32-bit words.");
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared memory words shall be lock-free.");
+
+struct SegmentHeader
+{
+    std::atomic<uint32_t> magic;            // Written last by the agent, once the segment is ready.
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t ring_size;                     // Data bytes per ring, a power of two.
+    std::atomic<uint32_t> doorbell;         // Futex word rung by the clients on every write.
+    std::atomic<uint32_t> agent_waiting;
+    uint32_t agent_pid;                     // Lets the clients tell a segment left by a crashed agent.
+    uint8_t reserved[CACHELINE_SIZE - 7 * sizeof(uint32_t)];
+};
+static_assert(sizeof(SegmentHeader) == CACHELINE_SIZE, "SegmentHeader shall fill a cache line.");
+
+struct SlotHeader
+{
+    std::atomic<uint32_t> owner;            // 0 if free, otherwise the pid of the client.
+    uint8_t reserved[CACHELINE_SIZE - sizeof(uint32_t)];
+};
+static_assert(sizeof(SlotHeader) == CACHELINE_SIZE, "SlotHeader shall fill a cache line.");
+
+struct RingHeader
+{
+    std::atomic<uint32_t> head;             // Written by the producer.
+    std::atomic<uint32_t> seq;              // Futex word the consumer sleeps on.
+    std::atomic<uint32_t> waiting;
+    uint8_t producer_pad[CACHELINE_SIZE - 3 * sizeof(uint32_t)];
+    std::atomic<uint32_t> tail;             // Written by the consumer.
+    uint8_t consumer_pad[CACHELINE_SIZE - sizeof(uint32_t)];
+};
+static_assert(sizeof(RingHeader) == 2 * CACHELINE_SIZE, "RingHeader shall fill two cache lines.");
+
+inline size_t slot_stride(
+        uint32_t ring_size)
+{
+    return sizeof(SlotHeader) + 2 * (sizeof(RingHeader) + ring_size);
+}
+
+inline size_t segment_size(
+        uint32_t slot_count,
+        uint32_t ring_size)
+{
+    return sizeof(SegmentHeader) + slot_count * slot_stride(ring_size);
+}
+
+inline SlotHeader* slot_at(
+        uint8_t* segment,
+        uint32_t ring_size,
+        uint32_t index)
+{
+    return reinterpret_cast<SlotHeader*>(segment + sizeof(SegmentHeader) + index * slot_stride(ring_size));
+}
+
+inline RingHeader* to_agent_ring(
+        SlotHeader* slot)
+{
+    return reinterpret_cast<RingHeader*>(reinterpret_cast<uint8_t*>(slot) + sizeof(SlotHeader));
+}
+
+inline RingHeader* to_client_ring(
+        SlotHeader* slot,
+        uint32_t ring_size)
+{
+    return reinterpret_cast<RingHeader*>(
+        reinterpret_cast<uint8_t*>(to_agent_ring(slot)) + sizeof(RingHeader) + ring_size);
+}
+
+inline uint8_t* ring_data(
+        RingHeader* ring)
+{
+    return reinterpret_cast<uint8_t*>(ring) + sizeof(RingHeader);
+}
+
+inline uint32_t record_size(
+        size_t len)
+{
+    return uint32_t(RECORD_HEADER_SIZE + ((len + 3) & ~size_t(3)));
+}
+
+inline int futex_wait(
+        std::atomic<uint32_t>& word,
+        uint32_t expected,
+        int timeout_ms)
+{
+    struct timespec ts{};
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    return int(syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0));
+}
+
+inline void futex_wake(
+        std::atomic<uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief Copies a record into the ring. Only the producer of the ring shall call it.
+ * @return false if the ring does not have room for the record.
+ */
+inline bool ring_write(
+        RingHeader* ring,
+        uint32_t ring_size,
+        const uint8_t* buf,
+        size_t len)
+{
+    const uint32_t mask = ring_size - 1;
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+    uint32_t size = record_size(len);
+    if ((size > ring_size) || ((ring_size - (head - tail)) < size))
+    {
+        return false;
+    }
+
+    uint8_t* data = ring_data(ring);
+    uint32_t record_len = uint32_t(len);
+    memcpy(data + (head & mask), &record_len, sizeof(record_len));
+    uint32_t offset = (head + uint32_t(RECORD_HEADER_SIZE)) & mask;
+    size_t first = std::min(len, size_t(ring_size - offset));
+    memcpy(data + offset, buf, first);
+    memcpy(data, buf + first, len - first);
+    ring->head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Copies the oldest record of the ring into buf. Only the consumer of the ring shall call it.
+ * @return Length of the record, 0 if the ring is empty, -1 if the record did not fit in buf and
+ *         it was dropped.
+ */
+inline ssize_t ring_read(
+        RingHeader* ring,
+        uint32_t ring_size,
+        uint8_t* buf,
+        size_t capacity)
+{
+    const uint32_t mask = ring_size - 1;
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return 0;
+    }
+
+    uint8_t* data = ring_data(ring);
+    uint32_t len;
+    memcpy(&len, data + (tail & mask), sizeof(len));
+    if ((len > (ring_size - RECORD_HEADER_SIZE)) || (record_size(len) > (head - tail)))
+    {
+        /* Corrupted ring, resynchronize with the producer. */
+        ring->tail.store(head, std::memory_order_release);
+        return -1;
+    }
+
+    ssize_t rv = -1;
+    if (len <= capacity)
+    {
+        uint32_t offset = (tail + uint32_t(RECORD_HEADER_SIZE)) & mask;
+        size_t first = std::min(size_t(len), size_t(ring_size - offset));
+        memcpy(buf, data + offset, first);
+        memcpy(buf + first, data, len - first);
+        rv = ssize_t(len);
+    }
+    ring->tail.store(tail + record_size(len), std::memory_order_release);
+    return rv;
+}
+
+/**
+ * @brief Publishes a write to a sleeping consumer through a futex word.
+ */
+inline void notify(
+        std::atomic<uint32_t>& word,
+        std::atomic<uint32_t>& waiting)
+{
+    word.fetch_add(1, std::memory_order_seq_cst);
+    if (0 != waiting.load(std::memory_order_seq_cst))
+    {
+        futex_wake(word);
+    }
+}
+
+} // namespace shm
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TRANSPORT_SHM_SHAREDMEMORYRING_HPP_
@@ -20,10 +20,13 @@
 #include <cstdint>
 #include <cstddef>
 #include <functional>
+#include <vector>
 
 #ifdef _WIN32
 #include <BaseTsd.h>
 typedef SSIZE_T ssize_t;
+#else
+#include <sys/types.h>
 #endif
 
 namespace eprosima {
@@ -72,6 +75,9 @@ private:
     static constexpr uint8_t framing_esc_flag = 0x7D;
     static constexpr uint8_t framing_xor_flag = 0x20;
 
+    /* Large enough to drain a serial driver buffer with a single read. */
+    static constexpr size_t read_buffer_size = 4096;
+
     /**
      * @brief Possible states for the framing protocol.
      */
@@ -139,7 +145,7 @@ public:
      *        and the previously user provided ReadCallback method.
      * @param buf Buffer to read data from.
      * @param len Length of the buffer.
-     * @param remote_addr Remote address tfrom which the message will be read.
+     * @param remote_addr Remote address from which the message will be read.
      * @param timeout Timeout in milliseconds.
      * @param transport_rc Return code of the read operation.
      * @return size_t Number of read bytes.
@@ -151,7 +157,6 @@ public:
             int timeout,
             TransportRc& transport_rc);
 
-private:
     /**
      * @brief Static method to update CRC.
      * @param crc CRC code to be updated.
@@ -161,6 +166,37 @@ private:
             uint16_t& crc,
             const uint8_t data);
 
+    /**
+     * @brief Static method to update CRC with a block of data, eight octets at a time (slicing-by-8).
+     * @param crc CRC code to be updated.
+     * @param buf Data to be loaded into the CRC code.
+     * @param len Length of the data.
+     */
+    static void update_crc(
+            uint16_t& crc,
+            const uint8_t* buf,
+            size_t len);
+
+private:
+    /**
+     * @brief Finds the first begin or escape flag, checking a machine word at a time.
+     * @param begin Start of the data.
+     * @param end End of the data.
+     * @return Pointer to the first flag, or end if there is none.
+     */
+    static const uint8_t* find_flag(
+            const uint8_t* begin,
+            const uint8_t* end);
+
+    /**
+     * @brief Appends data to the write buffer, escaping the flag octets.
+     * @param buf Data to be appended.
+     * @param len Length of the data.
+     */
+    void add_escaped(
+            const uint8_t* buf,
+            size_t len);
+
     /**
      * @brief Get next octet from the read buffer.
      * @param octet Octet to which the data will be written.
@@ -170,15 +206,21 @@ private:
             uint8_t& octet);
 
     /**
-     * @brief Add next octet to the write buffer.
-     * @param octet Data to be written.
-     * @return true if successful write, false otherwise.
+     * @brief Runs the state machine over the buffered data.
+     * @param buf Buffer to read the payload into.
+     * @param len Length of the buffer.
+     * @param remote_addr Remote address from which the message was sent.
+     * @param rv Length of the message, set if a valid frame was completed.
+     * @return True if a frame was completed or rejected, false if more data is needed.
      */
-    bool add_next_octet(
-            uint8_t octet);
+    bool parse_buffered(
+            uint8_t* buf,
+            size_t len,
+            uint8_t& remote_addr,
+            size_t& rv);
 
     /**
-     * @brief Internal write method implemented using circular write buffer.
+     * @brief Internal write method, writes the whole write buffer.
      * @param transport_rc Return code of the write operation.
      * @return True if success, false otherwise.
      */
@@ -186,8 +228,8 @@ private:
             TransportRc& transport_rc);
 
     /**
-     * @brief Internal read method implemented using circular read buffer.
-     * @param timeout Read timeout in milliseconds.
+     * @brief Internal read method, appends as much data as available to the read buffer.
+     * @param timeout Read timeout in milliseconds, decremented by the time spent.
      * @param transport_rc Return code of the read operation.
      * @return Number of Bytes read.
      */
@@ -200,9 +242,9 @@ private:
     uint8_t local_addr_;
     uint8_t remote_addr_;
 
-    uint8_t read_buffer_[42];
-    uint8_t read_buffer_head_;
-    uint8_t read_buffer_tail_;
+    std::vector<uint8_t> read_buffer_;
+    size_t read_buffer_head_;
+    size_t read_buffer_tail_;
 
     ReadCallback read_callback_;
 
@@ -211,8 +253,8 @@ private:
     uint16_t msg_crc_;
     uint16_t cmp_crc_;
 
-    uint8_t write_buffer_[42];
-    uint8_t write_buffer_pos_;
+    std::vector<uint8_t> write_buffer_;
+    size_t write_buffer_pos_;
 
     WriteCallback write_callback_;
 };
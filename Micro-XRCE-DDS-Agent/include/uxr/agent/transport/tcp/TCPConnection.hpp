@@ -17,6 +17,7 @@
 
 #include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
 #include <uxr/agent/transport/endpoint/IPv6EndPoint.hpp>
+#include <uxr/agent/message/MessagePool.hpp>
 
 #include <stdint.h>
 #include <vector>
@@ -37,7 +38,7 @@ typedef enum TCPInputBufferState
 
 struct TCPInputBuffer
 {
-    std::vector<uint8_t> buffer;
+    PooledBuffer buffer;
     uint16_t position;
     TCPInputBufferState state;
     uint16_t msg_size;
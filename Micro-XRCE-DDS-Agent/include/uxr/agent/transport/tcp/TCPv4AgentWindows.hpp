@@ -25,6 +25,7 @@
 #include <vector>
 #include <array>
 #include <list>
+#include <map>
 #include <set>
 #include <queue>
 
@@ -22,18 +22,22 @@
 #endif
 
 #include <netinet/in.h>
-#include <sys/poll.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 #include <array>
-#include <list>
-#include <set>
+#include <deque>
+#include <memory>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
 
 struct TCPv6ConnectionLinux : public TCPv6Connection
 {
-    struct pollfd* poll_fd;
+    int fd;
+    bool ready;     // Left with unread data by the previous round, queued in ready_connections_.
 };
 
 extern template class Server<IPv6EndPoint>;
@@ -74,6 +78,10 @@ private:
             OutputPacket<IPv6EndPoint> output_packet,
             TransportRc& transport_rc) final;
 
+    size_t send_messages(
+            std::vector<OutputPacket<IPv6EndPoint>>& output_packets,
+            TransportRc& transport_rc) final;
+
     bool handle_error(
             TransportRc transport_rc) final;
 
@@ -81,6 +89,27 @@ private:
             int timeout,
             TransportRc& transport_rc);
 
+    std::shared_ptr<TCPv6ConnectionLinux> find_connection(
+            const IPv6EndPoint& endpoint);
+
+    std::shared_ptr<TCPv6ConnectionLinux> find_connection(
+            uint32_t connection_id);
+
+    bool write_packets(
+            TCPv6ConnectionLinux& connection,
+            TransportRc& transport_rc);
+
+    bool send_iovecs(
+            TCPv6ConnectionLinux& connection,
+            struct iovec* iovecs,
+            size_t iovcnt,
+            TransportRc& transport_rc);
+
+    bool read_connection(
+            TCPv6ConnectionLinux& connection);
+
+    void accept_connections();
+
     bool open_connection(
             int fd,
             struct sockaddr_in6& sockaddr);
@@ -88,10 +117,6 @@ private:
     bool close_connection(
             TCPv6ConnectionLinux& connection);
 
-    bool connection_available();
-
-    void listener_loop();
-
     static void init_input_buffer(
             TCPInputBuffer& buffer);
 
@@ -110,18 +135,20 @@ private:
             TransportRc& transport_rc) final;
 
 private:
-    std::array<TCPv6ConnectionLinux, TCP_MAX_CONNECTIONS> connections_;
-    std::set<uint32_t> active_connections_;
-    std::list<uint32_t> free_connections_;
-    std::map<IPv6EndPoint, uint32_t> endpoint_to_connection_map_;
+    std::unordered_map<uint32_t, std::shared_ptr<TCPv6ConnectionLinux>> connections_;
+    std::unordered_map<IPv6EndPoint, uint32_t> endpoint_to_connection_map_;
+    uint32_t next_connection_id_;
     std::mutex connections_mtx_;
-    struct pollfd listener_poll_;
-    std::array<struct pollfd, TCP_MAX_CONNECTIONS> poll_fds_;
-    uint8_t buffer_[SERVER_BUFFER_SIZE];
+    int listener_fd_;
+    int epoll_fd_;
+    std::array<struct epoll_event, TCP_EPOLL_MAX_EVENTS> epoll_events_;
+    std::vector<const OutputPacket<IPv6EndPoint>*> send_packets_;
+    std::vector<std::array<uint8_t, 2>> send_headers_;
+    std::vector<struct iovec> send_iovecs_;
+    std::vector<bool> send_done_;
     uint16_t agent_port_;
-    std::thread listener_thread_;
-    std::atomic<bool> running_cond_;
     std::queue<InputPacket<IPv6EndPoint>> messages_queue_;
+    std::deque<uint32_t> ready_connections_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryServerLinux<IPv6EndPoint> discovery_server_;
 #endif
@@ -27,6 +27,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <unordered_map>
 
 namespace eprosima {
@@ -65,16 +67,32 @@ private:
             int timeout,
             TransportRc& transport_rc) final;
 
+    bool recv_messages(
+            std::vector<InputPacket<IPv4EndPoint>>& input_packets,
+            int timeout,
+            TransportRc& transport_rc) final;
+
     bool send_message(
             OutputPacket<IPv4EndPoint> output_packet,
             TransportRc& transport_rc) final;
 
+    size_t send_messages(
+            std::vector<OutputPacket<IPv4EndPoint>>& output_packets,
+            TransportRc& transport_rc) final;
+
     bool handle_error(
             TransportRc transport_rc) final;
 
 private:
     struct pollfd poll_fd_;
-    uint8_t buffer_[SERVER_BUFFER_SIZE];
+    PooledBuffer buffer_;
+    std::vector<PooledBuffer> recv_buffers_;
+    std::vector<struct iovec> recv_iovecs_;
+    std::vector<struct sockaddr_in> recv_addrs_;
+    std::vector<struct mmsghdr> recv_msgs_;
+    std::vector<struct iovec> send_iovecs_;
+    std::vector<struct sockaddr_in> send_addrs_;
+    std::vector<struct mmsghdr> send_msgs_;
     uint16_t agent_port_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryServerLinux<IPv4EndPoint> discovery_server_;
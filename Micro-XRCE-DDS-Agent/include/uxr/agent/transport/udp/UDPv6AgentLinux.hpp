@@ -24,6 +24,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <unordered_map>
 
 namespace eprosima {
@@ -62,16 +64,32 @@ private:
             int timeout,
             TransportRc& transport_rc) final;
 
+    bool recv_messages(
+            std::vector<InputPacket<IPv6EndPoint>>& input_packets,
+            int timeout,
+            TransportRc& transport_rc) final;
+
     bool send_message(
             OutputPacket<IPv6EndPoint> output_packet,
             TransportRc& transport_rc) final;
 
+    size_t send_messages(
+            std::vector<OutputPacket<IPv6EndPoint>>& output_packets,
+            TransportRc& transport_rc) final;
+
     bool handle_error(
             TransportRc transport_rc) final;
 
 private:
     struct pollfd poll_fd_;
-    uint8_t buffer_[SERVER_BUFFER_SIZE];
+    PooledBuffer buffer_;
+    std::vector<PooledBuffer> recv_buffers_;
+    std::vector<struct iovec> recv_iovecs_;
+    std::vector<struct sockaddr_in6> recv_addrs_;
+    std::vector<struct mmsghdr> recv_msgs_;
+    std::vector<struct iovec> send_iovecs_;
+    std::vector<struct sockaddr_in6> send_addrs_;
+    std::vector<struct mmsghdr> send_msgs_;
     uint16_t agent_port_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryServerLinux<IPv6EndPoint> discovery_server_;
@@ -0,0 +1,34 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TYPES_SHARED_DATA_HPP_
+#define UXR_AGENT_TYPES_SHARED_DATA_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Serialized data of a sample, immutable once written. The history of a topic, its readers and the
+ * messages delivering it share the same buffer instead of copying it.
+ */
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedData;
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TYPES_SHARED_DATA_HPP_
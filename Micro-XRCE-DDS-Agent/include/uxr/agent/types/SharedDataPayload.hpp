@@ -0,0 +1,71 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TYPES_SHARED_DATA_PAYLOAD_HPP_
+#define UXR_AGENT_TYPES_SHARED_DATA_PAYLOAD_HPP_
+
+#include <uxr/agent/types/XRCETypes.hpp>
+
+#include <fastcdr/Cdr.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * DATA payload in FORMAT_DATA which refers to the serialized data instead of holding a copy of it,
+ * as dds::xrce::DATA_Payload_Data does. It serializes to the same bytes, and the data shall outlive it.
+ */
+class SharedDataPayload
+{
+public:
+    SharedDataPayload(
+            const dds::xrce::RequestId& request_id,
+            const dds::xrce::ObjectId& object_id,
+            const std::vector<uint8_t>& data)
+        : request_{}
+        , data_(data)
+    {
+        request_.request_id(request_id);
+        request_.object_id(object_id);
+    }
+
+    const dds::xrce::BaseObjectRequest& request() const { return request_; }
+
+    const std::vector<uint8_t>& data() const { return data_; }
+
+    size_t getCdrSerializedSize(
+            size_t current_alignment = 0) const
+    {
+        return request_.getCdrSerializedSize(current_alignment) + data_.size();
+    }
+
+    void serialize(
+            fastcdr::Cdr& scdr) const
+    {
+        request_.serialize(scdr);
+        scdr.serializeArray(data_.data(), data_.size());
+    }
+
+private:
+    dds::xrce::BaseObjectRequest request_;
+    const std::vector<uint8_t>& data_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TYPES_SHARED_DATA_PAYLOAD_HPP_
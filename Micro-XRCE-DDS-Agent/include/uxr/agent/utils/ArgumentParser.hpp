@@ -15,6 +15,8 @@
 #ifndef UXR_AGENT_UTILS_ARGUMENTPARSER_HPP_
 #define UXR_AGENT_UTILS_ARGUMENTPARSER_HPP_
 
+#include <algorithm>
+#include <set>
 #include <sstream>
 #include <csignal>
 #include <type_traits>
@@ -34,6 +36,7 @@
 #include <uxr/agent/transport/serial/TermiosAgentLinux.hpp>
 #include <uxr/agent/transport/serial/PseudoTerminalAgentLinux.hpp>
 #include <uxr/agent/transport/serial/baud_rate_table_linux.h>
+#include <uxr/agent/transport/shm/SharedMemoryAgentLinux.hpp>
 
 #include <termios.h>
 #include <fcntl.h>
@@ -44,6 +47,7 @@
 #define DEFAULT_VERBOSE_LEVEL   4
 #define DEFAULT_DISCOVERY_PORT  7400
 #define DEFAULT_BAUDRATE_LEVEL  "115200"
+#define DEFAULT_SHM_NAME        "/uxr_agent"
 
 namespace eprosima {
 namespace uxr {
@@ -59,6 +63,7 @@ enum class TransportKind
 #ifndef _WIN32
     SERIAL,
     PSEUDOTERMINAL,
+    SHM,
 #endif // _WIN32
     HELP
 };
@@ -461,6 +466,7 @@ public:
         , refs_("-r", "--refs")
         , verbose_("-v", "--verbose", static_cast<uint16_t>(DEFAULT_VERBOSE_LEVEL),
             {0, 1, 2, 3, 4, 5, 6})
+        , workers_("-w", "--workers", static_cast<uint16_t>(PROCESSING_WORKERS))
 #ifdef UAGENT_DISCOVERY_PROFILE
         , discovery_("-d", "--discovery", static_cast<uint16_t>(DEFAULT_DISCOVERY_PORT), {}, false)
 #endif
@@ -520,6 +526,11 @@ public:
             result.first = false;
             return result;
         }
+        if ((ParseResult::INVALID == workers_.parse_argument(argc, argv)) || (0 == workers_.value()))
+        {
+            result.first = false;
+            return result;
+        }
 #ifdef UAGENT_DISCOVERY_PROFILE
         if (ParseResult::INVALID == discovery_.parse_argument(argc, argv))
         {
@@ -537,6 +548,15 @@ public:
         return result;
     }
 
+    void apply_settings(
+            std::unique_ptr<AgentType>& server)
+    {
+        if (workers_.found())
+        {
+            server->set_processing_workers(workers_.value());
+        }
+    }
+
     void apply_actions(
             std::unique_ptr<AgentType>& server)
     {
@@ -569,6 +589,7 @@ public:
         ss << "    " << middleware_.get_help() << std::endl;
         ss << "    " << refs_.get_help() << std::endl;
         ss << "    " << verbose_.get_help() << std::endl;
+        ss << "    " << workers_.get_help() << std::endl;
 #ifdef UAGENT_DISCOVERY_PROFILE
         ss << "    " << discovery_.get_help() << std::endl;
 #endif
@@ -583,6 +604,7 @@ private:
     Argument<std::string> middleware_;
     Argument<std::string> refs_;
     Argument<uint8_t> verbose_;
+    Argument<uint16_t> workers_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     Argument<uint16_t> discovery_;
 #endif
@@ -712,6 +734,42 @@ public:
 private:
     Argument<std::string> dev_;
 };
+
+/*************************************************************************************************
+ * Specific arguments for shared memory transports
+ *************************************************************************************************/
+template <typename AgentType>
+class SharedMemoryArgs
+{
+public:
+    SharedMemoryArgs()
+        : name_("-n", "--name", std::string(DEFAULT_SHM_NAME))
+    {
+    }
+
+    bool parse(
+            int argc,
+            char** argv)
+    {
+        bool result = static_cast<bool>(name_.parse_argument(argc, argv));
+        return result;
+    }
+
+    const std::string name() const
+    {
+        return name_.value();
+    }
+
+    const std::string get_help() const
+    {
+        std::stringstream ss;
+        ss << "    " << name_.get_help() << std::endl;
+        return ss.str();
+    }
+
+private:
+    Argument<std::string> name_;
+};
 #endif // _WIN32
 
 /*************************************************************************************************
@@ -732,6 +790,7 @@ public:
 #ifndef _WIN32
         , serial_args_()
         , pseudoterminal_args_()
+        , shm_args_()
 #endif // _WIN32
         , transport_kind_(transport_kind)
         , agent_server_()
@@ -772,6 +831,11 @@ public:
                 result &= pseudoterminal_args_.parse(argc_, argv_);
                 break;
             }
+            case TransportKind::SHM:
+            {
+                result &= shm_args_.parse(argc_, argv_);
+                break;
+            }
 #endif // _WIN32
             case TransportKind::INVALID:
             default:
@@ -786,6 +850,7 @@ public:
     bool launch_ipvx_agent()
     {
         agent_server_.reset(new AgentType(ip_args_.port(), utils::get_mw_kind(common_args_.middleware())));
+        common_args_.apply_settings(agent_server_);
         if (agent_server_->start())
         {
             common_args_.apply_actions(agent_server_);
@@ -842,6 +907,7 @@ public:
         agent_server_.reset(new TermiosAgent(
             serial_args_.dev().c_str(),  O_RDWR | O_NOCTTY, attr, 0, utils::get_mw_kind(common_args_.middleware())));
 
+        common_args_.apply_settings(agent_server_);
         if (agent_server_->start())
         {
             common_args_.apply_actions(agent_server_);
@@ -858,6 +924,7 @@ public:
     {
         agent_server_.reset(new PseudoTerminalAgent(
             O_RDWR | O_NOCTTY, pseudoterminal_args_.baud_rate().c_str(), 0, utils::get_mw_kind(common_args_.middleware())));
+        common_args_.apply_settings(agent_server_);
         if (agent_server_->start())
         {
             common_args_.apply_actions(agent_server_);
@@ -869,6 +936,22 @@ public:
             return false;
         }
     }
+
+    bool launch_shm_agent()
+    {
+        agent_server_.reset(new SharedMemoryAgent(shm_args_.name(), utils::get_mw_kind(common_args_.middleware())));
+        common_args_.apply_settings(agent_server_);
+        if (agent_server_->start())
+        {
+            common_args_.apply_actions(agent_server_);
+            return true;
+        }
+        else
+        {
+            std::cerr << "Error while starting shared memory agent!" << std::endl;
+            return false;
+        }
+    }
 #endif // _WIN32
 
     void show_help()
@@ -884,6 +967,8 @@ public:
 #ifndef _WIN32
         ss << pseudoterminal_args_.get_help();
         ss << serial_args_.get_help();
+        ss << "  * SHARED MEMORY (shm)" << std::endl;
+        ss << shm_args_.get_help();
 #endif // _WIN32
         ss << std::endl;
         // TODO(@jamoralp): Once documentation is updated with proper CLI section, add here an hyperlink to that section
@@ -898,6 +983,7 @@ private:
 #ifndef _WIN32
     SerialArgs<AgentType> serial_args_;
     PseudoTerminalArgs<AgentType> pseudoterminal_args_;
+    SharedMemoryArgs<AgentType> shm_args_;
 #endif // _WIN32
     TransportKind transport_kind_;
     std::unique_ptr<AgentType> agent_server_;
@@ -1042,6 +1128,46 @@ inline std::thread create_agent_thread<eprosima::uxr::PseudoTerminalAgent>(
     });
     return agent_thread;
 }
+
+template <>
+inline std::thread create_agent_thread<eprosima::uxr::SharedMemoryAgent>(
+        int argc,
+        char** argv,
+        eprosima::uxr::agent::TransportKind transport_kind,
+        const sigset_t* signals)
+{
+    std::thread agent_thread = std::thread([=]() -> void
+    {
+        eprosima::uxr::agent::parser::ArgumentParser<eprosima::uxr::SharedMemoryAgent>
+            parser(argc, argv, transport_kind);
+
+        switch (parser.parse_arguments())
+        {
+            case parser::ParseResult::INVALID:
+            case parser::ParseResult::NOT_FOUND:
+            {
+                parser::utils::usage(argv[0]);
+                break;
+            }
+            case parser::ParseResult::VALID:
+            {
+                if (parser.launch_shm_agent())
+                {
+                    /* Wait for defined signals. */
+                    int n_signal = 0;
+                    sigwait(signals, &n_signal);
+                }
+                break;
+            }
+            case parser::ParseResult::HELP:
+            {
+                parser.show_help();
+                break;
+            }
+        }
+    });
+    return agent_thread;
+}
 #endif // _WIN32
 
 } // namespace agent
@@ -0,0 +1,123 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_RTTESTIMATOR_HPP_
+#define UXR_AGENT_UTILS_RTTESTIMATOR_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Retransmission timeout estimator as TCP's (RFC 6298): a smoothed round-trip time and its mean
+ * deviation are updated from every sample, the timeout being SRTT + 4 * RTTVAR clamped to
+ * [min_rto, max_rto]. Each back-off doubles the timeout until the next sample or progress.
+ * Not thread-safe.
+ */
+class RttEstimator
+{
+public:
+    RttEstimator(
+            std::chrono::milliseconds initial_rto,
+            std::chrono::milliseconds min_rto,
+            std::chrono::milliseconds max_rto);
+
+    void add_sample(
+            std::chrono::steady_clock::duration rtt);
+
+    void back_off();
+
+    void reset_back_off() { backoff_ = 0; }
+
+    bool has_sample() const { return has_sample_; }
+
+    std::chrono::microseconds srtt() const { return srtt_; }
+
+    std::chrono::microseconds rttvar() const { return rttvar_; }
+
+    std::chrono::milliseconds rto() const;
+
+private:
+    static constexpr uint8_t max_backoff = 16;
+
+    const std::chrono::milliseconds min_rto_;
+    const std::chrono::milliseconds max_rto_;
+    std::chrono::milliseconds base_rto_;
+    std::chrono::microseconds srtt_;
+    std::chrono::microseconds rttvar_;
+    uint8_t backoff_;
+    bool has_sample_;
+};
+
+inline RttEstimator::RttEstimator(
+        std::chrono::milliseconds initial_rto,
+        std::chrono::milliseconds min_rto,
+        std::chrono::milliseconds max_rto)
+    : min_rto_(min_rto)
+    , max_rto_(max_rto)
+    , base_rto_(std::min(std::max(initial_rto, min_rto), max_rto))
+    , srtt_(0)
+    , rttvar_(0)
+    , backoff_(0)
+    , has_sample_(false)
+{}
+
+inline void RttEstimator::add_sample(
+        std::chrono::steady_clock::duration rtt)
+{
+    using namespace std::chrono;
+
+    const microseconds sample = std::max(duration_cast<microseconds>(rtt), microseconds(0));
+    if (has_sample_)
+    {
+        const microseconds error = (sample < srtt_) ? srtt_ - sample : sample - srtt_;
+        rttvar_ = (3 * rttvar_ + error) / 4;
+        srtt_ = (7 * srtt_ + sample) / 8;
+    }
+    else
+    {
+        srtt_ = sample;
+        rttvar_ = sample / 2;
+        has_sample_ = true;
+    }
+
+    /* Round up, a timeout shorter than the round-trip time only triggers spurious retransmissions. */
+    const microseconds rto = srtt_ + 4 * rttvar_;
+    base_rto_ = std::min(std::max(duration_cast<milliseconds>(rto + milliseconds(1) - microseconds(1)), min_rto_),
+                         max_rto_);
+    backoff_ = 0;
+}
+
+inline void RttEstimator::back_off()
+{
+    if ((backoff_ < max_backoff) && ((base_rto_ * (1 << backoff_)) < max_rto_))
+    {
+        ++backoff_;
+    }
+}
+
+inline std::chrono::milliseconds RttEstimator::rto() const
+{
+    return std::min(base_rto_ * (1 << backoff_), max_rto_);
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_RTTESTIMATOR_HPP_
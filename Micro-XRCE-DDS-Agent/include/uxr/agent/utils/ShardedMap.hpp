@@ -0,0 +1,166 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_SHARDEDMAP_HPP_
+#define UXR_AGENT_UTILS_SHARDEDMAP_HPP_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Concurrent hash map split in ShardCount independently locked hash tables.
+ * Lookups are O(1) and only contend with the operations on the same shard, which keeps
+ * the read-mostly maps consulted on every packet from serializing the processing threads.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, size_t ShardCount = 64>
+class ShardedMap
+{
+    static_assert((ShardCount & (ShardCount - 1)) == 0, "ShardCount shall be a power of two.");
+
+public:
+    ShardedMap() = default;
+
+    ShardedMap(ShardedMap&&) = delete;
+    ShardedMap(const ShardedMap&) = delete;
+    ShardedMap& operator=(ShardedMap&&) = delete;
+    ShardedMap& operator=(const ShardedMap&) = delete;
+
+    bool find(
+            const Key& key,
+            Value& value) const;
+
+    bool contains(
+            const Key& key) const;
+
+    /**
+     * Returns true if the key was not present.
+     */
+    bool insert_or_assign(
+            const Key& key,
+            const Value& value);
+
+    bool erase(
+            const Key& key);
+
+    size_t size() const;
+
+    void clear();
+
+private:
+    struct Shard
+    {
+        std::mutex mtx;
+        std::unordered_map<Key, Value, Hash> map;
+    };
+
+    Shard& get_shard(
+            const Key& key) const;
+
+private:
+    mutable std::array<Shard, ShardCount> shards_;
+};
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline typename ShardedMap<Key, Value, Hash, ShardCount>::Shard& ShardedMap<Key, Value, Hash, ShardCount>::get_shard(
+        const Key& key) const
+{
+    /* Fibonacci hashing, the shard is taken from the high bits so the buckets of a shard still spread. */
+    uint64_t hash = uint64_t(Hash()(key)) * UINT64_C(0x9E3779B97F4A7C15);
+    return shards_[size_t(hash >> 32) & (ShardCount - 1)];
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline bool ShardedMap<Key, Value, Hash, ShardCount>::find(
+        const Key& key,
+        Value& value) const
+{
+    bool rv = false;
+    Shard& shard = get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.map.find(key);
+    if (shard.map.end() != it)
+    {
+        value = it->second;
+        rv = true;
+    }
+    return rv;
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline bool ShardedMap<Key, Value, Hash, ShardCount>::contains(
+        const Key& key) const
+{
+    Shard& shard = get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    return shard.map.end() != shard.map.find(key);
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline bool ShardedMap<Key, Value, Hash, ShardCount>::insert_or_assign(
+        const Key& key,
+        const Value& value)
+{
+    Shard& shard = get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto result = shard.map.emplace(key, value);
+    if (!result.second)
+    {
+        result.first->second = value;
+    }
+    return result.second;
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline bool ShardedMap<Key, Value, Hash, ShardCount>::erase(
+        const Key& key)
+{
+    Shard& shard = get_shard(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    return 0 != shard.map.erase(key);
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline size_t ShardedMap<Key, Value, Hash, ShardCount>::size() const
+{
+    size_t rv = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        rv += shard.map.size();
+    }
+    return rv;
+}
+
+template<typename Key, typename Value, typename Hash, size_t ShardCount>
+inline void ShardedMap<Key, Value, Hash, ShardCount>::clear()
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.map.clear();
+    }
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_SHARDEDMAP_HPP_
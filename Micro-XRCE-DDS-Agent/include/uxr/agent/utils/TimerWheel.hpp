@@ -0,0 +1,299 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_TIMERWHEEL_HPP_
+#define UXR_AGENT_UTILS_TIMERWHEEL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Hierarchical timer wheel: level l has 64 slots of 64^l ticks each, so that arming, cancelling
+ * and expiring a timer is O(1) and the cost of advancing does not depend on the number of armed
+ * timers. Timers of the higher levels are cascaded down as the wheel turns.
+ * There is at most one timer per key, cancelled timers are dropped lazily when their slot is reached.
+ * Not thread-safe.
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class TimerWheel
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    explicit TimerWheel(
+            std::chrono::milliseconds tick,
+            TimePoint now = std::chrono::steady_clock::now());
+
+    /**
+     * Arms the timer of the key to expire after delay, unless it is already armed.
+     * Returns true if the timer has been armed.
+     */
+    bool arm(
+            const Key& key,
+            std::chrono::milliseconds delay,
+            TimePoint now = std::chrono::steady_clock::now());
+
+    /**
+     * Arms the timer of the key to expire after delay, replacing the previous one if any.
+     */
+    void rearm(
+            const Key& key,
+            std::chrono::milliseconds delay,
+            TimePoint now = std::chrono::steady_clock::now());
+
+    bool cancel(
+            const Key& key);
+
+    bool is_armed(
+            const Key& key) const { return armed_.end() != armed_.find(key); }
+
+    size_t size() const { return armed_.size(); }
+
+    /**
+     * Turns the wheel up to now, appending the keys of the expired timers.
+     */
+    void advance(
+            TimePoint now,
+            std::vector<Key>& expired);
+
+    /**
+     * Returns the time left until the first non-empty slot of the wheel, max() if nothing is armed.
+     * It is never later than the next expiration, but may be earlier: the slots of the upper levels
+     * are reached when they cascade down, and cancelled timers stay in their slot until then.
+     * Bounded by the number of slots, not by the number of armed timers.
+     */
+    std::chrono::milliseconds time_to_next_expiration(
+            TimePoint now = std::chrono::steady_clock::now()) const;
+
+private:
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t slot_count = size_t(1) << slot_bits;
+    static constexpr size_t slot_mask = slot_count - 1;
+    static constexpr size_t level_count = 4;
+
+    struct Timer
+    {
+        Key key;
+        uint64_t expiration;
+    };
+
+    uint64_t to_tick(
+            TimePoint time_point) const;
+
+    void insert(
+            const Key& key,
+            uint64_t expiration);
+
+private:
+    const std::chrono::milliseconds tick_;
+    const TimePoint origin_;
+    uint64_t current_tick_;
+    std::array<std::array<std::vector<Timer>, slot_count>, level_count> levels_;
+    std::unordered_map<Key, uint64_t, Hash> armed_;
+};
+
+template<typename Key, typename Hash>
+inline TimerWheel<Key, Hash>::TimerWheel(
+        std::chrono::milliseconds tick,
+        TimePoint now)
+    : tick_(tick)
+    , origin_(now)
+    , current_tick_(0)
+    , levels_()
+    , armed_()
+{}
+
+template<typename Key, typename Hash>
+inline uint64_t TimerWheel<Key, Hash>::to_tick(
+        TimePoint time_point) const
+{
+    return (time_point <= origin_)
+        ? 0
+        : uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(time_point - origin_).count() / tick_.count());
+}
+
+template<typename Key, typename Hash>
+inline void TimerWheel<Key, Hash>::insert(
+        const Key& key,
+        uint64_t expiration)
+{
+    uint64_t delta = (expiration > current_tick_) ? (expiration - current_tick_) : 0;
+    size_t level = 0;
+    while ((level < (level_count - 1)) && (delta >= (uint64_t(1) << (slot_bits * (level + 1)))))
+    {
+        ++level;
+    }
+
+    /*
+     * Beyond the last level, park the timer in the farthest slot and re-insert it from there.
+     * A due timer goes to the current slot, which advance processes right after cascading.
+     */
+    uint64_t slot_tick = (delta >= (uint64_t(1) << (slot_bits * level_count)))
+        ? current_tick_ + (uint64_t(slot_mask) << (slot_bits * level))
+        : std::max(expiration, current_tick_);
+    size_t slot = size_t(slot_tick >> (slot_bits * level)) & slot_mask;
+    levels_[level][slot].push_back(Timer{key, expiration});
+}
+
+template<typename Key, typename Hash>
+inline bool TimerWheel<Key, Hash>::arm(
+        const Key& key,
+        std::chrono::milliseconds delay,
+        TimePoint now)
+{
+    bool rv = false;
+    if (!is_armed(key))
+    {
+        rearm(key, delay, now);
+        rv = true;
+    }
+    return rv;
+}
+
+template<typename Key, typename Hash>
+inline void TimerWheel<Key, Hash>::rearm(
+        const Key& key,
+        std::chrono::milliseconds delay,
+        TimePoint now)
+{
+    /* Round up, a timer never expires before its delay. */
+    uint64_t ticks = uint64_t((delay.count() + tick_.count() - 1) / tick_.count());
+    uint64_t expiration = std::max(to_tick(now), current_tick_) + std::max(ticks, uint64_t(1));
+    armed_[key] = expiration;
+    insert(key, expiration);
+}
+
+template<typename Key, typename Hash>
+inline bool TimerWheel<Key, Hash>::cancel(
+        const Key& key)
+{
+    return 0 != armed_.erase(key);
+}
+
+template<typename Key, typename Hash>
+inline void TimerWheel<Key, Hash>::advance(
+        TimePoint now,
+        std::vector<Key>& expired)
+{
+    const uint64_t target_tick = to_tick(now);
+    if (armed_.empty())
+    {
+        /* Only stale timers in the slots, nothing to turn for. */
+        for (auto& level : levels_)
+        {
+            for (auto& slot : level)
+            {
+                slot.clear();
+            }
+        }
+        current_tick_ = std::max(current_tick_, target_tick);
+        return;
+    }
+
+    std::vector<Timer> timers;
+    while (current_tick_ < target_tick)
+    {
+        ++current_tick_;
+
+        /* Cascade the slots of the upper levels reached by this tick. */
+        for (size_t level = 1; level < level_count; ++level)
+        {
+            if (0 != (current_tick_ & ((uint64_t(1) << (slot_bits * level)) - 1)))
+            {
+                break;
+            }
+            size_t slot = size_t(current_tick_ >> (slot_bits * level)) & slot_mask;
+            timers.clear();
+            timers.swap(levels_[level][slot]);
+            for (const auto& timer : timers)
+            {
+                auto it = armed_.find(timer.key);
+                if ((armed_.end() != it) && (it->second == timer.expiration))
+                {
+                    insert(timer.key, timer.expiration);
+                }
+            }
+        }
+
+        timers.clear();
+        timers.swap(levels_[0][size_t(current_tick_) & slot_mask]);
+        for (const auto& timer : timers)
+        {
+            auto it = armed_.find(timer.key);
+            if ((armed_.end() != it) && (it->second == timer.expiration))
+            {
+                if (timer.expiration <= current_tick_)
+                {
+                    armed_.erase(it);
+                    expired.push_back(timer.key);
+                }
+                else
+                {
+                    insert(timer.key, timer.expiration);
+                }
+            }
+        }
+    }
+}
+
+template<typename Key, typename Hash>
+inline std::chrono::milliseconds TimerWheel<Key, Hash>::time_to_next_expiration(
+        TimePoint now) const
+{
+    if (armed_.empty())
+    {
+        return std::chrono::milliseconds::max();
+    }
+
+    /*
+     * Level 0 slots hold the timers of a single tick, the first non-empty one gives their expiration.
+     * A slot of an upper level is reached when it cascades, at the start of the range it covers;
+     * the slot of the current range holds the timers one turn ahead. Every level is looked at, the
+     * timers of an upper level may expire before those of a lower one.
+     */
+    uint64_t next_expiration = UINT64_MAX;
+    for (size_t level = 0; level < level_count; ++level)
+    {
+        const size_t shift = slot_bits * level;
+        const uint64_t current_range = current_tick_ >> shift;
+        for (uint64_t distance = 1; distance <= slot_count; ++distance)
+        {
+            const uint64_t range = current_range + distance;
+            if (((range << shift) < next_expiration) && !levels_[level][size_t(range) & slot_mask].empty())
+            {
+                next_expiration = range << shift;
+                break;
+            }
+        }
+    }
+    TimePoint next_time = origin_ + (tick_ * next_expiration);
+    return (next_time > now)
+        ? std::chrono::duration_cast<std::chrono::milliseconds>(next_time - now) + std::chrono::milliseconds(1)
+        : std::chrono::milliseconds(0);
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_TIMERWHEEL_HPP_
@@ -41,13 +41,24 @@ public:
             size_t required_tokens,
             T&& timeout);
 
+    bool try_consume_tokens(
+            size_t required_tokens,
+            std::chrono::milliseconds& wait_time);
+
+    /**
+     * Changes the rate and capacity, keeping the tokens available up to the new capacity.
+     */
+    void set_rate(
+            size_t rate,
+            size_t capacity = 0);
+
     size_t get_rate() { return rate_; }
     size_t get_capacity() { return capacity_; }
     size_t get_available_tokens() { return tokens_; }
 
 private:
-    const size_t rate_;
-    const size_t capacity_;
+    size_t rate_;
+    size_t capacity_;
     size_t tokens_;
     std::chrono::steady_clock::time_point timestamp_;
 };
@@ -62,6 +73,15 @@ inline TokenBucket::TokenBucket(
     timestamp_ = std::chrono::steady_clock::now();
 }
 
+inline void TokenBucket::set_rate(
+        size_t rate,
+        size_t capacity)
+{
+    rate_ = rate;
+    capacity_ = (capacity == 0) ? rate : capacity;
+    tokens_ = std::min(tokens_, capacity_);
+}
+
 template<typename T>
 inline bool TokenBucket::consume_tokens(
         size_t required_tokens,
@@ -110,6 +130,43 @@ inline bool TokenBucket::consume_tokens(
     return rv;
 }
 
+/**
+ * Non-blocking version of consume_tokens. When there are not enough tokens, wait_time is set to
+ * the time left until there are, or to milliseconds::max() if they never will.
+ */
+inline bool TokenBucket::try_consume_tokens(
+        size_t required_tokens,
+        std::chrono::milliseconds& wait_time)
+{
+    using namespace std::chrono;
+
+    if (required_tokens > capacity_)
+    {
+        wait_time = milliseconds::max();
+        return false;
+    }
+
+    bool rv = false;
+    const steady_clock::time_point now = steady_clock::now();
+    const size_t current_tokens = std::min(
+        capacity_,
+        tokens_ + size_t((rate_ * uint64_t(duration_cast<milliseconds>(now - timestamp_).count())) / std::milli::den));
+
+    if (current_tokens < required_tokens)
+    {
+        wait_time = milliseconds(
+            1 + (std::milli::den * uint64_t(required_tokens - current_tokens)) / rate_);
+    }
+    else
+    {
+        tokens_ = current_tokens - required_tokens;
+        timestamp_ = now;
+        rv = true;
+    }
+
+    return rv;
+}
+
 } // namespace utils
 } // namespace uxr
 } // namespace eprosima
@@ -101,6 +101,12 @@ bool AgentInstance::create(
                 valid_transport, &signals_));
             break;
         }
+        case agent::TransportKind::SHM:
+        {
+            agent_thread_ = std::move(agent::create_agent_thread<SharedMemoryAgent>(argc, argv,
+                valid_transport, &signals_));
+            break;
+        }
 #endif  // _WIN32
         case agent::TransportKind::HELP:
         {
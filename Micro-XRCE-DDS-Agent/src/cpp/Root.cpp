@@ -33,7 +33,8 @@ namespace uxr {
 Root::Root()
     : mtx_(),
       clients_(),
-      current_client_()
+      current_client_(),
+      client_index_()
 {
     current_client_ = clients_.begin();
 #ifdef UAGENT_LOGGER_PROFILE
@@ -45,6 +46,7 @@ Root::Root()
 /* It must be here instead of the hpp because the forward declaration of Middleware in the hpp. */
 Root::~Root()
 {
+    client_index_.clear();
     for (auto it = clients_.begin(); it != clients_.end(); )
     {
         it->second->release();
@@ -80,26 +82,30 @@ dds::xrce::ResultStatus Root::create_client(
             std::lock_guard<std::mutex> lock(mtx_);
             dds::xrce::ClientKey client_key = client_representation.client_key();
             dds::xrce::SessionId session_id = client_representation.session_id();
-            auto it = clients_.find(client_key);
-            if (it == clients_.end())
+            std::unordered_map<std::string, std::string> client_properties;
+
+            if (client_representation.properties())
             {
-                std::unordered_map<std::string, std::string> client_properties;
-
-                if (client_representation.properties())
-                {   
-                    auto v = *client_representation.properties();
-                    for (auto it_props = v.begin(); it_props != v.end(); ++it_props)
-                    {
-                        client_properties.insert(std::pair<std::string, std::string>(it_props->name(), it_props->value()));
-                    }
+                auto v = *client_representation.properties();
+                for (auto it_props = v.begin(); it_props != v.end(); ++it_props)
+                {
+                    client_properties.insert(std::pair<std::string, std::string>(it_props->name(), it_props->value()));
                 }
+            }
 
+            bool nack_window_requested = client_properties.end() != client_properties.find(NACK_WINDOW_PROPERTY);
+            std::shared_ptr<ProxyClient> session_client;
+            auto it = clients_.find(client_key);
+            if (it == clients_.end())
+            {
                 std::shared_ptr<ProxyClient> new_client = std::make_shared<ProxyClient>(
                     client_representation,
                     middleware_kind,
                     std::move(client_properties));
-                if (clients_.emplace(client_key, std::move(new_client)).second)
+                if (clients_.emplace(client_key, new_client).second)
                 {
+                    client_index_.insert_or_assign(client_key, new_client);
+                    session_client = new_client;
                     UXR_AGENT_LOG_INFO(
                         UXR_DECORATE_GREEN("create"),
                         UXR_CREATE_SESSION_PATTERN,
@@ -123,13 +129,32 @@ dds::xrce::ResultStatus Root::create_client(
                 {
                     it->second = std::make_shared<ProxyClient>(
                         client_representation,
-                        middleware_kind);
+                        middleware_kind,
+                        std::move(client_properties));
+                    client_index_.insert_or_assign(client_key, it->second);
+                    session_client = it->second;
                 }
                 else
                 {
-                    client->session().reset();
+                    client->reset_session(client_properties);
+                    session_client = client;
                 }
             }
+
+            /* Tell the client the selective-repeat window agreed for its session. */
+            if (session_client && nack_window_requested)
+            {
+                dds::xrce::Property nack_window_property;
+                nack_window_property.name(NACK_WINDOW_PROPERTY);
+                nack_window_property.value(std::to_string(session_client->session().nack_window()));
+                agent_representation.properties(dds::xrce::PropertySeq{nack_window_property});
+
+                UXR_AGENT_LOG_DEBUG(
+                    UXR_DECORATE_GREEN("nack window"),
+                    UXR_CLIENT_KEY_PATTERN UXR_FIELD_SEP "nack_window: {}",
+                    conversion::clientkey_to_raw(client_key),
+                    session_client->session().nack_window());
+            }
         }
         else
         {
@@ -186,6 +211,7 @@ dds::xrce::ResultStatus Root::delete_client(const dds::xrce::ClientKey& client_k
         {
             ++current_client_;
         }
+        client_index_.erase(client_key);
         client->release();
         clients_.erase(client_key);
         result_status.status(dds::xrce::STATUS_OK);
@@ -209,12 +235,7 @@ dds::xrce::ResultStatus Root::delete_client(const dds::xrce::ClientKey& client_k
 std::shared_ptr<ProxyClient> Root::get_client(const dds::xrce::ClientKey& client_key)
 {
     std::shared_ptr<ProxyClient> client;
-    std::lock_guard<std::mutex> lock(mtx_);
-    auto it = clients_.find(client_key);
-    if (it != clients_.end())
-    {
-        client = clients_.at(client_key);
-    }
+    client_index_.find(client_key, client);
     return client;
 }
 
@@ -306,6 +327,7 @@ void Root::set_verbose_level(uint8_t verbose_level)
 void Root::reset()
 {
     std::lock_guard<std::mutex> lock(mtx_);
+    client_index_.clear();
     for (auto it = clients_.begin(); it != clients_.end(); )
     {
         it->second->release();
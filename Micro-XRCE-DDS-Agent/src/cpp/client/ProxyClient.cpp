@@ -40,7 +40,9 @@ ProxyClient::ProxyClient(
         std::unordered_map<std::string, std::string>&& properties)  // 性质 hash表
     : representation_(representation)               // 列表初始化
     , objects_()                                    // objects_  初始化为空
-    , session_(SessionInfo{representation.client_key(), representation.session_id(), representation.mtu()}) // 用client的表示里的client_key、session_id 和 mtu初始化session信息
+    , session_(SessionInfo{
+            representation.client_key(), representation.session_id(), representation.mtu(),
+            negotiate_nack_window(properties)}) // 用client的表示里的client_key、session_id 和 mtu初始化session信息
     , state_{State::alive}                          // 状态初始化为alive
     , timestamp_{std::chrono::steady_clock::now()}  // 时间戳定位现在
     , properties_(std::move(properties))            // 将性质强转为右值引用
@@ -222,6 +224,16 @@ Session& ProxyClient::session()
     return session_;
 }
 
+/*
+ * A client reconnecting with the same session keeps its entities, but the window is agreed again
+ * from the properties of the new CREATE_CLIENT.
+ */
+void ProxyClient::reset_session(
+        const std::unordered_map<std::string, std::string>& properties)
+{
+    session_.reset(negotiate_nack_window(properties));
+}
+
 bool ProxyClient::create_object(
         const dds::xrce::ObjectId& object_id,
         const dds::xrce::ObjectVariant& representation,
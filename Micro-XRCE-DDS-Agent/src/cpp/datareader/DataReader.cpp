@@ -135,15 +135,21 @@ bool DataReader::read(
     */
 
     write_args.client = proxy_client_;
+    write_args.writable_notifier = reader_.get_notifier();
+
+    bool event_driven =
+        proxy_client_->get_middleware().set_data_available_callback(get_raw_id(), reader_.get_notifier());
 
     using namespace std::placeholders;
     return (reader_.stop_reading() &&
-            reader_.start_reading(delivery_control, std::bind(&DataReader::read_fn, this, _1, _2, _3), false, write_fn, write_args));
+            reader_.start_reading(
+                delivery_control, std::bind(&DataReader::read_fn, this, _1, _2, _3), false, write_fn, write_args,
+                event_driven));
 }
 
 bool DataReader::read_fn(
         bool,
-        std::vector<uint8_t>& data,
+        SharedData& data,
         std::chrono::milliseconds timeout)
 {
     bool rv = false;
@@ -152,8 +158,8 @@ bool DataReader::read_fn(
         UXR_AGENT_LOG_MESSAGE(
             UXR_DECORATE_YELLOW("[==>> DDS <<==]"),
             get_raw_id(),
-            data.data(),
-            data.size());
+            data->data(),
+            data->size());
         rv = true;
     }
     return rv;
@@ -96,13 +96,15 @@ bool DataWriter::matched(const dds::xrce::ObjectVariant& new_object_rep) const
 bool DataWriter::write(dds::xrce::WRITE_DATA_Payload_Data& write_data)
 {
     bool rv = false;
-    if (proxy_client_->get_middleware().write_data(get_raw_id(), write_data.data().serialized_data()))
+    /* The data deserialized from the input message is handed to the middleware, not copied. */
+    SharedData data = std::make_shared<const std::vector<uint8_t>>(std::move(write_data.data().serialized_data()));
+    if (proxy_client_->get_middleware().write_data(get_raw_id(), data))
     {
         UXR_AGENT_LOG_MESSAGE(
             UXR_DECORATE_YELLOW("[** <<DDS>> **]"),
             get_raw_id(),
-            write_data.data().serialized_data().data(),
-            write_data.data().serialized_data().size());
+            data->data(),
+            data->size());
         rv = true;
     }
     return rv;
@@ -123,5 +125,10 @@ bool DataWriter::write(const std::vector<uint8_t>& data)
     return rv;
 }
 
+bool DataWriter::is_writable() const
+{
+    return proxy_client_->get_middleware().is_writable(get_raw_id());
+}
+
 } // namespace uxr
 } // namespace eprosima
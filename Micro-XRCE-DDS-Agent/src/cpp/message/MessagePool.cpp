@@ -0,0 +1,124 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/message/MessagePool.hpp>
+#include <uxr/agent/config.hpp>
+
+#include <new>
+
+namespace eprosima {
+namespace uxr {
+
+constexpr size_t MessagePool::min_block_size;
+constexpr size_t MessagePool::class_count;
+
+MessagePool& MessagePool::instance()
+{
+    /* Never destroyed, messages may outlive other static objects. */
+    static MessagePool* pool = new MessagePool();
+    return *pool;
+}
+
+MessagePool::MessagePool()
+    : classes_()
+    , allocations_{0}
+    , heap_allocations_{0}
+{}
+
+size_t MessagePool::size_class(
+        size_t size)
+{
+    size_t index = 0;
+    size_t block_size = min_block_size;
+    while ((block_size < size) && (index < class_count))
+    {
+        block_size <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+size_t MessagePool::cached_blocks(
+        size_t index)
+{
+    /* The budget is in bytes so that the large classes do not pin megabytes after a burst. */
+    size_t blocks = MESSAGE_POOL_CACHED_BYTES / (min_block_size << index);
+    return (0 < blocks) ? blocks : 1;
+}
+
+void* MessagePool::allocate(
+        size_t size)
+{
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+
+    size_t index = size_class(size);
+    if (class_count > index)
+    {
+        SizeClass& block_class = classes_[index];
+        {
+            std::lock_guard<std::mutex> lock(block_class.mtx);
+            if (!block_class.free_blocks.empty())
+            {
+                void* block = block_class.free_blocks.back();
+                block_class.free_blocks.pop_back();
+                return block;
+            }
+        }
+        heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(min_block_size << index);
+    }
+
+    heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+}
+
+void MessagePool::deallocate(
+        void* ptr,
+        size_t size)
+{
+    if (nullptr == ptr)
+    {
+        return;
+    }
+
+    size_t index = size_class(size);
+    if (class_count > index)
+    {
+        SizeClass& block_class = classes_[index];
+        std::lock_guard<std::mutex> lock(block_class.mtx);
+        size_t max_blocks = cached_blocks(index);
+        if (max_blocks > block_class.free_blocks.size())
+        {
+            if (block_class.free_blocks.capacity() == block_class.free_blocks.size())
+            {
+                block_class.free_blocks.reserve(max_blocks);
+            }
+            block_class.free_blocks.push_back(ptr);
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
+
+MessagePool::Stats MessagePool::get_stats() const
+{
+    Stats stats;
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    stats.heap_allocations = heap_allocations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace uxr
+} // namespace eprosima
@@ -14,12 +14,23 @@
 
 #include <uxr/agent/middleware/ced/CedEntities.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 
 namespace eprosima {
 namespace uxr {
 
+static size_t round_up_to_power_of_two(size_t value)
+{
+    size_t power = 1;
+    while (power < value)
+    {
+        power <<= 1;
+    }
+    return power;
+}
+
 /**********************************************************************************************************************
  * CedTopicManager
  **********************************************************************************************************************/
@@ -70,6 +81,7 @@ void CedTopicManager::unregister_on_new_topic_cb(uint32_t key)
 bool CedTopicManager::register_topic(
         const std::string& topic_name,
         int16_t domain_id,
+        const HistoryQos& history_qos,
         std::shared_ptr<CedGlobalTopic>& topic)
 {
     std::lock_guard<std::mutex> lock(mtx_);
@@ -88,6 +100,7 @@ bool CedTopicManager::register_topic(
     }
 
     /* Register topic. */
+    bool rv = true;
     auto it_topic = topics_[domain_id].find(topic_name);
     if (topics_[domain_id].end() == it_topic)
     {
@@ -96,15 +109,26 @@ bool CedTopicManager::register_topic(
         {
             cb_topic.second(domain_id, topic_name);
         }
-        topic = std::make_shared<CedGlobalTopic>(topic_name, domain_id);
+        topic = std::make_shared<CedGlobalTopic>(topic_name, domain_id, history_qos);
         topics_[domain_id].emplace(topic_name, topic);
     }
     else
     {
         topic = it_topic->second.lock();
+        if (!topic)
+        {
+            /* Being destroyed, its unregistration leaves the new one in place. */
+            topic = std::make_shared<CedGlobalTopic>(topic_name, domain_id, history_qos);
+            it_topic->second = topic;
+        }
+        else if (!topic->has_history(history_qos))
+        {
+            topic.reset();
+            rv = false;
+        }
     }
 
-    return true;
+    return rv;
 }
 
 bool CedTopicManager::unregister_topic(
@@ -138,10 +162,16 @@ bool CedTopicManager::unregister_topic(
  **********************************************************************************************************************/
 CedGlobalTopic::CedGlobalTopic(
         const std::string& topic_name,
-        int16_t domain_id)
+        int16_t domain_id,
+        const HistoryQos& history_qos)
     : name_(topic_name)
     , domain_id_(domain_id)
-    , last_write_(UINT16_MAX)
+    , history_kind_(history_qos.kind)
+    , history_mask_(round_up_to_power_of_two(history_qos.depth) - 1)
+    , history_(new HistorySlot[history_mask_ + 1])
+    , last_write_(0)
+    , readers_{}
+    , waiting_readers_(0)
 {
 }
 
@@ -155,8 +185,14 @@ const std::string& CedGlobalTopic::name() const
     return name_;
 }
 
+bool CedGlobalTopic::has_history(
+        const HistoryQos& history_qos) const
+{
+    return (history_kind_ == history_qos.kind) && (history_depth() == round_up_to_power_of_two(history_qos.depth));
+}
+
 bool CedGlobalTopic::write(
-        const std::vector<uint8_t>& data,
+        const SharedData& data,
         WriteAccess write_access,
         TopicSource topic_src,
         uint8_t& errcode)
@@ -164,59 +200,126 @@ bool CedGlobalTopic::write(
     bool rv = false;
     if (check_write_access(write_access, topic_src))
     {
-        std::unique_lock<std::mutex> lock(mtx_);
-        size_t index = uint16_t(last_write_ + 1) % history_.size();
-        history_[index] = data;
-        srcs_[index] = topic_src;
-        ++last_write_;
-        lock.unlock();
-        cv_.notify_all();
-        errcode = 0;
-        rv = true;
+        /* The sample is built before taking the lock, the writers only serialize among themselves. */
+        CedSamplePtr sample = std::make_shared<const CedSample>(data, topic_src);
+
+        std::unique_lock<std::mutex> lock(write_mtx_);
+        if ((HistoryKind::KEEP_LAST == history_kind_) || has_room())
+        {
+            const uint64_t sequence = last_write_.load(std::memory_order_relaxed) + 1;
+            HistorySlot& slot = history_[sequence & history_mask_];
+            slot.sequence.store(HistorySlot::busy, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            sample = std::atomic_exchange(&slot.sample, sample);
+            slot.sequence.store(sequence, std::memory_order_release);
+            last_write_.store(sequence);
+            lock.unlock();
+
+            /* Only the readers blocked in read() need a notification, the others find the sample by themselves. */
+            if (0 < waiting_readers_.load())
+            {
+                {
+                    std::lock_guard<std::mutex> wait_lock(wait_mtx_);
+                }
+                cv_.notify_all();
+            }
+
+            std::lock_guard<std::mutex> on_data_available_lock(on_data_available_mtx_);
+            for (const auto& on_data_available : on_data_available_map_)
+            {
+                on_data_available.second();
+            }
+            errcode = 0;
+            rv = true;
+        }
+        else
+        {
+            errcode = 2;
+        }
     }
     return rv;
 }
 
+bool CedGlobalTopic::is_writable()
+{
+    std::lock_guard<std::mutex> lock(write_mtx_);
+    return (HistoryKind::KEEP_LAST == history_kind_) || has_room();
+}
+
+bool CedGlobalTopic::has_room() const
+{
+    /* The next sample takes the slot of the one written history_depth samples before. */
+    const uint64_t last_write = last_write_.load(std::memory_order_relaxed);
+    const uint64_t overwritten = (last_write > history_mask_) ? last_write - history_mask_ : 0;
+    return std::all_of(readers_.begin(), readers_.end(),
+                       [overwritten](const std::atomic<uint64_t>* last_read)
+                       {
+                           return overwritten <= last_read->load();
+                       });
+}
+
 bool CedGlobalTopic::read(
-        std::vector<uint8_t>& data,
+        CedSamplePtr& sample,
         std::chrono::milliseconds timeout,
-        SeqNum& last_read,
+        std::atomic<uint64_t>& last_read,
         ReadAccess read_access,
         uint8_t& errcode)
 {
-    bool rv = false;
-    std::unique_lock<std::mutex> lock(mtx_);
-    if (last_read != last_write_)
+    uint64_t read_until = last_read.load(std::memory_order_relaxed);
+    bool rv = get_sample(sample, read_until, read_access);
+    if (!rv && (0 < timeout.count()))
     {
-        /* Fix last_read. */
-        if ((last_read <= (last_write_ - int(history_.size()))) || (last_read > last_write_))
+        /* The samples skipped may be the ones a KEEP_ALL writer is held back by. */
+        update_last_read(last_read, read_until);
+
+        /* Try to read data with timeout in case, the sample being taken out of the lock. */
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+        bool written = true;
+        while (!rv && written)
         {
-            last_read = last_write_ - int(history_.size());
+            waiting_readers_.fetch_add(1);
+            std::unique_lock<std::mutex> lock(wait_mtx_);
+            written = cv_.wait_until(lock, deadline, [&](){ return read_until < last_write_.load(); });
+            lock.unlock();
+            waiting_readers_.fetch_sub(1);
+            rv = written && get_sample(sample, read_until, read_access);
         }
+    }
+    update_last_read(last_read, read_until);
 
-        /* Try to read data without timeout. */
-        do
-        {
-            rv = get_data(data, last_read, read_access);
-        } while(!rv && (last_read != last_write_));
+    if (!rv)
+    {
+        errcode = 1;
     }
+    return rv;
+}
 
-    if (!rv && (last_read == last_write_))
+void CedGlobalTopic::update_last_read(
+        std::atomic<uint64_t>& last_read,
+        uint64_t read_until)
+{
+    if (last_read.load(std::memory_order_relaxed) != read_until)
     {
-        /* Try to read data with timeout in case. */
-        auto now = std::chrono::steady_clock::now();
-        if (cv_.wait_until(lock, now + std::chrono::milliseconds(timeout), [&](){
-                           return last_read != last_write_ && get_data(data, last_read, read_access); }))
-        {
-            rv = true;
-        }
-        else
-        {
-            errcode = 1;
-        }
+        last_read.store(read_until);
     }
+}
 
-    return rv;
+void CedGlobalTopic::register_reader(
+        std::atomic<uint64_t>& last_read)
+{
+    std::lock_guard<std::mutex> lock(write_mtx_);
+
+    /* A new reader starts from the oldest sample in the history. */
+    const uint64_t last_write = last_write_.load(std::memory_order_relaxed);
+    last_read.store((last_write > history_mask_) ? last_write - history_mask_ - 1 : 0);
+    readers_.insert(&last_read);
+}
+
+void CedGlobalTopic::unregister_reader(
+        const std::atomic<uint64_t>& last_read)
+{
+    std::lock_guard<std::mutex> lock(write_mtx_);
+    readers_.erase(&last_read);
 }
 
 bool CedGlobalTopic::check_write_access(
@@ -230,29 +333,48 @@ bool CedGlobalTopic::check_write_access(
 
 bool CedGlobalTopic::check_read_access(
         ReadAccess read_access,
-        size_t index)
+        TopicSource topic_src)
 {
     return (ReadAccess::COMPLETE == read_access) ||
-           ((ReadAccess::INTERNAL == read_access) && (TopicSource::INTERNAL == srcs_[index])) ||
-           ((ReadAccess::EXTERNAL == read_access) && (TopicSource::EXTERNAL == srcs_[index]));
+           ((ReadAccess::INTERNAL == read_access) && (TopicSource::INTERNAL == topic_src)) ||
+           ((ReadAccess::EXTERNAL == read_access) && (TopicSource::EXTERNAL == topic_src));
 }
 
-bool CedGlobalTopic::get_data(
-        std::vector<uint8_t>& data,
-        SeqNum& last_read,
+bool CedGlobalTopic::get_sample(
+        CedSamplePtr& sample,
+        uint64_t& last_read,
         ReadAccess read_access)
 {
     bool rv = false;
-    size_t index = uint16_t(++last_read) % history_.size();
-    if (check_read_access(read_access, index))
+    const uint64_t history_depth = history_mask_ + 1;
+    uint64_t last_write = last_write_.load();
+    while (!rv && (last_read < last_write))
     {
-        data.assign(history_[index].begin(), history_[index].end());
-        rv = true;
+        /* A reader falling behind loses the samples overwritten since its last read. */
+        const uint64_t sequence = std::max(last_read + 1, (last_write > history_depth) ? last_write - history_depth + 1 : 1);
+        HistorySlot& slot = history_[sequence & history_mask_];
+        if (sequence == slot.sequence.load(std::memory_order_acquire))
+        {
+            CedSamplePtr candidate = std::atomic_load(&slot.sample);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence == slot.sequence.load(std::memory_order_relaxed))
+            {
+                last_read = sequence;
+                if (check_read_access(read_access, candidate->src))
+                {
+                    sample = std::move(candidate);
+                    rv = true;
+                }
+                continue;
+            }
+        }
+
+        /* Overwritten while reading, catch up with the writers. */
+        last_write = last_write_.load();
     }
     return rv;
 }
 
-
 /**********************************************************************************************************************
  * CedParticipant
  **********************************************************************************************************************/
@@ -299,6 +421,13 @@ CedGlobalTopic* CedTopic::get_global_topic() const
 bool CedDataWriter::write(
         const std::vector<uint8_t>& data,
         uint8_t& errcode) const
+{
+    return write(std::make_shared<const std::vector<uint8_t>>(data), errcode);
+}
+
+bool CedDataWriter::write(
+        const SharedData& data,
+        uint8_t& errcode) const
 {
     return topic_->get_global_topic()->write(data, write_access_, topic_src_, errcode);
 }
@@ -306,12 +435,59 @@ bool CedDataWriter::write(
 /**********************************************************************************************************************
  * CedDataReader
  **********************************************************************************************************************/
+void CedGlobalTopic::set_on_data_available(
+        const CedDataReader* datareader,
+        const std::function<void ()>& on_data_available)
+{
+    std::lock_guard<std::mutex> lock(on_data_available_mtx_);
+    if (on_data_available)
+    {
+        on_data_available_map_[datareader] = on_data_available;
+    }
+    else
+    {
+        on_data_available_map_.erase(datareader);
+    }
+}
+
+CedDataReader::~CedDataReader()
+{
+    topic_->get_global_topic()->set_on_data_available(this, nullptr);
+    topic_->get_global_topic()->unregister_reader(last_read_);
+}
+
 bool CedDataReader::read(
         std::vector<uint8_t>& data,
         std::chrono::milliseconds timeout,
         uint8_t &errcode)
 {
-    return topic_->get_global_topic()->read(data, timeout, last_read_, read_access_, errcode);
+    SharedData shared_data;
+    bool rv = read(shared_data, timeout, errcode);
+    if (rv)
+    {
+        data.assign(shared_data->begin(), shared_data->end());
+    }
+    return rv;
+}
+
+bool CedDataReader::read(
+        SharedData& data,
+        std::chrono::milliseconds timeout,
+        uint8_t &errcode)
+{
+    CedSamplePtr sample;
+    bool rv = topic_->get_global_topic()->read(sample, timeout, last_read_, read_access_, errcode);
+    if (rv)
+    {
+        data = sample->data;
+    }
+    return rv;
+}
+
+void CedDataReader::set_on_data_available(
+        const std::function<void ()>& on_data_available)
+{
+    topic_->get_global_topic()->set_on_data_available(this, on_data_available);
 }
 
 } // namespace uxr
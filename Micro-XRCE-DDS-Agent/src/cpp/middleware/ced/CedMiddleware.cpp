@@ -14,6 +14,9 @@
 
 #include <uxr/agent/middleware/ced/CedMiddleware.hpp>
 
+#include <cctype>
+#include <cstdlib>
+
 namespace eprosima {
 namespace uxr {
 
@@ -66,6 +69,124 @@ std::string remove_suffix_form_datareader_ref(std::string const & ref)
     return ref.substr(0, ref.find("__dr"));
 }
 
+/**
+ * Looks for the first <tag> element within xml[begin, end), which are updated to bound its content.
+ */
+static bool find_xml_element(
+        const std::string& xml,
+        const std::string& tag,
+        size_t& begin,
+        size_t& end)
+{
+    bool rv = false;
+    size_t open = xml.find("<" + tag, begin);
+    while (!rv && (std::string::npos != open) && (open < end))
+    {
+        const size_t name_end = open + 1 + tag.size();
+        if ((name_end < xml.size()) && (('>' == xml[name_end]) || std::isspace(static_cast<unsigned char>(xml[name_end]))))
+        {
+            const size_t content = xml.find('>', name_end);
+            const size_t close = xml.find("</" + tag + ">", content);
+            if ((std::string::npos != close) && (close < end))
+            {
+                begin = content + 1;
+                end = close;
+                rv = true;
+            }
+            break;
+        }
+        open = xml.find("<" + tag, name_end);
+    }
+    return rv;
+}
+
+static bool get_xml_text(
+        const std::string& xml,
+        const std::string& tag,
+        size_t begin,
+        size_t end,
+        std::string& text)
+{
+    bool rv = find_xml_element(xml, tag, begin, end);
+    if (rv)
+    {
+        const char* whitespaces = " \t\r\n";
+        const size_t first = xml.find_first_not_of(whitespaces, begin);
+        const size_t last = xml.find_last_not_of(whitespaces, end - 1);
+        text = ((std::string::npos != first) && (first < end)) ? xml.substr(first, last - first + 1) : "";
+    }
+    return rv;
+}
+
+/**
+ * Takes the topic name and history from the <topic> element of the XML, or the XML as a reference without it.
+ */
+static bool parse_topic_xml(
+        const std::string& xml,
+        std::string& topic_name,
+        HistoryQos& history_qos)
+{
+    bool rv = true;
+    size_t begin = 0;
+    size_t end = xml.size();
+    if (find_xml_element(xml, "topic", begin, end))
+    {
+        rv = get_xml_text(xml, "name", begin, end, topic_name) && !topic_name.empty();
+
+        size_t history_begin = begin;
+        size_t history_end = end;
+        if (rv && find_xml_element(xml, "historyQos", history_begin, history_end))
+        {
+            std::string kind;
+            if (get_xml_text(xml, "kind", history_begin, history_end, kind))
+            {
+                if ("KEEP_LAST" == kind)
+                {
+                    history_qos.kind = HistoryKind::KEEP_LAST;
+                }
+                else if ("KEEP_ALL" == kind)
+                {
+                    history_qos.kind = HistoryKind::KEEP_ALL;
+                }
+                else
+                {
+                    rv = false;
+                }
+            }
+
+            std::string depth;
+            if (rv && get_xml_text(xml, "depth", history_begin, history_end, depth))
+            {
+                char* depth_end = nullptr;
+                const unsigned long value = std::strtoul(depth.c_str(), &depth_end, 10);
+                rv = !depth.empty() && ('\0' == *depth_end) && (0 < value) && (UINT16_MAX >= value);
+                history_qos.depth = size_t(value);
+            }
+        }
+    }
+    else
+    {
+        topic_name = remove_suffix_form_topic_ref(xml);
+    }
+    return rv;
+}
+
+/**
+ * Takes the topic name from the <topic> element of a DataWriter or DataReader XML, or the XML as a reference.
+ */
+static std::string topic_ref_from_xml(
+        const std::string& xml)
+{
+    std::string topic_ref = xml;
+    size_t begin = 0;
+    size_t end = xml.size();
+    if (find_xml_element(xml, "topic", begin, end))
+    {
+        get_xml_text(xml, "name", begin, end, topic_ref);
+    }
+    return topic_ref;
+}
+
 /**********************************************************************************************************************
  * Create functions.
  **********************************************************************************************************************/
@@ -95,14 +216,22 @@ bool CedMiddleware::create_participant_by_xml(
 static
 std::shared_ptr<CedTopic> create_topic(
         std::shared_ptr<CedParticipant>& participant,
-        const std::string& topic_name)
+        const std::string& topic_name,
+        const HistoryQos& history_qos)
 {
     std::shared_ptr<CedTopic> topic;
     topic = participant->find_topic(topic_name);
-    if (!topic)
+    if (topic)
+    {
+        if (!topic->get_global_topic()->has_history(history_qos))
+        {
+            topic.reset();
+        }
+    }
+    else
     {
         std::shared_ptr<CedGlobalTopic> global_topic;
-        if (CedTopicManager::register_topic(topic_name, participant->get_domain_id(), global_topic))
+        if (CedTopicManager::register_topic(topic_name, participant->get_domain_id(), history_qos, global_topic))
         {
             topic = std::make_shared<CedTopic>(participant, global_topic);
             if (!participant->register_topic(topic))
@@ -127,7 +256,7 @@ bool CedMiddleware::create_topic_by_ref(
         if (topics_.end() == it_topic)
         {
             std::shared_ptr<CedTopic> topic =
-                create_topic(it_participant->second, remove_suffix_form_topic_ref(ref));
+                create_topic(it_participant->second, remove_suffix_form_topic_ref(ref), HistoryQos());
             rv = topic && topics_.emplace(topic_id, std::move(topic)).second;
         }
     }
@@ -139,7 +268,20 @@ bool CedMiddleware::create_topic_by_xml(
         uint16_t participant_id,
         const std::string& xml)
 {
-    return create_topic_by_ref(topic_id, participant_id, xml);
+    bool rv = false;
+    auto it_participant = participants_.find(participant_id);
+    if (participants_.end() != it_participant)
+    {
+        auto it_topic = topics_.find(topic_id);
+        std::string topic_name;
+        HistoryQos history_qos;
+        if ((topics_.end() == it_topic) && parse_topic_xml(xml, topic_name, history_qos))
+        {
+            std::shared_ptr<CedTopic> topic = create_topic(it_participant->second, topic_name, history_qos);
+            rv = topic && topics_.emplace(topic_id, std::move(topic)).second;
+        }
+    }
+    return rv;
 }
 
 bool CedMiddleware::create_publisher_by_xml(
@@ -212,7 +354,7 @@ bool CedMiddleware::create_datawriter_by_xml(
         uint16_t publisher_id,
         const std::string& xml)
 {
-    return create_datawriter_by_ref(datawriter_id, publisher_id, xml);
+    return create_datawriter_by_ref(datawriter_id, publisher_id, topic_ref_from_xml(xml));
 }
 
 bool CedMiddleware::create_datareader_by_ref(
@@ -246,7 +388,7 @@ bool CedMiddleware::create_datareader_by_xml(
         uint16_t subscriber_id,
         const std::string& xml)
 {
-    return create_datareader_by_ref(datareader_id, subscriber_id, xml);
+    return create_datareader_by_ref(datareader_id, subscriber_id, topic_ref_from_xml(xml));
 }
 
 /**********************************************************************************************************************
@@ -299,6 +441,32 @@ bool CedMiddleware::write_data(
     return rv;
 }
 
+bool CedMiddleware::write_data(
+        uint16_t datawriter_id,
+        const SharedData& data)
+{
+    bool rv = false;
+    auto it = datawriters_.find(datawriter_id);
+    if (datawriters_.end() != it)
+    {
+        uint8_t errcode;
+        rv = it->second->write(data, errcode);
+    }
+    return rv;
+}
+
+bool CedMiddleware::is_writable(
+        uint16_t datawriter_id)
+{
+    bool rv = true;
+    auto it = datawriters_.find(datawriter_id);
+    if (datawriters_.end() != it)
+    {
+        rv = it->second->is_writable();
+    }
+    return rv;
+}
+
 bool CedMiddleware::read_data(
         uint16_t datareader_id,
         std::vector<uint8_t>& data,
@@ -314,6 +482,35 @@ bool CedMiddleware::read_data(
     return rv;
 }
 
+bool CedMiddleware::read_data(
+        uint16_t datareader_id,
+        SharedData& data,
+        std::chrono::milliseconds timeout)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        uint8_t errcode;
+        rv = it->second->read(data, timeout, errcode);
+    }
+    return rv;
+}
+
+bool CedMiddleware::set_data_available_callback(
+        uint16_t datareader_id,
+        const std::function<void ()>& callback)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        it->second->set_on_data_available(callback);
+        rv = true;
+    }
+    return rv;
+}
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
@@ -628,7 +628,7 @@ bool FastDDSDataReader::create_by_ref(const std::string& ref)
                 fastdds::dds::DataReaderQos qos;
                 set_qos_from_attributes(qos, attrs);
 
-                ptr_ = subscriber_->create_datareader(topic_->get_ptr(), qos);
+                ptr_ = subscriber_->create_datareader(topic_->get_ptr(), qos, this);
                 rv = (nullptr != ptr_);
             }
         }
@@ -648,7 +648,7 @@ bool FastDDSDataReader::create_by_xml(const std::string& xml)
                 fastdds::dds::DataReaderQos qos;
                 set_qos_from_attributes(qos, attrs);
 
-                ptr_ = subscriber_->create_datareader(topic_->get_ptr(), qos);
+                ptr_ = subscriber_->create_datareader(topic_->get_ptr(), qos, this);
                 rv = (nullptr != ptr_);
             }
         }
@@ -707,6 +707,21 @@ bool FastDDSDataReader::read(
     return rv;
 }
 
+void FastDDSDataReader::set_on_data_available(const std::function<void ()>& on_data_available)
+{
+    std::lock_guard<std::mutex> lock(on_data_available_mtx_);
+    on_data_available_ = on_data_available;
+}
+
+void FastDDSDataReader::on_data_available(fastdds::dds::DataReader* /*reader*/)
+{
+    std::lock_guard<std::mutex> lock(on_data_available_mtx_);
+    if (on_data_available_)
+    {
+        on_data_available_();
+    }
+}
+
 const fastdds::dds::DataReader* FastDDSDataReader::ptr() const
 {
     return ptr_;
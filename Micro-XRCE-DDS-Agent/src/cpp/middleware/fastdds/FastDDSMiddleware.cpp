@@ -686,6 +686,20 @@ bool FastDDSMiddleware::read_data(
    return rv;
 }
 
+bool FastDDSMiddleware::set_data_available_callback(
+        uint16_t datareader_id,
+        const std::function<void ()>& callback)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        it->second->set_on_data_available(callback);
+        rv = true;
+    }
+    return rv;
+}
+
 bool FastDDSMiddleware::read_request(
         uint16_t replier_id,
         std::vector<uint8_t>& data,
@@ -20,10 +20,12 @@
 #include <uxr/agent/Root.hpp>
 #include <uxr/agent/transport/Server.hpp>
 #include <uxr/agent/utils/Time.hpp>
+#include <uxr/agent/types/SharedDataPayload.hpp>
 
 #include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
 #include <uxr/agent/transport/endpoint/IPv6EndPoint.hpp>
 #include <uxr/agent/transport/endpoint/SerialEndPoint.hpp>
+#include <uxr/agent/transport/endpoint/SharedMemoryEndPoint.hpp>
 #include <uxr/agent/transport/endpoint/CustomEndPoint.hpp>
 
 namespace eprosima {
@@ -37,8 +39,17 @@ Processor<EndPoint>::Processor(
     : server_(server)
     , middleware_kind_{middleware_kind}
     , root_(root)
+    , timers_mtx_()
+    , timers_cv_()
+    , timers_wakeup_(std::chrono::steady_clock::time_point::max())
+    , heartbeat_wheel_(heartbeat_tick)
+    , flush_times_()
+    , flush_deadlines_()
 {}
 
+template<typename EndPoint>
+constexpr std::chrono::milliseconds Processor<EndPoint>::heartbeat_tick;
+
 template<typename EndPoint>
 void Processor<EndPoint>::process_input_packet(
         InputPacket<EndPoint>&& input_packet)
@@ -95,10 +106,7 @@ void Processor<EndPoint>::process_input_packet(
             dds::xrce::StreamId stream_id = input_packet.message->get_header().stream_id();
             dds::xrce::SequenceNr sequence_nr = input_packet.message->get_header().sequence_nr();
             session.push_input_message(std::move(input_packet.message), stream_id, sequence_nr);
-            while (session.pop_input_message(stream_id, input_packet.message))
-            {
-                process_input_message(*client, input_packet);
-            }
+            process_input_stream(*client, stream_id, input_packet);
 
             if (is_reliable_stream(stream_id))
             {
@@ -112,19 +120,37 @@ void Processor<EndPoint>::process_input_packet(
                 client->session().fill_acknack(stream_id, acknack_payload);
                 acknack_payload.stream_id(header.stream_id());
 
+                /* Sessions with an extended window also report the missing messages beyond the bitmap. */
+                std::vector<dds::xrce::ACKNACK_Payload> nack_ranges;
+                client->session().fill_nack_ranges(stream_id, nack_ranges);
+
                 dds::xrce::SubmessageHeader acknack_subheader;
                 acknack_subheader.submessage_id(dds::xrce::ACKNACK);
                 acknack_subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
-                acknack_subheader.submessage_length(uint16_t(acknack_payload.getCdrSerializedSize()));
+                acknack_subheader.submessage_length(uint16_t(raw_codec::encoded_size(acknack_payload)));
 
-                const size_t message_size = acknack_header.getCdrSerializedSize() +
-                                            acknack_subheader.getCdrSerializedSize() +
-                                            acknack_payload.getCdrSerializedSize();
+                size_t message_size = raw_codec::encoded_size(acknack_header) +
+                                      raw_codec::encoded_size(acknack_subheader) +
+                                      raw_codec::encoded_size(acknack_payload);
+                for (auto& nack_range : nack_ranges)
+                {
+                    nack_range.stream_id(header.stream_id());
+                    message_size = ((message_size + 3) & ~size_t(3)) +
+                                   raw_codec::encoded_size(acknack_subheader) +
+                                   raw_codec::encoded_size(nack_range);
+                }
 
                 OutputPacket<EndPoint> output_packet;
                 output_packet.destination = input_packet.source;
-                output_packet.message.reset(new OutputMessage(acknack_header, message_size));
+                output_packet.message = make_output_message(acknack_header, message_size);
                 output_packet.message->append_submessage(dds::xrce::ACKNACK, acknack_payload);
+                for (const auto& nack_range : nack_ranges)
+                {
+                    output_packet.message->append_submessage(
+                        dds::xrce::ACKNACK,
+                        nack_range,
+                        uint8_t(dds::xrce::FLAG_LITTLE_ENDIANNESS | dds::xrce::FLAG_NACK_RANGE));
+                }
 
                 server_.push_output_packet(std::move(output_packet));
             }
@@ -150,7 +176,7 @@ void Processor<EndPoint>::process_input_packet(
 
                     OutputPacket<EndPoint> output_packet;
                     output_packet.destination = input_packet.source;
-                    output_packet.message.reset(new OutputMessage(input_packet.message->get_header(), message_size));
+                    output_packet.message = make_output_message(input_packet.message->get_header(), message_size);
                     output_packet.message->append_submessage(dds::xrce::STATUS, status_payload);
 
                     server_.push_output_packet(std::move(output_packet));
@@ -160,6 +186,25 @@ void Processor<EndPoint>::process_input_packet(
     }
 }
 
+template<typename EndPoint>
+void Processor<EndPoint>::process_input_stream(
+        ProxyClient& client,
+        dds::xrce::StreamId stream_id,
+        InputPacket<EndPoint>& input_packet)
+{
+    Session& session = client.session();
+    while (session.pop_input_message(stream_id, input_packet.message))
+    {
+        process_input_message(client, input_packet);
+        if (input_packet.message->is_held())
+        {
+            /* Unacknowledged meanwhile, it is processed again on the next message or HEARTBEAT of the stream. */
+            session.hold_input_message(stream_id, std::move(input_packet.message));
+            break;
+        }
+    }
+}
+
 template<typename EndPoint>
 void Processor<EndPoint>::process_input_message(
         ProxyClient& client,
@@ -213,6 +258,9 @@ bool Processor<EndPoint>::process_submessage(
         case dds::xrce::TIMESTAMP:
             rv = process_timestamp_submessage(client, input_packet);
             break;
+        case dds::xrce::PERFORMANCE:
+            rv = process_performance_submessage(client, input_packet);
+            break;
         default:
             rv = false;
             break;
@@ -281,7 +329,7 @@ bool Processor<EndPoint>::process_create_client_submessage(
 
             OutputPacket<EndPoint> output_packet;
             output_packet.destination = input_packet.source;
-            output_packet.message = std::shared_ptr<OutputMessage>(new OutputMessage(status_header, message_size));
+            output_packet.message = make_output_message(status_header, message_size);
             output_packet.message->append_submessage(dds::xrce::STATUS_AGENT, status_agent);
 
             server_.push_output_packet(std::move(output_packet));
@@ -323,10 +371,7 @@ bool Processor<EndPoint>::process_create_submessage(
 
         OutputPacket<EndPoint> output_packet;
         output_packet.destination = input_packet.source;
-        while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
-        {
-            server_.push_output_packet(std::move(output_packet));
-        }
+        send_output_messages(client, dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet);
     }
     return rv;
 }
@@ -362,10 +407,7 @@ bool Processor<EndPoint>::process_delete_submessage(
                 status_payload,
                 std::chrono::milliseconds(0));
 
-            while (client.session().get_next_output_message(dds::xrce::STREAMID_NONE, output_packet.message))
-            {
-                server_.push_output_packet(std::move(output_packet));
-            }
+            send_output_messages(client, dds::xrce::STREAMID_NONE, output_packet);
         }
         else
         {
@@ -377,10 +419,7 @@ bool Processor<EndPoint>::process_delete_submessage(
                 status_payload,
                 std::chrono::milliseconds(0));
 
-            while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
-            {
-                server_.push_output_packet(std::move(output_packet));
-            }
+            send_output_messages(client, dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet);
         }
     }
     else
@@ -419,7 +458,16 @@ bool Processor<EndPoint>::process_write_data_submessage(
                                 std::dynamic_pointer_cast<DataWriter>(client.get_object(object_id));
                         if (nullptr != data_writer)
                         {
-                            written = data_writer->write(data_payload);
+                            /* Backpressure: a reliable sample waits in its stream, unacknowledged, rather than being lost. */
+                            if (is_reliable_stream(input_packet.message->get_header().stream_id()) &&
+                                !data_writer->is_writable())
+                            {
+                                input_packet.message->hold_submessage();
+                            }
+                            else
+                            {
+                                written = data_writer->write(data_payload);
+                            }
                         }
                         break;
                     }
@@ -548,10 +596,7 @@ bool Processor<EndPoint>::process_read_data_submessage(
 
             OutputPacket<EndPoint> output_packet;
             output_packet.destination = input_packet.source;
-            while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
-            {
-                server_.push_output_packet(std::move(output_packet));
-            }
+            send_output_messages(client, dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet);
         }
     }
     else
@@ -598,7 +643,25 @@ bool Processor<EndPoint>::process_acknack_submessage(
             }
         }
 
-        client.session().update_from_acknack(stream_id, first_message);
+        /* A NACK range only asks for retransmissions, its base is not an acknowledgement. */
+        if (0 == (input_packet.message->get_subheader().flags() & dds::xrce::FLAG_NACK_RANGE))
+        {
+            dds::xrce::HEARTBEAT_Payload previous_state;
+            client.session().fill_heartbeat(stream_id, previous_state);
+            client.session().update_from_acknack(stream_id, first_message);
+            dds::xrce::HEARTBEAT_Payload current_state;
+            bool unacked_data = client.session().fill_heartbeat(stream_id, current_state);
+            update_heartbeat(
+                client,
+                stream_id,
+                unacked_data,
+                previous_state.first_unacked_seq_nr() != current_state.first_unacked_seq_nr());
+
+            /* The acknowledgement opens the congestion window to the messages waiting to be sent. */
+            OutputPacket<EndPoint> output_packet;
+            output_packet.destination = input_packet.source;
+            send_output_messages(client, stream_id, output_packet);
+        }
     }
     else
     {
@@ -625,6 +688,14 @@ bool Processor<EndPoint>::process_heartbeat_submessage(
                                                heartbeat_payload.first_unacked_seq_nr(),
                                                heartbeat_payload.last_unacked_seq_nr());
 
+        /* Retries the message held back, if any, before acknowledging. */
+        if (is_reliable_stream(stream_id))
+        {
+            InputPacket<EndPoint> stream_packet;
+            stream_packet.source = input_packet.source;
+            process_input_stream(client, stream_id, stream_packet);
+        }
+
         dds::xrce::ACKNACK_Payload acknack_payload;
         client.session().fill_acknack(stream_id, acknack_payload);
         acknack_payload.stream_id(stream_id);
@@ -667,15 +738,33 @@ bool Processor<EndPoint>::process_fragment_submessage(
         ProxyClient& client,
         InputPacket<EndPoint>& input_packet)
 {
+    bool rv = true;
     dds::xrce::StreamId stream_id = input_packet.message->get_header().stream_id();
-    client.session().push_input_fragment(stream_id, input_packet.message);
     InputPacket<EndPoint> fragment_packet;
-    if (client.session().pop_input_fragment_message(stream_id, fragment_packet.message))
+    bool reassembled = client.session().pop_held_input_fragment_message(stream_id, fragment_packet.message);
+    if (reassembled)
+    {
+        /* The last fragment of a message held back, already reassembled. */
+        input_packet.message->skip_payload();
+    }
+    else
+    {
+        client.session().push_input_fragment(stream_id, input_packet.message);
+        reassembled = client.session().pop_input_fragment_message(stream_id, fragment_packet.message);
+    }
+
+    if (reassembled)
     {
         fragment_packet.source = input_packet.source;
         process_input_message(client, fragment_packet);
+        if (fragment_packet.message->is_held())
+        {
+            client.session().hold_input_fragment_message(stream_id, std::move(fragment_packet.message));
+            input_packet.message->hold_submessage();
+            rv = false;
+        }
     }
-    return true;
+    return rv;
 }
 
 template<typename EndPoint>
@@ -718,6 +807,39 @@ bool Processor<EndPoint>::process_timestamp_submessage(
     return rv;
 }
 
+template<typename EndPoint>
+bool Processor<EndPoint>::process_performance_submessage(
+        ProxyClient& client,
+        InputPacket<EndPoint>& input_packet)
+{
+    bool rv = true;
+    dds::xrce::SampleData performance;
+    performance.serialized_data().resize(input_packet.message->get_subheader().submessage_length());
+    if (input_packet.message->get_raw_payload(performance.serialized_data().data(), performance.serialized_data().size()))
+    {
+        /* The payload is opaque to the agent, it is sent back as is on the stream it came from. */
+        if (dds::xrce::FLAG_ECHO & input_packet.message->get_subheader().flags())
+        {
+            const dds::xrce::StreamId stream_id = input_packet.message->get_header().stream_id();
+            rv = client.session().push_output_submessage(
+                stream_id, dds::xrce::PERFORMANCE, performance, std::chrono::milliseconds(0));
+
+            OutputPacket<EndPoint> output_packet;
+            output_packet.destination = input_packet.source;
+            send_output_messages(client, stream_id, output_packet);
+        }
+    }
+    else
+    {
+        UXR_AGENT_LOG_ERROR(
+            UXR_DECORATE_RED("deserialization error processing PERFORMANCE submessage"),
+            UXR_CLIENT_KEY_PATTERN,
+            conversion::clientkey_to_raw(client.get_client_key()));
+        rv = false;
+    }
+    return rv;
+}
+
 template<typename EndPoint>
 bool Processor<EndPoint>::read_data_callback(
         const WriteFnArgs& cb_args,
@@ -726,20 +848,21 @@ bool Processor<EndPoint>::read_data_callback(
 {
     bool rv = false;
 
-    dds::xrce::DATA_Payload_Data data_payload;
-    data_payload.request_id(cb_args.request_id);
-    data_payload.object_id(cb_args.object_id);
-    data_payload.data().serialized_data(buffer);
+    /* The data is serialized straight into the output message, it may be shared by other readers. */
+    SharedDataPayload data_payload{cb_args.request_id, cb_args.object_id, buffer};
 
     OutputPacket<EndPoint> output_packet;
     if (server_.get_endpoint(conversion::clientkey_to_raw(cb_args.client_key), output_packet.destination))
     {
-        rv = cb_args.client->session().push_output_submessage(cb_args.stream_id, dds::xrce::DATA, data_payload, timeout);
-
-        while (cb_args.client->session().get_next_output_message(cb_args.stream_id, output_packet.message))
+        rv = cb_args.client->session().push_output_submessage(
+            cb_args.stream_id, dds::xrce::DATA, data_payload, timeout, OUTPUT_COALESCING);
+        if (!rv && cb_args.writable_notifier)
         {
-            server_.push_output_packet(std::move(output_packet));
+            /* Stream full, the reader retries when the client acknowledges instead of polling. */
+            cb_args.client->session().notify_when_writable(cb_args.stream_id, cb_args.writable_notifier);
         }
+
+        send_output_messages(*cb_args.client, cb_args.stream_id, output_packet);
     }
     else
     {
@@ -785,8 +908,7 @@ bool Processor<EndPoint>::process_get_info_packet(
                                     info_payload.getCdrSerializedSize();
 
         output_packet.destination = input_packet.source;
-        output_packet.message = OutputMessagePtr(new OutputMessage(input_packet.message->get_header(),
-                                                                    message_size));
+        output_packet.message = make_output_message(input_packet.message->get_header(), message_size);
         rv = output_packet.message->append_submessage(dds::xrce::INFO, info_payload);
     }
 
@@ -839,8 +961,7 @@ bool Processor<EndPoint>::process_get_info_packet(
                                             info_payload.getCdrSerializedSize();
 
                 output_packet.destination = input_packet.source;
-                output_packet.message = OutputMessagePtr(new OutputMessage(input_packet.message->get_header(),
-                                                                           message_size));
+                output_packet.message = make_output_message(input_packet.message->get_header(), message_size);
                 rv = output_packet.message->append_submessage(dds::xrce::INFO, info_payload);
             }
         }
@@ -850,52 +971,249 @@ bool Processor<EndPoint>::process_get_info_packet(
 }
 
 template<typename EndPoint>
-void Processor<EndPoint>::check_heartbeats()
+void Processor<EndPoint>::send_output_messages(
+        ProxyClient& client,
+        dds::xrce::StreamId stream_id,
+        OutputPacket<EndPoint>& output_packet)
 {
-    dds::xrce::MessageHeader header;
-    header.stream_id(dds::xrce::STREAMID_NONE);
-    header.sequence_nr(0x00);
+    bool sent = false;
+    while (client.session().get_next_output_message(stream_id, output_packet.message))
+    {
+        server_.push_output_packet(std::move(output_packet));
+        sent = true;
+    }
 
-    dds::xrce::HEARTBEAT_Payload heartbeat;
+    if (sent && (dds::xrce::STREAMID_BUILTIN_RELIABLE <= stream_id))
+    {
+        arm_heartbeat(client, stream_id);
+    }
 
-    dds::xrce::SubmessageHeader subheader;
-    subheader.submessage_id(dds::xrce::HEARTBEAT);
-    subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
-    subheader.submessage_length(uint16_t(heartbeat.getCdrSerializedSize()));
+    /* A coalesced message waiting for more submessages is sent by the timers thread at the latest. */
+    std::chrono::steady_clock::time_point flush_time;
+    if (client.session().get_output_flush_time(stream_id, flush_time))
+    {
+        schedule_flush(client, stream_id, flush_time);
+    }
+}
 
-    const size_t message_size =
-            header.getCdrSerializedSize() +
-            subheader.getCdrSerializedSize() +
-            heartbeat.getCdrSerializedSize();
+template<typename EndPoint>
+void Processor<EndPoint>::schedule_flush(
+        ProxyClient& client,
+        dds::xrce::StreamId stream_id,
+        std::chrono::steady_clock::time_point flush_time)
+{
+    uint32_t raw_client_key = conversion::clientkey_to_raw(client.get_client_key());
+    uint64_t output_key = (uint64_t(raw_client_key) << 8) | stream_id;
+
+    std::lock_guard<std::mutex> lock(timers_mtx_);
+    auto it = flush_times_.find(output_key);
+    if ((flush_times_.end() == it) || (flush_time < it->second))
+    {
+        flush_times_[output_key] = flush_time;
+        flush_deadlines_.emplace(flush_time, output_key);
+        if (flush_time < timers_wakeup_)
+        {
+            timers_cv_.notify_one();
+        }
+    }
+}
+
+template<typename EndPoint>
+bool Processor<EndPoint>::next_flush_deadline(
+        std::chrono::steady_clock::time_point& deadline)
+{
+    bool rv = false;
+    /* Drop the entries superseded by an earlier deadline, or already flushed. */
+    while (!rv && !flush_deadlines_.empty())
+    {
+        auto it = flush_times_.find(flush_deadlines_.top().second);
+        if ((flush_times_.end() != it) && (it->second == flush_deadlines_.top().first))
+        {
+            deadline = it->second;
+            rv = true;
+        }
+        else
+        {
+            flush_deadlines_.pop();
+        }
+    }
+    return rv;
+}
 
+template<typename EndPoint>
+void Processor<EndPoint>::flush_output_messages(
+        uint64_t output_key)
+{
+    uint32_t raw_client_key = uint32_t(output_key >> 8);
+    dds::xrce::StreamId stream_id = dds::xrce::StreamId(output_key & 0xFF);
+
+    std::shared_ptr<ProxyClient> client = root_.get_client(conversion::raw_to_clientkey(raw_client_key));
     OutputPacket<EndPoint> output_packet;
+    if (client && server_.get_endpoint(raw_client_key, output_packet.destination))
+    {
+        send_output_messages(*client, stream_id, output_packet);
+    }
+}
+
+template<typename EndPoint>
+void Processor<EndPoint>::arm_heartbeat(
+        ProxyClient& client,
+        dds::xrce::StreamId stream_id)
+{
+    using namespace std::chrono;
+
+    uint32_t raw_client_key = conversion::clientkey_to_raw(client.get_client_key());
+    uint64_t heartbeat_key = (uint64_t(raw_client_key) << 8) | stream_id;
+    milliseconds rto = client.session().get_retransmission_timeout(stream_id);
 
-    std::shared_ptr<ProxyClient> client;
-    while (root_.get_next_client(client))
+    std::lock_guard<std::mutex> lock(timers_mtx_);
+    steady_clock::time_point now = steady_clock::now();
+    if (heartbeat_wheel_.arm(heartbeat_key, rto, now) && (now + rto < timers_wakeup_))
+    {
+        timers_cv_.notify_one();
+    }
+}
+
+template<typename EndPoint>
+void Processor<EndPoint>::update_heartbeat(
+        ProxyClient& client,
+        dds::xrce::StreamId stream_id,
+        bool unacked_data,
+        bool acked_data)
+{
+    uint32_t raw_client_key = conversion::clientkey_to_raw(client.get_client_key());
+    uint64_t heartbeat_key = (uint64_t(raw_client_key) << 8) | stream_id;
+
+    if (!unacked_data)
+    {
+        std::lock_guard<std::mutex> lock(timers_mtx_);
+        heartbeat_wheel_.cancel(heartbeat_key);
+    }
+    else if (acked_data)
     {
-        if (server_.get_endpoint(conversion::clientkey_to_raw(client->get_client_key()), output_packet.destination) &&
-             ProxyClient::State::alive == client->get_state())
+        /* The client answers, restart the timer for the messages still in flight. */
+        std::chrono::milliseconds rto = client.session().get_retransmission_timeout(stream_id);
+        std::lock_guard<std::mutex> lock(timers_mtx_);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        heartbeat_wheel_.rearm(heartbeat_key, rto, now);
+        if (now + rto < timers_wakeup_)
         {
-            header.session_id(client->get_session_id());
-            header.client_key(client->get_client_key());
+            timers_cv_.notify_one();
+        }
+    }
+}
 
-            for (auto stream : client->session().get_output_streams())
-            {
-                if (client->session().fill_heartbeat(stream, heartbeat))
-                {
-                    output_packet.message = OutputMessagePtr(new OutputMessage(header, message_size));
-                    output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat);
+template<typename EndPoint>
+void Processor<EndPoint>::check_output_timers(
+        std::chrono::milliseconds max_wait)
+{
+    using namespace std::chrono;
 
-                    server_.push_output_packet(std::move(output_packet));
-                }
-            }
+    std::vector<uint64_t> expired;
+    std::vector<uint64_t> flushes;
+    steady_clock::time_point deadline;
+    {
+        std::unique_lock<std::mutex> lock(timers_mtx_);
+        steady_clock::time_point now = steady_clock::now();
+        timers_wakeup_ = now + std::min(max_wait, heartbeat_wheel_.time_to_next_expiration(now));
+        if (next_flush_deadline(deadline) && (deadline < timers_wakeup_))
+        {
+            timers_wakeup_ = deadline;
+        }
+        timers_cv_.wait_until(lock, timers_wakeup_);
+        timers_wakeup_ = steady_clock::time_point::max();
+
+        now = steady_clock::now();
+        heartbeat_wheel_.advance(now, expired);
+        while (next_flush_deadline(deadline) && (deadline <= now))
+        {
+            flushes.push_back(flush_deadlines_.top().second);
+            flush_times_.erase(flush_deadlines_.top().second);
+            flush_deadlines_.pop();
+        }
+    }
+
+    for (uint64_t output_key : flushes)
+    {
+        flush_output_messages(output_key);
+    }
+
+    for (uint64_t heartbeat_key : expired)
+    {
+        send_heartbeat(heartbeat_key);
+    }
+}
+
+template<typename EndPoint>
+void Processor<EndPoint>::send_heartbeat(
+        uint64_t heartbeat_key)
+{
+    uint32_t raw_client_key = uint32_t(heartbeat_key >> 8);
+    dds::xrce::StreamId stream_id = dds::xrce::StreamId(heartbeat_key & 0xFF);
+
+    std::shared_ptr<ProxyClient> client = root_.get_client(conversion::raw_to_clientkey(raw_client_key));
+    if (!client)
+    {
+        return;
+    }
+
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    if (!client->session().fill_heartbeat(stream_id, heartbeat))
+    {
+        return;
+    }
+
+    OutputPacket<EndPoint> output_packet;
+    if ((ProxyClient::State::alive != client->get_state()) ||
+        !server_.get_endpoint(raw_client_key, output_packet.destination))
+    {
+        /* Unreachable client with data still unacknowledged, keep polling in case it comes back. */
+        std::lock_guard<std::mutex> lock(timers_mtx_);
+        heartbeat_wheel_.arm(heartbeat_key, std::chrono::milliseconds(HEARTBEAT_MAX_PERIOD));
+    }
+    else
+    {
+        /* The retransmission timeout expired, resend the oldest message without waiting for the NACK. */
+        OutputPacket<EndPoint> retransmission_packet;
+        retransmission_packet.destination = output_packet.destination;
+        if (client->session().get_output_message(
+                stream_id, heartbeat.first_unacked_seq_nr(), retransmission_packet.message))
+        {
+            server_.push_output_packet(std::move(retransmission_packet));
         }
+
+        dds::xrce::MessageHeader header;
+        header.session_id(client->get_session_id());
+        header.stream_id(dds::xrce::STREAMID_NONE);
+        header.sequence_nr(0x00);
+        header.client_key(client->get_client_key());
+
+        dds::xrce::SubmessageHeader subheader;
+        subheader.submessage_id(dds::xrce::HEARTBEAT);
+        subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
+        subheader.submessage_length(uint16_t(raw_codec::encoded_size(heartbeat)));
+
+        const size_t message_size =
+                raw_codec::encoded_size(header) +
+                raw_codec::encoded_size(subheader) +
+                raw_codec::encoded_size(heartbeat);
+
+        output_packet.message = make_output_message(header, message_size);
+        output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat);
+        server_.push_output_packet(std::move(output_packet));
+
+        /* Back off while the client does not acknowledge. */
+        client->session().back_off_retransmission(stream_id);
+        std::chrono::milliseconds rto = client->session().get_retransmission_timeout(stream_id);
+        std::lock_guard<std::mutex> lock(timers_mtx_);
+        heartbeat_wheel_.arm(heartbeat_key, rto);
     }
 }
 
 template class Processor<IPv4EndPoint>;
 template class Processor<IPv6EndPoint>;
 template class Processor<SerialEndPoint>;
+template class Processor<SharedMemoryEndPoint>;
 template class Processor<CustomEndPoint>;
 
 } // namespace uxr
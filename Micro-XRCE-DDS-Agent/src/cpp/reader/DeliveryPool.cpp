@@ -0,0 +1,162 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/reader/DeliveryPool.hpp>
+#include <uxr/agent/config.hpp>
+
+namespace eprosima {
+namespace uxr {
+
+DeliveryPool& DeliveryPool::instance()
+{
+    /* Never destroyed, the workers live as long as the process. */
+    static DeliveryPool* pool = new DeliveryPool();
+    return *pool;
+}
+
+DeliveryPool::DeliveryPool()
+    : mtx_()
+    , cond_var_()
+    , idle_cond_var_()
+    , ready_tasks_()
+    , timers_()
+    , workers_()
+{
+    for (uint16_t i = 0; i < READER_DELIVERY_WORKERS; ++i)
+    {
+        workers_.emplace_back(&DeliveryPool::worker_loop, this);
+        workers_.back().detach();
+    }
+}
+
+void DeliveryPool::start_task(
+        const std::shared_ptr<DeliveryTask>& task)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    task->active_ = true;
+    schedule(task);
+}
+
+void DeliveryPool::stop_task(
+        const std::shared_ptr<DeliveryTask>& task)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    task->active_ = false;
+    idle_cond_var_.wait(lock, [&task] { return !task->running_; });
+}
+
+void DeliveryPool::notify(
+        const std::shared_ptr<DeliveryTask>& task)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (task->active_)
+    {
+        schedule(task);
+    }
+}
+
+void DeliveryPool::schedule(
+        const std::shared_ptr<DeliveryTask>& task)
+{
+    if (task->running_)
+    {
+        task->notified_ = true;
+    }
+    else if (!task->queued_)
+    {
+        task->queued_ = true;
+        ready_tasks_.push_back(task);
+        cond_var_.notify_one();
+    }
+}
+
+void DeliveryPool::worker_loop()
+{
+    using namespace std::chrono;
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (;;)
+    {
+        /* Move the expired timers to the ready queue. */
+        steady_clock::time_point now = steady_clock::now();
+        while (!timers_.empty() && (timers_.begin()->first <= now))
+        {
+            std::shared_ptr<DeliveryTask> task = timers_.begin()->second.lock();
+            if (task && task->active_ && (task->next_run_ == timers_.begin()->first))
+            {
+                schedule(task);
+            }
+            timers_.erase(timers_.begin());
+        }
+
+        if (ready_tasks_.empty())
+        {
+            if (timers_.empty())
+            {
+                cond_var_.wait(lock);
+            }
+            else
+            {
+                cond_var_.wait_until(lock, timers_.begin()->first);
+            }
+            continue;
+        }
+
+        std::shared_ptr<DeliveryTask> task = std::move(ready_tasks_.front());
+        ready_tasks_.pop_front();
+        task->queued_ = false;
+        if (!task->active_)
+        {
+            continue;
+        }
+
+        task->running_ = true;
+        task->notified_ = false;
+        task->next_run_ = steady_clock::time_point();
+        lock.unlock();
+
+        steady_clock::time_point next_run = steady_clock::time_point::max();
+        bool keep_running = task->run(next_run);
+
+        lock.lock();
+        task->running_ = false;
+        idle_cond_var_.notify_all();
+
+        if (!keep_running)
+        {
+            task->active_ = false;
+        }
+        else if (task->active_)
+        {
+            if (task->notified_ || (next_run <= steady_clock::now()))
+            {
+                schedule(task);
+            }
+            else if (steady_clock::time_point::max() != next_run)
+            {
+                task->next_run_ = next_run;
+                bool earliest = timers_.empty() || (next_run < timers_.begin()->first);
+                timers_.emplace(next_run, task);
+                if (earliest)
+                {
+                    /* Another worker may be sleeping on a later timer. */
+                    cond_var_.notify_one();
+                }
+            }
+        }
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
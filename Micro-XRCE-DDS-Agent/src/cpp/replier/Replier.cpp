@@ -148,6 +148,7 @@ bool Replier::read(
     */
 
     write_args.client = proxy_client_;
+    write_args.writable_notifier = reader_.get_notifier();
 
     using namespace std::placeholders;
     return (reader_.stop_reading() &&
@@ -156,17 +157,19 @@ bool Replier::read(
 
 bool Replier::read_fn(
         bool,
-        std::vector<uint8_t>& data,
+        SharedData& data,
         std::chrono::milliseconds timeout)
 {
     bool rv = false;
-    if (proxy_client_->get_middleware().read_request(get_raw_id(), data, timeout))
+    std::shared_ptr<std::vector<uint8_t>> request = std::make_shared<std::vector<uint8_t>>();
+    if (proxy_client_->get_middleware().read_request(get_raw_id(), *request, timeout))
     {
         UXR_AGENT_LOG_MESSAGE(
             UXR_DECORATE_YELLOW("[==>> DDS <<==]"),
             get_raw_id(),
-            data.data(),
-            data.size());
+            request->data(),
+            request->size());
+        data = std::move(request);
         rv = true;
     }
     return rv;
@@ -154,6 +154,7 @@ bool Requester::read(
     */
 
     write_args.client = proxy_client_;
+    write_args.writable_notifier = reader_.get_notifier();
 
     using namespace std::placeholders;
     return (reader_.stop_reading() &&
@@ -163,7 +164,7 @@ bool Requester::read(
 
 bool Requester::read_fn(
         bool,
-        std::vector<uint8_t>& data,
+        SharedData& data,
         std::chrono::milliseconds timeout)
 {
     bool rv = false;
@@ -177,12 +178,14 @@ bool Requester::read_fn(
         request.request_id()[0] = uint8_t((sequence_number >> 8) & 0xFF);
         request.request_id()[1] = uint8_t(sequence_number & 0xFF);
 
-        data.resize(request.getMaxCdrSerializedSize() + temp_data.size());
-        fastcdr::FastBuffer fastbuffer{reinterpret_cast<char*>(data.data()), data.size()};
+        std::shared_ptr<std::vector<uint8_t>> reply =
+                std::make_shared<std::vector<uint8_t>>(request.getMaxCdrSerializedSize() + temp_data.size());
+        fastcdr::FastBuffer fastbuffer{reinterpret_cast<char*>(reply->data()), reply->size()};
         fastcdr::Cdr serializer(fastbuffer);
 
         request.serialize(serializer);
         serializer.serializeArray(temp_data.data(), temp_data.size());
+        data = std::move(reply);
 
         UXR_AGENT_LOG_MESSAGE(
             UXR_DECORATE_YELLOW("[==>> DDS <<==]"),
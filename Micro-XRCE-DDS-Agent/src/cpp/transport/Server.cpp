@@ -17,10 +17,13 @@
 #include <uxr/agent/processor/Processor.hpp>
 #include <uxr/agent/Root.hpp>
 #include <uxr/agent/logger/Logger.hpp>
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/LockFreeScheduler.hpp>
 
 #include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
 #include <uxr/agent/transport/endpoint/IPv6EndPoint.hpp>
 #include <uxr/agent/transport/endpoint/SerialEndPoint.hpp>
+#include <uxr/agent/transport/endpoint/SharedMemoryEndPoint.hpp>
 #include <uxr/agent/transport/endpoint/CustomEndPoint.hpp>
 
 #include <functional>
@@ -33,14 +36,26 @@ namespace uxr {
 extern template class Processor<IPv4EndPoint>;
 extern template class Processor<IPv6EndPoint>;
 extern template class Processor<SerialEndPoint>;
+extern template class Processor<SharedMemoryEndPoint>;
 extern template class Processor<CustomEndPoint>;
 
+template<typename T>
+static std::unique_ptr<Scheduler<T>> create_scheduler()
+{
+#ifdef UAGENT_LOCKFREE_SCHEDULER
+    return std::unique_ptr<Scheduler<T>>(new LockFreeScheduler<T>(SERVER_QUEUE_MAX_SIZE, SCHEDULER_SPIN_COUNT));
+#else
+    return std::unique_ptr<Scheduler<T>>(new FCFSScheduler<T>(SERVER_QUEUE_MAX_SIZE));
+#endif
+}
+
 template<typename EndPoint>
 Server<EndPoint>::Server(Middleware::Kind middleware_kind)
     : processor_(new Processor<EndPoint>(*this, *root_, middleware_kind))   
     , running_cond_(false)      // 初始化原子变量running_cond为假
-    , input_scheduler_(SERVER_QUEUE_MAX_SIZE)
-    , output_scheduler_(SERVER_QUEUE_MAX_SIZE)
+    , processing_workers_(PROCESSING_WORKERS)
+    , input_schedulers_()
+    , output_scheduler_(create_scheduler<OutputPacket<EndPoint>>())
     , transport_rc_{TransportRc::ok}
     , error_mtx_{}
     , error_cv_{}
@@ -65,8 +80,13 @@ bool Server<EndPoint>::start()
     }
 
     /* Scheduler initialization. */
-    input_scheduler_.init();
-    output_scheduler_.init();
+    input_schedulers_.clear();
+    for (uint16_t i = 0; i < processing_workers_; ++i)
+    {
+        input_schedulers_.emplace_back(create_scheduler<InputPacket<EndPoint>>());
+        input_schedulers_.back()->init();
+    }
+    output_scheduler_->init();
   
     /* Thread initialization. */
     // 初始化五个线程：错误处理、接受者、发送者、处理器、心跳
@@ -74,7 +94,10 @@ bool Server<EndPoint>::start()
     error_handler_thread_ = std::thread(&Server::error_handler_loop, this);
     receiver_thread_ = std::thread(&Server::receiver_loop, this);
     sender_thread_ = std::thread(&Server::sender_loop, this);
-    processing_thread_ = std::thread(&Server::processing_loop, this);
+    for (size_t i = 0; i < input_schedulers_.size(); ++i)
+    {
+        processing_threads_.emplace_back(&Server::processing_loop, this, i);
+    }
     heartbeat_thread_ = std::thread(&Server::heartbeat_loop, this);
 
     return true;
@@ -87,8 +110,11 @@ bool Server<EndPoint>::stop()
     running_cond_ = false;
 
     /* Stop input and output queues. */
-    input_scheduler_.deinit();
-    output_scheduler_.deinit();
+    for (auto& input_scheduler : input_schedulers_)
+    {
+        input_scheduler->deinit();
+    }
+    output_scheduler_->deinit();
 
     error_cv_.notify_one();
 
@@ -101,10 +127,14 @@ bool Server<EndPoint>::stop()
     {
         sender_thread_.join();
     }
-    if (processing_thread_.joinable())
+    for (auto& processing_thread : processing_threads_)
     {
-        processing_thread_.join();
+        if (processing_thread.joinable())
+        {
+            processing_thread.join();
+        }
     }
+    processing_threads_.clear();
     if (heartbeat_thread_.joinable())
     {
         heartbeat_thread_.join();
@@ -127,6 +157,19 @@ bool Server<EndPoint>::stop()
     return rv;
 }
 
+template<typename EndPoint>
+bool Server<EndPoint>::set_processing_workers(uint16_t processing_workers)
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!running_cond_ && (0 < processing_workers))
+    {
+        processing_workers_ = processing_workers;
+        rv = true;
+    }
+    return rv;
+}
+
 #ifdef UAGENT_DISCOVERY_PROFILE
 template<typename EndPoint>
 bool Server<EndPoint>::enable_discovery(uint16_t discovery_port)
@@ -171,20 +214,58 @@ void Server<EndPoint>::push_output_packet(
 {
     if (output_packet.message)
     {
-        output_scheduler_.push(std::move(output_packet), 0);
+        output_scheduler_->push(std::move(output_packet), 0);
     }
 }
 
 template<typename EndPoint>
-void Server<EndPoint>::receiver_loop()
+bool Server<EndPoint>::recv_messages(
+        std::vector<InputPacket<EndPoint>>& input_packets,
+        int timeout,
+        TransportRc& transport_rc)
 {
     InputPacket<EndPoint> input_packet{};
+    bool rv = recv_message(input_packet, timeout, transport_rc);
+    if (rv)
+    {
+        input_packets.push_back(std::move(input_packet));
+    }
+    return rv;
+}
+
+template<typename EndPoint>
+void Server<EndPoint>::receiver_loop()
+{
+    std::vector<InputPacket<EndPoint>> input_packets;
+    input_packets.reserve(UDP_RECV_BATCH_SIZE);
+    std::vector<std::vector<InputPacket<EndPoint>>> worker_packets(input_schedulers_.size());
+    std::hash<EndPoint> endpoint_hash;
     while (running_cond_)
     {
         TransportRc transport_rc = TransportRc::ok;
-        if (recv_message(input_packet, RECEIVE_TIMEOUT, transport_rc))
+        if (recv_messages(input_packets, RECEIVE_TIMEOUT, transport_rc))
         {
-            input_scheduler_.push(std::move(input_packet), 0);
+            if (1 == input_schedulers_.size())
+            {
+                input_schedulers_.front()->push_batch(input_packets, 0);
+            }
+            else
+            {
+                /* Route by source so that every packet of a client is processed by the same worker. */
+                for (auto& input_packet : input_packets)
+                {
+                    size_t worker_id = endpoint_hash(input_packet.source) % worker_packets.size();
+                    worker_packets[worker_id].push_back(std::move(input_packet));
+                }
+                input_packets.clear();
+                for (size_t i = 0; i < worker_packets.size(); ++i)
+                {
+                    if (!worker_packets[i].empty())
+                    {
+                        input_schedulers_[i]->push_batch(worker_packets[i], 0);
+                    }
+                }
+            }
         }
         else
         {
@@ -198,36 +279,55 @@ void Server<EndPoint>::receiver_loop()
     }
 }
 
+template<typename EndPoint>
+size_t Server<EndPoint>::send_messages(
+        std::vector<OutputPacket<EndPoint>>& output_packets,
+        TransportRc& transport_rc)
+{
+    size_t sent = 0;
+    for (auto& output_packet : output_packets)
+    {
+        if (!send_message(output_packet, transport_rc) && (TransportRc::server_error == transport_rc))
+        {
+            break;
+        }
+        ++sent;
+    }
+    return sent;
+}
+
 template<typename EndPoint>
 void Server<EndPoint>::sender_loop()
 {
-    OutputPacket<EndPoint> output_packet{};
+    std::vector<OutputPacket<EndPoint>> output_packets;
+    output_packets.reserve(UDP_SEND_BATCH_SIZE);
     while (running_cond_)
     {
-        if (output_scheduler_.pop(output_packet))
+        /* Packets left by a server error are retried before taking new ones. */
+        if (!output_packets.empty() || output_scheduler_->pop_batch(output_packets, UDP_SEND_BATCH_SIZE))
         {
             TransportRc transport_rc = TransportRc::ok;
-            if (!send_message(output_packet, transport_rc))
+            size_t sent = send_messages(output_packets, transport_rc);
+            output_packets.erase(output_packets.begin(), output_packets.begin() + std::ptrdiff_t(sent));
+            if (!output_packets.empty() && (TransportRc::server_error == transport_rc))
             {
-                if (TransportRc::server_error == transport_rc)
-                {
-                    std::unique_lock<std::mutex> lock(error_mtx_);
-                    transport_rc_ = transport_rc;
-                    output_scheduler_.push_front(std::move(output_packet));
-                    error_cv_.notify_one();
-                }
+                std::unique_lock<std::mutex> lock(error_mtx_);
+                transport_rc_ = transport_rc;
+                error_cv_.notify_one();
             }
         }
     }
 }
 
 template<typename EndPoint>
-void Server<EndPoint>::processing_loop()
+void Server<EndPoint>::processing_loop(
+        size_t worker_id)
 {
     InputPacket<EndPoint> input_packet;
+    Scheduler<InputPacket<EndPoint>>& input_scheduler = *input_schedulers_[worker_id];
     while (running_cond_)
     {
-        if (input_scheduler_.pop(input_packet))
+        if (input_scheduler.pop(input_packet))
         {
             processor_->process_input_packet(std::move(input_packet));
         }
@@ -239,8 +339,7 @@ void Server<EndPoint>::heartbeat_loop()
 {
     while (running_cond_)
     {
-        processor_->check_heartbeats();
-        std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_PERIOD));
+        processor_->check_output_timers(std::chrono::milliseconds(HEARTBEAT_PERIOD));
     }
 }
 
@@ -259,7 +358,7 @@ void Server<EndPoint>::error_handler_loop()
             while (running_cond_ && !error_handled)
             {
                 error_handled = handle_error(transport_rc_);
-                std::this_thread::sleep_for(::chrono::milliseconds(500));
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
             }
             transport_rc_ = TransportRc::ok;
         }
@@ -269,6 +368,7 @@ void Server<EndPoint>::error_handler_loop()
 template class Server<IPv4EndPoint>;
 template class Server<IPv6EndPoint>;
 template class Server<SerialEndPoint>;
+template class Server<SharedMemoryEndPoint>;
 template class Server<CustomEndPoint>;
 
 } // namespace uxr
@@ -27,7 +27,7 @@ SerialAgent::SerialAgent(
     : Server<SerialEndPoint>{middleware_kind}
     , addr_{addr}
     , poll_fd_{}
-    , buffer_{0}
+    , buffer_(SERVER_BUFFER_SIZE)
     , framing_io_(
           addr,
           std::bind(&SerialAgent::write_data, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
@@ -82,10 +82,10 @@ bool SerialAgent::recv_message(
 {
     bool rv = false;
     uint8_t remote_addr;
-    ssize_t bytes_read = framing_io_.read_framed_msg(buffer_,sizeof (buffer_), remote_addr, timeout, transport_rc);
+    ssize_t bytes_read = framing_io_.read_framed_msg(buffer_.data(), buffer_.size(), remote_addr, timeout, transport_rc);
     if (0 < bytes_read)
     {
-        input_packet.message.reset(new InputMessage(buffer_, static_cast<size_t>(bytes_read)));
+        input_packet.message.reset(InputMessage::from_buffer(buffer_, static_cast<size_t>(bytes_read)));
         input_packet.source = SerialEndPoint(remote_addr);
         rv = true;
 
@@ -0,0 +1,268 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/transport/shm/SharedMemoryAgentLinux.hpp>
+#include <uxr/agent/transport/shm/SharedMemoryRing.hpp>
+#include <uxr/agent/logger/Logger.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+
+namespace eprosima {
+namespace uxr {
+
+SharedMemoryAgent::SharedMemoryAgent(
+        const std::string& name,
+        Middleware::Kind middleware_kind)
+    : Server<SharedMemoryEndPoint>{middleware_kind}
+    , name_{name}
+    , segment_{nullptr}
+    , segment_size_{shm::segment_size(SHM_SLOTS, SHM_RING_SIZE)}
+    , next_slot_{0}
+    , buffer_(SERVER_BUFFER_SIZE)
+{}
+
+SharedMemoryAgent::~SharedMemoryAgent()
+{
+    try
+    {
+        stop();
+    }
+    catch (std::exception& e)
+    {
+        UXR_AGENT_LOG_CRITICAL(
+            UXR_DECORATE_RED("error stopping server"),
+            "exception: {}",
+            e.what());
+    }
+}
+
+bool SharedMemoryAgent::init()
+{
+    bool rv = false;
+
+    /* A segment left by a crashed agent is replaced, its clients have to reconnect anyway. */
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+    if (-1 != fd)
+    {
+        void* segment = MAP_FAILED;
+        if ((0 == fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH))
+            && (0 == ftruncate(fd, off_t(segment_size_))))
+        {
+            segment = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+
+        if (MAP_FAILED != segment)
+        {
+            /* ftruncate zero-fills the segment: every slot is free and every ring empty. */
+            segment_ = static_cast<uint8_t*>(segment);
+            shm::SegmentHeader* header = reinterpret_cast<shm::SegmentHeader*>(segment_);
+            header->version = shm::SEGMENT_VERSION;
+            header->slot_count = SHM_SLOTS;
+            header->ring_size = SHM_RING_SIZE;
+            header->agent_pid = uint32_t(getpid());
+            header->magic.store(shm::SEGMENT_MAGIC, std::memory_order_release);
+            rv = true;
+
+            UXR_AGENT_LOG_INFO(
+                UXR_DECORATE_GREEN("running..."),
+                "shared memory: {}, slots: {}",
+                name_, SHM_SLOTS);
+        }
+        else
+        {
+            shm_unlink(name_.c_str());
+            UXR_AGENT_LOG_ERROR(
+                UXR_DECORATE_RED("mmap error"),
+                "shared memory: {}, errno: {}",
+                name_, errno);
+        }
+    }
+    else
+    {
+        UXR_AGENT_LOG_ERROR(
+            UXR_DECORATE_RED("shm_open error"),
+            "shared memory: {}, errno: {}",
+            name_, errno);
+    }
+
+    return rv;
+}
+
+bool SharedMemoryAgent::fini()
+{
+    if (nullptr == segment_)
+    {
+        return true;
+    }
+
+    bool rv = false;
+    reinterpret_cast<shm::SegmentHeader*>(segment_)->magic.store(0, std::memory_order_release);
+    if ((0 == munmap(segment_, segment_size_)) && (0 == shm_unlink(name_.c_str())))
+    {
+        rv = true;
+        UXR_AGENT_LOG_INFO(
+            UXR_DECORATE_GREEN("server stopped"),
+            "shared memory: {}",
+            name_);
+    }
+    else
+    {
+        UXR_AGENT_LOG_ERROR(
+            UXR_DECORATE_RED("shared memory error"),
+            "shared memory: {}, errno: {}",
+            name_, errno);
+    }
+    segment_ = nullptr;
+    return rv;
+}
+
+bool SharedMemoryAgent::read_next(
+        InputPacket<SharedMemoryEndPoint>& input_packet)
+{
+    /* Round-robin over the slots so that a busy client does not starve the others. */
+    for (uint16_t i = 0; i < SHM_SLOTS; ++i)
+    {
+        uint16_t index = uint16_t((next_slot_ + i) % SHM_SLOTS);
+        shm::SlotHeader* slot = shm::slot_at(segment_, SHM_RING_SIZE, index);
+        if (0 == slot->owner.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        ssize_t bytes_received = shm::ring_read(shm::to_agent_ring(slot), SHM_RING_SIZE, buffer_.data(), buffer_.size());
+        if (0 < bytes_received)
+        {
+            input_packet.message.reset(InputMessage::from_buffer(buffer_, size_t(bytes_received)));
+            input_packet.source = SharedMemoryEndPoint(index);
+            next_slot_ = uint16_t((index + 1) % SHM_SLOTS);
+
+            uint32_t raw_client_key = 0u;
+            Server<SharedMemoryEndPoint>::get_client_key(input_packet.source, raw_client_key);
+            UXR_AGENT_LOG_MESSAGE(
+                UXR_DECORATE_YELLOW("[==>> SHM <<==]"),
+                raw_client_key,
+                input_packet.message->get_buf(),
+                input_packet.message->get_len());
+            return true;
+        }
+        else if (0 > bytes_received)
+        {
+            UXR_AGENT_LOG_WARN(
+                UXR_DECORATE_YELLOW("message dropped"),
+                "slot: {}",
+                index);
+        }
+    }
+    return false;
+}
+
+bool SharedMemoryAgent::recv_message(
+        InputPacket<SharedMemoryEndPoint>& input_packet,
+        int timeout,
+        TransportRc& transport_rc)
+{
+    bool rv = read_next(input_packet);
+    if (!rv)
+    {
+        /* Announce the wait before the last look at the rings, a client writing after it rings the doorbell. */
+        shm::SegmentHeader* header = reinterpret_cast<shm::SegmentHeader*>(segment_);
+        header->agent_waiting.store(1, std::memory_order_seq_cst);
+        uint32_t doorbell = header->doorbell.load(std::memory_order_seq_cst);
+        rv = read_next(input_packet);
+        if (!rv)
+        {
+            shm::futex_wait(header->doorbell, doorbell, timeout);
+            rv = read_next(input_packet);
+        }
+        header->agent_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    if (!rv)
+    {
+        transport_rc = TransportRc::timeout_error;
+    }
+    return rv;
+}
+
+bool SharedMemoryAgent::recv_messages(
+        std::vector<InputPacket<SharedMemoryEndPoint>>& input_packets,
+        int timeout,
+        TransportRc& transport_rc)
+{
+    InputPacket<SharedMemoryEndPoint> input_packet{};
+    bool rv = recv_message(input_packet, timeout, transport_rc);
+    while (rv)
+    {
+        input_packets.push_back(std::move(input_packet));
+        if ((SHM_RECV_BATCH_SIZE <= input_packets.size()) || !read_next(input_packet))
+        {
+            break;
+        }
+    }
+    return rv;
+}
+
+bool SharedMemoryAgent::send_message(
+        OutputPacket<SharedMemoryEndPoint> output_packet,
+        TransportRc& transport_rc)
+{
+    bool rv = false;
+    uint16_t index = output_packet.destination.get_slot();
+    shm::SlotHeader* slot = (index < SHM_SLOTS) ? shm::slot_at(segment_, SHM_RING_SIZE, index) : nullptr;
+
+    if ((nullptr != slot) && (0 != slot->owner.load(std::memory_order_acquire)))
+    {
+        shm::RingHeader* ring = shm::to_client_ring(slot, SHM_RING_SIZE);
+        if (shm::ring_write(ring, SHM_RING_SIZE, output_packet.message->get_buf(), output_packet.message->get_len()))
+        {
+            shm::notify(ring->seq, ring->waiting);
+            rv = true;
+
+            uint32_t raw_client_key = 0u;
+            Server<SharedMemoryEndPoint>::get_client_key(output_packet.destination, raw_client_key);
+            UXR_AGENT_LOG_MESSAGE(
+                UXR_DECORATE_YELLOW("[** <<SHM>> **]"),
+                raw_client_key,
+                output_packet.message->get_buf(),
+                output_packet.message->get_len());
+        }
+        else
+        {
+            /* The client does not keep up, the message is dropped as a full socket buffer would. */
+            transport_rc = TransportRc::connection_error;
+        }
+    }
+    else
+    {
+        transport_rc = TransportRc::connection_error;
+    }
+
+    return rv;
+}
+
+bool SharedMemoryAgent::handle_error(
+        TransportRc /*transport_rc*/)
+{
+    return fini() && init();
+}
+
+} // namespace uxr
+} // namespace eprosima
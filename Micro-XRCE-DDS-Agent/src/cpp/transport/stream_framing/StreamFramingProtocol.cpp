@@ -13,12 +13,52 @@
 // limitations under the License.
 
 #include <uxr/agent/transport/stream_framing/StreamFramingProtocol.hpp>
+
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
 
 namespace eprosima {
 namespace uxr {
 
+namespace {
+
+/* Slicing-by-8 tables: table[k][i] is the CRC of the octet i followed by k zero octets. */
+using Crc16SlicingTable = std::array<std::array<uint16_t, 256>, 8>;
+
+Crc16SlicingTable make_crc16_slicing_table()
+{
+    Crc16SlicingTable table;
+    for (size_t i = 0; i < 256; ++i)
+    {
+        uint16_t crc = static_cast<uint16_t>(i);
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+        }
+        table[0][i] = crc;
+    }
+    for (size_t k = 1; k < table.size(); ++k)
+    {
+        for (size_t i = 0; i < 256; ++i)
+        {
+            table[k][i] = static_cast<uint16_t>((table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF]);
+        }
+    }
+    return table;
+}
+
+const Crc16SlicingTable& crc16_slicing_table()
+{
+    static const Crc16SlicingTable table = make_crc16_slicing_table();
+    return table;
+}
+
+} // unnamed namespace
+
 constexpr uint16_t FramingIO::crc16_table[256];
+constexpr size_t FramingIO::read_buffer_size;
 
 FramingIO::FramingIO(
         uint8_t local_addr,
@@ -27,7 +67,7 @@ FramingIO::FramingIO(
     : state_(InputState::UXR_FRAMING_UNINITIALIZED)
     , local_addr_(local_addr)
     , remote_addr_(0)
-    , read_buffer_()
+    , read_buffer_(read_buffer_size)
     , read_buffer_head_(0)
     , read_buffer_tail_(0)
     , read_callback_(read_callback)
@@ -47,61 +87,37 @@ size_t FramingIO::write_framed_msg(
         uint8_t remote_addr,
         TransportRc& transport_rc)
 {
+    /* The whole frame is escaped into the write buffer, in the worst case every octet is escaped. */
+    const size_t max_frame_size = 1 + 2 * (4 + len + 2);
+    if (write_buffer_.size() < max_frame_size)
+    {
+        write_buffer_.resize(max_frame_size);
+    }
+
     /* Buffer being flag. */
     write_buffer_[0] = framing_begin_flag;
     write_buffer_pos_ = 1;
 
     /* Buffer header. */
-    add_next_octet(local_addr_);
-    add_next_octet(remote_addr);
-    add_next_octet(static_cast<uint8_t>(len & 0xFF));
-    add_next_octet(static_cast<uint8_t>(len >> 8));
-
-    /* Write payload. */
-    uint8_t octet = 0;
-    uint16_t written_len = 0;
+    const uint8_t header[4] = {
+        local_addr_,
+        remote_addr,
+        static_cast<uint8_t>(len & 0xFF),
+        static_cast<uint8_t>(len >> 8)};
+    add_escaped(header, sizeof(header));
+
+    /* Buffer payload. */
     uint16_t crc = 0;
-    bool cond = true;
-    while (written_len < len && cond)
-    {
-        octet = static_cast<uint8_t>(*(buf + written_len));
-        if (add_next_octet(octet))
-        {
-            update_crc(crc, octet);
-            ++written_len;
-        }
-        else
-        {
-            cond = transport_write(transport_rc);
-        }
-    }
-
-    /* Write CRC. */
-    uint8_t tmp_crc[2];
-    tmp_crc[0] = static_cast<uint8_t>(crc & 0xFF);
-    tmp_crc[1] = static_cast<uint8_t>(crc >> 8);
-    written_len = 0;
-    while (written_len < sizeof(tmp_crc) && cond)
-    {
-        octet = *(tmp_crc + written_len);
-        if (add_next_octet(octet))
-        {
-            update_crc(crc, octet);
-            ++written_len;
-        }
-        else
-        {
-            cond = transport_write(transport_rc);
-        }
-    }
+    update_crc(crc, buf, len);
+    add_escaped(buf, len);
 
-    /* Flus write buffer. */
-    if (cond && (0 < write_buffer_pos_))
-    {
-        cond = transport_write(transport_rc);
-    }
+    /* Buffer CRC. */
+    const uint8_t tmp_crc[2] = {
+        static_cast<uint8_t>(crc & 0xFF),
+        static_cast<uint8_t>(crc >> 8)};
+    add_escaped(tmp_crc, sizeof(tmp_crc));
 
-    return cond ? len : 0;
+    return transport_write(transport_rc) ? len : 0;
 }
 
 size_t FramingIO::read_framed_msg(
@@ -113,33 +129,74 @@ size_t FramingIO::read_framed_msg(
 {
     size_t rv = 0;
 
-    size_t read_bytes = transport_read(timeout, transport_rc);
+    /* Frames left in the read buffer by a previous read go first, without touching the transport. */
+    bool exit_cond = parse_buffered(buf, len, remote_addr, rv);
+    while (!exit_cond)
+    {
+        exit_cond = (0 == transport_read(timeout, transport_rc))
+                || parse_buffered(buf, len, remote_addr, rv);
+    }
 
-    if (0 < read_bytes || (read_buffer_tail_ != read_buffer_head_))
+    return rv;
+}
+
+bool FramingIO::parse_buffered(
+        uint8_t* buf,
+        size_t len,
+        uint8_t& remote_addr,
+        size_t& rv)
+{
+    /**
+     * State Machine.
+     */
+    bool frame_cond = false;
+    bool exit_cond = false;
+    while (!exit_cond)
     {
-        /**
-         * State Machine.
-         */
-        bool exit_cond = false;
-        while (!exit_cond)
+        uint8_t octet = 0;
+        switch (state_)
         {
-            uint8_t octet = 0;
-            switch (state_)
+            case InputState::UXR_FRAMING_UNINITIALIZED:
+            {
+                const uint8_t* begin = read_buffer_.data() + read_buffer_tail_;
+                const void* flag = std::memchr(begin, framing_begin_flag, read_buffer_head_ - read_buffer_tail_);
+                if (nullptr != flag)
+                {
+                    read_buffer_tail_ += size_t(static_cast<const uint8_t*>(flag) - begin) + 1;
+                    state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
+                }
+                else
+                {
+                    read_buffer_tail_ = read_buffer_head_;
+                    exit_cond = true;
+                }
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_SRC_ADDR:
             {
-                case InputState::UXR_FRAMING_UNINITIALIZED:
+                if (get_next_octet(remote_addr_))
                 {
-                    octet = 0;
-                    while ((framing_begin_flag != octet) &&
-                           (read_buffer_head_ != read_buffer_tail_))
+                    state_ = InputState::UXR_FRAMING_READING_DST_ADDR;
+                }
+                else
+                {
+                    if (framing_begin_flag != remote_addr_)
                     {
-                        octet = read_buffer_[read_buffer_tail_];
-                        read_buffer_tail_ =
-                            static_cast<uint8_t>(
-                                static_cast<size_t>(
-                                    read_buffer_tail_ + 1) %
-                                    sizeof(read_buffer_));
+                        exit_cond = true;
                     }
-
+                }
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_DST_ADDR:
+            {
+                if (get_next_octet(octet))
+                {
+                    state_ = (octet == local_addr_)
+                            ? InputState::UXR_FRAMING_READING_LEN_LSB
+                            : InputState::UXR_FRAMING_UNINITIALIZED;
+                }
+                else
+                {
                     if (framing_begin_flag == octet)
                     {
                         state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
@@ -148,84 +205,82 @@ size_t FramingIO::read_framed_msg(
                     {
                         exit_cond = true;
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_SRC_ADDR:
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_LEN_LSB:
+            {
+                if (get_next_octet(octet))
+                {
+                    msg_len_ = octet;
+                    state_ = InputState::UXR_FRAMING_READING_LEN_MSB;
+                }
+                else
                 {
-                    if (get_next_octet(remote_addr_))
+                    if (framing_begin_flag == octet)
                     {
-                        state_ = InputState::UXR_FRAMING_READING_DST_ADDR;
+                        state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
                     }
                     else
                     {
-                        if (framing_begin_flag != remote_addr_)
-                        {
-                            exit_cond = true;
-                        }
+                        exit_cond = true;
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_DST_ADDR:
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_LEN_MSB:
+            {
+                if (get_next_octet(octet))
                 {
-                    if (get_next_octet(octet))
+                    msg_len_ += (octet << 8);
+                    msg_pos_ = 0;
+                    cmp_crc_ = 0;
+                    if (len < msg_len_)
                     {
-                        state_ = (octet == local_addr_)
-                                ? InputState::UXR_FRAMING_READING_LEN_LSB
-                                : InputState::UXR_FRAMING_UNINITIALIZED;
+                        state_ = InputState::UXR_FRAMING_UNINITIALIZED;
+                        frame_cond = true;
+                        exit_cond = true;
                     }
                     else
                     {
-                        if (framing_begin_flag == octet)
-                        {
-                            state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
-                        }
-                        else
-                        {
-                            exit_cond = true;
-                        }
+                        state_ = InputState::UXR_FRAMING_READING_PAYLOAD;
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_LEN_LSB:
+                else
                 {
-                    if (get_next_octet(octet))
+                    if (framing_begin_flag == octet)
                     {
-                        msg_len_ = octet;
-                        state_ = InputState::UXR_FRAMING_READING_LEN_MSB;
+                        state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
                     }
                     else
                     {
-                        if (framing_begin_flag == octet)
-                        {
-                            state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
-                        }
-                        else
-                        {
-                            exit_cond = true;
-                        }
+                        exit_cond = true;
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_LEN_MSB:
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_PAYLOAD:
+            {
+                /* Runs of plain octets are copied at once, only the flags go octet by octet. */
+                while ((msg_pos_ < msg_len_) && (InputState::UXR_FRAMING_READING_PAYLOAD == state_) && !exit_cond)
                 {
-                    if (get_next_octet(octet))
+                    const uint8_t* begin = read_buffer_.data() + read_buffer_tail_;
+                    const size_t available = std::min(read_buffer_head_ - read_buffer_tail_, size_t(msg_len_ - msg_pos_));
+                    const size_t run = size_t(find_flag(begin, begin + available) - begin);
+                    std::memcpy(buf + msg_pos_, begin, run);
+                    update_crc(cmp_crc_, begin, run);
+                    msg_pos_ = static_cast<uint16_t>(msg_pos_ + run);
+                    read_buffer_tail_ += run;
+
+                    if (msg_pos_ < msg_len_)
                     {
-                        msg_len_ += (octet << 8);
-                        msg_pos_ = 0;
-                        cmp_crc_ = 0;
-                        if (len < msg_len_)
-                        {
-                            state_ = InputState::UXR_FRAMING_UNINITIALIZED;
-                            exit_cond = true;
-                        }
-                        else
+                        if (get_next_octet(octet))
                         {
-                            state_ = InputState::UXR_FRAMING_READING_PAYLOAD;
+                            buf[static_cast<size_t>(msg_pos_)] = octet;
+                            ++msg_pos_;
+                            update_crc(cmp_crc_, octet);
                         }
-                    }
-                    else
-                    {
-                        if (framing_begin_flag == octet)
+                        else if (framing_begin_flag == octet)
                         {
                             state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
                         }
@@ -234,87 +289,63 @@ size_t FramingIO::read_framed_msg(
                             exit_cond = true;
                         }
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_PAYLOAD:
-                {
-                    while ((msg_pos_ < msg_len_) && get_next_octet(octet))
-                    {
-                        buf[static_cast<size_t>(msg_pos_)] = octet;
-                        ++msg_pos_;
-                        update_crc(cmp_crc_, octet);
-                    }
 
-                    if (msg_pos_ == msg_len_)
+                if ((InputState::UXR_FRAMING_READING_PAYLOAD == state_) && (msg_pos_ == msg_len_))
+                {
+                    state_ = InputState::UXR_FRAMING_READING_CRC_LSB;
+                }
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_CRC_LSB:
+            {
+                if (get_next_octet(octet))
+                {
+                    msg_crc_ = octet;
+                    state_ = InputState::UXR_FRAMING_READING_CRC_MSB;
+                }
+                else
+                {
+                    if (framing_begin_flag == octet)
                     {
-                        state_ = InputState::UXR_FRAMING_READING_CRC_LSB;
+                        state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
                     }
                     else
                     {
-                        if (framing_begin_flag == octet)
-                        {
-                            state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
-                        }
-                        else if (0 < transport_read(timeout, transport_rc))
-                        {
-                            /* Do nothing */
-                        }
-                        else
-                        {
-                            exit_cond = true;
-                        }
+                        exit_cond = true;
                     }
-                    break;
                 }
-                case InputState::UXR_FRAMING_READING_CRC_LSB:
+                break;
+            }
+            case InputState::UXR_FRAMING_READING_CRC_MSB:
+                if (get_next_octet(octet))
                 {
-                    if (get_next_octet(octet))
+                    msg_crc_ += (octet << 8);
+                    state_ = InputState::UXR_FRAMING_UNINITIALIZED;
+                    if (cmp_crc_ == msg_crc_)
                     {
-                        msg_crc_ = octet;
-                        state_ = InputState::UXR_FRAMING_READING_CRC_MSB;
+                        remote_addr = remote_addr_;
+                        rv = msg_len_;
                     }
-                    else
-                    {
-                        if (framing_begin_flag == octet)
-                        {
-                            state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
-                        }
-                        else
-                        {
-                            exit_cond = true;
-                        }
-                    }
-                    break;
+                    frame_cond = true;
+                    exit_cond = true;
                 }
-                case InputState::UXR_FRAMING_READING_CRC_MSB:
-                    if (get_next_octet(octet))
+                else
+                {
+                    if (framing_begin_flag == octet)
                     {
-                        msg_crc_ += (octet << 8);
-                        state_ = InputState::UXR_FRAMING_UNINITIALIZED;
-                        if (cmp_crc_ == msg_crc_)
-                        {
-                            remote_addr = remote_addr_;
-                            rv = msg_len_;
-                        }
-                        exit_cond = true;
+                        state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
                     }
                     else
                     {
-                        if (framing_begin_flag == octet)
-                        {
-                            state_ = InputState::UXR_FRAMING_READING_SRC_ADDR;
-                        }
-                        else
-                        {
-                            exit_cond = true;
-                        }
+                        exit_cond = true;
                     }
-                    break;
-            }
+                }
+                break;
         }
     }
 
-    return rv;
+    return frame_cond;
 }
 
 void FramingIO::update_crc(
@@ -324,6 +355,79 @@ void FramingIO::update_crc(
     crc = (crc >> 8) ^ crc16_table[(crc ^ data) & 0xFF];
 }
 
+void FramingIO::update_crc(
+        uint16_t& crc,
+        const uint8_t* buf,
+        size_t len)
+{
+    const Crc16SlicingTable& table = crc16_slicing_table();
+    uint16_t tmp_crc = crc;
+    while (8 <= len)
+    {
+        /* The 16-bit CRC only overlaps the first two octets, the other six are looked up directly. */
+        tmp_crc = table[7][(buf[0] ^ tmp_crc) & 0xFF] ^ table[6][(buf[1] ^ (tmp_crc >> 8)) & 0xFF]
+                ^ table[5][buf[2]] ^ table[4][buf[3]] ^ table[3][buf[4]] ^ table[2][buf[5]]
+                ^ table[1][buf[6]] ^ table[0][buf[7]];
+        buf += 8;
+        len -= 8;
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        tmp_crc = (tmp_crc >> 8) ^ crc16_table[(tmp_crc ^ buf[i]) & 0xFF];
+    }
+    crc = tmp_crc;
+}
+
+const uint8_t* FramingIO::find_flag(
+        const uint8_t* begin,
+        const uint8_t* end)
+{
+    /* A word holds a flag if one of its octets XOR the flag is zero, which sets the high bit of
+       (x - 0x01) & ~x in that octet. */
+    constexpr uint64_t ones = 0x0101010101010101ULL;
+    constexpr uint64_t highs = 0x8080808080808080ULL;
+    while (sizeof(uint64_t) <= size_t(end - begin))
+    {
+        uint64_t word;
+        std::memcpy(&word, begin, sizeof(word));
+        const uint64_t begin_match = word ^ (ones * framing_begin_flag);
+        const uint64_t esc_match = word ^ (ones * framing_esc_flag);
+        if (0 != ((((begin_match - ones) & ~begin_match) | ((esc_match - ones) & ~esc_match)) & highs))
+        {
+            break;
+        }
+        begin += sizeof(uint64_t);
+    }
+
+    while ((begin != end) && (framing_begin_flag != *begin) && (framing_esc_flag != *begin))
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+void FramingIO::add_escaped(
+        const uint8_t* buf,
+        size_t len)
+{
+    const uint8_t* end = buf + len;
+    while (buf != end)
+    {
+        const uint8_t* flag = find_flag(buf, end);
+        std::memcpy(write_buffer_.data() + write_buffer_pos_, buf, size_t(flag - buf));
+        write_buffer_pos_ += size_t(flag - buf);
+
+        if (flag != end)
+        {
+            write_buffer_[write_buffer_pos_] = framing_esc_flag;
+            write_buffer_[write_buffer_pos_ + 1] = *flag ^ framing_xor_flag;
+            write_buffer_pos_ += 2;
+            ++flag;
+        }
+        buf = flag;
+    }
+}
+
 bool FramingIO::get_next_octet(
         uint8_t& octet)
 {
@@ -335,27 +439,19 @@ bool FramingIO::get_next_octet(
         if (framing_esc_flag != read_buffer_[read_buffer_tail_])
         {
             octet = read_buffer_[read_buffer_tail_];
-            read_buffer_tail_ = static_cast<uint8_t>(
-                static_cast<size_t>(read_buffer_tail_ + 1) % sizeof(read_buffer_));
+            ++read_buffer_tail_;
 
             rv = (framing_begin_flag != octet);
         }
-        else
+        else if ((read_buffer_tail_ + 1) != read_buffer_head_)
         {
-            uint8_t temp_tail = static_cast<uint8_t>(
-                static_cast<size_t>(read_buffer_tail_ + 1) % sizeof(read_buffer_));
+            octet = read_buffer_[read_buffer_tail_ + 1];
+            read_buffer_tail_ += 2;
 
-            if (temp_tail != read_buffer_head_)
+            if (framing_begin_flag != octet)
             {
-                octet = read_buffer_[temp_tail];
-                read_buffer_tail_ = static_cast<uint8_t>(
-                    static_cast<size_t>(read_buffer_tail_ + 2) % sizeof(read_buffer_));
-
-                if (framing_begin_flag != octet)
-                {
-                    octet ^= framing_xor_flag;
-                    rv = true;
-                }
+                octet ^= framing_xor_flag;
+                rv = true;
             }
         }
     }
@@ -363,31 +459,6 @@ bool FramingIO::get_next_octet(
     return rv;
 }
 
-bool FramingIO::add_next_octet(
-        uint8_t octet)
-{
-    bool rv = false;
-
-    if (framing_begin_flag == octet || framing_esc_flag == octet)
-    {
-        if (static_cast<uint8_t>(write_buffer_pos_ + 1) < sizeof(write_buffer_))
-        {
-            write_buffer_[write_buffer_pos_] = framing_esc_flag;
-            write_buffer_[write_buffer_pos_ + 1] = octet ^ framing_xor_flag;
-            write_buffer_pos_ += 2;
-            rv = true;
-        }
-    }
-    else if (write_buffer_pos_ < sizeof(write_buffer_))
-    {
-        write_buffer_[write_buffer_pos_] = octet;
-        ++write_buffer_pos_;
-        rv = true;
-    }
-
-    return rv;
-}
-
 bool FramingIO::transport_write(
         TransportRc& transport_rc)
 {
@@ -396,98 +467,55 @@ bool FramingIO::transport_write(
 
     do
     {
-        ssize_t write_res = write_callback_(write_buffer_, write_buffer_pos_, transport_rc);
-        last_written = (0 < write_res) ? write_res : 0;
+        ssize_t write_res = write_callback_(write_buffer_.data() + bytes_written,
+                                            write_buffer_pos_ - bytes_written,
+                                            transport_rc);
+        last_written = (0 < write_res) ? size_t(write_res) : 0;
         bytes_written += last_written;
     } while (bytes_written < write_buffer_pos_ && 0 < last_written);
 
-    if (write_buffer_pos_ == bytes_written)
-    {
-        write_buffer_pos_ = 0;
-        return true;
-    }
-
-    return false;
+    bool rv = (write_buffer_pos_ == bytes_written);
+    write_buffer_pos_ = 0;
+    return rv;
 }
 
 size_t FramingIO::transport_read(
         int& timeout,
         TransportRc& transport_rc)
 {
-    const auto time_init = std::chrono::system_clock::now();
+    const auto time_init = std::chrono::steady_clock::now();
 
     /**
-     * Compute read-buffer available size.
-     * We keep track of two possible fragments to handle the case of
-     * some intermediate section of the circular buffer being written,
-     * that is, head > tail.
+     * The state machine consumes everything but an incomplete escape sequence,
+     * so the pending octets are moved to the front and the rest of the buffer is read at once.
      */
-    uint8_t available_length[2] = {0, 0};
-    if (read_buffer_head_ == read_buffer_tail_)
-    {
-        read_buffer_head_ = 0;
-        read_buffer_tail_ = 0;
-        available_length[0] = sizeof(read_buffer_) - 1;
-    }
-    else if (read_buffer_head_ > read_buffer_tail_)
-    {
-        if (0 < read_buffer_tail_)
-        {
-            available_length[0] =
-                static_cast<uint8_t>(sizeof(read_buffer_) - read_buffer_head_);
-            available_length[1] =
-                static_cast<uint8_t>(read_buffer_tail_ - 1);
-        }
-        else
-        {
-            available_length[0] =
-                static_cast<uint8_t>(sizeof(read_buffer_) - read_buffer_head_ - 1);
-        }
-    }
-    else
+    const size_t pending = read_buffer_head_ - read_buffer_tail_;
+    if (0 < pending)
     {
-        available_length[0] =
-            static_cast<uint8_t>(read_buffer_tail_ - read_buffer_head_ - 1);
+        std::memmove(read_buffer_.data(), read_buffer_.data() + read_buffer_tail_, pending);
     }
-
-    /**
-     * Read from serial, according to the fragment size previously calculated.
-     */
-    size_t bytes_read[2] = {0, 0};
-    if (0 < available_length[0])
+    read_buffer_head_ = pending;
+    read_buffer_tail_ = 0;
+
+    size_t bytes_read = 0;
+    ssize_t read_res = read_callback_(read_buffer_.data() + read_buffer_head_,
+                                      read_buffer_.size() - read_buffer_head_,
+                                      timeout,
+                                      transport_rc);
+    if (0 < read_res)
     {
-        ssize_t read_res = read_callback_(&read_buffer_[read_buffer_head_],
-                                       available_length[0],
-                                       timeout,
-                                       transport_rc);
-        bytes_read[0] = (0 < read_res) ? read_res : 0;
-
-        read_buffer_head_ = static_cast<uint8_t>(
-            static_cast<size_t>(read_buffer_head_ + bytes_read[0]) % sizeof(read_buffer_));
-
-        if (0 < bytes_read[0])
-        {
-            if ((bytes_read[0] == available_length[0]) && (0 < available_length[1]))
-            {
-                read_res = read_callback_(&read_buffer_[read_buffer_head_],
-                                       available_length[1],
-                                       0,
-                                       transport_rc);
-                bytes_read[1] = (0 < read_res) ? read_res : 0;
-
-                read_buffer_head_ = static_cast<uint8_t>(
-                    static_cast<size_t>(read_buffer_head_ + bytes_read[1]) % sizeof(read_buffer_));
-            }
-        }
+        bytes_read = size_t(read_res);
+        read_buffer_head_ += bytes_read;
     }
 
     timeout -= static_cast<int>(
         std::chrono::duration_cast<std::chrono::milliseconds>(
-            time_init - std::chrono::system_clock::now())
+            std::chrono::steady_clock::now() - time_init)
             .count());
+    timeout = std::max(timeout, 0);
 
-    return bytes_read[0] + bytes_read[1];
+    return bytes_read;
 }
 
 } // namespace uxr
-} // namespace eprosima
\ No newline at end of file
+} // namespace eprosima
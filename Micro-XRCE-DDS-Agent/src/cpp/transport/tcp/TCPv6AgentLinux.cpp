@@ -18,18 +18,24 @@
 #include <uxr/agent/logger/Logger.hpp>
 
 #include <sys/types.h>
+#include <sys/poll.h>
 #include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <limits.h>
 #include <arpa/inet.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
 #include <signal.h>
+#include <algorithm>
 #include <functional>
 
 namespace eprosima {
 namespace uxr {
 
 const uint8_t max_attemps = 16;
+const int send_poll_timeout = 100;
+const uint64_t listener_key = UINT64_MAX;
 
 #ifdef UAGENT_DISCOVERY_PROFILE
 extern template class DiscoveryServer<IPv6EndPoint>;
@@ -42,15 +48,19 @@ TCPv6Agent::TCPv6Agent(
     : Server<IPv6EndPoint>{middleware_kind}
     , TCPServerBase{}
     , connections_{}
-    , active_connections_{}
-    , free_connections_{}
-    , listener_poll_{}
-    , poll_fds_{}
-    , buffer_{0}
+    , endpoint_to_connection_map_{}
+    , next_connection_id_{0}
+    , connections_mtx_{}
+    , listener_fd_{-1}
+    , epoll_fd_{-1}
+    , epoll_events_{}
+    , send_packets_{}
+    , send_headers_{}
+    , send_iovecs_{}
+    , send_done_{}
     , agent_port_{agent_port}
-    , listener_thread_{}
-    , running_cond_{false}
     , messages_queue_{}
+    , ready_connections_{}
 #ifdef UAGENT_DISCOVERY_PROFILE
     , discovery_server_{*processor_}
 #endif
@@ -78,10 +88,11 @@ bool TCPv6Agent::init()
     /* Ignore SIGPIPE signal. */
     signal(SIGPIPE, sigpipe_handler);
 
-    /* Listener socket initialization. */
-    listener_poll_.fd = socket(PF_INET6, SOCK_STREAM, 0);
+    /* Listener socket initialization, accepted connections are served from the same epoll set. */
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    listener_fd_ = socket(PF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 
-    if (-1 != listener_poll_.fd)
+    if ((-1 != epoll_fd_) && (-1 != listener_fd_))
     {
         /* IP and Port setup. */
         struct sockaddr_in6 address;
@@ -91,7 +102,7 @@ bool TCPv6Agent::init()
         address.sin6_port = htons(uint16_t(agent_port_));
         address.sin6_addr = in6addr_any;
 
-        if (-1 != bind(listener_poll_.fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)))
+        if (-1 != bind(listener_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)))
         {
             /* Log. */
             UXR_AGENT_LOG_DEBUG(
@@ -99,26 +110,13 @@ bool TCPv6Agent::init()
                 "port: {}",
                 agent_port_);
 
-            /* Setup listener poll. */
-            listener_poll_.events = POLLIN;
-
-            /* Setup connections. */
-            for (size_t i = 0; i < poll_fds_.size(); ++i)
-            {
-                poll_fds_[i].fd = -1;
-                poll_fds_[i].events = POLLIN;
-                connections_[i].poll_fd = &poll_fds_[i];
-                connections_[i].id = uint32_t(i);
-                connections_[i].active = false;
-                init_input_buffer(connections_[i].input_buffer);
-                free_connections_.push_back(connections_[i].id);
-            }
-
             /* Init listener. */
-            if (-1 != listen(listener_poll_.fd, TCP_MAX_BACKLOG_CONNECTIONS))
+            struct epoll_event event{};
+            event.events = EPOLLIN | EPOLLET;
+            event.data.u64 = listener_key;
+            if ((-1 != listen(listener_fd_, TCP_MAX_BACKLOG_CONNECTIONS))
+                && (-1 != epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listener_fd_, &event)))
             {
-                running_cond_ = true;
-                listener_thread_ = std::thread(&TCPv6Agent::listener_loop, this);
                 rv = true;
 
                 UXR_AGENT_LOG_INFO(
@@ -154,32 +152,41 @@ bool TCPv6Agent::init()
 
 bool TCPv6Agent::fini()
 {
-    /* Stop listener thread. */
-    running_cond_ = false;
-    if (listener_thread_.joinable())
-    {
-        listener_thread_.join();
-    }
-
     /* Close listener. */
-    if (-1 != listener_poll_.fd)
+    if (-1 != listener_fd_)
     {
-        if (0 == ::close(listener_poll_.fd))
+        if (0 == ::close(listener_fd_))
         {
-            listener_poll_.fd = -1;
+            listener_fd_ = -1;
         }
     }
 
     /* Disconnect clients. */
-    for (auto& conn : connections_)
+    std::vector<std::shared_ptr<TCPv6ConnectionLinux>> connections;
+    std::unique_lock<std::mutex> lock(connections_mtx_);
+    for (const auto& it : connections_)
+    {
+        connections.push_back(it.second);
+    }
+    lock.unlock();
+    for (auto& conn : connections)
     {
-        close_connection(conn);
+        close_connection(*conn);
     }
 
-    std::lock_guard<std::mutex> lock(connections_mtx_);
+    /* Close epoll set. */
+    if (-1 != epoll_fd_)
+    {
+        if (0 == ::close(epoll_fd_))
+        {
+            epoll_fd_ = -1;
+        }
+    }
+
+    lock.lock();
 
     bool rv = false;
-    if ((-1 == listener_poll_.fd) && (active_connections_.empty()))
+    if ((-1 == listener_fd_) && (-1 == epoll_fd_) && (connections_.empty()))
     {
         rv = true;
         UXR_AGENT_LOG_INFO(
@@ -258,92 +265,186 @@ bool TCPv6Agent::send_message(
         TransportRc& transport_rc)
 {
     bool rv = false;
-    uint8_t msg_size_buf[2];
     transport_rc = TransportRc::connection_error;
 
-    std::unique_lock<std::mutex> lock(connections_mtx_);
-    auto it = endpoint_to_connection_map_.find(output_packet.destination);
-    if (it != endpoint_to_connection_map_.end())
+    std::shared_ptr<TCPv6ConnectionLinux> connection = find_connection(output_packet.destination);
+    if (connection)
     {
-        TCPv6ConnectionLinux& connection = connections_.at(it->second);
-        lock.unlock();
+        send_packets_.assign(1, &output_packet);
+        rv = write_packets(*connection, transport_rc);
+    }
 
-        msg_size_buf[0] = uint8_t(0x00FF & output_packet.message->get_len());
-        msg_size_buf[1] = uint8_t((0xFF00 & output_packet.message->get_len()) >> 8);
-        uint8_t n_attemps = 0;
-        uint16_t bytes_sent = 0;
+    return rv;
+}
 
-        /* Send message size. */
-        bool size_sent = false;
-        do
+size_t TCPv6Agent::send_messages(
+        std::vector<OutputPacket<IPv6EndPoint>>& output_packets,
+        TransportRc& transport_rc)
+{
+    /* The packets of the batch addressed to the same connection go out in order in one gather write. */
+    send_done_.assign(output_packets.size(), false);
+    for (size_t i = 0; i < output_packets.size(); ++i)
+    {
+        if (send_done_[i])
         {
-            size_t send_rv = send_data(connection, msg_size_buf, 2, transport_rc);
-            if (0 < send_rv)
-            {
-                bytes_sent += uint16_t(send_rv);
-                size_sent = (bytes_sent == 2);
-            }
-            else
-            {
-                if (TransportRc::ok != transport_rc)
-                {
-                    break;
-                }
-            }
-            ++n_attemps;
+            continue;
         }
-        while (!size_sent && n_attemps < max_attemps);
 
-        /* Send message payload. */
-        bool payload_sent = false;
-        if (size_sent)
+        send_packets_.clear();
+        for (size_t j = i; j < output_packets.size(); ++j)
         {
-            n_attemps = 0;
-            bytes_sent = 0;
-            do
+            if (!send_done_[j] && (output_packets[j].destination == output_packets[i].destination))
             {
-                size_t send_rv =
-                    send_data(
-                        connection,
-                        output_packet.message->get_buf() + bytes_sent,
-                        output_packet.message->get_len() - bytes_sent,
-                        transport_rc);
-                if (0 < send_rv)
-                {
-                    bytes_sent += uint16_t(send_rv);
-                    payload_sent = (bytes_sent == uint16_t(output_packet.message->get_len()));
-                }
-                else
-                {
-                    if (TransportRc::ok != transport_rc)
-                    {
-                        break;
-                    }
-                }
-                ++n_attemps;
+                send_packets_.push_back(&output_packets[j]);
+                send_done_[j] = true;
             }
-            while (!payload_sent && n_attemps < max_attemps);
         }
 
-        if (payload_sent)
+        std::shared_ptr<TCPv6ConnectionLinux> connection = find_connection(output_packets[i].destination);
+        if (connection)
         {
-            rv = true;
+            TransportRc write_rc = TransportRc::ok;
+            write_packets(*connection, write_rc);
+        }
+    }
+
+    /* Connection errors are not server errors, the whole batch is always consumed. */
+    transport_rc = TransportRc::ok;
+    return output_packets.size();
+}
 
+std::shared_ptr<TCPv6ConnectionLinux> TCPv6Agent::find_connection(
+        const IPv6EndPoint& endpoint)
+{
+    /* The connection is kept alive by its reference even if the receiver closes it meanwhile. */
+    std::shared_ptr<TCPv6ConnectionLinux> connection;
+    std::lock_guard<std::mutex> lock(connections_mtx_);
+    auto it = endpoint_to_connection_map_.find(endpoint);
+    if (it != endpoint_to_connection_map_.end())
+    {
+        connection = connections_.at(it->second);
+    }
+    return connection;
+}
+
+std::shared_ptr<TCPv6ConnectionLinux> TCPv6Agent::find_connection(
+        uint32_t connection_id)
+{
+    std::shared_ptr<TCPv6ConnectionLinux> connection;
+    std::lock_guard<std::mutex> lock(connections_mtx_);
+    auto it = connections_.find(connection_id);
+    if (it != connections_.end())
+    {
+        connection = it->second;
+    }
+    return connection;
+}
+
+bool TCPv6Agent::write_packets(
+        TCPv6ConnectionLinux& connection,
+        TransportRc& transport_rc)
+{
+    /* Length prefix and payload of every packet are interleaved in a single iovec array. */
+    send_headers_.resize(send_packets_.size());
+    send_iovecs_.resize(2 * send_packets_.size());
+    for (size_t i = 0; i < send_packets_.size(); ++i)
+    {
+        const OutputMessage& message = *send_packets_[i]->message;
+        send_headers_[i][0] = uint8_t(0x00FF & message.get_len());
+        send_headers_[i][1] = uint8_t((0xFF00 & message.get_len()) >> 8);
+        send_iovecs_[2 * i].iov_base = send_headers_[i].data();
+        send_iovecs_[2 * i].iov_len = send_headers_[i].size();
+        send_iovecs_[2 * i + 1].iov_base = message.get_buf();
+        send_iovecs_[2 * i + 1].iov_len = message.get_len();
+    }
+
+    bool rv = send_iovecs(connection, send_iovecs_.data(), send_iovecs_.size(), transport_rc);
+    if (rv)
+    {
+        for (const auto& output_packet : send_packets_)
+        {
             uint32_t raw_client_key = 0u;
-            Server<IPv6EndPoint>::get_client_key(output_packet.destination, raw_client_key);
+            Server<IPv6EndPoint>::get_client_key(output_packet->destination, raw_client_key);
             UXR_AGENT_LOG_MESSAGE(
                 UXR_DECORATE_YELLOW("[** <<TCP>> **]"),
                 raw_client_key,
-                output_packet.message->get_buf(),
-                output_packet.message->get_len());
+                output_packet->message->get_buf(),
+                output_packet->message->get_len());
         }
+    }
 
-        if (TransportRc::connection_error == transport_rc)
+    if (TransportRc::connection_error == transport_rc)
+    {
+        close_connection(connection);
+    }
+
+    return rv;
+}
+
+bool TCPv6Agent::send_iovecs(
+        TCPv6ConnectionLinux& connection,
+        struct iovec* iovecs,
+        size_t iovcnt,
+        TransportRc& transport_rc)
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(connection.mtx);
+    if (connection.active)
+    {
+        transport_rc = TransportRc::ok;
+        size_t index = 0;
+        size_t total_sent = 0;
+        uint8_t n_attemps = 0;
+        while ((index < iovcnt) && (n_attemps < max_attemps) && (TransportRc::ok == transport_rc))
         {
-            close_connection(connection);
+            struct msghdr msg{};
+            msg.msg_iov = iovecs + index;
+            msg.msg_iovlen = std::min(iovcnt - index, size_t(IOV_MAX));
+            ssize_t bytes_sent = sendmsg(connection.fd, &msg, MSG_NOSIGNAL);
+            if (-1 != bytes_sent)
+            {
+                /* Skip the buffers fully written and trim the one written halfway. */
+                size_t remaining = size_t(bytes_sent);
+                total_sent += remaining;
+                while ((index < iovcnt) && (remaining >= iovecs[index].iov_len))
+                {
+                    remaining -= iovecs[index].iov_len;
+                    ++index;
+                }
+                if (0 < remaining)
+                {
+                    iovecs[index].iov_base = static_cast<uint8_t*>(iovecs[index].iov_base) + remaining;
+                    iovecs[index].iov_len -= remaining;
+                }
+            }
+            else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                /* Non-blocking socket with a full send buffer, wait a bit for room before the next attempt. */
+                struct pollfd poll_fd{connection.fd, POLLOUT, 0};
+                poll(&poll_fd, 1, send_poll_timeout);
+                ++n_attemps;
+            }
+            else if (EINTR == errno)
+            {
+                ++n_attemps;
+            }
+            else
+            {
+                transport_rc = TransportRc::connection_error;
+            }
         }
-    }
+        rv = (index == iovcnt);
 
+        /* A frame cut halfway would break the length-prefix framing of the whole stream. */
+        if (!rv && (0 < total_sent))
+        {
+            transport_rc = TransportRc::connection_error;
+        }
+    }
+    else
+    {
+        transport_rc = TransportRc::connection_error;
+    }
     return rv;
 }
 
@@ -358,21 +459,25 @@ bool TCPv6Agent::open_connection(
         struct sockaddr_in6& sockaddr)
 {
     bool rv = false;
+    std::shared_ptr<TCPv6ConnectionLinux> connection = std::make_shared<TCPv6ConnectionLinux>();
+    connection->fd = fd;
+    std::array<uint8_t, 16> addr{};
+    std::copy(std::begin(sockaddr.sin6_addr.s6_addr), std::end(sockaddr.sin6_addr.s6_addr), addr.begin());
+    connection->endpoint = IPv6EndPoint(addr, sockaddr.sin6_port);
+    connection->active = true;
+    connection->ready = false;
+    init_input_buffer(connection->input_buffer);
+
     std::lock_guard<std::mutex> lock(connections_mtx_);
-    if (!free_connections_.empty())
-    {
-        uint32_t id = free_connections_.front();
-        TCPv6ConnectionLinux& connection = connections_[size_t(id)];
-        connection.poll_fd->fd = fd;
-        std::array<uint8_t, 16> addr{};
-        std::copy(std::begin(sockaddr.sin6_addr.s6_addr), std::end(sockaddr.sin6_addr.s6_addr), addr.begin());
-        connection.endpoint = IPv6EndPoint(addr, sockaddr.sin6_port);
-        connection.active = true;
-        init_input_buffer(connection.input_buffer);
-
-        endpoint_to_connection_map_[connection.endpoint] = connection.id;
-        active_connections_.insert(id);
-        free_connections_.pop_front();
+    connection->id = next_connection_id_++;
+
+    struct epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = connection->id;
+    if (-1 != epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event))
+    {
+        endpoint_to_connection_map_[connection->endpoint] = connection->id;
+        connections_.emplace(connection->id, std::move(connection));
         rv = true;
     }
     return rv;
@@ -382,26 +487,24 @@ bool TCPv6Agent::close_connection(
         TCPv6ConnectionLinux& connection)
 {
     bool rv = false;
-    std::unique_lock<std::mutex> lock(connections_mtx_);
-    auto it_conn = active_connections_.find(connection.id);
-    if (it_conn != active_connections_.end())
+    std::unique_lock<std::mutex> conn_lock(connection.mtx);
+    if (connection.active)
     {
-        lock.unlock();
-        std::unique_lock<std::mutex> conn_lock(connection.mtx);
-        if (0 == ::close(connection.poll_fd->fd))
+        /* Closing the socket also removes it from the epoll set. */
+        ::close(connection.fd);
+        connection.fd = -1;
+        connection.active = false;
+        conn_lock.unlock();
+
+        std::lock_guard<std::mutex> lock(connections_mtx_);
+        auto it = endpoint_to_connection_map_.find(connection.endpoint);
+        if ((it != endpoint_to_connection_map_.end()) && (it->second == connection.id))
         {
-            connection.poll_fd->fd = -1;
-            connection.active = false;
-            conn_lock.unlock();
-
-            lock.lock();
-            endpoint_to_connection_map_.erase(connection.endpoint);
-            active_connections_.erase(it_conn);
-            free_connections_.push_back(connection.id);
-            lock.unlock();
-
-            rv = true;
+            endpoint_to_connection_map_.erase(it);
         }
+        connections_.erase(connection.id);
+
+        rv = true;
     }
     return rv;
 }
@@ -417,88 +520,134 @@ bool TCPv6Agent::read_message(
         int timeout,
         TransportRc& transport_rc)
 {
-    std::unique_lock<std::mutex> lock(connections_mtx_);
-    if (active_connections_.empty())
+    bool rv = false;
+
+    /* Connections left with data by the previous round go first, once each. */
+    for (size_t i = ready_connections_.size(); 0 < i; --i)
     {
-        lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
-        return false;
+        std::shared_ptr<TCPv6ConnectionLinux> connection = find_connection(ready_connections_.front());
+        ready_connections_.pop_front();
+        if (connection)
+        {
+            connection->ready = false;
+            if (read_connection(*connection))
+            {
+                rv = true;
+            }
+        }
     }
-    lock.unlock();
 
-    bool rv = false;
-    int poll_rv = poll(poll_fds_.data(), poll_fds_.size(), timeout);
-    if (0 < poll_rv)
+    /* Then the newly ready sockets, without blocking if there is already something to deliver. */
+    int epoll_rv = epoll_wait(
+        epoll_fd_, epoll_events_.data(), int(epoll_events_.size()), (rv || !ready_connections_.empty()) ? 0 : timeout);
+    if (0 < epoll_rv)
     {
-        for (auto& conn : connections_)
+        /* Only the ready sockets are visited. */
+        for (size_t i = 0; i < size_t(epoll_rv); ++i)
         {
-            if (POLLIN == (POLLIN & conn.poll_fd->revents))
+            const struct epoll_event& event = epoll_events_[i];
+            if (listener_key == event.data.u64)
             {
-                uint16_t bytes_read = read_data(conn, transport_rc);
-                if (TransportRc::ok == transport_rc)
-                {
-                    if (0 < bytes_read)
-                    {
-                        InputPacket<IPv6EndPoint> input_packet;
-                        input_packet.message.reset(new InputMessage(conn.input_buffer.buffer.data(), bytes_read));
-                        input_packet.source = conn.endpoint;
-                        messages_queue_.push(std::move(input_packet));
-                        rv = true;
-                    }
-                }
-                else
-                {
-                    if (TransportRc::connection_error == transport_rc)
-                    {
-                        close_connection(conn);
-                    }
-                }
+                accept_connections();
             }
             else
             {
-                transport_rc = TransportRc::connection_error;
+                /* Those already in the ready list are served on the next round. */
+                std::shared_ptr<TCPv6ConnectionLinux> connection = find_connection(uint32_t(event.data.u64));
+                if (connection && !connection->ready && read_connection(*connection))
+                {
+                    rv = true;
+                }
             }
         }
     }
+
+    if (rv)
+    {
+        transport_rc = TransportRc::ok;
+    }
     else
     {
-        transport_rc = (0 == poll_rv) ? TransportRc::timeout_error : TransportRc::server_error;
+        transport_rc = ((0 <= epoll_rv) || (EINTR == errno))
+            ? TransportRc::timeout_error
+            : TransportRc::server_error;
     }
     return rv;
 }
 
-void TCPv6Agent::listener_loop()
+bool TCPv6Agent::read_connection(
+        TCPv6ConnectionLinux& connection)
 {
-    while (running_cond_)
+    /*
+     * Edge-triggered, the socket shall be drained until it would block. A round reads at most a batch of
+     * messages so that a busy client does not starve the others, the connection then waits in the ready list.
+     */
+    bool rv = false;
+    TransportRc transport_rc = TransportRc::ok;
+    size_t messages = 0;
+    do
     {
-        int poll_rv = poll(&listener_poll_, 1, 100);
-        if (0 < poll_rv)
+        uint16_t bytes_read = read_data(connection, transport_rc);
+        if (0 < bytes_read)
         {
-            if (POLLIN == (POLLIN & listener_poll_.revents))
-            {
-                if (connection_available())
-                {
-                    struct sockaddr_in6 client_addr{};
-                    socklen_t client_addr_len = sizeof(client_addr);
-                    int incoming_fd =
-                        accept(
-                            listener_poll_.fd,
-                            reinterpret_cast<struct sockaddr*>(&client_addr),
-                            &client_addr_len);
-                    if (-1 != incoming_fd)
-                    {
-                        open_connection(incoming_fd, client_addr);
-                    }
-                }
-            }
+            InputPacket<IPv6EndPoint> input_packet;
+            input_packet.message.reset(InputMessage::from_buffer(connection.input_buffer.buffer, bytes_read));
+            input_packet.source = connection.endpoint;
+            messages_queue_.push(std::move(input_packet));
+            rv = true;
         }
+        ++messages;
+    }
+    while ((TransportRc::ok == transport_rc) && (TCP_RECV_BATCH_SIZE > messages));
+
+    if (TransportRc::connection_error == transport_rc)
+    {
+        close_connection(connection);
+    }
+    else if (TransportRc::ok == transport_rc)
+    {
+        connection.ready = true;
+        ready_connections_.push_back(connection.id);
     }
+    return rv;
 }
 
-bool TCPv6Agent::connection_available()
+void TCPv6Agent::accept_connections()
 {
-    std::lock_guard<std::mutex> lock(connections_mtx_);
-    return !free_connections_.empty();
+    /* Edge-triggered, the whole backlog is accepted in one go. */
+    bool accepting = true;
+    while (accepting)
+    {
+        struct sockaddr_in6 client_addr{};
+        socklen_t client_addr_len = sizeof(client_addr);
+        int incoming_fd =
+            accept4(
+                listener_fd_,
+                reinterpret_cast<struct sockaddr*>(&client_addr),
+                &client_addr_len,
+                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (-1 != incoming_fd)
+        {
+            /* Messages are small and answered one by one, Nagle would hold each reply for the delayed ACK. */
+            int nodelay = 1;
+            setsockopt(incoming_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            if (!open_connection(incoming_fd, client_addr))
+            {
+                ::close(incoming_fd);
+            }
+        }
+        else if ((EINTR != errno) && (ECONNABORTED != errno))
+        {
+            accepting = false;
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno))
+            {
+                UXR_AGENT_LOG_ERROR(
+                    UXR_DECORATE_RED("accept error"),
+                    "port: {}, errno: {}",
+                    agent_port_, errno);
+            }
+        }
+    }
 }
 
 size_t TCPv6Agent::recv_data(
@@ -511,23 +660,15 @@ size_t TCPv6Agent::recv_data(
     std::lock_guard<std::mutex> lock(connection.mtx);
     if (connection.active)
     {
-        int poll_rv = poll(connection.poll_fd, 1, 0);
-        if (0 < poll_rv)
+        ssize_t bytes_received = recv(connection.fd, buffer, len, 0);
+        if (0 < bytes_received)
         {
-            ssize_t bytes_received = recv(connection.poll_fd->fd, buffer, len, 0);
-            if (0 < bytes_received)
-            {
-                rv = size_t(bytes_received);
-                transport_rc = TransportRc::ok;
-            }
-            else
-            {
-                transport_rc = TransportRc::connection_error;
-            }
+            rv = size_t(bytes_received);
+            transport_rc = TransportRc::ok;
         }
         else
         {
-            transport_rc = (0 == poll_rv)
+            transport_rc = ((-1 == bytes_received) && ((EAGAIN == errno) || (EWOULDBLOCK == errno)))
                 ? TransportRc::timeout_error
                 : TransportRc::connection_error;
         }
@@ -549,12 +690,19 @@ size_t TCPv6Agent::send_data(
     std::lock_guard<std::mutex> lock(connection.mtx);
     if (connection.active)
     {
-        ssize_t bytes_sent = send(connection.poll_fd->fd, buffer, len, 0);
+        ssize_t bytes_sent = send(connection.fd, buffer, len, 0);
         if (-1 != bytes_sent)
         {
             rv = size_t(bytes_sent);
             transport_rc = TransportRc::ok;
         }
+        else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            /* Non-blocking socket with a full send buffer, wait a bit for room before the next attempt. */
+            struct pollfd poll_fd{connection.fd, POLLOUT, 0};
+            poll(&poll_fd, 1, send_poll_timeout);
+            transport_rc = TransportRc::ok;
+        }
         else
         {
             transport_rc = TransportRc::connection_error;
@@ -414,7 +414,7 @@ bool TCPv6Agent::read_message(
                     if (0 < bytes_read)
                     {
                         InputPacket<IPv6EndPoint> input_packet;
-                        input_packet.message.reset(new InputMessage(conn.input_buffer.buffer.data(), bytes_read));
+                        input_packet.message.reset(InputMessage::from_buffer(conn.input_buffer.buffer, bytes_read));
                         input_packet.source = conn.endpoint;
                         messages_queue_.push(std::move(input_packet));
                         rv = true;
@@ -22,6 +22,7 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <algorithm>
 #include <cstring>
 #include <cerrno>
 
@@ -38,12 +39,36 @@ UDPv6Agent::UDPv6Agent(
         Middleware::Kind middleware_kind)
     : Server<IPv6EndPoint>{middleware_kind}
     , poll_fd_{-1, 0, 0}
-    , buffer_{0}
+    , buffer_(SERVER_BUFFER_SIZE)
+    , recv_buffers_(UDP_RECV_BATCH_SIZE)
+    , recv_iovecs_(UDP_RECV_BATCH_SIZE)
+    , recv_addrs_(UDP_RECV_BATCH_SIZE)
+    , recv_msgs_(UDP_RECV_BATCH_SIZE)
+    , send_iovecs_(UDP_SEND_BATCH_SIZE)
+    , send_addrs_(UDP_SEND_BATCH_SIZE)
+    , send_msgs_(UDP_SEND_BATCH_SIZE)
     , agent_port_{agent_port}
 #ifdef UAGENT_DISCOVERY_PROFILE
     , discovery_server_{*processor_}
 #endif
-{}
+{
+    for (size_t i = 0; i < recv_msgs_.size(); ++i)
+    {
+        recv_buffers_[i].resize(SERVER_BUFFER_SIZE);
+        recv_iovecs_[i].iov_base = recv_buffers_[i].data();
+        recv_iovecs_[i].iov_len = SERVER_BUFFER_SIZE;
+        recv_msgs_[i].msg_hdr.msg_name = &recv_addrs_[i];
+        recv_msgs_[i].msg_hdr.msg_iov = &recv_iovecs_[i];
+        recv_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+    for (size_t i = 0; i < send_msgs_.size(); ++i)
+    {
+        send_msgs_[i].msg_hdr.msg_name = &send_addrs_[i];
+        send_msgs_[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        send_msgs_[i].msg_hdr.msg_iov = &send_iovecs_[i];
+        send_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
 
 UDPv6Agent::~UDPv6Agent()
 {
@@ -180,14 +205,14 @@ bool UDPv6Agent::recv_message(
         ssize_t bytes_received =
             recvfrom(
                 poll_fd_.fd,
-                buffer_,
-                sizeof(buffer_),
+                buffer_.data(),
+                buffer_.size(),
                 0,
                 reinterpret_cast<sockaddr*>(&client_addr),
                 &client_addr_len);
         if (-1 != bytes_received)
         {
-            input_packet.message.reset(new InputMessage(buffer_, size_t(bytes_received)));
+            input_packet.message.reset(InputMessage::from_buffer(buffer_, size_t(bytes_received)));
             std::array<uint8_t, 16> addr{};
             std::copy(std::begin(client_addr.sin6_addr.s6_addr), std::end(client_addr.sin6_addr.s6_addr), addr.begin());
             input_packet.source = IPv6EndPoint(addr, client_addr.sin6_port);
@@ -214,6 +239,71 @@ bool UDPv6Agent::recv_message(
     return rv;
 }
 
+bool UDPv6Agent::recv_messages(
+        std::vector<InputPacket<IPv6EndPoint>>& input_packets,
+        int timeout,
+        TransportRc& transport_rc)
+{
+    if (1 == UDP_RECV_BATCH_SIZE)
+    {
+        return Server<IPv6EndPoint>::recv_messages(input_packets, timeout, transport_rc);
+    }
+
+    bool rv = false;
+    int poll_rv = poll(&poll_fd_, 1, timeout);
+    if (0 < poll_rv)
+    {
+        for (auto& msg : recv_msgs_)
+        {
+            msg.msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        }
+
+        int msgs_received =
+            recvmmsg(
+                poll_fd_.fd,
+                recv_msgs_.data(),
+                static_cast<unsigned int>(recv_msgs_.size()),
+                MSG_DONTWAIT,
+                nullptr);
+        if (0 < msgs_received)
+        {
+            for (int i = 0; i < msgs_received; ++i)
+            {
+                InputPacket<IPv6EndPoint> input_packet;
+                input_packet.message.reset(
+                    InputMessage::from_buffer(recv_buffers_[i], size_t(recv_msgs_[i].msg_len)));
+                recv_iovecs_[i].iov_base = recv_buffers_[i].data();
+                std::array<uint8_t, 16> addr{};
+                std::copy(std::begin(recv_addrs_[i].sin6_addr.s6_addr), std::end(recv_addrs_[i].sin6_addr.s6_addr), addr.begin());
+                input_packet.source = IPv6EndPoint(addr, recv_addrs_[i].sin6_port);
+
+                uint32_t raw_client_key = 0u;
+                Server<IPv6EndPoint>::get_client_key(input_packet.source, raw_client_key);
+                UXR_AGENT_LOG_MESSAGE(
+                    UXR_DECORATE_YELLOW("[==>> UDP <<==]"),
+                    raw_client_key,
+                    input_packet.message->get_buf(),
+                    input_packet.message->get_len());
+
+                input_packets.push_back(std::move(input_packet));
+            }
+            rv = true;
+        }
+        else
+        {
+            transport_rc = ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+                ? TransportRc::timeout_error
+                : TransportRc::server_error;
+        }
+    }
+    else
+    {
+        transport_rc = (0 == poll_rv) ? TransportRc::timeout_error : TransportRc::server_error;
+    }
+
+    return rv;
+}
+
 bool UDPv6Agent::send_message(
         OutputPacket<IPv6EndPoint> output_packet,
         TransportRc& transport_rc)
@@ -258,6 +348,60 @@ bool UDPv6Agent::send_message(
     return rv;
 }
 
+size_t UDPv6Agent::send_messages(
+        std::vector<OutputPacket<IPv6EndPoint>>& output_packets,
+        TransportRc& transport_rc)
+{
+    if (1 == UDP_SEND_BATCH_SIZE)
+    {
+        return Server<IPv6EndPoint>::send_messages(output_packets, transport_rc);
+    }
+
+    size_t sent = 0;
+    while (sent < output_packets.size())
+    {
+        size_t first = sent;
+        size_t batch_size = std::min(output_packets.size() - first, send_msgs_.size());
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            memset(&send_addrs_[i], 0, sizeof(struct sockaddr_in6));
+            send_addrs_[i].sin6_family = AF_INET6;
+            send_addrs_[i].sin6_port = output_packets[first + i].destination.get_port();
+            std::copy(
+                output_packets[first + i].destination.get_addr().begin(),
+                output_packets[first + i].destination.get_addr().end(),
+                send_addrs_[i].sin6_addr.s6_addr);
+            send_iovecs_[i].iov_base = output_packets[first + i].message->get_buf();
+            send_iovecs_[i].iov_len = output_packets[first + i].message->get_len();
+        }
+
+        int msgs_sent = sendmmsg(poll_fd_.fd, send_msgs_.data(), static_cast<unsigned int>(batch_size), 0);
+        if (-1 == msgs_sent)
+        {
+            transport_rc = TransportRc::server_error;
+            break;
+        }
+
+        for (int i = 0; i < msgs_sent; ++i)
+        {
+            const OutputPacket<IPv6EndPoint>& output_packet = output_packets[first + size_t(i)];
+            if (size_t(send_msgs_[i].msg_len) == output_packet.message->get_len())
+            {
+                uint32_t raw_client_key = 0u;
+                Server<IPv6EndPoint>::get_client_key(output_packet.destination, raw_client_key);
+                UXR_AGENT_LOG_MESSAGE(
+                    UXR_DECORATE_YELLOW("[** <<UDP>> **]"),
+                    raw_client_key,
+                    output_packet.message->get_buf(),
+                    output_packet.message->get_len());
+            }
+        }
+        sent += size_t(msgs_sent);
+    }
+
+    return sent;
+}
+
 bool UDPv6Agent::handle_error(
         TransportRc /*transport_rc*/)
 {
@@ -1014,6 +1014,7 @@ size_t dds::xrce::CLIENT_Representation::getCdrSerializedSize(size_t current_ali
     current_alignment += 1 + eprosima::fastcdr::Cdr::alignment(current_alignment, 1);
     if (m_properties)
     {
+        current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
         for (size_t a = 0; a < (*m_properties).size(); ++a)
         {
             current_alignment += (*m_properties).at(a).getCdrSerializedSize(current_alignment);
@@ -1071,6 +1072,7 @@ dds::xrce::AGENT_Representation::AGENT_Representation(const AGENT_Representation
     m_xrce_cookie = x.m_xrce_cookie;
     m_xrce_version = x.m_xrce_version;
     m_xrce_vendor_id = x.m_xrce_vendor_id;
+    m_properties = x.m_properties;
 }
 
 dds::xrce::AGENT_Representation::AGENT_Representation(AGENT_Representation &&x)
@@ -1078,6 +1080,7 @@ dds::xrce::AGENT_Representation::AGENT_Representation(AGENT_Representation &&x)
     m_xrce_cookie = std::move(x.m_xrce_cookie);
     m_xrce_version = std::move(x.m_xrce_version);
     m_xrce_vendor_id = std::move(x.m_xrce_vendor_id);
+    m_properties = std::move(x.m_properties);
 }
 
 dds::xrce::AGENT_Representation& dds::xrce::AGENT_Representation::operator=(const AGENT_Representation &x)
@@ -1085,6 +1088,7 @@ dds::xrce::AGENT_Representation& dds::xrce::AGENT_Representation::operator=(cons
     m_xrce_cookie = x.m_xrce_cookie;
     m_xrce_version = x.m_xrce_version;
     m_xrce_vendor_id = x.m_xrce_vendor_id;
+    m_properties = x.m_properties;
     
     return *this;
 }
@@ -1094,6 +1098,7 @@ dds::xrce::AGENT_Representation& dds::xrce::AGENT_Representation::operator=(AGEN
     m_xrce_cookie = std::move(x.m_xrce_cookie);
     m_xrce_version = std::move(x.m_xrce_version);
     m_xrce_vendor_id = std::move(x.m_xrce_vendor_id);
+    m_properties = std::move(x.m_properties);
     
     return *this;
 }
@@ -1123,6 +1128,7 @@ size_t dds::xrce::AGENT_Representation::getCdrSerializedSize(size_t current_alig
     current_alignment += 1 + eprosima::fastcdr::Cdr::alignment(current_alignment, 1);
     if (m_properties)
     {
+        current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
         for (size_t a = 0; a < (*m_properties).size(); ++a)
         {
             current_alignment += (*m_properties).at(a).getCdrSerializedSize(current_alignment);
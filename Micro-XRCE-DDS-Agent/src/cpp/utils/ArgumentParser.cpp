@@ -32,7 +32,7 @@ bool eprosima::uxr::agent::parser::utils::usage(
     std::stringstream ss;
     ss << "Usage: '" << executable_name_str << " <udp4|udp6|tcp4|tpc6";
 #ifndef _WIN32
-    ss << "|serial|pseudoterminal";
+    ss << "|serial|pseudoterminal|shm";
 #endif // _WIN32
     ss << "> <<args>>'" << std::endl;
     if (no_help)
@@ -55,6 +55,7 @@ eprosima::uxr::agent::TransportKind eprosima::uxr::agent::parser::utils::check_t
 #ifndef _WIN32
     {"serial", eprosima::uxr::agent::TransportKind::SERIAL},
     {"pseudoterminal", eprosima::uxr::agent::TransportKind::PSEUDOTERMINAL},
+    {"shm", eprosima::uxr::agent::TransportKind::SHM},
 #endif // _WIN32
     {"-h", eprosima::uxr::agent::TransportKind::HELP},
     {"--help", eprosima::uxr::agent::TransportKind::HELP}
@@ -30,9 +30,14 @@ class ProxyClient
 {
 public:
     explicit ProxyClient(
-        const dds::xrce::CLIENT_Representation& /*representation*/,
+        const dds::xrce::CLIENT_Representation& representation,
         Middleware::Kind /*middleware_kind*/,
-        std::unordered_map<std::string, std::string>&& properties = {}) {};
+        std::unordered_map<std::string, std::string>&& properties = {})
+        : session_id_(representation.session_id())
+        , session_(SessionInfo{
+                representation.client_key(), representation.session_id(), representation.mtu(),
+                negotiate_nack_window(properties)})
+    {}
 
     ~ProxyClient() = default;
 
@@ -41,10 +46,21 @@ public:
     ProxyClient& operator=(ProxyClient&&) = delete;
     ProxyClient& operator=(const ProxyClient&) = delete;
 
-    MOCK_METHOD0(get_session_id, dds::xrce::SessionId());
-    MOCK_METHOD0(session, Session&());
+    /* Root relies on the session of its clients, so the mock keeps a real one. */
+    dds::xrce::SessionId get_session_id() const { return session_id_; }
+
+    Session& session() { return session_; }
+
+    void reset_session(const std::unordered_map<std::string, std::string>& properties)
+    {
+        session_.reset(negotiate_nack_window(properties));
+    }
 
     void release() {}
+
+private:
+    dds::xrce::SessionId session_id_;
+    Session session_;
 };
 
 } // namespace uxr
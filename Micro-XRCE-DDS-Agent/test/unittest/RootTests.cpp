@@ -85,6 +85,69 @@ TEST_F(RootTests, CreateClientIncompatibleVersion)
     ASSERT_EQ(dds::xrce::STATUS_ERR_INCOMPATIBLE, response.status());
 }
 
+TEST_F(RootTests, CreateClientNackWindow)
+{
+    dds::xrce::CREATE_CLIENT_Payload create_data = generate_create_client_payload();
+    dds::xrce::AGENT_Representation agent_representation;
+    dds::xrce::ResultStatus response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_FALSE(agent_representation.properties());
+
+    dds::xrce::Property nack_window_property;
+    nack_window_property.name(NACK_WINDOW_PROPERTY);
+    nack_window_property.value("1000");
+    create_data.client_representation().properties(dds::xrce::PropertySeq{nack_window_property});
+    create_data.client_representation().session_id(uint8_t(create_data.client_representation().session_id() + 1));
+    response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_TRUE(agent_representation.properties());
+    ASSERT_EQ(1u, agent_representation.properties()->size());
+    ASSERT_EQ(NACK_WINDOW_PROPERTY, agent_representation.properties()->at(0).name());
+
+    uint16_t nack_window = uint16_t(RELIABLE_STREAM_DEPTH - (RELIABLE_STREAM_DEPTH % ACKNACK_BITMAP_WINDOW));
+    nack_window = std::max(nack_window, ACKNACK_BITMAP_WINDOW);
+    ASSERT_EQ(std::to_string(nack_window), agent_representation.properties()->at(0).value());
+}
+
+TEST_F(RootTests, CreateClientNackWindowOnReconnection)
+{
+    dds::xrce::CREATE_CLIENT_Payload create_data = generate_create_client_payload();
+    dds::xrce::Property nack_window_property;
+    nack_window_property.name(NACK_WINDOW_PROPERTY);
+    nack_window_property.value("1000");
+    create_data.client_representation().properties(dds::xrce::PropertySeq{nack_window_property});
+    dds::xrce::AGENT_Representation agent_representation;
+    dds::xrce::ResultStatus response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+
+    uint16_t nack_window = uint16_t(RELIABLE_STREAM_DEPTH - (RELIABLE_STREAM_DEPTH % ACKNACK_BITMAP_WINDOW));
+    nack_window = std::max(nack_window, ACKNACK_BITMAP_WINDOW);
+    ASSERT_TRUE(agent_representation.properties());
+    ASSERT_EQ(std::to_string(nack_window), agent_representation.properties()->at(0).value());
+
+    /* Same session, the client asks for a smaller window. */
+    nack_window_property.value(std::to_string(ACKNACK_BITMAP_WINDOW));
+    create_data.client_representation().properties(dds::xrce::PropertySeq{nack_window_property});
+    dds::xrce::AGENT_Representation reconnection_representation;
+    response = root_.create_client(
+                create_data.client_representation(),
+                reconnection_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_TRUE(reconnection_representation.properties());
+    ASSERT_EQ(std::to_string(ACKNACK_BITMAP_WINDOW), reconnection_representation.properties()->at(0).value());
+    ASSERT_EQ(ACKNACK_BITMAP_WINDOW, root_.get_client(client_key)->session().nack_window());
+}
+
 TEST_F(RootTests, DeleteExistingClient)
 {
     dds::xrce::CREATE_CLIENT_Payload create_data = generate_create_client_payload();
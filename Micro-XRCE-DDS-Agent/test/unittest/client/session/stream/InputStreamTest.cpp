@@ -266,6 +266,34 @@ TEST_F(ReliableInputStreamTest, PushPopMessage)
     ASSERT_FALSE(reliable_stream_.pop_message(input_message));
 }
 
+TEST_F(ReliableInputStreamTest, HoldMessage)
+{
+    uint8_t buf[128] = {0};
+    InputMessagePtr input_message;
+
+    reliable_stream_.emplace_message(0x0000, buf, sizeof(buf));
+    reliable_stream_.emplace_message(0x0001, buf, sizeof(buf));
+    ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    uint8_t* held_buf = input_message->get_buf();
+
+    /* The message held back is not acknowledged, neither reported as missing. */
+    reliable_stream_.hold_message(std::move(input_message));
+    dds::xrce::ACKNACK_Payload acknack;
+    reliable_stream_.fill_acknack(acknack);
+    ASSERT_EQ(acknack.first_unacked_seq_num(), 0x0000);
+    ASSERT_EQ(acknack.nack_bitmap().at(0), 0x00);
+    ASSERT_EQ(acknack.nack_bitmap().at(1), 0x00);
+    ASSERT_FALSE(reliable_stream_.emplace_message(0x0000, buf, sizeof(buf)));
+
+    /* It is popped again first, then the following ones. */
+    ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    ASSERT_EQ(input_message->get_buf(), held_buf);
+    ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    ASSERT_FALSE(reliable_stream_.pop_message(input_message));
+    reliable_stream_.fill_acknack(acknack);
+    ASSERT_EQ(acknack.first_unacked_seq_num(), 0x0002);
+}
+
 TEST_F(ReliableInputStreamTest, Reset)
 {
     uint8_t buf[128] = {0};
@@ -299,6 +327,35 @@ TEST_F(ReliableInputStreamTest, UpdateFromHeartbeat)
     ASSERT_TRUE (reliable_stream_.emplace_message(0x0001, buf, sizeof(buf)));
 }
 
+TEST_F(ReliableInputStreamTest, UpdateFromHeartbeatDiscards)
+{
+    uint8_t buf[128] = {0};
+    InputMessagePtr input_message;
+
+    /* Window across the sequence number wrap, with the first message lost. */
+    reliable_stream_.update_from_heartbeat(0x7FFF, 0x7FFE);
+    reliable_stream_.update_from_heartbeat(0xFFFE, 0xFFFD);
+    for (uint16_t i = 0; i < RELIABLE_STREAM_DEPTH - 1; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.emplace_message(SeqNum(0xFFFF) + SeqNum(i), buf, sizeof(buf)));
+    }
+    ASSERT_FALSE(reliable_stream_.pop_message(input_message));
+
+    /* The writer gives up on it, the rest are popped in order. */
+    reliable_stream_.update_from_heartbeat(0xFFFF, 0xFFFF);
+    for (uint16_t i = 0; i < RELIABLE_STREAM_DEPTH - 1; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    }
+    ASSERT_FALSE(reliable_stream_.pop_message(input_message));
+
+    dds::xrce::ACKNACK_Payload acknack;
+    reliable_stream_.fill_acknack(acknack);
+    ASSERT_EQ(acknack.first_unacked_seq_num(), SeqNum(0xFFFF) + SeqNum(RELIABLE_STREAM_DEPTH - 1));
+    ASSERT_EQ(acknack.nack_bitmap().at(0), 0x00);
+    ASSERT_EQ(acknack.nack_bitmap().at(1), 0x00);
+}
+
 TEST_F(ReliableInputStreamTest, FillAcknack)
 {
     uint8_t buf[128] = {0};
@@ -340,6 +397,79 @@ TEST_F(ReliableInputStreamTest, FillAcknack)
     }
 }
 
+TEST_F(ReliableInputStreamTest, FillNackRanges)
+{
+    uint8_t buf[128] = {0};
+
+    std::vector<dds::xrce::ACKNACK_Payload> nack_ranges;
+    reliable_stream_.fill_nack_ranges(RELIABLE_STREAM_DEPTH, nack_ranges);
+    ASSERT_TRUE(nack_ranges.empty());
+
+    /* Only the last message of the window is received, every range but the last one is full. */
+    reliable_stream_.emplace_message(RELIABLE_STREAM_DEPTH - 1, buf, sizeof(buf));
+    reliable_stream_.fill_nack_ranges(ACKNACK_BITMAP_WINDOW, nack_ranges);
+    ASSERT_TRUE(nack_ranges.empty());
+
+    reliable_stream_.fill_nack_ranges(RELIABLE_STREAM_DEPTH, nack_ranges);
+    const size_t expected_ranges = (RELIABLE_STREAM_DEPTH - 1) / ACKNACK_BITMAP_WINDOW;
+    ASSERT_EQ(nack_ranges.size(), expected_ranges);
+    for (size_t i = 0; i < expected_ranges; ++i)
+    {
+        uint16_t offset = uint16_t((i + 1) * ACKNACK_BITMAP_WINDOW);
+        size_t range_size = std::min(size_t(RELIABLE_STREAM_DEPTH - 1 - offset), size_t(ACKNACK_BITMAP_WINDOW));
+        uint16_t raw_bitmap = uint16_t((uint32_t(1) << range_size) - 1);
+        ASSERT_EQ(nack_ranges[i].first_unacked_seq_num(), offset);
+        ASSERT_EQ(nack_ranges[i].nack_bitmap().at(0), (raw_bitmap & 0xFF00) >> 8);
+        ASSERT_EQ(nack_ranges[i].nack_bitmap().at(1), raw_bitmap & 0x00FF);
+    }
+
+    /* Ranges without missing messages are not reported. */
+    for (uint16_t i = ACKNACK_BITMAP_WINDOW; i < RELIABLE_STREAM_DEPTH - 1; ++i)
+    {
+        reliable_stream_.emplace_message(i, buf, sizeof(buf));
+    }
+    nack_ranges.clear();
+    reliable_stream_.fill_nack_ranges(RELIABLE_STREAM_DEPTH, nack_ranges);
+    ASSERT_TRUE(nack_ranges.empty());
+}
+
+TEST_F(ReliableInputStreamTest, FragmentReassembly)
+{
+    const std::array<uint16_t, 3> fragment_sizes{{300, 6000, 100}};
+    std::vector<uint8_t> expected{0x81, 0x80, 0x00, 0x00};
+    uint8_t pattern = 0;
+
+    InputMessagePtr message;
+    for (size_t i = 0; i < fragment_sizes.size(); ++i)
+    {
+        ASSERT_FALSE(reliable_stream_.pop_fragment_message(message));
+
+        uint8_t flags = dds::xrce::FLAG_LITTLE_ENDIANNESS;
+        if ((fragment_sizes.size() - 1) == i)
+        {
+            flags |= dds::xrce::FLAG_LAST_FRAGMENT;
+        }
+        std::vector<uint8_t> raw{0x81, 0x80, uint8_t(i), 0x00,
+                                 dds::xrce::FRAGMENT, flags,
+                                 uint8_t(fragment_sizes[i] & 0xFF), uint8_t(fragment_sizes[i] >> 8)};
+        for (uint16_t j = 0; j < fragment_sizes[i]; ++j)
+        {
+            raw.push_back(pattern);
+            expected.push_back(pattern);
+            ++pattern;
+        }
+
+        message.reset(new InputMessage(raw.data(), raw.size()));
+        ASSERT_TRUE(message->prepare_next_submessage());
+        reliable_stream_.push_fragment(message);
+    }
+
+    ASSERT_TRUE(reliable_stream_.pop_fragment_message(message));
+    ASSERT_FALSE(reliable_stream_.pop_fragment_message(message));
+    ASSERT_EQ(expected.size(), message->get_len());
+    ASSERT_EQ(0, memcmp(expected.data(), message->get_buf(), expected.size()));
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
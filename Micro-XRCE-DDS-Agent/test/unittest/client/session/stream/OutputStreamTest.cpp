@@ -17,6 +17,7 @@
 #include <map>
 #include <queue>
 #include <mutex>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -36,7 +37,7 @@ class NoneOutputStreamTest : public ::testing::Test
 public:
     NoneOutputStreamTest()
         : none_stream_{}
-        , session_info_{client_key, session_id, mtu}
+        , session_info_{client_key, session_id, mtu, ACKNACK_BITMAP_WINDOW}
     {}
 
 public:
@@ -93,7 +94,7 @@ class BestEffortOutputStreamTest : public ::testing::Test
 public:
     BestEffortOutputStreamTest()
         : best_effort_stream_{}
-        , session_info_{client_key, session_id, mtu}
+        , session_info_{client_key, session_id, mtu, ACKNACK_BITMAP_WINDOW}
         , stream_id_{dds::xrce::STREAMID_BUILTIN_BEST_EFFORTS}
     {}
 
@@ -144,6 +145,53 @@ TEST_F(BestEffortOutputStreamTest, MaximumMessageSize)
     ASSERT_FALSE(best_effort_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
 }
 
+/**
+ * @brief   This test checks the coalescing of submessages.
+ *          Coalesced submessages shall share a message until it is full, and the last message
+ *          shall be held back until its flush time.
+ */
+TEST_F(BestEffortOutputStreamTest, Coalescing)
+{
+    dds::xrce::MessageHeader header{};
+    dds::xrce::SubmessageHeader subheader{};
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(16);
+
+    const size_t submessage_size = subheader.getCdrSerializedSize() + write_data.getCdrSerializedSize();
+    const size_t submessages_per_message = (mtu - header.getCdrSerializedSize()) / submessage_size;
+
+    /* Lingering message. */
+    std::chrono::steady_clock::time_point flush_time;
+    OutputMessagePtr output_message;
+    for (size_t i = 0; i < submessages_per_message; ++i)
+    {
+        ASSERT_TRUE(best_effort_stream_.push_submessage(
+            session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    }
+    ASSERT_TRUE(best_effort_stream_.get_flush_time(flush_time));
+    std::this_thread::sleep_until(flush_time);
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message));
+    ASSERT_EQ(header.getCdrSerializedSize() + submessages_per_message * submessage_size, output_message->get_len());
+    ASSERT_FALSE(best_effort_stream_.pop_message(output_message));
+    ASSERT_FALSE(best_effort_stream_.get_flush_time(flush_time));
+
+    /* Full messages are not held back. */
+    for (size_t i = 0; i < submessages_per_message + 1; ++i)
+    {
+        ASSERT_TRUE(best_effort_stream_.push_submessage(
+            session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    }
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message));
+    ASSERT_EQ(header.getCdrSerializedSize() + submessages_per_message * submessage_size, output_message->get_len());
+
+    /* A submessage that is not coalesced releases the lingering message. */
+    ASSERT_TRUE(best_effort_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message));
+    ASSERT_EQ(header.getCdrSerializedSize() + submessage_size, output_message->get_len());
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message));
+    ASSERT_FALSE(best_effort_stream_.pop_message(output_message));
+}
+
 /****************************************************************************************
  * Reliable Output Stream.
  ****************************************************************************************/
@@ -152,7 +200,7 @@ class ReliableOutputStreamTest : public ::testing::Test
 public:
     ReliableOutputStreamTest()
         : reliable_stream_{}
-        , session_info_{client_key, session_id, mtu}
+        , session_info_{client_key, session_id, mtu, ACKNACK_BITMAP_WINDOW}
         , stream_id_{dds::xrce::STREAMID_BUILTIN_RELIABLE}
     {}
 
@@ -466,6 +514,342 @@ TEST_F(ReliableOutputStreamTest, UpdateFromAcknack)
     ASSERT_EQ(hearbeat.last_unacked_seq_nr(), expected_last_unacked);
 }
 
+/**
+ * @brief   This test checks the writable notifications.
+ *          A full stream shall call the notifiers once an acknowledgement makes room, and only then.
+ */
+TEST_F(ReliableOutputStreamTest, WritableNotification)
+{
+    int notifications = 0;
+    auto notifier = [&notifications]() { ++notifications; };
+
+    /* Room left, notified right away. */
+    reliable_stream_.notify_when_writable(notifier);
+    ASSERT_EQ(1, notifications);
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    OutputMessagePtr output_message;
+    for (int i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(
+            session_info_,
+            stream_id_,
+            dds::xrce::WRITE_DATA,
+            write_data,
+            std::chrono::milliseconds(0)));
+        ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    }
+    ASSERT_FALSE(reliable_stream_.push_submessage(
+        session_info_,
+        stream_id_,
+        dds::xrce::WRITE_DATA,
+        write_data,
+        std::chrono::milliseconds(0)));
+
+    /* Full, kept until an acknowledgement moves the window. */
+    reliable_stream_.notify_when_writable(notifier);
+    ASSERT_EQ(1, notifications);
+    reliable_stream_.update_from_acknack(0x0000);
+    ASSERT_EQ(1, notifications);
+    reliable_stream_.update_from_acknack(0x0001);
+    ASSERT_EQ(2, notifications);
+    ASSERT_TRUE(reliable_stream_.push_submessage(
+        session_info_,
+        stream_id_,
+        dds::xrce::WRITE_DATA,
+        write_data,
+        std::chrono::milliseconds(0)));
+
+    /* Called once. */
+    reliable_stream_.update_from_acknack(0x0002);
+    ASSERT_EQ(2, notifications);
+}
+
+/**
+ * @brief   This test checks the coalescing of submessages.
+ *          Coalesced submessages shall share a sequence number until the message is full,
+ *          and the last message shall be held back until its flush time.
+ */
+TEST_F(ReliableOutputStreamTest, Coalescing)
+{
+    dds::xrce::MessageHeader header{};
+    dds::xrce::SubmessageHeader subheader{};
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(16);
+
+    const size_t submessage_size = subheader.getCdrSerializedSize() + write_data.getCdrSerializedSize();
+    const size_t submessages_per_message = (mtu - header.getCdrSerializedSize()) / submessage_size;
+
+    for (size_t i = 0; i < submessages_per_message + 1; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(
+            session_info_,
+            stream_id_,
+            dds::xrce::WRITE_DATA,
+            write_data,
+            std::chrono::milliseconds(500),
+            true));
+    }
+
+    dds::xrce::HEARTBEAT_Payload hearbeat;
+    reliable_stream_.fill_heartbeat(hearbeat);
+    ASSERT_EQ(hearbeat.first_unacked_seq_nr(), 0x0000);
+    ASSERT_EQ(hearbeat.last_unacked_seq_nr(), 0x0001);
+
+    /* The full message is sent at once, the last one is held back. */
+    std::chrono::steady_clock::time_point flush_time;
+    OutputMessagePtr output_message;
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_EQ(header.getCdrSerializedSize() + submessages_per_message * submessage_size, output_message->get_len());
+    ASSERT_TRUE(reliable_stream_.get_flush_time(flush_time));
+    std::this_thread::sleep_until(flush_time);
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_EQ(header.getCdrSerializedSize() + submessage_size, output_message->get_len());
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message));
+    ASSERT_FALSE(reliable_stream_.get_flush_time(flush_time));
+
+    /* Once handed out, a message is not appended to anymore. */
+    ASSERT_TRUE(reliable_stream_.push_submessage(
+        session_info_,
+        stream_id_,
+        dds::xrce::WRITE_DATA,
+        write_data,
+        std::chrono::milliseconds(500),
+        true));
+    ASSERT_TRUE(reliable_stream_.get_message(0x0002, output_message));
+    ASSERT_TRUE(reliable_stream_.push_submessage(
+        session_info_,
+        stream_id_,
+        dds::xrce::WRITE_DATA,
+        write_data,
+        std::chrono::milliseconds(500),
+        true));
+    reliable_stream_.fill_heartbeat(hearbeat);
+    ASSERT_EQ(hearbeat.last_unacked_seq_nr(), 0x0003);
+}
+
+/**
+ * @brief   This test checks the retransmission timeout of the stream.
+ *          It shall be derived from the acknowledged messages sent once, ignoring the retransmitted ones,
+ *          and doubled on each back-off until the next acknowledgement.
+ */
+TEST_F(ReliableOutputStreamTest, RetransmissionTimeout)
+{
+    const std::chrono::milliseconds initial_rto(HEARTBEAT_PERIOD);
+    ASSERT_EQ(reliable_stream_.get_retransmission_timeout(), initial_rto);
+    reliable_stream_.back_off_retransmission();
+    ASSERT_EQ(reliable_stream_.get_retransmission_timeout(),
+              std::min(2 * initial_rto, std::chrono::milliseconds(HEARTBEAT_MAX_PERIOD)));
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    OutputMessagePtr output_message;
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(
+            session_info_,
+            stream_id_,
+            dds::xrce::WRITE_DATA,
+            write_data,
+            std::chrono::milliseconds(500)));
+        ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    }
+
+    /* A short round-trip time shortens the timeout, down to its lower bound. */
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    reliable_stream_.update_from_acknack(0x0001);
+    const std::chrono::milliseconds measured_rto = reliable_stream_.get_retransmission_timeout();
+    ASSERT_GE(measured_rto, std::chrono::milliseconds(HEARTBEAT_MIN_PERIOD));
+    ASSERT_LT(measured_rto, initial_rto);
+
+    /* A retransmitted message does not give a sample. */
+    ASSERT_TRUE(reliable_stream_.get_message(0x0001, output_message));
+    std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_PERIOD));
+    reliable_stream_.update_from_acknack(0x0002);
+    ASSERT_EQ(reliable_stream_.get_retransmission_timeout(), measured_rto);
+
+    /* The back-off is undone by the acknowledgements. */
+    ASSERT_TRUE(reliable_stream_.push_submessage(
+        session_info_,
+        stream_id_,
+        dds::xrce::WRITE_DATA,
+        write_data,
+        std::chrono::milliseconds(500)));
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    reliable_stream_.back_off_retransmission();
+    ASSERT_GT(reliable_stream_.get_retransmission_timeout(), measured_rto);
+    ASSERT_TRUE(reliable_stream_.get_message(0x0002, output_message));
+    reliable_stream_.update_from_acknack(0x0003);
+    ASSERT_EQ(reliable_stream_.get_retransmission_timeout(), measured_rto);
+}
+
+/**
+ * @brief   This test checks the congestion control of the stream.
+ *          A loss shall shrink the window, hold back the new messages until the acknowledgements
+ *          free it, and be reported in the stats.
+ */
+TEST_F(ReliableOutputStreamTest, CongestionControl)
+{
+    reliable_stream_.set_congestion_controller(
+        std::unique_ptr<CongestionController>(new AimdCongestionController(RELIABLE_STREAM_DEPTH)));
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    OutputMessagePtr output_message;
+    for (int i = 0; i < RELIABLE_STREAM_DEPTH - 1; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(
+            session_info_,
+            stream_id_,
+            dds::xrce::WRITE_DATA,
+            write_data,
+            std::chrono::milliseconds(0)));
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    }
+
+    ReliableOutputStream::Stats stats = reliable_stream_.get_stats();
+    ASSERT_EQ(stats.window, RELIABLE_STREAM_DEPTH);
+    ASSERT_EQ(stats.in_flight, 4);
+    ASSERT_EQ(stats.sent, 4u);
+
+    /* A NACK of the first message halves the window. */
+    ASSERT_TRUE(reliable_stream_.get_message(0x0000, output_message));
+    stats = reliable_stream_.get_stats();
+    ASSERT_EQ(stats.window, RELIABLE_STREAM_DEPTH / 2);
+    ASSERT_EQ(stats.retransmitted, 1u);
+    ASSERT_EQ(stats.loss_events, 1u);
+
+    /* The losses of the same window do not shrink it again. */
+    ASSERT_TRUE(reliable_stream_.get_message(0x0002, output_message));
+    stats = reliable_stream_.get_stats();
+    ASSERT_EQ(stats.window, RELIABLE_STREAM_DEPTH / 2);
+    ASSERT_EQ(stats.retransmitted, 2u);
+    ASSERT_EQ(stats.loss_events, 1u);
+
+    /* No more than the window in flight. */
+    while (reliable_stream_.get_next_message(output_message))
+    {}
+    ASSERT_EQ(reliable_stream_.get_stats().in_flight, RELIABLE_STREAM_DEPTH / 2);
+
+    /* The acknowledgements release the held back messages. */
+    reliable_stream_.update_from_acknack(0x0002);
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message));
+
+    /* A timeout restarts from the minimum window. */
+    reliable_stream_.back_off_retransmission();
+    stats = reliable_stream_.get_stats();
+    ASSERT_EQ(stats.window, 1);
+    ASSERT_EQ(stats.timeouts, 1u);
+
+    /* Without congestion control the depth of the stream is the only bound. */
+    reliable_stream_.set_congestion_controller(nullptr);
+    while (reliable_stream_.get_next_message(output_message))
+    {}
+    stats = reliable_stream_.get_stats();
+    ASSERT_EQ(stats.window, RELIABLE_STREAM_DEPTH);
+    ASSERT_EQ(stats.in_flight, RELIABLE_STREAM_DEPTH - 3);
+    ASSERT_EQ(stats.pacing_rate, 0u);
+}
+
+/**
+ * @brief   This test checks the retransmissions of the stream.
+ *          A message shall not be retransmitted again within the smoothed round-trip time.
+ */
+TEST_F(ReliableOutputStreamTest, RetransmissionSuppression)
+{
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    OutputMessagePtr output_message;
+    auto push_and_send = [&]()
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(
+            session_info_,
+            stream_id_,
+            dds::xrce::WRITE_DATA,
+            write_data,
+            std::chrono::milliseconds(500)));
+        ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    };
+
+    /* No round-trip time yet, every NACK is answered. */
+    push_and_send();
+    ASSERT_TRUE(reliable_stream_.get_message(0x0000, output_message));
+    ASSERT_TRUE(reliable_stream_.get_message(0x0000, output_message));
+
+    push_and_send();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    reliable_stream_.update_from_acknack(0x0002);
+    ASSERT_GE(reliable_stream_.get_stats().srtt, std::chrono::milliseconds(5));
+
+    /* The NACKs received before the retransmission could arrive are ignored. */
+    push_and_send();
+    push_and_send();
+    ASSERT_TRUE(reliable_stream_.get_message(0x0002, output_message));
+    ASSERT_FALSE(reliable_stream_.get_message(0x0002, output_message));
+    ASSERT_TRUE(reliable_stream_.get_message(0x0003, output_message));
+    std::this_thread::sleep_for(reliable_stream_.get_stats().srtt);
+    ASSERT_TRUE(reliable_stream_.get_message(0x0002, output_message));
+    ASSERT_EQ(reliable_stream_.get_stats().retransmitted, 5u);
+}
+
+/****************************************************************************************
+ * AIMD Congestion Controller.
+ ****************************************************************************************/
+TEST(AimdCongestionControllerTest, WindowEvolution)
+{
+    AimdCongestionController controller(16, 2);
+    ASSERT_EQ(controller.window(), 16);
+
+    /* Multiplicative decrease, once per window of messages. */
+    controller.on_loss(10, 25);
+    ASSERT_EQ(controller.window(), 8);
+    controller.on_loss(20, 25);
+    ASSERT_EQ(controller.window(), 8);
+    controller.on_loss(26, 33);
+    ASSERT_EQ(controller.window(), 4);
+
+    /* Additive increase, one message per window acknowledged. */
+    controller.on_acknowledged(3);
+    ASSERT_EQ(controller.window(), 4);
+    controller.on_acknowledged(1);
+    ASSERT_EQ(controller.window(), 5);
+    controller.on_acknowledged(5);
+    ASSERT_EQ(controller.window(), 6);
+
+    /* Slow start after a timeout, up to half the previous window. */
+    controller.on_timeout();
+    ASSERT_EQ(controller.window(), 2);
+    controller.on_acknowledged(1);
+    ASSERT_EQ(controller.window(), 3);
+    controller.on_acknowledged(2);
+    ASSERT_EQ(controller.window(), 3);
+
+    /* The window never exceeds its bounds. */
+    for (int i = 0; i < 1000; ++i)
+    {
+        controller.on_acknowledged(16);
+    }
+    ASSERT_EQ(controller.window(), 16);
+    for (uint16_t i = 0; i < 10; ++i)
+    {
+        controller.on_timeout();
+    }
+    ASSERT_EQ(controller.window(), 2);
+}
+
+TEST(AimdCongestionControllerTest, PacingRate)
+{
+    AimdCongestionController controller(16);
+    ASSERT_EQ(controller.pacing_rate(std::chrono::microseconds(0), mtu), 0u);
+
+    /* Twice the window per round-trip time. */
+    ASSERT_EQ(controller.pacing_rate(std::chrono::milliseconds(10), mtu), 2 * 16 * mtu * 100);
+    controller.on_loss(0, 15);
+    ASSERT_EQ(controller.pacing_rate(std::chrono::milliseconds(10), mtu), 2 * 8 * mtu * 100);
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
@@ -0,0 +1,260 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/client/session/stream/InputStream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Previous ReliableInputStream reordering, kept as the baseline of the benchmark.
+ */
+class MapReliableInputStream
+{
+public:
+    MapReliableInputStream()
+        : last_handled_(UINT16_MAX)
+        , last_announced_(UINT16_MAX)
+    {}
+
+    template<typename ... Args>
+    bool emplace_message(
+            SeqNum seq_num,
+            Args ... args)
+    {
+        bool rv = false;
+        if ((seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH)))
+        {
+            if (seq_num > last_announced_)
+            {
+                last_announced_ = seq_num;
+            }
+            if (messages_.end() == messages_.find(seq_num))
+            {
+                messages_.emplace(seq_num, InputMessagePtr(new InputMessage(std::forward<Args>(args)...)));
+                rv = true;
+            }
+        }
+        return rv;
+    }
+
+    bool pop_message(
+            InputMessagePtr& message)
+    {
+        bool rv = false;
+        auto it = messages_.find(last_handled_ + 1);
+        if (it != messages_.end())
+        {
+            last_handled_ += 1;
+            message = std::move(messages_.at(last_handled_));
+            messages_.erase(last_handled_);
+            rv = true;
+        }
+        return rv;
+    }
+
+    void update_from_heartbeat(
+            SeqNum first_unacked,
+            SeqNum last_unacked)
+    {
+        if (last_handled_ + 1 < first_unacked)
+        {
+            last_handled_ = first_unacked - 1;
+        }
+        if (last_announced_ < last_unacked)
+        {
+            last_announced_ = last_unacked;
+        }
+    }
+
+    void fill_acknack(
+            dds::xrce::ACKNACK_Payload& acknack)
+    {
+        acknack.nack_bitmap() = {0, 0};
+        acknack.first_unacked_seq_num(last_handled_ + 1);
+        for (uint16_t i = 0; i < 8; i++)
+        {
+            if ((last_handled_ + SeqNum(i) < last_announced_)
+                && (messages_.end() == messages_.find(last_handled_ + SeqNum(i + 1))))
+            {
+                acknack.nack_bitmap().at(1) = uint8_t(acknack.nack_bitmap().at(1) | (0x01 << i));
+            }
+            if ((last_handled_ + SeqNum(i + 8) < last_announced_)
+                && (messages_.end() == messages_.find(last_handled_ + SeqNum(i + 9))))
+            {
+                acknack.nack_bitmap().at(0) = uint8_t(acknack.nack_bitmap().at(0) | (0x01 << i));
+            }
+        }
+    }
+
+private:
+    SeqNum last_handled_;
+    SeqNum last_announced_;
+    std::map<uint16_t, InputMessagePtr> messages_;
+};
+
+/**
+ * Lossy link between a reliable writer and the input stream: every round the writer announces its
+ * last sequence number, reads the ACKNACK and sends the NACKed messages plus the new ones that fit
+ * in the window, shuffled and with a fixed loss ratio.
+ */
+class ReliableInputStreamBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr size_t total_messages = 300000;
+    static constexpr double loss_ratio = 0.1;
+
+    struct LinkStats
+    {
+        size_t delivered;
+        size_t rounds;
+        bool ordered;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    template<typename Stream>
+    struct LossyLink
+    {
+        LossyLink()
+            : generator(42)
+            , loss(loss_ratio)
+            , first_unacked(0)
+            , next_seq_num(0)
+            , sent(0)
+            , stats{0, 0, true, std::chrono::nanoseconds(0)}
+        {}
+
+        /*
+         * One round of the link, returns the ACKNACK read by the writer at the beginning of it.
+         */
+        dds::xrce::ACKNACK_Payload round()
+        {
+            dds::xrce::ACKNACK_Payload acknack;
+            std::vector<SeqNum> outgoing;
+            uint8_t buf[16] = {0};
+
+            auto start = std::chrono::steady_clock::now();
+            stream.update_from_heartbeat(first_unacked, next_seq_num - 1);
+            stream.fill_acknack(acknack);
+            stats.elapsed += std::chrono::steady_clock::now() - start;
+
+            first_unacked = acknack.first_unacked_seq_num();
+            uint16_t bitmap = uint16_t((uint16_t(acknack.nack_bitmap().at(0)) << 8) | acknack.nack_bitmap().at(1));
+            for (uint16_t i = 0; i < 16; ++i)
+            {
+                if (0 != (bitmap & (1 << i)))
+                {
+                    outgoing.push_back(first_unacked + SeqNum(i));
+                }
+            }
+            while ((uint16_t(next_seq_num - first_unacked) < RELIABLE_STREAM_DEPTH) && (sent < total_messages))
+            {
+                outgoing.push_back(next_seq_num);
+                ++next_seq_num;
+                ++sent;
+            }
+            std::shuffle(outgoing.begin(), outgoing.end(), generator);
+
+            InputMessagePtr message;
+            start = std::chrono::steady_clock::now();
+            for (const auto& seq_num : outgoing)
+            {
+                if (!loss(generator))
+                {
+                    stream.emplace_message(seq_num, buf, sizeof(buf));
+                }
+            }
+            while (stream.pop_message(message))
+            {
+                ++stats.delivered;
+            }
+            stats.elapsed += std::chrono::steady_clock::now() - start;
+
+            ++stats.rounds;
+            return acknack;
+        }
+
+        Stream stream;
+        std::mt19937 generator;
+        std::bernoulli_distribution loss;
+        SeqNum first_unacked;
+        SeqNum next_seq_num;
+        size_t sent;
+        LinkStats stats;
+    };
+
+    template<typename Stream>
+    void run(
+            const char* name)
+    {
+        LossyLink<Stream> link;
+        while ((link.stats.delivered < total_messages) && (link.stats.rounds < 100 * total_messages))
+        {
+            link.round();
+        }
+        ASSERT_EQ(total_messages, link.stats.delivered);
+
+        double seconds = std::chrono::duration<double>(link.stats.elapsed).count();
+        std::cout << "[ BENCHMARK] " << name << ": "
+                  << static_cast<uint64_t>(double(link.stats.delivered) / seconds) << " messages/s, "
+                  << link.stats.rounds << " rounds" << std::endl;
+    }
+};
+
+constexpr size_t ReliableInputStreamBenchmark::total_messages;
+constexpr double ReliableInputStreamBenchmark::loss_ratio;
+
+TEST_F(ReliableInputStreamBenchmark, same_acknacks_as_baseline)
+{
+    LossyLink<ReliableInputStream> ring_link;
+    LossyLink<MapReliableInputStream> map_link;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        dds::xrce::ACKNACK_Payload ring_acknack = ring_link.round();
+        dds::xrce::ACKNACK_Payload map_acknack = map_link.round();
+        ASSERT_EQ(map_acknack.first_unacked_seq_num(), ring_acknack.first_unacked_seq_num());
+        ASSERT_EQ(map_acknack.nack_bitmap(), ring_acknack.nack_bitmap());
+    }
+    ASSERT_EQ(map_link.stats.delivered, ring_link.stats.delivered);
+}
+
+TEST_F(ReliableInputStreamBenchmark, map)
+{
+    run<MapReliableInputStream>("map");
+}
+
+TEST_F(ReliableInputStreamBenchmark, ring)
+{
+    run<ReliableInputStream>("ring");
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/message/Packet.hpp>
+#include <uxr/agent/message/MessagePool.hpp>
+#include <uxr/agent/config.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+/* Counts every heap allocation of the process. */
+static std::atomic<uint64_t> heap_allocations{0};
+
+/* Keeps the compiler from eliding the allocations of the reference loop. */
+static void* volatile escaped;
+
+static void escape(void* a, void* b, void* c, void* d)
+{
+    escaped = a;
+    escaped = b;
+    escaped = c;
+    escaped = d;
+}
+
+void* operator new(size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if (nullptr == ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class MessagePoolTest : public ::testing::Test
+{
+protected:
+    static constexpr size_t iterations = 10000;
+    static constexpr size_t mtu = 512;
+
+    MessagePoolTest()
+    {
+        header_.session_id(0x81);
+        header_.stream_id(0x00);
+        header_.sequence_nr(0);
+    }
+
+    /* Receive one datagram and answer it with an ACKNACK and a HEARTBEAT, as the processing path does. */
+    void message_cycle()
+    {
+        std::unique_ptr<InputMessage> input_message(new InputMessage(raw_input_, sizeof(raw_input_)));
+
+        dds::xrce::ACKNACK_Payload acknack;
+        OutputMessagePtr acknack_message = make_output_message(header_, mtu);
+        acknack_message->append_submessage(dds::xrce::ACKNACK, acknack);
+
+        dds::xrce::HEARTBEAT_Payload heartbeat;
+        OutputMessagePtr heartbeat_message = make_output_message(header_, mtu);
+        heartbeat_message->append_submessage(dds::xrce::HEARTBEAT, heartbeat);
+    }
+
+    dds::xrce::MessageHeader header_;
+    uint8_t raw_input_[64] = {0x81, 0x00, 0x00, 0x00};
+};
+
+constexpr size_t MessagePoolTest::iterations;
+constexpr size_t MessagePoolTest::mtu;
+
+TEST_F(MessagePoolTest, steady_state_allocations)
+{
+    /* Before: what one cycle costed with per-message new[] plus the shared_ptr control blocks. */
+    uint64_t start = heap_allocations.load();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        std::unique_ptr<uint8_t[]> input_buffer(new uint8_t[sizeof(raw_input_)]);
+        std::unique_ptr<uint64_t> input_object(new uint64_t);
+        std::unique_ptr<uint8_t[]> acknack_buffer(new uint8_t[mtu]{0});
+        std::unique_ptr<uint8_t[]> heartbeat_buffer(new uint8_t[mtu]{0});
+        std::shared_ptr<uint64_t> acknack_object(new uint64_t);
+        std::shared_ptr<uint64_t> heartbeat_object(new uint64_t);
+        escape(input_buffer.get(), input_object.get(), acknack_buffer.get(), heartbeat_buffer.get());
+        escape(acknack_object.get(), heartbeat_object.get(), nullptr, nullptr);
+    }
+    double before = double(heap_allocations.load() - start) / iterations;
+
+    /* After: warm the pool up and measure. */
+    message_cycle();
+    MessagePool::Stats stats_start = MessagePool::instance().get_stats();
+    start = heap_allocations.load();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        message_cycle();
+    }
+    double after = double(heap_allocations.load() - start) / iterations;
+    MessagePool::Stats stats_end = MessagePool::instance().get_stats();
+
+    std::cout << "[ BENCHMARK] heap allocations per cycle: before " << before << ", after " << after
+              << " (pool blocks: " << (stats_end.allocations - stats_start.allocations) / iterations
+              << " per cycle)" << std::endl;
+
+    ASSERT_EQ(0.0, after);
+    ASSERT_EQ(stats_start.heap_allocations, stats_end.heap_allocations);
+}
+
+TEST_F(MessagePoolTest, block_reuse)
+{
+    void* first = MessagePool::instance().allocate(1000);
+    MessagePool::instance().deallocate(first, 1000);
+    void* second = MessagePool::instance().allocate(600);
+    ASSERT_EQ(first, second);
+    MessagePool::instance().deallocate(second, 600);
+
+    /* Bigger than any size class, straight to the heap. */
+    void* big = MessagePool::instance().allocate(70000);
+    ASSERT_NE(nullptr, big);
+    MessagePool::instance().deallocate(big, 70000);
+}
+
+TEST_F(MessagePoolTest, cache_budget)
+{
+    /* The largest size class keeps MESSAGE_POOL_CACHED_BYTES worth of blocks, not a fixed count. */
+    const size_t block_size = 65536;
+    const size_t cached = MESSAGE_POOL_CACHED_BYTES / block_size;
+    std::vector<void*> blocks(2 * cached + 1);
+
+    for (auto& block : blocks)
+    {
+        block = MessagePool::instance().allocate(block_size);
+    }
+    for (auto& block : blocks)
+    {
+        MessagePool::instance().deallocate(block, block_size);
+    }
+
+    /* Only the budget came back from the cache, the rest of the burst went back to the heap. */
+    MessagePool::Stats stats_start = MessagePool::instance().get_stats();
+    for (auto& block : blocks)
+    {
+        block = MessagePool::instance().allocate(block_size);
+    }
+    MessagePool::Stats stats_end = MessagePool::instance().get_stats();
+    for (auto& block : blocks)
+    {
+        MessagePool::instance().deallocate(block, block_size);
+    }
+
+    ASSERT_EQ(blocks.size() - cached, stats_end.heap_allocations - stats_start.heap_allocations);
+}
+
+TEST_F(MessagePoolTest, output_padding)
+{
+    /* Dirty a block of the same class the message will reuse. */
+    void* block = MessagePool::instance().allocate(mtu);
+    std::memset(block, 0xFF, mtu);
+    MessagePool::instance().deallocate(block, mtu);
+
+    dds::xrce::MessageHeader header;
+    header.session_id(0x81);
+    OutputMessage output_message(header, mtu);
+    ASSERT_EQ(block, output_message.get_buf());
+
+    uint8_t payload[3] = {1, 2, 3};
+    ASSERT_TRUE(output_message.append_raw_payload(dds::xrce::WRITE_DATA, payload, sizeof(payload)));
+    ASSERT_TRUE(output_message.append_raw_payload(dds::xrce::WRITE_DATA, payload, sizeof(payload)));
+
+    /* 4 bytes header + 4 subheader + 3 payload + 1 padding + 4 subheader + 3 payload. */
+    ASSERT_EQ(19u, output_message.get_len());
+    ASSERT_EQ(0, output_message.get_buf()[11]);
+}
+
+TEST_F(MessagePoolTest, zero_copy_receive)
+{
+    PooledBuffer buffer(1024);
+    std::memcpy(buffer.data(), raw_input_, sizeof(raw_input_));
+
+    /* A message filling at least half of the buffer takes its block. */
+    uint8_t* received = buffer.data();
+    std::unique_ptr<InputMessage> large_message(InputMessage::from_buffer(buffer, 600));
+    ASSERT_EQ(received, large_message->get_buf());
+    ASSERT_EQ(600u, large_message->get_len());
+    ASSERT_EQ(0x81, large_message->get_header().session_id());
+    ASSERT_NE(received, buffer.data());
+    ASSERT_EQ(1024u, buffer.size());
+
+    /* Small messages are copied, the buffer keeps its block. */
+    std::memcpy(buffer.data(), raw_input_, sizeof(raw_input_));
+    std::unique_ptr<InputMessage> small_message(InputMessage::from_buffer(buffer, sizeof(raw_input_)));
+    ASSERT_NE(buffer.data(), small_message->get_buf());
+    ASSERT_EQ(0x81, small_message->get_header().session_id());
+
+    /* The adopted block goes back to its size class. */
+    large_message.reset();
+    void* block = MessagePool::instance().allocate(1024);
+    ASSERT_EQ(static_cast<void*>(received), block);
+    MessagePool::instance().deallocate(block, 1024);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,311 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/message/InputMessage.hpp>
+#include <uxr/agent/message/OutputMessage.hpp>
+#include <uxr/agent/message/RawCodec.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class SerializationTests : public ::testing::Test
+{
+protected:
+    SerializationTests()
+        : sample_(48)
+    {
+        header_.session_id(0x01);
+        header_.stream_id(0x80);
+        header_.sequence_nr(0x1234);
+        header_.client_key({{0xAA, 0xBB, 0xCC, 0xDD}});
+
+        subheader_.submessage_id(dds::xrce::HEARTBEAT);
+        subheader_.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
+        subheader_.submessage_length(0x0305);
+
+        acknack_.first_unacked_seq_num(0xFFFE);
+        acknack_.nack_bitmap({{0x81, 0x42}});
+        acknack_.stream_id(0x85);
+
+        heartbeat_.first_unacked_seq_nr(0x0102);
+        heartbeat_.last_unacked_seq_nr(0xFF03);
+        heartbeat_.stream_id(0x81);
+
+        for (size_t i = 0; i < sample_.size(); ++i)
+        {
+            sample_[i] = uint8_t(i * 7 + 1);
+        }
+    }
+
+    /* Serializes data with fastcdr, as the generated code does. */
+    template<class T>
+    std::vector<uint8_t> cdr_bytes(const T& data)
+    {
+        std::vector<uint8_t> buf(data.getCdrSerializedSize());
+        fastcdr::FastBuffer fastbuffer{reinterpret_cast<char*>(buf.data()), buf.size()};
+        fastcdr::Cdr serializer{fastbuffer};
+        data.serialize(serializer);
+        EXPECT_EQ(buf.size(), serializer.getSerializedDataLength());
+        return buf;
+    }
+
+    template<class T>
+    std::vector<uint8_t> raw_bytes(const T& data)
+    {
+        const T local{data};
+        std::vector<uint8_t> buf(raw_codec::encoded_size(local));
+        raw_codec::encode(local, buf.data());
+        return buf;
+    }
+
+    /* Times op over a number of rounds, in nanoseconds per call. */
+    template<class Op>
+    double ns_per_op(Op op)
+    {
+        constexpr size_t rounds = 1000000;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            op(i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / rounds;
+    }
+
+    /* Prints fastcdr against raw for a pair of operations. */
+    template<class CdrOp, class RawOp>
+    void compare(const char* name, CdrOp cdr_op, RawOp raw_op)
+    {
+        double cdr_ns = ns_per_op(cdr_op);
+        double raw_ns = ns_per_op(raw_op);
+        std::cout << "[ BENCHMARK] " << name << ": fastcdr " << cdr_ns << " ns/op, raw " << raw_ns << " ns/op"
+                  << std::endl;
+    }
+
+    dds::xrce::MessageHeader header_;
+    dds::xrce::SubmessageHeader subheader_;
+    dds::xrce::ACKNACK_Payload acknack_;
+    dds::xrce::HEARTBEAT_Payload heartbeat_;
+    std::vector<uint8_t> sample_;
+};
+
+TEST_F(SerializationTests, EncodeMatchesFastCdr)
+{
+    EXPECT_EQ(cdr_bytes(header_), raw_bytes(header_));
+    header_.session_id(0x81);
+    EXPECT_EQ(cdr_bytes(header_), raw_bytes(header_));
+
+    EXPECT_EQ(cdr_bytes(subheader_), raw_bytes(subheader_));
+    EXPECT_EQ(cdr_bytes(acknack_), raw_bytes(acknack_));
+    EXPECT_EQ(cdr_bytes(heartbeat_), raw_bytes(heartbeat_));
+
+    SharedDataPayload data{{{0x01, 0x02}}, {{0x03, 0x04}}, sample_};
+    EXPECT_EQ(cdr_bytes(data), raw_bytes(data));
+}
+
+TEST_F(SerializationTests, DecodeMatchesFastCdr)
+{
+    dds::xrce::MessageHeader header;
+    raw_codec::decode(header, cdr_bytes(header_).data());
+    EXPECT_EQ(header_.session_id(), header.session_id());
+    EXPECT_EQ(header_.stream_id(), header.stream_id());
+    EXPECT_EQ(header_.sequence_nr(), header.sequence_nr());
+    EXPECT_EQ(header_.client_key(), header.client_key());
+
+    dds::xrce::SubmessageHeader subheader;
+    raw_codec::decode(subheader, cdr_bytes(subheader_).data());
+    EXPECT_EQ(subheader_.submessage_id(), subheader.submessage_id());
+    EXPECT_EQ(subheader_.flags(), subheader.flags());
+    EXPECT_EQ(subheader_.submessage_length(), subheader.submessage_length());
+
+    dds::xrce::ACKNACK_Payload acknack;
+    raw_codec::decode(acknack, cdr_bytes(acknack_).data());
+    EXPECT_EQ(acknack_.first_unacked_seq_num(), acknack.first_unacked_seq_num());
+    EXPECT_EQ(acknack_.nack_bitmap(), acknack.nack_bitmap());
+    EXPECT_EQ(acknack_.stream_id(), acknack.stream_id());
+
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    raw_codec::decode(heartbeat, cdr_bytes(heartbeat_).data());
+    EXPECT_EQ(heartbeat_.first_unacked_seq_nr(), heartbeat.first_unacked_seq_nr());
+    EXPECT_EQ(heartbeat_.last_unacked_seq_nr(), heartbeat.last_unacked_seq_nr());
+    EXPECT_EQ(heartbeat_.stream_id(), heartbeat.stream_id());
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data;
+    write_data.request_id({{0x01, 0x02}});
+    write_data.object_id({{0x03, 0x04}});
+    write_data.data().serialized_data(sample_);
+    dds::xrce::WRITE_DATA_Payload_Data decoded;
+    decoded.data().resize(sample_.size());
+    raw_codec::decode(decoded, cdr_bytes(write_data).data());
+    EXPECT_EQ(write_data.request_id(), decoded.request_id());
+    EXPECT_EQ(write_data.object_id(), decoded.object_id());
+    EXPECT_EQ(sample_, decoded.data().serialized_data());
+}
+
+/* The raw and the fastcdr paths interleave within a message. */
+TEST_F(SerializationTests, MixedMessageRoundTrip)
+{
+    dds::xrce::STATUS_Payload status;
+    status.related_request().request_id({{0x05, 0x06}});
+    status.related_request().object_id({{0x07, 0x08}});
+    status.result().status(dds::xrce::STATUS_ERR_DDS_ERROR);
+    status.result().implementation_status(0x09);
+
+    std::vector<uint8_t> odd_sample(sample_.begin(), sample_.end() - 1);
+    SharedDataPayload odd_data{{{0x01, 0x02}}, {{0x03, 0x04}}, odd_sample};
+    SharedDataPayload data{{{0x01, 0x02}}, {{0x03, 0x04}}, sample_};
+
+    OutputMessage output{header_, 512};
+    ASSERT_TRUE(output.append_submessage(dds::xrce::HEARTBEAT, heartbeat_));
+    ASSERT_TRUE(output.append_submessage(dds::xrce::DATA, odd_data));
+    ASSERT_TRUE(output.append_submessage(dds::xrce::STATUS, status));
+    ASSERT_TRUE(output.append_submessage(dds::xrce::ACKNACK, acknack_));
+    ASSERT_TRUE(output.append_submessage(dds::xrce::DATA, data));
+
+    InputMessage input{output.get_buf(), output.get_len()};
+    EXPECT_EQ(header_.sequence_nr(), input.get_header().sequence_nr());
+    EXPECT_EQ(header_.client_key(), input.get_header().client_key());
+
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    ASSERT_TRUE(input.prepare_next_submessage());
+    EXPECT_EQ(dds::xrce::HEARTBEAT, input.get_subheader().submessage_id());
+    ASSERT_TRUE(input.get_payload(heartbeat));
+    EXPECT_EQ(heartbeat_.last_unacked_seq_nr(), heartbeat.last_unacked_seq_nr());
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data;
+    ASSERT_TRUE(input.prepare_next_submessage());
+    write_data.data().resize(input.get_subheader().submessage_length() - raw_codec::OBJECT_REQUEST_SIZE);
+    ASSERT_TRUE(input.get_payload(write_data));
+    EXPECT_EQ(odd_sample, write_data.data().serialized_data());
+
+    dds::xrce::STATUS_Payload decoded_status;
+    ASSERT_TRUE(input.prepare_next_submessage());
+    EXPECT_EQ(dds::xrce::STATUS, input.get_subheader().submessage_id());
+    ASSERT_TRUE(input.get_payload(decoded_status));
+    EXPECT_EQ(status.related_request().object_id(), decoded_status.related_request().object_id());
+    EXPECT_EQ(status.result().status(), decoded_status.result().status());
+    EXPECT_EQ(status.result().implementation_status(), decoded_status.result().implementation_status());
+
+    dds::xrce::ACKNACK_Payload acknack;
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_TRUE(input.get_payload(acknack));
+    EXPECT_EQ(acknack_.nack_bitmap(), acknack.nack_bitmap());
+
+    ASSERT_TRUE(input.prepare_next_submessage());
+    write_data.data().resize(input.get_subheader().submessage_length() - raw_codec::OBJECT_REQUEST_SIZE);
+    ASSERT_TRUE(input.get_payload(write_data));
+    EXPECT_EQ(sample_, write_data.data().serialized_data());
+    EXPECT_FALSE(input.prepare_next_submessage());
+}
+
+TEST_F(SerializationTests, Truncated)
+{
+    OutputMessage output{header_, 16};
+    EXPECT_FALSE(output.append_submessage(dds::xrce::HEARTBEAT, heartbeat_));
+
+    uint8_t buf[14];
+    std::vector<uint8_t> header = cdr_bytes(header_);
+    std::vector<uint8_t> subheader = cdr_bytes(subheader_);
+    memcpy(buf, header.data(), header.size());
+    memcpy(buf + header.size(), subheader.data(), subheader.size());
+
+    InputMessage input{buf, sizeof(buf)};
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    ASSERT_TRUE(input.prepare_next_submessage());
+    EXPECT_FALSE(input.get_payload(heartbeat));
+}
+
+TEST_F(SerializationTests, Benchmark)
+{
+    std::vector<uint8_t> buf(512);
+    fastcdr::FastBuffer fastbuffer{reinterpret_cast<char*>(buf.data()), buf.size()};
+    fastcdr::Cdr cdr{fastbuffer};
+    uint8_t* raw = buf.data();
+    uint32_t sink = 0;
+
+    compare("encode MessageHeader",
+        [&](size_t i){ header_.sequence_nr(uint16_t(i)); cdr.reset(); header_.serialize(cdr); sink += raw[2]; },
+        [&](size_t i){ header_.sequence_nr(uint16_t(i)); raw_codec::encode(header_, raw); sink += raw[2]; });
+    compare("encode SubmessageHeader",
+        [&](size_t i){ subheader_.submessage_length(uint16_t(i)); cdr.reset(); subheader_.serialize(cdr); sink += raw[2]; },
+        [&](size_t i){ subheader_.submessage_length(uint16_t(i)); raw_codec::encode(subheader_, raw); sink += raw[2]; });
+    compare("encode ACKNACK",
+        [&](size_t i){ acknack_.first_unacked_seq_num(uint16_t(i)); cdr.reset(); acknack_.serialize(cdr); sink += raw[0]; },
+        [&](size_t i){ acknack_.first_unacked_seq_num(uint16_t(i)); raw_codec::encode(acknack_, raw); sink += raw[0]; });
+    compare("encode HEARTBEAT",
+        [&](size_t i){ heartbeat_.last_unacked_seq_nr(uint16_t(i)); cdr.reset(); heartbeat_.serialize(cdr); sink += raw[2]; },
+        [&](size_t i){ heartbeat_.last_unacked_seq_nr(uint16_t(i)); raw_codec::encode(heartbeat_, raw); sink += raw[2]; });
+
+    SharedDataPayload data{{{0x01, 0x02}}, {{0x03, 0x04}}, sample_};
+    compare("encode DATA (48 B)",
+        [&](size_t i){ sample_[0] = uint8_t(i); cdr.reset(); data.serialize(cdr); sink += raw[4]; },
+        [&](size_t i){ sample_[0] = uint8_t(i); raw_codec::encode(data, raw); sink += raw[4]; });
+
+    /* Decoding rotates over pre-filled slots, so that the loads are neither hoisted nor stalled by the stores. */
+    constexpr size_t slots = 8;
+    constexpr size_t slot_size = 64;
+    std::vector<uint8_t> input(slots * slot_size);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = uint8_t(i * 37);
+    }
+    std::vector<fastcdr::FastBuffer> fastbuffers;
+    std::vector<fastcdr::Cdr> cdrs;
+    fastbuffers.reserve(slots);
+    cdrs.reserve(slots);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        fastbuffers.emplace_back(reinterpret_cast<char*>(&input[i * slot_size]), slot_size);
+        cdrs.emplace_back(fastbuffers.back());
+    }
+
+    dds::xrce::MessageHeader header;
+    compare("decode MessageHeader",
+        [&](size_t i){ fastcdr::Cdr& c = cdrs[i % slots]; c.reset(); header.deserialize(c); sink += header.sequence_nr(); },
+        [&](size_t i){ raw_codec::decode(header, &input[(i % slots) * slot_size]); sink += header.sequence_nr(); });
+
+    dds::xrce::SubmessageHeader subheader;
+    compare("decode SubmessageHeader",
+        [&](size_t i){ fastcdr::Cdr& c = cdrs[i % slots]; c.reset(); subheader.deserialize(c); sink += subheader.submessage_length(); },
+        [&](size_t i){ raw_codec::decode(subheader, &input[(i % slots) * slot_size]); sink += subheader.submessage_length(); });
+
+    dds::xrce::ACKNACK_Payload acknack;
+    compare("decode ACKNACK",
+        [&](size_t i){ fastcdr::Cdr& c = cdrs[i % slots]; c.reset(); acknack.deserialize(c); sink += acknack.first_unacked_seq_num(); },
+        [&](size_t i){ raw_codec::decode(acknack, &input[(i % slots) * slot_size]); sink += acknack.first_unacked_seq_num(); });
+
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    compare("decode HEARTBEAT",
+        [&](size_t i){ fastcdr::Cdr& c = cdrs[i % slots]; c.reset(); heartbeat.deserialize(c); sink += heartbeat.last_unacked_seq_nr(); },
+        [&](size_t i){ raw_codec::decode(heartbeat, &input[(i % slots) * slot_size]); sink += heartbeat.last_unacked_seq_nr(); });
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data;
+    write_data.data().resize(sample_.size());
+    compare("decode WRITE_DATA (48 B)",
+        [&](size_t i){ fastcdr::Cdr& c = cdrs[i % slots]; c.reset(); write_data.deserialize(c); sink += write_data.data().serialized_data()[0]; },
+        [&](size_t i){ raw_codec::decode(write_data, &input[(i % slots) * slot_size]); sink += write_data.data().serialized_data()[0]; });
+
+    EXPECT_NE(0u, sink);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <iostream>
+#include <thread>
+
 namespace eprosima {
 namespace uxr {
 namespace testing {
@@ -897,6 +901,303 @@ TEST_F(CedMiddlewareUnitTests, WriteReadData)
     EXPECT_FALSE(middleware_.read_data(1, input_data, std::chrono::milliseconds(100)));
 }
 
+TEST_F(CedMiddlewareUnitTests, SharedData)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref);
+    middleware_.create_datareader_by_ref(1, 0, datareader_ref);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref);
+
+    SharedData output_data = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{0, 1, 2});
+    EXPECT_TRUE(middleware_.write_data(0, output_data));
+
+    /* Both readers get the buffer written, not a copy of it. */
+    SharedData input_data_one;
+    SharedData input_data_two;
+    EXPECT_TRUE(middleware_.read_data(0, input_data_one, std::chrono::milliseconds(0)));
+    EXPECT_TRUE(middleware_.read_data(1, input_data_two, std::chrono::milliseconds(0)));
+    EXPECT_EQ(output_data, input_data_one);
+    EXPECT_EQ(output_data, input_data_two);
+
+    /* The readers of vectors still get their own copy. */
+    std::vector<uint8_t> input_data{};
+    EXPECT_TRUE(middleware_.write_data(0, *output_data));
+    EXPECT_TRUE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+    EXPECT_EQ(*output_data, input_data);
+    EXPECT_FALSE(middleware_.read_data(0, input_data_one, std::chrono::milliseconds(0)));
+}
+
+TEST_F(CedMiddlewareUnitTests, HistoryOverwrite)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref);
+
+    /* Write more samples than the history keeps. */
+    const uint8_t overwritten = 4;
+    for (uint8_t i = 0; i < CED_HISTORY_DEPTH + overwritten; ++i)
+    {
+        EXPECT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{i}));
+    }
+
+    /* The reader gets the last samples, in order. */
+    std::vector<uint8_t> input_data{};
+    for (uint8_t i = overwritten; i < CED_HISTORY_DEPTH + overwritten; ++i)
+    {
+        ASSERT_TRUE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+        ASSERT_EQ(input_data, std::vector<uint8_t>{i});
+    }
+    EXPECT_FALSE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+
+    /* A reader created afterwards gets the history too. */
+    middleware_.create_datareader_by_ref(1, 0, datareader_ref);
+    ASSERT_TRUE(middleware_.read_data(1, input_data, std::chrono::milliseconds(0)));
+    ASSERT_EQ(input_data, std::vector<uint8_t>{overwritten});
+}
+
+TEST_F(CedMiddlewareUnitTests, CreateTopicByXMLHistory)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+    middleware_.create_participant_by_ref(1, 0, participant_ref);
+
+    std::string keep_all_xml{
+        "<dds><topic><name>Topic</name><dataType>Type</dataType>"
+        "<historyQos><kind>KEEP_ALL</kind><depth>32</depth></historyQos></topic></dds>"};
+    std::string keep_last_xml{
+        "<dds><topic><name>Topic</name><dataType>Type</dataType>"
+        "<historyQos><kind>KEEP_LAST</kind><depth>32</depth></historyQos></topic></dds>"};
+
+    EXPECT_TRUE(middleware_.create_topic_by_xml(0, 0, keep_all_xml));
+
+    /* The same topic, from another participant. */
+    EXPECT_TRUE(middleware_.create_topic_by_xml(1, 1, keep_all_xml));
+
+    /* The same topic with a different history. */
+    EXPECT_FALSE(middleware_.create_topic_by_xml(2, 1, keep_last_xml));
+    EXPECT_FALSE(middleware_.create_topic_by_ref(2, 1, std::string{"Topic"}));
+
+    /* Invalid history. */
+    EXPECT_FALSE(middleware_.create_topic_by_xml(2, 0,
+        "<dds><topic><name>Other</name><historyQos><kind>KEEP_SOME</kind></historyQos></topic></dds>"));
+    EXPECT_FALSE(middleware_.create_topic_by_xml(2, 0,
+        "<dds><topic><name>Other</name><historyQos><depth>0</depth></historyQos></topic></dds>"));
+    EXPECT_FALSE(middleware_.create_topic_by_xml(2, 0,
+        "<dds><topic><name>Other</name><historyQos><depth>many</depth></historyQos></topic></dds>"));
+    EXPECT_FALSE(middleware_.create_topic_by_xml(2, 0, "<dds><topic><dataType>Type</dataType></topic></dds>"));
+
+    /* The DataWriters and DataReaders find the topic from the name in their XML. */
+    middleware_.create_publisher_by_xml(0, 0, std::string{"Publisher"});
+    middleware_.create_subscriber_by_xml(0, 0, std::string{"Subscriber"});
+    EXPECT_TRUE(middleware_.create_datawriter_by_xml(0, 0,
+        "<dds><data_writer><topic><kind>NO_KEY</kind><name>Topic</name></topic></data_writer></dds>"));
+    EXPECT_TRUE(middleware_.create_datareader_by_xml(0, 0,
+        "<dds><data_reader><topic><kind>NO_KEY</kind><name>Topic</name></topic></data_reader></dds>"));
+    EXPECT_FALSE(middleware_.create_datareader_by_xml(1, 0,
+        "<dds><data_reader><topic><name>Other</name></topic></data_reader></dds>"));
+}
+
+TEST_F(CedMiddlewareUnitTests, KeepAllHistory)
+{
+    const uint8_t depth = 4;
+
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_xml{
+        "<dds><topic><name>Topic</name>"
+        "<historyQos><kind>KEEP_ALL</kind><depth>4</depth></historyQos></topic></dds>"};
+    ASSERT_TRUE(middleware_.create_topic_by_xml(0, 0, topic_xml));
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref);
+
+    /* Without readers nothing is kept for anyone. */
+    for (uint8_t i = 0; i < 2 * depth; ++i)
+    {
+        EXPECT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{i}));
+    }
+
+    /* The reader starts from the history, the writer is refused right away instead of overwriting an unread sample. */
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref);
+
+    EXPECT_FALSE(middleware_.is_writable(0));
+    EXPECT_FALSE(middleware_.write_data(0, std::vector<uint8_t>{0xFF}));
+
+    std::vector<uint8_t> input_data{};
+    ASSERT_TRUE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+    EXPECT_EQ(input_data, std::vector<uint8_t>{depth});
+    EXPECT_TRUE(middleware_.is_writable(0));
+    EXPECT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{2 * depth}));
+
+    /* A slow reader loses nothing, the writer waits until it is writable again. */
+    const uint8_t samples = 200;
+    std::atomic<uint8_t> expected{depth + 1};
+    std::atomic<uint16_t> out_of_order{0};
+    std::thread reader_thread([&]()
+    {
+        std::vector<uint8_t> data;
+        while ((samples > expected) && middleware_.read_data(0, data, std::chrono::milliseconds(1000)))
+        {
+            if (data.front() != expected)
+            {
+                ++out_of_order;
+            }
+            expected = uint8_t(data.front() + 1);
+            if (0 == (expected % 16))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(25));
+            }
+        }
+    });
+
+    for (uint8_t i = 2 * depth + 1; i < samples; ++i)
+    {
+        while (!middleware_.is_writable(0))
+        {
+            std::this_thread::yield();
+        }
+        ASSERT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{i}));
+    }
+    reader_thread.join();
+
+    EXPECT_EQ(out_of_order, 0);
+    EXPECT_EQ(expected, samples);
+
+    /* Deleting the reader releases the writer. */
+    for (uint8_t i = 0; i < depth; ++i)
+    {
+        EXPECT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{i}));
+    }
+    EXPECT_FALSE(middleware_.is_writable(0));
+    EXPECT_TRUE(middleware_.delete_datareader(0));
+    EXPECT_TRUE(middleware_.is_writable(0));
+    EXPECT_TRUE(middleware_.write_data(0, std::vector<uint8_t>{0}));
+}
+
+/**
+ * Fan-out benchmark: one writer and many readers blocked on the same topic. The writer stays within
+ * half the history of the slowest reader, so every reader shall get every sample, in order.
+ * The delivery rate is printed.
+ */
+TEST_F(CedMiddlewareUnitTests, FanOutBenchmark)
+{
+    const uint16_t readers = 50;
+    const uint32_t samples = 20000;
+    const size_t sample_size = 64;
+    const uint32_t max_lead = std::max(CED_HISTORY_DEPTH / 2, 1);
+
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    std::string datareader_ref{"Topic"};
+    for (uint16_t i = 0; i < readers; ++i)
+    {
+        ASSERT_TRUE(middleware_.create_datareader_by_ref(i, 0, datareader_ref));
+    }
+
+    std::string datawriter_ref{"Topic"};
+    ASSERT_TRUE(middleware_.create_datawriter_by_ref(0, 0, datawriter_ref));
+
+    std::vector<std::atomic<uint32_t>> progress(readers);
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint16_t> out_of_order{0};
+    std::vector<std::thread> reader_threads;
+    for (uint16_t i = 0; i < readers; ++i)
+    {
+        progress[i] = 0;
+        reader_threads.emplace_back([&, i]()
+        {
+            std::vector<uint8_t> data;
+            uint32_t expected = 0;
+            while ((samples > expected) && middleware_.read_data(i, data, std::chrono::milliseconds(1000)))
+            {
+                uint32_t index;
+                memcpy(&index, data.data(), sizeof(index));
+                if (index != expected)
+                {
+                    ++out_of_order;
+                }
+                expected = index + 1;
+                progress[i].store(expected);
+                ++received;
+            }
+        });
+    }
+
+    std::vector<uint8_t> data(sample_size, 0xAA);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < samples; ++i)
+    {
+        for (uint16_t j = 0; j < readers; ++j)
+        {
+            while (i >= progress[j].load() + max_lead)
+            {
+                std::this_thread::yield();
+            }
+        }
+        memcpy(data.data(), &i, sizeof(i));
+        ASSERT_TRUE(middleware_.write_data(0, data));
+    }
+
+    for (auto& reader_thread : reader_threads)
+    {
+        reader_thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(out_of_order, 0);
+    EXPECT_EQ(received, uint64_t(samples) * readers);
+    std::cout << "1 writer, " << readers << " readers: "
+              << uint64_t(samples / elapsed) << " samples/s, "
+              << uint64_t(received / elapsed) << " deliveries/s "
+              << "(history depth " << CED_HISTORY_DEPTH << ")" << std::endl;
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace testing
@@ -0,0 +1,180 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/message/InputMessage.hpp>
+#include <uxr/agent/message/OutputMessage.hpp>
+#include <uxr/agent/transport/udp/UDPv4AgentLinux.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <chrono>
+#include <thread>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+constexpr uint16_t agent_port = 38123;
+constexpr dds::xrce::SessionId session_id = 0x01;
+constexpr dds::xrce::ClientKey client_key = {0xAA, 0xBB, 0xCC, 0xDD};
+constexpr uint16_t mtu = 512;
+
+/**
+ * Heartbeat timer of the agent reliable output streams across the liveness of the client.
+ * The test target is built with a short CLIENT_DEAD_TIME, see CMakeLists.txt.
+ */
+class HeartbeatTimerTest : public ::testing::Test
+{
+protected:
+    HeartbeatTimerTest()
+        : agent_(agent_port, Middleware::Kind::CED)
+        , agent_address_{}
+    {
+        agent_address_.sin_family = AF_INET;
+        agent_address_.sin_port = htons(agent_port);
+        agent_address_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd_ = socket(PF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address));
+    }
+
+    ~HeartbeatTimerTest()
+    {
+        agent_.stop();
+        ::close(fd_);
+    }
+
+    template<class T>
+    void send(
+            dds::xrce::SessionId message_session_id,
+            dds::xrce::StreamId stream_id,
+            dds::xrce::SubmessageId submessage_id,
+            const T& payload)
+    {
+        dds::xrce::MessageHeader header;
+        header.session_id(message_session_id);
+        header.stream_id(stream_id);
+        header.sequence_nr(0x00);
+        header.client_key(client_key);
+
+        dds::xrce::SubmessageHeader subheader;
+        OutputMessagePtr message = make_output_message(
+                header,
+                header.getCdrSerializedSize() + subheader.getCdrSerializedSize() + payload.getCdrSerializedSize());
+        message->append_submessage(submessage_id, payload);
+        sendto(fd_, message->get_buf(), message->get_len(), 0,
+               reinterpret_cast<const struct sockaddr*>(&agent_address_), sizeof(agent_address_));
+    }
+
+    /* Receives until a message whose first submessage is of the given kind, or the timeout. */
+    bool receive(
+            dds::xrce::SubmessageId submessage_id,
+            std::chrono::milliseconds timeout)
+    {
+        using namespace std::chrono;
+
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+        const steady_clock::time_point deadline = steady_clock::now() + timeout;
+        steady_clock::time_point now = steady_clock::now();
+        while (now < deadline)
+        {
+            struct pollfd poll_fd{fd_, POLLIN, 0};
+            if (0 < poll(&poll_fd, 1, int(duration_cast<milliseconds>(deadline - now).count()) + 1))
+            {
+                ssize_t len = recv(fd_, buffer, sizeof(buffer), 0);
+                if (0 < len)
+                {
+                    InputMessage message(buffer, size_t(len));
+                    if (message.prepare_next_submessage() &&
+                        (submessage_id == message.get_subheader().submessage_id()))
+                    {
+                        return true;
+                    }
+                }
+            }
+            now = steady_clock::now();
+        }
+        return false;
+    }
+
+    void drain()
+    {
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+        while (0 < recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT))
+        {
+        }
+    }
+
+    UDPv4Agent agent_;
+    struct sockaddr_in agent_address_;
+    int fd_;
+};
+
+TEST_F(HeartbeatTimerTest, DeadClientComesBack)
+{
+    using namespace std::chrono;
+
+    ASSERT_TRUE(agent_.start());
+
+    dds::xrce::CREATE_CLIENT_Payload create_client;
+    create_client.client_representation().xrce_cookie(dds::xrce::XRCE_COOKIE);
+    create_client.client_representation().xrce_version(dds::xrce::XRCE_VERSION);
+    create_client.client_representation().client_key(client_key);
+    create_client.client_representation().session_id(session_id);
+    create_client.client_representation().mtu(mtu);
+    send(dds::xrce::SESSIONID_NONE_WITHOUT_CLIENT_KEY, dds::xrce::STREAMID_NONE, dds::xrce::CREATE_CLIENT,
+         create_client);
+    ASSERT_TRUE(receive(dds::xrce::STATUS_AGENT, milliseconds(1000)));
+
+    /* The STATUS of this request goes out on the builtin reliable stream and is never acknowledged. */
+    dds::xrce::DELETE_Payload delete_payload;
+    delete_payload.request_id({0x00, 0x01});
+    delete_payload.object_id({0x00, (0x01 << 4) | dds::xrce::OBJK_TOPIC});
+    send(session_id, dds::xrce::STREAMID_BUILTIN_RELIABLE, dds::xrce::DELETE_ID, delete_payload);
+    ASSERT_TRUE(receive(dds::xrce::STATUS, milliseconds(1000)));
+
+    /* Silent client: dead after CLIENT_DEAD_TIME, the timer expires at least once after that. */
+    std::this_thread::sleep_for(CLIENT_DEAD_TIME + milliseconds(HEARTBEAT_MAX_PERIOD + HEARTBEAT_PERIOD));
+    drain();
+
+    /* An ACKNACK acknowledging nothing brings the client back without touching the timer. */
+    dds::xrce::ACKNACK_Payload acknack;
+    acknack.first_unacked_seq_num(0x0000);
+    acknack.nack_bitmap({0x00, 0x00});
+    acknack.stream_id(dds::xrce::STREAMID_BUILTIN_RELIABLE);
+    send(session_id, dds::xrce::STREAMID_NONE, dds::xrce::ACKNACK, acknack);
+
+    /* The STATUS is still unacknowledged, so the agent shall keep sending heartbeats. */
+    ASSERT_TRUE(receive(dds::xrce::HEARTBEAT, milliseconds(2 * HEARTBEAT_MAX_PERIOD)));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
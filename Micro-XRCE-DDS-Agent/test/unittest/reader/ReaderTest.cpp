@@ -0,0 +1,264 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/reader/Reader.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Simulated middleware DataReader: published samples are counted and read one by one.
+ */
+struct FakeTopic
+{
+    FakeTopic()
+        : published{0}
+        , read{0}
+        , written{0}
+    {}
+
+    bool read_fn(
+            bool,
+            SharedData& data,
+            std::chrono::milliseconds)
+    {
+        uint32_t current = read.load();
+        if (current < published.load())
+        {
+            read.store(current + 1);
+            data = std::make_shared<const std::vector<uint8_t>>(sample_size, 0xAA);
+            return true;
+        }
+        return false;
+    }
+
+    bool write_fn(
+            int,
+            const std::vector<uint8_t>& data,
+            std::chrono::milliseconds)
+    {
+        written.fetch_add(1);
+        return sample_size == data.size();
+    }
+
+    std::atomic<uint32_t> published;
+    std::atomic<uint32_t> read;
+    std::atomic<uint32_t> written;
+    size_t sample_size = 100;
+};
+
+class ReaderTest : public ::testing::Test
+{
+protected:
+    typedef Reader<bool, int> TestReader;
+
+    static dds::xrce::DataDeliveryControl delivery_control(
+            uint16_t max_samples,
+            uint16_t max_elapsed_time,
+            uint16_t max_bytes_per_second)
+    {
+        dds::xrce::DataDeliveryControl control;
+        control.max_samples(max_samples);
+        control.max_elapsed_time(max_elapsed_time);
+        control.max_bytes_per_second(max_bytes_per_second);
+        return control;
+    }
+
+    static bool start(
+            TestReader& reader,
+            FakeTopic& topic,
+            const dds::xrce::DataDeliveryControl& control,
+            bool event_driven)
+    {
+        using namespace std::placeholders;
+        return reader.start_reading(
+            control,
+            std::bind(&FakeTopic::read_fn, &topic, _1, _2, _3),
+            false,
+            std::bind(&FakeTopic::write_fn, &topic, _1, _2, _3),
+            0,
+            event_driven);
+    }
+
+    static bool wait_for(
+            const std::function<bool ()>& condition,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        auto final_time = std::chrono::steady_clock::now() + timeout;
+        while (!condition() && (std::chrono::steady_clock::now() < final_time))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return condition();
+    }
+};
+
+TEST_F(ReaderTest, max_samples)
+{
+    FakeTopic topic;
+    topic.published = 100;
+
+    TestReader reader;
+    ASSERT_TRUE(start(reader, topic, delivery_control(5, 0, 0), false));
+    ASSERT_TRUE(wait_for([&] { return 5u == topic.written.load(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(5u, topic.written.load());
+
+    /* Once done, the reader can start again. */
+    ASSERT_TRUE(start(reader, topic, delivery_control(2, 0, 0), false));
+    ASSERT_TRUE(wait_for([&] { return 7u == topic.written.load(); }));
+    ASSERT_TRUE(reader.stop_reading());
+}
+
+TEST_F(ReaderTest, polling)
+{
+    FakeTopic topic;
+
+    TestReader reader;
+    ASSERT_TRUE(start(reader, topic, delivery_control(0xFFFF, 0, 0), false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(0u, topic.written.load());
+
+    /* Without notifications the sample is found by the next poll. */
+    topic.published = 1;
+    ASSERT_TRUE(wait_for([&] { return 1u == topic.written.load(); }));
+    ASSERT_TRUE(reader.stop_reading());
+}
+
+TEST_F(ReaderTest, max_elapsed_time)
+{
+    FakeTopic topic;
+
+    TestReader reader;
+    ASSERT_TRUE(start(reader, topic, delivery_control(0xFFFF, 1, 0), true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+
+    /* The reading is over, notifications are ignored. */
+    topic.published = 1;
+    reader.get_notifier()();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(0u, topic.written.load());
+
+    ASSERT_TRUE(start(reader, topic, delivery_control(0xFFFF, 0, 0), true));
+    ASSERT_TRUE(wait_for([&] { return 1u == topic.written.load(); }));
+}
+
+TEST_F(ReaderTest, max_bytes_per_second)
+{
+    FakeTopic topic;
+    topic.published = 1000;
+
+    /* The bucket starts full with 1000 tokens, then 1000 more per second. */
+    TestReader reader;
+    ASSERT_TRUE(start(reader, topic, delivery_control(0xFFFF, 0, 1000), false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_TRUE(reader.stop_reading());
+
+    uint32_t written = topic.written.load();
+    ASSERT_GE(written, 10u);
+    ASSERT_LE(written, 16u);
+}
+
+TEST_F(ReaderTest, write_retry)
+{
+    FakeTopic topic;
+    topic.published = 1;
+    std::atomic<uint32_t> attempts{0};
+
+    using namespace std::placeholders;
+    TestReader reader;
+    ASSERT_TRUE(reader.start_reading(
+        delivery_control(1, 0, 0),
+        std::bind(&FakeTopic::read_fn, &topic, _1, _2, _3),
+        false,
+        [&](int, const std::vector<uint8_t>&, std::chrono::milliseconds)
+        {
+            /* Output stream full the first times. */
+            return 3 <= ++attempts;
+        },
+        0));
+    ASSERT_TRUE(wait_for([&] { return 3u == attempts.load(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    /* The sample is written again, not read again. */
+    ASSERT_EQ(3u, attempts.load());
+    ASSERT_EQ(1u, topic.read.load());
+}
+
+TEST_F(ReaderTest, event_driven_fan_out)
+{
+    constexpr size_t readers_count = 2000;
+    constexpr uint32_t samples_per_reader = 10;
+
+    std::vector<std::unique_ptr<FakeTopic>> topics;
+    std::vector<std::unique_ptr<TestReader>> readers;
+    for (size_t i = 0; i < readers_count; ++i)
+    {
+        topics.emplace_back(new FakeTopic());
+        readers.emplace_back(new TestReader());
+        ASSERT_TRUE(start(*readers.back(), *topics.back(), delivery_control(0xFFFF, 0, 0), true));
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    for (uint32_t sample = 1; sample <= samples_per_reader; ++sample)
+    {
+        for (size_t i = 0; i < readers_count; ++i)
+        {
+            topics[i]->published = sample;
+            readers[i]->get_notifier()();
+        }
+    }
+    ASSERT_TRUE(wait_for([&]
+        {
+            for (auto& topic : topics)
+            {
+                if (samples_per_reader != topic->written.load())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }));
+    auto end_time = std::chrono::steady_clock::now();
+
+    std::cout << "[ BENCHMARK] " << readers_count << " readers on " << READER_DELIVERY_WORKERS << " workers: "
+              << readers_count * samples_per_reader << " samples in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count()
+              << " ms" << std::endl;
+
+    for (auto& reader : readers)
+    {
+        ASSERT_TRUE(reader->stop_reading());
+    }
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
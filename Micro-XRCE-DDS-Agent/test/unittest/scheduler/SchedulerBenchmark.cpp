@@ -0,0 +1,146 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/LockFreeScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Several producers push tagged elements while a single consumer drains them with pop_batch.
+ * The queue is large enough to never drop, so every element shall be received and the order
+ * of each producer preserved. The throughput is printed for comparison.
+ */
+class SchedulerBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr size_t producers = 4;
+    static constexpr size_t elements_per_producer = 250000;
+    static constexpr size_t total_elements = producers * elements_per_producer;
+    static constexpr size_t batch_size = 32;
+
+    void run(
+            const char* name,
+            Scheduler<uint64_t>& scheduler)
+    {
+        scheduler.init();
+
+        std::vector<uint64_t> next_expected(producers, 0);
+        size_t received = 0;
+        bool in_order = true;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&scheduler, p]
+            {
+                for (uint64_t i = 0; i < elements_per_producer; ++i)
+                {
+                    scheduler.push((uint64_t(p) << 32) | i, 0);
+                }
+            });
+        }
+
+        std::vector<uint64_t> batch;
+        batch.reserve(batch_size);
+        while (received < total_elements && scheduler.pop_batch(batch, batch_size))
+        {
+            for (uint64_t element : batch)
+            {
+                size_t producer = size_t(element >> 32);
+                uint64_t sequence = element & 0xFFFFFFFF;
+                in_order = in_order && (next_expected[producer] == sequence);
+                next_expected[producer] = sequence + 1;
+            }
+            received += batch.size();
+            batch.clear();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        scheduler.deinit();
+
+        ASSERT_EQ(total_elements, received);
+        ASSERT_TRUE(in_order);
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "[ BENCHMARK] " << name << ": "
+                  << static_cast<uint64_t>(double(received) / seconds) << " elements/s" << std::endl;
+    }
+};
+
+constexpr size_t SchedulerBenchmark::producers;
+constexpr size_t SchedulerBenchmark::elements_per_producer;
+constexpr size_t SchedulerBenchmark::total_elements;
+constexpr size_t SchedulerBenchmark::batch_size;
+
+TEST_F(SchedulerBenchmark, fcfs)
+{
+    FCFSScheduler<uint64_t> scheduler(total_elements);
+    run("FCFSScheduler", scheduler);
+}
+
+TEST_F(SchedulerBenchmark, lock_free)
+{
+    LockFreeScheduler<uint64_t> scheduler(total_elements, 1024);
+    run("LockFreeScheduler", scheduler);
+}
+
+TEST_F(SchedulerBenchmark, lock_free_park)
+{
+    LockFreeScheduler<uint64_t> scheduler(total_elements, 0);
+    run("LockFreeScheduler (no spin)", scheduler);
+}
+
+TEST_F(SchedulerBenchmark, lock_free_full)
+{
+    LockFreeScheduler<uint64_t> scheduler(4, 0);
+    scheduler.init();
+    for (uint64_t i = 0; i < 8; ++i)
+    {
+        scheduler.push(uint64_t(i), 0);
+    }
+
+    /* A full ring drops the newest elements. */
+    std::vector<uint64_t> batch;
+    ASSERT_TRUE(scheduler.pop_batch(batch, 8));
+    ASSERT_EQ(batch, std::vector<uint64_t>({0, 1, 2, 3}));
+
+    scheduler.deinit();
+    uint64_t element;
+    ASSERT_FALSE(scheduler.pop(element));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
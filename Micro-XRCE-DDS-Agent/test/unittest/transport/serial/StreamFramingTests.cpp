@@ -0,0 +1,383 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/transport/stream_framing/StreamFramingProtocol.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class StreamFramingTests : public ::testing::Test
+{
+protected:
+    static constexpr uint8_t agent_addr = 0;
+    static constexpr uint8_t client_addr = 1;
+    static constexpr size_t max_msg_len = 4096;
+
+    StreamFramingTests()
+        : wire_{}
+        , wire_pos_{0}
+        , chunk_{1}
+        , reads_{0}
+        , writer_{
+            client_addr,
+            [&](uint8_t* buf, size_t len, TransportRc&) -> ssize_t
+            {
+                wire_.insert(wire_.end(), buf, buf + len);
+                return ssize_t(len);
+            },
+            [&](uint8_t*, size_t, int, TransportRc& transport_rc) -> ssize_t
+            {
+                transport_rc = TransportRc::timeout_error;
+                return 0;
+            }}
+        , reader_{
+            agent_addr,
+            [&](uint8_t*, size_t, TransportRc& transport_rc) -> ssize_t
+            {
+                transport_rc = TransportRc::server_error;
+                return 0;
+            },
+            [&](uint8_t* buf, size_t len, int, TransportRc& transport_rc) -> ssize_t
+            {
+                /* Hand out the wire in small chunks to split the frames at every position. */
+                ++reads_;
+                size_t available = std::min(len, std::min(chunk_, wire_.size() - wire_pos_));
+                std::copy_n(wire_.begin() + ssize_t(wire_pos_), available, buf);
+                wire_pos_ += available;
+                if (0 == available)
+                {
+                    transport_rc = TransportRc::timeout_error;
+                }
+                return ssize_t(available);
+            }}
+    {}
+
+    static std::vector<uint8_t> make_payload(
+            size_t len,
+            size_t seed)
+    {
+        /* Plenty of flag and escape octets. */
+        std::vector<uint8_t> payload(len);
+        for (size_t i = 0; i < len; ++i)
+        {
+            switch ((seed + i * 7) % 5)
+            {
+                case 0: payload[i] = 0x7E; break;
+                case 1: payload[i] = 0x7D; break;
+                default: payload[i] = uint8_t(seed * 31 + i); break;
+            }
+        }
+        return payload;
+    }
+
+    void write_frame(
+            const std::vector<uint8_t>& payload)
+    {
+        TransportRc transport_rc = TransportRc::ok;
+        ASSERT_EQ(payload.size(), writer_.write_framed_msg(payload.data(), payload.size(), agent_addr, transport_rc));
+    }
+
+    /* Reads until a frame arrives or the wire is exhausted. */
+    size_t read_frame(
+            std::vector<uint8_t>& buf,
+            uint8_t& remote_addr)
+    {
+        size_t rv = 0;
+        TransportRc transport_rc = TransportRc::ok;
+        while (0 == rv && TransportRc::timeout_error != transport_rc)
+        {
+            transport_rc = TransportRc::ok;
+            rv = reader_.read_framed_msg(buf.data(), buf.size(), remote_addr, 0, transport_rc);
+        }
+        return rv;
+    }
+
+    std::vector<uint8_t> wire_;
+    size_t wire_pos_;
+    size_t chunk_;
+    size_t reads_;
+    FramingIO writer_;
+    FramingIO reader_;
+};
+
+constexpr uint8_t StreamFramingTests::agent_addr;
+constexpr uint8_t StreamFramingTests::client_addr;
+constexpr size_t StreamFramingTests::max_msg_len;
+
+TEST_F(StreamFramingTests, Encoding)
+{
+    const std::vector<uint8_t> payload{0x01, 0x7E, 0x02, 0x7D, 0x03};
+    write_frame(payload);
+
+    /* Flag, addresses, length, escaped payload and CRC. */
+    const std::vector<uint8_t> expected{
+        0x7E, client_addr, agent_addr, 0x05, 0x00,
+        0x01, 0x7D, 0x5E, 0x02, 0x7D, 0x5D, 0x03};
+    ASSERT_LE(expected.size(), wire_.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), wire_.begin()));
+}
+
+TEST_F(StreamFramingTests, SplitFrames)
+{
+    std::vector<std::vector<uint8_t>> payloads;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        payloads.push_back(make_payload(1 + i * 13 % 1500, i));
+        write_frame(payloads.back());
+    }
+
+    std::vector<uint8_t> buf(max_msg_len);
+    for (chunk_ = 1; chunk_ <= 8192; chunk_ *= 3)
+    {
+        wire_pos_ = 0;
+        for (const auto& payload : payloads)
+        {
+            uint8_t remote_addr = 0xFF;
+            ASSERT_EQ(payload.size(), read_frame(buf, remote_addr)) << "chunk: " << chunk_;
+            EXPECT_EQ(client_addr, remote_addr);
+            ASSERT_TRUE(std::equal(payload.begin(), payload.end(), buf.begin())) << "chunk: " << chunk_;
+        }
+    }
+}
+
+TEST_F(StreamFramingTests, Resynchronization)
+{
+    std::vector<uint8_t> buf(max_msg_len);
+    const std::vector<uint8_t> payload = make_payload(300, 1);
+
+    /* Garbage, a frame truncated by a new flag, and a frame for another address. */
+    wire_ = {0x00, 0x7D, 0x11, 0x7E, client_addr, agent_addr, 0x40};
+    write_frame(payload);
+    wire_.insert(wire_.end(), {0x7E, client_addr, 0x33, 0x02, 0x00, 0xAA, 0xBB, 0x00, 0x00});
+    write_frame(payload);
+
+    chunk_ = 64;
+    uint8_t remote_addr = 0xFF;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ(payload.size(), read_frame(buf, remote_addr));
+        EXPECT_TRUE(std::equal(payload.begin(), payload.end(), buf.begin()));
+    }
+    EXPECT_EQ(0u, read_frame(buf, remote_addr));
+}
+
+TEST_F(StreamFramingTests, Rejection)
+{
+    std::vector<uint8_t> buf(512);
+    const std::vector<uint8_t> large = make_payload(600, 2);
+    const std::vector<uint8_t> small = make_payload(100, 3);
+
+    /* A frame larger than the buffer, a frame with a corrupted CRC and a valid frame. */
+    write_frame(large);
+    write_frame(small);
+    wire_.back() ^= 0x01;
+    write_frame(small);
+
+    chunk_ = 8192;
+    uint8_t remote_addr = 0xFF;
+    ASSERT_EQ(small.size(), read_frame(buf, remote_addr));
+    EXPECT_TRUE(std::equal(small.begin(), small.end(), buf.begin()));
+    EXPECT_EQ(0u, read_frame(buf, remote_addr));
+}
+
+TEST_F(StreamFramingTests, CrcCrossCheck)
+{
+    /* CRC-16/ARC check value. */
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint16_t crc = 0;
+    FramingIO::update_crc(crc, check, sizeof(check));
+    EXPECT_EQ(0xBB3D, crc);
+
+    /* Every length and alignment against the octet at a time table. */
+    std::vector<uint8_t> data(300);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 167 + (i >> 3));
+    }
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+        for (size_t len = 0; len + offset <= data.size(); ++len)
+        {
+            uint16_t expected = uint16_t(offset * 0x1021);
+            for (size_t i = 0; i < len; ++i)
+            {
+                FramingIO::update_crc(expected, data[offset + i]);
+            }
+            uint16_t computed = uint16_t(offset * 0x1021);
+            FramingIO::update_crc(computed, data.data() + offset, len);
+            ASSERT_EQ(expected, computed) << "offset: " << offset << ", len: " << len;
+        }
+    }
+}
+
+TEST_F(StreamFramingTests, CrcBenchmark)
+{
+    constexpr size_t rounds = 50;
+    std::vector<uint8_t> data(1 << 20);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 167);
+    }
+
+    uint16_t octet_crc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (uint8_t octet : data)
+        {
+            FramingIO::update_crc(octet_crc, octet);
+        }
+    }
+    std::chrono::duration<double> octet_elapsed = std::chrono::steady_clock::now() - start;
+
+    uint16_t block_crc = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        FramingIO::update_crc(block_crc, data.data(), data.size());
+    }
+    std::chrono::duration<double> block_elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(octet_crc, block_crc);
+    std::cout << "[ BENCHMARK] crc16 octet at a time: " << rounds * data.size() / octet_elapsed.count() / 1e6
+              << " MB/s, slicing-by-8: " << rounds * data.size() / block_elapsed.count() / 1e6 << " MB/s" << std::endl;
+}
+
+TEST_F(StreamFramingTests, PseudoTerminalThroughputBenchmark)
+{
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, master_fd);
+    ASSERT_EQ(0, grantpt(master_fd));
+    ASSERT_EQ(0, unlockpt(master_fd));
+    int slave_fd = open(ptsname(master_fd), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, slave_fd);
+
+    /* Raw mode on both ends, as the serial agent and client configure the ports. */
+    for (int fd : {master_fd, slave_fd})
+    {
+        struct termios attr{};
+        ASSERT_EQ(0, tcgetattr(fd, &attr));
+        cfmakeraw(&attr);
+        ASSERT_EQ(0, tcsetattr(fd, TCSANOW, &attr));
+    }
+
+    constexpr size_t frames = 20000;
+    constexpr size_t payload_size = 512;
+
+    std::thread client([&]()
+    {
+        FramingIO framing_io{
+            client_addr,
+            [&](uint8_t* buf, size_t len, TransportRc&) -> ssize_t
+            {
+                size_t written = 0;
+                while (written < len)
+                {
+                    ssize_t rv = ::write(master_fd, buf + written, len - written);
+                    if (0 > rv)
+                    {
+                        return 0;
+                    }
+                    written += size_t(rv);
+                }
+                return ssize_t(len);
+            },
+            [&](uint8_t*, size_t, int, TransportRc&) -> ssize_t { return 0; }};
+
+        std::vector<uint8_t> payload(payload_size);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            /* Regular traffic: a few flag octets per message. */
+            for (size_t j = 0; j < payload_size; ++j)
+            {
+                payload[j] = uint8_t(i + j * 13);
+            }
+            TransportRc transport_rc = TransportRc::ok;
+            framing_io.write_framed_msg(payload.data(), payload.size(), agent_addr, transport_rc);
+        }
+    });
+
+    size_t reads = 0;
+    FramingIO framing_io{
+        agent_addr,
+        [&](uint8_t*, size_t, TransportRc&) -> ssize_t { return 0; },
+        [&](uint8_t* buf, size_t len, int timeout, TransportRc& transport_rc) -> ssize_t
+        {
+            ++reads;
+            struct pollfd poll_fd{slave_fd, POLLIN, 0};
+            ssize_t rv = 0;
+            if (0 < poll(&poll_fd, 1, timeout))
+            {
+                rv = ::read(slave_fd, buf, len);
+            }
+            else
+            {
+                transport_rc = TransportRc::timeout_error;
+            }
+            return rv;
+        }};
+
+    std::vector<uint8_t> buf(max_msg_len);
+    size_t received = 0;
+    size_t timeouts = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (received < frames && timeouts < 100)
+    {
+        uint8_t remote_addr = 0;
+        TransportRc transport_rc = TransportRc::ok;
+        if (0 < framing_io.read_framed_msg(buf.data(), buf.size(), remote_addr, 10, transport_rc))
+        {
+            ++received;
+        }
+        else if (TransportRc::timeout_error == transport_rc)
+        {
+            ++timeouts;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    client.join();
+    close(slave_fd);
+    close(master_fd);
+
+    EXPECT_EQ(frames, received);
+    std::cout << "[ BENCHMARK] pty framing: "
+              << received / elapsed.count() << " frames/s, "
+              << received * payload_size / elapsed.count() / 1e6 << " MB/s, "
+              << double(reads) / double(received) << " reads/frame" << std::endl;
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
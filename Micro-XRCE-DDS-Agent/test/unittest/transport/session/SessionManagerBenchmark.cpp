@@ -0,0 +1,232 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/transport/SessionManager.hpp>
+#include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
+#include <uxr/agent/transport/endpoint/IPv6EndPoint.hpp>
+#include <uxr/agent/transport/endpoint/SerialEndPoint.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Former SessionManager lookups: ordered maps behind a single mutex, kept for comparison.
+ */
+class OrderedSessionMap
+{
+public:
+    void establish_session(
+            const IPv4EndPoint& endpoint,
+            uint32_t client_key)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        endpoint_to_client_map_[endpoint] = client_key;
+        client_to_endpoint_map_[client_key] = endpoint;
+    }
+
+    bool get_client_key(
+            const IPv4EndPoint& endpoint,
+            uint32_t& client_key)
+    {
+        bool rv = false;
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = endpoint_to_client_map_.find(endpoint);
+        if (it != endpoint_to_client_map_.end())
+        {
+            client_key = it->second;
+            rv = true;
+        }
+        return rv;
+    }
+
+    bool get_endpoint(
+            uint32_t client_key,
+            IPv4EndPoint& endpoint)
+    {
+        bool rv = false;
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = client_to_endpoint_map_.find(client_key);
+        if (it != client_to_endpoint_map_.end())
+        {
+            endpoint = it->second;
+            rv = true;
+        }
+        return rv;
+    }
+
+private:
+    std::map<IPv4EndPoint, uint32_t> endpoint_to_client_map_;
+    std::map<uint32_t, IPv4EndPoint> client_to_endpoint_map_;
+    std::mutex mtx_;
+};
+
+class SessionManagerBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t sessions = 10000;
+    static constexpr uint32_t lookups_per_thread = 500000;
+    static constexpr uint8_t session_id = 0x81;
+
+    static IPv4EndPoint endpoint_of(uint32_t i)
+    {
+        /* 10.0.x.y, one port per client. */
+        return IPv4EndPoint(0x0000000A | ((i & 0xFFFF) << 16), uint16_t(2000 + (i % 40000)));
+    }
+
+    static uint32_t client_key_of(uint32_t i)
+    {
+        return 0xAA000000 | (i * 2654435761u >> 8);
+    }
+
+    /**
+     * Every thread resolves the client of an input packet and the endpoint of an output message,
+     * as the processing workers do, and returns the number of consistent answers.
+     */
+    template<typename Map>
+    static double run(
+            Map& map,
+            uint32_t threads_count)
+    {
+        std::atomic<uint32_t> found{0};
+        std::vector<std::thread> threads;
+        auto start_time = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < threads_count; ++t)
+        {
+            threads.emplace_back([&map, &found, t]()
+            {
+                uint32_t local_found = 0;
+                uint32_t index = t * 7919;
+                for (uint32_t i = 0; i < lookups_per_thread; ++i)
+                {
+                    index = (index + 104729) % sessions;
+                    uint32_t client_key = 0;
+                    IPv4EndPoint endpoint;
+                    if (map.get_client_key(endpoint_of(index), client_key) &&
+                        map.get_endpoint(client_key, endpoint) &&
+                        (client_key_of(index) == client_key) &&
+                        (endpoint_of(index) == endpoint))
+                    {
+                        ++local_found;
+                    }
+                }
+                found += local_found;
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+        EXPECT_EQ(threads_count * lookups_per_thread, found.load());
+        return double(threads_count) * lookups_per_thread * 2
+            / std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
+    }
+};
+
+TEST_F(SessionManagerBenchmark, sessions_lifecycle)
+{
+    SessionManager<IPv4EndPoint> session_manager;
+    uint32_t client_key = 0;
+    IPv4EndPoint endpoint;
+
+    /* Sessions with the client key in the header are only resolved from agent to client. */
+    session_manager.establish_session(endpoint_of(1), client_key_of(1), 0x01);
+    ASSERT_FALSE(session_manager.get_client_key(endpoint_of(1), client_key));
+    ASSERT_TRUE(session_manager.get_endpoint(client_key_of(1), endpoint));
+    ASSERT_TRUE(endpoint_of(1) == endpoint);
+
+    /* A client reconnecting from another endpoint releases the old one. */
+    session_manager.establish_session(endpoint_of(2), client_key_of(2), session_id);
+    session_manager.establish_session(endpoint_of(3), client_key_of(2), session_id);
+    ASSERT_FALSE(session_manager.get_client_key(endpoint_of(2), client_key));
+    ASSERT_TRUE(session_manager.get_client_key(endpoint_of(3), client_key));
+    ASSERT_EQ(client_key_of(2), client_key);
+    ASSERT_TRUE(session_manager.get_endpoint(client_key_of(2), endpoint));
+    ASSERT_TRUE(endpoint_of(3) == endpoint);
+
+    session_manager.destroy_session(endpoint_of(3));
+    ASSERT_FALSE(session_manager.get_client_key(endpoint_of(3), client_key));
+    ASSERT_FALSE(session_manager.get_endpoint(client_key_of(2), endpoint));
+}
+
+TEST_F(SessionManagerBenchmark, endpoints_hash)
+{
+    /* Equal endpoints shall hash equal, and the hashes shall spread over distinct endpoints. */
+    ASSERT_TRUE(IPv4EndPoint(0x0100007F, 2018) == IPv4EndPoint(0x0100007F, 2018));
+    ASSERT_FALSE(IPv4EndPoint(0x0100007F, 2018) == IPv4EndPoint(0x0100007F, 2019));
+    ASSERT_EQ(std::hash<IPv4EndPoint>()(IPv4EndPoint(0x0100007F, 2018)),
+              std::hash<IPv4EndPoint>()(IPv4EndPoint(0x0100007F, 2018)));
+
+    std::array<uint8_t, 16> addr{};
+    addr[15] = 1;
+    ASSERT_TRUE(IPv6EndPoint(addr, 2018) == IPv6EndPoint(addr, 2018));
+    ASSERT_FALSE(IPv6EndPoint(addr, 2018) == IPv6EndPoint(addr, 2019));
+    ASSERT_EQ(std::hash<IPv6EndPoint>()(IPv6EndPoint(addr, 2018)),
+              std::hash<IPv6EndPoint>()(IPv6EndPoint(addr, 2018)));
+
+    ASSERT_TRUE(SerialEndPoint(1) == SerialEndPoint(1));
+    ASSERT_FALSE(SerialEndPoint(1) == SerialEndPoint(2));
+
+    std::unordered_map<size_t, uint32_t> hashes;
+    for (uint32_t i = 0; i < sessions; ++i)
+    {
+        ++hashes[std::hash<IPv4EndPoint>()(endpoint_of(i))];
+    }
+    ASSERT_EQ(size_t(sessions), hashes.size());
+}
+
+TEST_F(SessionManagerBenchmark, lookups)
+{
+    SessionManager<IPv4EndPoint> session_manager;
+    OrderedSessionMap ordered_map;
+    for (uint32_t i = 0; i < sessions; ++i)
+    {
+        session_manager.establish_session(endpoint_of(i), client_key_of(i), session_id);
+        ordered_map.establish_session(endpoint_of(i), client_key_of(i));
+    }
+
+    const uint32_t threads_count = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    for (uint32_t threads : {1u, threads_count})
+    {
+        double ordered_rate = run(ordered_map, threads);
+        double sharded_rate = run(session_manager, threads);
+        std::cout << "[ BENCHMARK] " << sessions << " sessions, " << threads << " threads: "
+                  << "ordered maps " << uint64_t(ordered_rate / 1000) << " klookups/s, "
+                  << "sharded hash maps " << uint64_t(sharded_rate / 1000) << " klookups/s" << std::endl;
+    }
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+#ifdef UAGENT_LOGGER_PROFILE
+    spdlog::set_level(spdlog::level::off);
+#endif
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,276 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/transport/shm/SharedMemoryRing.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class SharedMemoryRingTest : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t ring_size = 1024;
+    static constexpr size_t round_trips = 20000;
+    static constexpr size_t payload_size = 64;
+
+    SharedMemoryRingTest()
+        : size_(shm::segment_size(1, ring_size))
+    {
+        void* segment = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        segment_ = (MAP_FAILED != segment) ? static_cast<uint8_t*>(segment) : nullptr;
+        slot_ = shm::slot_at(segment_, ring_size, 0);
+    }
+
+    ~SharedMemoryRingTest()
+    {
+        munmap(segment_, size_);
+    }
+
+    static std::vector<uint8_t> make_record(
+            size_t len,
+            size_t seed)
+    {
+        std::vector<uint8_t> record(len);
+        for (size_t i = 0; i < len; ++i)
+        {
+            record[i] = uint8_t(seed * 31 + i);
+        }
+        return record;
+    }
+
+    /* Waits for a record as the client and the agent do: announce, re-check, sleep on the futex word. */
+    static ssize_t wait_read(
+            shm::RingHeader* ring,
+            uint8_t* buf,
+            size_t capacity)
+    {
+        ssize_t len = shm::ring_read(ring, ring_size, buf, capacity);
+        while (0 == len)
+        {
+            ring->waiting.store(1, std::memory_order_seq_cst);
+            uint32_t seq = ring->seq.load(std::memory_order_seq_cst);
+            len = shm::ring_read(ring, ring_size, buf, capacity);
+            if (0 == len)
+            {
+                shm::futex_wait(ring->seq, seq, 100);
+                len = shm::ring_read(ring, ring_size, buf, capacity);
+            }
+            ring->waiting.store(0, std::memory_order_relaxed);
+        }
+        return len;
+    }
+
+    static void write_notify(
+            shm::RingHeader* ring,
+            const uint8_t* buf,
+            size_t len)
+    {
+        while (!shm::ring_write(ring, ring_size, buf, len))
+        {
+            std::this_thread::yield();
+        }
+        shm::notify(ring->seq, ring->waiting);
+    }
+
+    size_t size_;
+    uint8_t* segment_;
+    shm::SlotHeader* slot_;
+};
+
+constexpr uint32_t SharedMemoryRingTest::ring_size;
+constexpr size_t SharedMemoryRingTest::round_trips;
+constexpr size_t SharedMemoryRingTest::payload_size;
+
+TEST_F(SharedMemoryRingTest, Layout)
+{
+    ASSERT_NE(nullptr, segment_);
+    uint8_t* to_agent = reinterpret_cast<uint8_t*>(shm::to_agent_ring(slot_));
+    uint8_t* to_client = reinterpret_cast<uint8_t*>(shm::to_client_ring(slot_, ring_size));
+    EXPECT_EQ(size_t(64), size_t(to_agent - segment_) - sizeof(shm::SegmentHeader));
+    EXPECT_EQ(size_t(128 + ring_size), size_t(to_client - to_agent));
+    EXPECT_EQ(size_, size_t(to_client - segment_) + 128 + ring_size);
+}
+
+TEST_F(SharedMemoryRingTest, WrapAround)
+{
+    ASSERT_NE(nullptr, segment_);
+    shm::RingHeader* ring = shm::to_agent_ring(slot_);
+    std::vector<uint8_t> buf(ring_size);
+
+    /* Record sizes not multiple of the ring size, so the records land at every offset. */
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        size_t len = 1 + (i * 37) % 300;
+        std::vector<uint8_t> record = make_record(len, i);
+        ASSERT_TRUE(shm::ring_write(ring, ring_size, record.data(), record.size()));
+        ASSERT_EQ(ssize_t(len), shm::ring_read(ring, ring_size, buf.data(), buf.size()));
+        ASSERT_TRUE(std::equal(record.begin(), record.end(), buf.begin()));
+    }
+    EXPECT_EQ(0, shm::ring_read(ring, ring_size, buf.data(), buf.size()));
+}
+
+TEST_F(SharedMemoryRingTest, Full)
+{
+    ASSERT_NE(nullptr, segment_);
+    shm::RingHeader* ring = shm::to_agent_ring(slot_);
+    std::vector<uint8_t> record = make_record(100, 0);
+    std::vector<uint8_t> buf(ring_size);
+
+    size_t written = 0;
+    while (shm::ring_write(ring, ring_size, record.data(), record.size()))
+    {
+        ++written;
+    }
+    EXPECT_EQ(size_t(ring_size / shm::record_size(record.size())), written);
+    EXPECT_FALSE(shm::ring_write(ring, ring_size, buf.data(), ring_size));
+
+    ASSERT_EQ(ssize_t(record.size()), shm::ring_read(ring, ring_size, buf.data(), buf.size()));
+    EXPECT_TRUE(shm::ring_write(ring, ring_size, record.data(), record.size()));
+}
+
+TEST_F(SharedMemoryRingTest, Oversized)
+{
+    ASSERT_NE(nullptr, segment_);
+    shm::RingHeader* ring = shm::to_agent_ring(slot_);
+    std::vector<uint8_t> large = make_record(200, 1);
+    std::vector<uint8_t> small = make_record(10, 2);
+    std::vector<uint8_t> buf(64);
+
+    ASSERT_TRUE(shm::ring_write(ring, ring_size, large.data(), large.size()));
+    ASSERT_TRUE(shm::ring_write(ring, ring_size, small.data(), small.size()));
+    EXPECT_EQ(-1, shm::ring_read(ring, ring_size, buf.data(), buf.size()));
+    ASSERT_EQ(ssize_t(small.size()), shm::ring_read(ring, ring_size, buf.data(), buf.size()));
+    EXPECT_TRUE(std::equal(small.begin(), small.end(), buf.begin()));
+}
+
+TEST_F(SharedMemoryRingTest, Stream)
+{
+    ASSERT_NE(nullptr, segment_);
+    shm::RingHeader* ring = shm::to_agent_ring(slot_);
+    constexpr size_t total = 100000;
+
+    std::thread producer([&]()
+    {
+        for (size_t i = 0; i < total; ++i)
+        {
+            std::vector<uint8_t> record = make_record(1 + i % 250, i);
+            write_notify(ring, record.data(), record.size());
+        }
+    });
+
+    std::vector<uint8_t> buf(ring_size);
+    for (size_t i = 0; i < total; ++i)
+    {
+        std::vector<uint8_t> record = make_record(1 + i % 250, i);
+        ASSERT_EQ(ssize_t(record.size()), wait_read(ring, buf.data(), buf.size()));
+        ASSERT_TRUE(std::equal(record.begin(), record.end(), buf.begin()));
+    }
+    producer.join();
+}
+
+TEST_F(SharedMemoryRingTest, RoundTripBenchmark)
+{
+    ASSERT_NE(nullptr, segment_);
+    shm::RingHeader* to_agent = shm::to_agent_ring(slot_);
+    shm::RingHeader* to_client = shm::to_client_ring(slot_, ring_size);
+    std::vector<uint8_t> payload = make_record(payload_size, 0);
+
+    std::thread echo([&]()
+    {
+        std::vector<uint8_t> buf(ring_size);
+        for (size_t i = 0; i < round_trips; ++i)
+        {
+            ssize_t len = wait_read(to_agent, buf.data(), buf.size());
+            write_notify(to_client, buf.data(), size_t(len));
+        }
+    });
+
+    std::vector<uint8_t> buf(ring_size);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < round_trips; ++i)
+    {
+        write_notify(to_agent, payload.data(), payload.size());
+        ASSERT_EQ(ssize_t(payload_size), wait_read(to_client, buf.data(), buf.size()));
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    echo.join();
+    std::cout << "[ BENCHMARK] shm round trip: " << elapsed.count() / round_trips << " us" << std::endl;
+}
+
+TEST_F(SharedMemoryRingTest, UDPRoundTripBenchmark)
+{
+    int fds[2];
+    struct sockaddr_in addrs[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        fds[i] = socket(PF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, fds[i]);
+        addrs[i] = {};
+        addrs[i].sin_family = AF_INET;
+        addrs[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(0, bind(fds[i], reinterpret_cast<struct sockaddr*>(&addrs[i]), sizeof(addrs[i])));
+        socklen_t addr_len = sizeof(addrs[i]);
+        getsockname(fds[i], reinterpret_cast<struct sockaddr*>(&addrs[i]), &addr_len);
+    }
+    std::vector<uint8_t> payload = make_record(payload_size, 0);
+
+    std::thread echo([&]()
+    {
+        uint8_t buf[ring_size];
+        for (size_t i = 0; i < round_trips; ++i)
+        {
+            ssize_t len = recv(fds[1], buf, sizeof(buf), 0);
+            sendto(fds[1], buf, size_t(len), 0, reinterpret_cast<struct sockaddr*>(&addrs[0]), sizeof(addrs[0]));
+        }
+    });
+
+    uint8_t buf[ring_size];
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < round_trips; ++i)
+    {
+        sendto(fds[0], payload.data(), payload.size(), 0,
+               reinterpret_cast<struct sockaddr*>(&addrs[1]), sizeof(addrs[1]));
+        ASSERT_EQ(ssize_t(payload_size), recv(fds[0], buf, sizeof(buf), 0));
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    echo.join();
+    std::cout << "[ BENCHMARK] udp round trip: " << elapsed.count() / round_trips << " us" << std::endl;
+    close(fds[0]);
+    close(fds[1]);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
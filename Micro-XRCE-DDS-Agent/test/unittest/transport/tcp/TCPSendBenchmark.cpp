@@ -0,0 +1,268 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/config.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Loopback benchmark of the length-prefix framing strategies available to the TCP agents:
+ * one send for the length and another for the payload, one writev per message and one
+ * gather write per batch of messages addressed to the same connection.
+ * Only correctness is asserted, the throughput is printed for comparison.
+ */
+class TCPSendBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr size_t message_size = 64;
+    static constexpr size_t total_messages = 100000;
+    static constexpr size_t batch_size = UDP_SEND_BATCH_SIZE;
+
+    TCPSendBenchmark()
+        : send_fd_(-1)
+        , recv_fd_(-1)
+        , messages_(batch_size, std::vector<uint8_t>(message_size))
+    {
+        int listener_fd = socket(PF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t address_len = sizeof(address);
+        if ((0 == bind(listener_fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)))
+            && (0 == getsockname(listener_fd, reinterpret_cast<struct sockaddr*>(&address), &address_len))
+            && (0 == listen(listener_fd, 1)))
+        {
+            send_fd_ = socket(PF_INET, SOCK_STREAM, 0);
+            if (0 == connect(send_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)))
+            {
+                recv_fd_ = accept(listener_fd, nullptr, nullptr);
+            }
+        }
+        ::close(listener_fd);
+    }
+
+    ~TCPSendBenchmark() override
+    {
+        ::close(send_fd_);
+        ::close(recv_fd_);
+    }
+
+    void SetUp() override
+    {
+        ASSERT_NE(-1, send_fd_);
+        ASSERT_NE(-1, recv_fd_);
+    }
+
+    void fill_message(
+            size_t index,
+            uint32_t sequence)
+    {
+        std::vector<uint8_t>& message = messages_[index];
+        memset(message.data(), 0xAA, message.size());
+        memcpy(message.data(), &sequence, sizeof(sequence));
+    }
+
+    bool write_all(
+            struct iovec* iovecs,
+            size_t iovcnt)
+    {
+        size_t index = 0;
+        while (index < iovcnt)
+        {
+            ssize_t bytes_sent = writev(send_fd_, iovecs + index, int(iovcnt - index));
+            if (-1 == bytes_sent)
+            {
+                return false;
+            }
+            size_t remaining = size_t(bytes_sent);
+            while ((index < iovcnt) && (remaining >= iovecs[index].iov_len))
+            {
+                remaining -= iovecs[index].iov_len;
+                ++index;
+            }
+            if (0 < remaining)
+            {
+                iovecs[index].iov_base = static_cast<uint8_t*>(iovecs[index].iov_base) + remaining;
+                iovecs[index].iov_len -= remaining;
+            }
+        }
+        return true;
+    }
+
+    bool send_split(
+            size_t count)
+    {
+        bool rv = true;
+        for (size_t i = 0; rv && (i < count); ++i)
+        {
+            uint8_t header[2] = {uint8_t(message_size & 0xFF), uint8_t((message_size >> 8) & 0xFF)};
+            struct iovec header_iovec{header, sizeof(header)};
+            struct iovec payload_iovec{messages_[i].data(), messages_[i].size()};
+            rv = write_all(&header_iovec, 1) && write_all(&payload_iovec, 1);
+        }
+        return rv;
+    }
+
+    bool send_vectored(
+            size_t count)
+    {
+        bool rv = true;
+        for (size_t i = 0; rv && (i < count); ++i)
+        {
+            uint8_t header[2] = {uint8_t(message_size & 0xFF), uint8_t((message_size >> 8) & 0xFF)};
+            struct iovec iovecs[2] = {{header, sizeof(header)}, {messages_[i].data(), messages_[i].size()}};
+            rv = write_all(iovecs, 2);
+        }
+        return rv;
+    }
+
+    bool send_gathered(
+            size_t count)
+    {
+        std::vector<std::array<uint8_t, 2>> headers(count);
+        std::vector<struct iovec> iovecs(2 * count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            headers[i] = {{uint8_t(message_size & 0xFF), uint8_t((message_size >> 8) & 0xFF)}};
+            iovecs[2 * i] = {headers[i].data(), headers[i].size()};
+            iovecs[2 * i + 1] = {messages_[i].data(), messages_[i].size()};
+        }
+        return write_all(iovecs.data(), iovecs.size());
+    }
+
+    /*
+     * Reads the framed stream the same way the client does and checks the order of the messages.
+     */
+    void receive(
+            size_t& received,
+            bool& ordered)
+    {
+        std::vector<uint8_t> buffer(SERVER_BUFFER_SIZE);
+        std::vector<uint8_t> frame;
+        frame.reserve(SERVER_BUFFER_SIZE);
+        received = 0;
+        ordered = true;
+        while (received < total_messages)
+        {
+            ssize_t bytes_received = recv(recv_fd_, buffer.data(), buffer.size(), 0);
+            if (0 >= bytes_received)
+            {
+                break;
+            }
+            frame.insert(frame.end(), buffer.begin(), buffer.begin() + bytes_received);
+
+            size_t position = 0;
+            while (2 <= (frame.size() - position))
+            {
+                size_t frame_size = size_t(frame[position]) | (size_t(frame[position + 1]) << 8);
+                if ((frame.size() - position - 2) < frame_size)
+                {
+                    break;
+                }
+                uint32_t sequence;
+                memcpy(&sequence, &frame[position + 2], sizeof(sequence));
+                ordered = ordered && (message_size == frame_size) && (uint32_t(received) == sequence);
+                ++received;
+                position += 2 + frame_size;
+            }
+            frame.erase(frame.begin(), frame.begin() + std::ptrdiff_t(position));
+        }
+    }
+
+    template<typename SendFunction>
+    void run(
+            const char* name,
+            SendFunction send_function)
+    {
+        size_t received = 0;
+        bool ordered = false;
+        auto start = std::chrono::steady_clock::now();
+        std::thread receiver(&TCPSendBenchmark::receive, this, std::ref(received), std::ref(ordered));
+
+        size_t sent = 0;
+        bool send_ok = true;
+        while (send_ok && (sent < total_messages))
+        {
+            size_t count = std::min(batch_size, total_messages - sent);
+            for (size_t i = 0; i < count; ++i)
+            {
+                fill_message(i, uint32_t(sent + i));
+            }
+            send_ok = send_function(count);
+            sent += count;
+        }
+
+        receiver.join();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        ASSERT_TRUE(send_ok);
+        ASSERT_EQ(total_messages, received);
+        ASSERT_TRUE(ordered);
+
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << "[ BENCHMARK] " << name << ": "
+                  << static_cast<uint64_t>(double(received) / seconds) << " messages/s" << std::endl;
+    }
+
+    int send_fd_;
+    int recv_fd_;
+    std::vector<std::vector<uint8_t>> messages_;
+};
+
+constexpr size_t TCPSendBenchmark::message_size;
+constexpr size_t TCPSendBenchmark::total_messages;
+constexpr size_t TCPSendBenchmark::batch_size;
+
+TEST_F(TCPSendBenchmark, split_send)
+{
+    run("send + send", [this](size_t count) { return send_split(count); });
+}
+
+TEST_F(TCPSendBenchmark, writev)
+{
+    run("writev", [this](size_t count) { return send_vectored(count); });
+}
+
+TEST_F(TCPSendBenchmark, gather_batch)
+{
+    run("gather batch", [this](size_t count) { return send_gathered(count); });
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,554 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/client/session/stream/InputStream.hpp>
+#include <uxr/agent/client/session/stream/OutputStream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+constexpr dds::xrce::SessionId session_id = 0x81;
+constexpr dds::xrce::ClientKey client_key = {0xAA, 0xBB, 0xCC, 0xDD};
+constexpr dds::xrce::StreamId stream_id = dds::xrce::STREAMID_BUILTIN_RELIABLE;
+constexpr size_t mtu = 512;
+constexpr size_t total_messages = 2000;
+constexpr size_t payload_size = 200;
+
+int open_loopback_socket(
+        struct sockaddr_in& address)
+{
+    int fd = socket(PF_INET, SOCK_DGRAM, 0);
+    address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((-1 != fd) && (0 == bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address))))
+    {
+        socklen_t address_len = sizeof(address);
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&address), &address_len);
+    }
+    return fd;
+}
+
+void send_message(
+        int fd,
+        const struct sockaddr_in& address,
+        const OutputMessagePtr& message)
+{
+    sendto(fd, message->get_buf(), message->get_len(), 0,
+           reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
+}
+
+template<class T>
+OutputMessagePtr make_control_message(
+        dds::xrce::SubmessageId submessage_id,
+        const T& payload)
+{
+    dds::xrce::MessageHeader header;
+    header.session_id(session_id);
+    header.stream_id(dds::xrce::STREAMID_NONE);
+    header.sequence_nr(0x00);
+    header.client_key(client_key);
+
+    dds::xrce::SubmessageHeader subheader;
+    OutputMessagePtr message = make_output_message(
+            header,
+            header.getCdrSerializedSize() + subheader.getCdrSerializedSize() + payload.getCdrSerializedSize());
+    message->append_submessage(submessage_id, payload);
+    return message;
+}
+
+/**
+ * Impaired link between the agent and the client: the agent to client direction goes through a
+ * bottleneck of the given rate with a drop-tail queue, and loses packets at random. The client to
+ * agent direction is forwarded as it is.
+ */
+class LossyProxy
+{
+public:
+    struct Impairment
+    {
+        double loss;            // Random loss probability.
+        size_t rate;            // Bottleneck rate in bytes per second.
+        size_t queue_limit;     // Packets queued at the bottleneck.
+        uint32_t seed;
+    };
+
+    struct Counters
+    {
+        size_t forwarded;
+        size_t random_drops;
+        size_t queue_drops;
+    };
+
+    LossyProxy(
+            const Impairment& impairment,
+            const struct sockaddr_in& client_address)
+        : impairment_(impairment)
+        , client_address_(client_address)
+        , agent_address_{}
+        , running_(false)
+        , counters_{}
+    {
+        agent_side_fd_ = open_loopback_socket(agent_side_address_);
+        client_side_fd_ = open_loopback_socket(client_side_address_);
+    }
+
+    ~LossyProxy()
+    {
+        stop();
+        ::close(agent_side_fd_);
+        ::close(client_side_fd_);
+    }
+
+    const struct sockaddr_in& address() const { return agent_side_address_; }
+
+    void start()
+    {
+        running_ = true;
+        thread_ = std::thread(&LossyProxy::run, this);
+    }
+
+    void stop()
+    {
+        running_ = false;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    Counters counters() const { return counters_; }
+
+private:
+    struct QueuedPacket
+    {
+        std::chrono::steady_clock::time_point departure;
+        std::vector<uint8_t> data;
+    };
+
+    void run()
+    {
+        using namespace std::chrono;
+
+        std::mt19937 generator(impairment_.seed);
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        std::deque<QueuedPacket> queue;
+        steady_clock::time_point last_departure = steady_clock::now();
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+
+        struct pollfd poll_fds[2] = {{agent_side_fd_, POLLIN, 0}, {client_side_fd_, POLLIN, 0}};
+        while (running_)
+        {
+            int timeout = 10;
+            if (!queue.empty())
+            {
+                const steady_clock::time_point now = steady_clock::now();
+                timeout = (queue.front().departure > now)
+                        ? int(duration_cast<milliseconds>(queue.front().departure - now).count())
+                        : 0;
+            }
+
+            if (0 < poll(poll_fds, 2, timeout))
+            {
+                if (POLLIN == (poll_fds[0].revents & POLLIN))
+                {
+                    socklen_t address_len = sizeof(agent_address_);
+                    ssize_t len = recvfrom(agent_side_fd_, buffer, sizeof(buffer), 0,
+                                           reinterpret_cast<struct sockaddr*>(&agent_address_), &address_len);
+                    if (0 < len)
+                    {
+                        if (distribution(generator) < impairment_.loss)
+                        {
+                            ++counters_.random_drops;
+                        }
+                        else if (queue.size() >= impairment_.queue_limit)
+                        {
+                            ++counters_.queue_drops;
+                        }
+                        else
+                        {
+                            const steady_clock::time_point now = steady_clock::now();
+                            last_departure = std::max(last_departure, now) +
+                                    microseconds((uint64_t(len) * std::micro::den) / impairment_.rate);
+                            queue.push_back(QueuedPacket{last_departure, std::vector<uint8_t>(buffer, buffer + len)});
+                        }
+                    }
+                }
+                if (POLLIN == (poll_fds[1].revents & POLLIN))
+                {
+                    ssize_t len = recv(client_side_fd_, buffer, sizeof(buffer), 0);
+                    if (0 < len)
+                    {
+                        sendto(agent_side_fd_, buffer, size_t(len), 0,
+                               reinterpret_cast<struct sockaddr*>(&agent_address_), sizeof(agent_address_));
+                    }
+                }
+            }
+
+            const steady_clock::time_point now = steady_clock::now();
+            while (!queue.empty() && (queue.front().departure <= now))
+            {
+                sendto(client_side_fd_, queue.front().data.data(), queue.front().data.size(), 0,
+                       reinterpret_cast<const struct sockaddr*>(&client_address_), sizeof(client_address_));
+                ++counters_.forwarded;
+                queue.pop_front();
+            }
+        }
+    }
+
+private:
+    const Impairment impairment_;
+    const struct sockaddr_in client_address_;
+    struct sockaddr_in agent_address_;
+    struct sockaddr_in agent_side_address_;
+    struct sockaddr_in client_side_address_;
+    int agent_side_fd_;
+    int client_side_fd_;
+    std::atomic<bool> running_;
+    Counters counters_;
+    std::thread thread_;
+};
+
+/**
+ * Client side: delivers the reliable stream in order, acknowledging every message and heartbeat
+ * as the client would do.
+ */
+class ReliableReceiver
+{
+public:
+    ReliableReceiver()
+        : running_(false)
+        , delivered_(0)
+        , out_of_order_(0)
+    {
+        fd_ = open_loopback_socket(address_);
+    }
+
+    ~ReliableReceiver()
+    {
+        stop();
+        ::close(fd_);
+    }
+
+    const struct sockaddr_in& address() const { return address_; }
+
+    void start()
+    {
+        running_ = true;
+        thread_ = std::thread(&ReliableReceiver::run, this);
+    }
+
+    void stop()
+    {
+        running_ = false;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    size_t delivered() const { return delivered_; }
+
+    size_t out_of_order() const { return out_of_order_; }
+
+private:
+    void run()
+    {
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+        SeqNum expected = 0;
+        struct pollfd poll_fd{fd_, POLLIN, 0};
+        while (running_)
+        {
+            if (0 >= poll(&poll_fd, 1, 10))
+            {
+                continue;
+            }
+
+            struct sockaddr_in source{};
+            socklen_t source_len = sizeof(source);
+            ssize_t len = recvfrom(fd_, buffer, sizeof(buffer), 0,
+                                   reinterpret_cast<struct sockaddr*>(&source), &source_len);
+            if (0 >= len)
+            {
+                continue;
+            }
+
+            InputMessagePtr message(new InputMessage(buffer, size_t(len)));
+            if (dds::xrce::STREAMID_NONE == message->get_header().stream_id())
+            {
+                dds::xrce::HEARTBEAT_Payload heartbeat;
+                if (message->prepare_next_submessage() &&
+                    (dds::xrce::HEARTBEAT == message->get_subheader().submessage_id()) &&
+                    message->get_payload(heartbeat))
+                {
+                    stream_.update_from_heartbeat(heartbeat.first_unacked_seq_nr(), heartbeat.last_unacked_seq_nr());
+                }
+            }
+            else
+            {
+                SeqNum seq_num = message->get_header().sequence_nr();
+                stream_.push_message(seq_num, std::move(message));
+                while (stream_.pop_message(message))
+                {
+                    if (SeqNum(message->get_header().sequence_nr()) != expected)
+                    {
+                        ++out_of_order_;
+                    }
+                    expected = SeqNum(message->get_header().sequence_nr()) + 1;
+                    ++delivered_;
+                }
+            }
+
+            dds::xrce::ACKNACK_Payload acknack;
+            stream_.fill_acknack(acknack);
+            acknack.stream_id(stream_id);
+            send_message(fd_, source, make_control_message(dds::xrce::ACKNACK, acknack));
+        }
+    }
+
+private:
+    int fd_;
+    struct sockaddr_in address_;
+    ReliableInputStream stream_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> delivered_;
+    std::atomic<size_t> out_of_order_;
+    std::thread thread_;
+};
+
+/**
+ * Loopback impairment harness of the reliable output stream: the agent side below plays the part
+ * of the Processor (NACK retransmissions, acknowledgements, heartbeats on the retransmission
+ * timeout) over a LossyProxy. The delivery is asserted, the stats are printed for comparison.
+ */
+class ReliableStreamImpairmentTest : public ::testing::Test
+{
+protected:
+    struct Result
+    {
+        size_t delivered;
+        size_t out_of_order;
+        std::chrono::milliseconds elapsed;
+        ReliableOutputStream::Stats stats;
+        LossyProxy::Counters link;
+    };
+
+    Result run(
+            const LossyProxy::Impairment& impairment,
+            bool congestion_control)
+    {
+        using namespace std::chrono;
+
+        ReliableReceiver receiver;
+        LossyProxy proxy(impairment, receiver.address());
+        struct sockaddr_in agent_address;
+        int fd = open_loopback_socket(agent_address);
+        receiver.start();
+        proxy.start();
+
+        ReliableOutputStream stream;
+        stream.set_congestion_controller(congestion_control
+                ? std::unique_ptr<CongestionController>(new AimdCongestionController(RELIABLE_STREAM_DEPTH))
+                : nullptr);
+
+        const SessionInfo session_info{client_key, session_id, mtu, ACKNACK_BITMAP_WINDOW};
+        dds::xrce::WRITE_DATA_Payload_Data write_data{};
+        write_data.data().serialized_data().resize(payload_size);
+
+        size_t pushed = 0;
+        bool armed = false;
+        steady_clock::time_point heartbeat_time;
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+        OutputMessagePtr message;
+
+        const steady_clock::time_point start = steady_clock::now();
+        const steady_clock::time_point deadline = start + seconds(30);
+        while ((receiver.delivered() < total_messages) && (steady_clock::now() < deadline))
+        {
+            while ((pushed < total_messages) &&
+                   stream.push_submessage(session_info, stream_id, dds::xrce::WRITE_DATA, write_data, milliseconds(0)))
+            {
+                ++pushed;
+            }
+            while (stream.get_next_message(message))
+            {
+                send_message(fd, proxy.address(), message);
+                if (!armed)
+                {
+                    heartbeat_time = steady_clock::now() + stream.get_retransmission_timeout();
+                    armed = true;
+                }
+            }
+
+            /* Wait for an ACKNACK, the heartbeat or the pacer. */
+            steady_clock::time_point wakeup = steady_clock::now() + milliseconds(10);
+            steady_clock::time_point flush_time;
+            if (stream.get_flush_time(flush_time))
+            {
+                wakeup = std::min(wakeup, flush_time);
+            }
+            if (armed)
+            {
+                wakeup = std::min(wakeup, heartbeat_time);
+            }
+            const steady_clock::time_point now = steady_clock::now();
+            const int timeout = (wakeup > now) ? int(duration_cast<milliseconds>(wakeup - now).count()) : 0;
+
+            struct pollfd poll_fd{fd, POLLIN, 0};
+            ssize_t len = (0 < poll(&poll_fd, 1, timeout)) ? recv(fd, buffer, sizeof(buffer), 0) : -1;
+            if (0 < len)
+            {
+                InputMessage input_message(buffer, size_t(len));
+                dds::xrce::ACKNACK_Payload acknack;
+                if (input_message.prepare_next_submessage() && input_message.get_payload(acknack))
+                {
+                    const uint16_t first_unacked = acknack.first_unacked_seq_num();
+                    for (uint16_t i = 0; i < 8; ++i)
+                    {
+                        const uint8_t mask = uint8_t(0x01 << i);
+                        if (((acknack.nack_bitmap().at(1) & mask) == mask) &&
+                            stream.get_message(SeqNum(first_unacked + i), message))
+                        {
+                            send_message(fd, proxy.address(), message);
+                        }
+                        if (((acknack.nack_bitmap().at(0) & mask) == mask) &&
+                            stream.get_message(SeqNum(first_unacked + i + 8), message))
+                        {
+                            send_message(fd, proxy.address(), message);
+                        }
+                    }
+
+                    dds::xrce::HEARTBEAT_Payload heartbeat;
+                    const bool acked = stream.fill_heartbeat(heartbeat) &&
+                            (SeqNum(first_unacked) > SeqNum(heartbeat.first_unacked_seq_nr()));
+                    stream.update_from_acknack(first_unacked);
+                    if (!stream.fill_heartbeat(heartbeat))
+                    {
+                        armed = false;
+                    }
+                    else if (acked)
+                    {
+                        heartbeat_time = steady_clock::now() + stream.get_retransmission_timeout();
+                        armed = true;
+                    }
+                }
+            }
+
+            /* Retransmission timeout, as Processor::send_heartbeat. */
+            dds::xrce::HEARTBEAT_Payload heartbeat;
+            if (armed && (steady_clock::now() >= heartbeat_time) && stream.fill_heartbeat(heartbeat))
+            {
+                if (stream.get_message(heartbeat.first_unacked_seq_nr(), message))
+                {
+                    send_message(fd, proxy.address(), message);
+                }
+                heartbeat.stream_id(stream_id);
+                send_message(fd, proxy.address(), make_control_message(dds::xrce::HEARTBEAT, heartbeat));
+                stream.back_off_retransmission();
+                heartbeat_time = steady_clock::now() + stream.get_retransmission_timeout();
+            }
+        }
+
+        Result result;
+        result.elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+        result.stats = stream.get_stats();
+        proxy.stop();
+        receiver.stop();
+        ::close(fd);
+        result.delivered = receiver.delivered();
+        result.out_of_order = receiver.out_of_order();
+        result.link = proxy.counters();
+        return result;
+    }
+
+    static void print(
+            const char* name,
+            const Result& result)
+    {
+        std::cout << name << ": "
+                  << result.delivered << " messages in " << result.elapsed.count() << " ms, "
+                  << result.stats.retransmitted << " retransmitted, "
+                  << result.stats.loss_events << " loss events, "
+                  << result.stats.timeouts << " timeouts, "
+                  << "window " << result.stats.window << ", "
+                  << "pacing " << result.stats.pacing_rate << " B/s, "
+                  << "srtt " << result.stats.srtt.count() << " us, "
+                  << "link drops " << result.link.random_drops << " random / "
+                  << result.link.queue_drops << " queue" << std::endl;
+    }
+};
+
+TEST_F(ReliableStreamImpairmentTest, RandomLoss)
+{
+    const LossyProxy::Impairment impairment{0.02, 4 * 1024 * 1024, 64, 0x5EED};
+
+    const Result result = run(impairment, true);
+    print("AIMD", result);
+    ASSERT_EQ(result.delivered, total_messages);
+    ASSERT_EQ(result.out_of_order, 0u);
+    ASSERT_GT(result.link.random_drops, 0u);
+    ASSERT_GT(result.stats.retransmitted, 0u);
+    ASSERT_GT(result.stats.loss_events, 0u);
+}
+
+TEST_F(ReliableStreamImpairmentTest, Bottleneck)
+{
+    /* A queue shorter than the stream depth, a full window overflows it. */
+    const LossyProxy::Impairment impairment{0.01, 1024 * 1024, RELIABLE_STREAM_DEPTH / 4, 0x5EED};
+
+    const Result controlled = run(impairment, true);
+    print("AIMD", controlled);
+    ASSERT_EQ(controlled.delivered, total_messages);
+    ASSERT_EQ(controlled.out_of_order, 0u);
+    ASSERT_GT(controlled.stats.loss_events, 0u);
+    ASSERT_GT(controlled.stats.srtt.count(), 0);
+
+    const Result uncontrolled = run(impairment, false);
+    print("None", uncontrolled);
+    ASSERT_EQ(uncontrolled.delivered, total_messages);
+    ASSERT_EQ(uncontrolled.out_of_order, 0u);
+    ASSERT_EQ(uncontrolled.stats.loss_events, 0u);
+
+    /* Bounding the messages in flight to what the bottleneck can take spares most retransmissions. */
+    ASSERT_LT(controlled.stats.retransmitted, uncontrolled.stats.retransmitted);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
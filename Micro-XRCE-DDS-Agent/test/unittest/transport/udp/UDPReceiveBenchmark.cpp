@@ -0,0 +1,227 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/config.hpp>
+#include <uxr/agent/message/Packet.hpp>
+#include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+/**
+ * Loopback benchmark of the two receive strategies available to the UDP agents:
+ * the legacy poll + recvfrom per datagram and the batched poll + recvmmsg.
+ * Only correctness is asserted, the throughput is printed for comparison.
+ */
+class UDPReceiveBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr size_t packet_size = 64;
+    static constexpr size_t total_packets = 200000;
+    static constexpr size_t burst_size = UDP_RECV_BATCH_SIZE;
+
+    UDPReceiveBenchmark()
+        : payload_(packet_size, 0xAA)
+    {
+        recv_fd_ = socket(PF_INET, SOCK_DGRAM, 0);
+        send_fd_ = socket(PF_INET, SOCK_DGRAM, 0);
+
+        int rcvbuf = 4 * 1024 * 1024;
+        setsockopt(recv_fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(recv_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address));
+
+        socklen_t address_len = sizeof(recv_addr_);
+        getsockname(recv_fd_, reinterpret_cast<struct sockaddr*>(&recv_addr_), &address_len);
+    }
+
+    ~UDPReceiveBenchmark() override
+    {
+        ::close(recv_fd_);
+        ::close(send_fd_);
+    }
+
+    void SetUp() override
+    {
+        ASSERT_NE(-1, recv_fd_);
+        ASSERT_NE(-1, send_fd_);
+        ASSERT_NE(0, recv_addr_.sin_port);
+    }
+
+    void send_burst()
+    {
+        for (size_t i = 0; i < burst_size; ++i)
+        {
+            sendto(
+                send_fd_,
+                payload_.data(),
+                payload_.size(),
+                0,
+                reinterpret_cast<struct sockaddr*>(&recv_addr_),
+                sizeof(recv_addr_));
+        }
+    }
+
+    size_t recv_single(
+            std::vector<InputPacket<IPv4EndPoint>>& input_packets)
+    {
+        size_t received = 0;
+        uint8_t buffer[SERVER_BUFFER_SIZE];
+        struct pollfd poll_fd{recv_fd_, POLLIN, 0};
+        while (received < burst_size && 0 < poll(&poll_fd, 1, 100))
+        {
+            struct sockaddr_in client_addr{};
+            socklen_t client_addr_len = sizeof(client_addr);
+            ssize_t bytes_received =
+                recvfrom(
+                    recv_fd_,
+                    buffer,
+                    sizeof(buffer),
+                    0,
+                    reinterpret_cast<struct sockaddr*>(&client_addr),
+                    &client_addr_len);
+            if (-1 == bytes_received)
+            {
+                break;
+            }
+            InputPacket<IPv4EndPoint> input_packet;
+            input_packet.message.reset(new InputMessage(buffer, size_t(bytes_received)));
+            input_packet.source = IPv4EndPoint(client_addr.sin_addr.s_addr, client_addr.sin_port);
+            input_packets.push_back(std::move(input_packet));
+            ++received;
+        }
+        return received;
+    }
+
+    size_t recv_batch(
+            std::vector<InputPacket<IPv4EndPoint>>& input_packets)
+    {
+        static std::vector<uint8_t> buffer(burst_size * SERVER_BUFFER_SIZE);
+        static std::vector<struct iovec> iovecs(burst_size);
+        static std::vector<struct sockaddr_in> addrs(burst_size);
+        static std::vector<struct mmsghdr> msgs(burst_size);
+
+        size_t received = 0;
+        struct pollfd poll_fd{recv_fd_, POLLIN, 0};
+        while (received < burst_size && 0 < poll(&poll_fd, 1, 100))
+        {
+            for (size_t i = 0; i < burst_size; ++i)
+            {
+                iovecs[i].iov_base = buffer.data() + (i * SERVER_BUFFER_SIZE);
+                iovecs[i].iov_len = SERVER_BUFFER_SIZE;
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+                msgs[i].msg_hdr.msg_iov = &iovecs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            int msgs_received =
+                recvmmsg(
+                    recv_fd_,
+                    msgs.data(),
+                    static_cast<unsigned int>(burst_size - received),
+                    MSG_DONTWAIT,
+                    nullptr);
+            if (0 >= msgs_received)
+            {
+                break;
+            }
+            for (int i = 0; i < msgs_received; ++i)
+            {
+                InputPacket<IPv4EndPoint> input_packet;
+                input_packet.message.reset(
+                    new InputMessage(static_cast<uint8_t*>(iovecs[i].iov_base), size_t(msgs[i].msg_len)));
+                input_packet.source = IPv4EndPoint(addrs[i].sin_addr.s_addr, addrs[i].sin_port);
+                input_packets.push_back(std::move(input_packet));
+            }
+            received += size_t(msgs_received);
+        }
+        return received;
+    }
+
+    template<typename RecvFunction>
+    void run(
+            const char* name,
+            RecvFunction recv_function)
+    {
+        std::vector<InputPacket<IPv4EndPoint>> input_packets;
+        input_packets.reserve(burst_size);
+
+        size_t received = 0;
+        std::chrono::nanoseconds elapsed{0};
+        while (received < total_packets)
+        {
+            send_burst();
+            auto start = std::chrono::steady_clock::now();
+            size_t burst_received = recv_function(input_packets);
+            elapsed += std::chrono::steady_clock::now() - start;
+            ASSERT_EQ(burst_size, burst_received);
+            for (auto& input_packet : input_packets)
+            {
+                ASSERT_EQ(packet_size, input_packet.message->get_len());
+            }
+            input_packets.clear();
+            received += burst_received;
+        }
+
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << "[ BENCHMARK] " << name << ": "
+                  << static_cast<uint64_t>(double(received) / seconds) << " packets/s" << std::endl;
+    }
+
+    int recv_fd_;
+    int send_fd_;
+    struct sockaddr_in recv_addr_{};
+    std::vector<uint8_t> payload_;
+};
+
+constexpr size_t UDPReceiveBenchmark::packet_size;
+constexpr size_t UDPReceiveBenchmark::total_packets;
+constexpr size_t UDPReceiveBenchmark::burst_size;
+
+TEST_F(UDPReceiveBenchmark, recvfrom)
+{
+    run("recvfrom", [this](std::vector<InputPacket<IPv4EndPoint>>& packets) { return recv_single(packets); });
+}
+
+TEST_F(UDPReceiveBenchmark, recvmmsg)
+{
+    run("recvmmsg", [this](std::vector<InputPacket<IPv4EndPoint>>& packets) { return recv_batch(packets); });
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
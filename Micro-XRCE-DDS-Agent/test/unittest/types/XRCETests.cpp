@@ -16,11 +16,13 @@
 
 #include <uxr/agent/message/InputMessage.hpp>
 #include <uxr/agent/message/OutputMessage.hpp>
+#include <uxr/agent/types/SharedDataPayload.hpp>
 
 #include <fastcdr/exceptions/BadParamException.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <iomanip>
@@ -245,6 +247,28 @@ TEST_F(SerializerDeserializerTests, DataSubmessage)
     ASSERT_EQ(data_payload.data().serialized_data(), deserialized_data.data().serialized_data());
 }
 
+TEST_F(SerializerDeserializerTests, SharedDataSubmessage)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::DATA_Payload_Data data_payload = generate_data_payload_data();
+    SharedDataPayload shared_data_payload{
+        data_payload.request_id(), data_payload.object_id(), data_payload.data().serialized_data()};
+    ASSERT_EQ(data_payload.getCdrSerializedSize(), shared_data_payload.getCdrSerializedSize());
+
+    dds::xrce::SubmessageHeader submessage_header;
+    size_t message_size = message_header.getCdrSerializedSize() +
+                          submessage_header.getCdrSerializedSize() +
+                          data_payload.getCdrSerializedSize();
+
+    OutputMessage output(message_header, message_size);
+    ASSERT_TRUE(output.append_submessage(dds::xrce::DATA, data_payload));
+    OutputMessage shared_output(message_header, message_size);
+    ASSERT_TRUE(shared_output.append_submessage(dds::xrce::DATA, shared_data_payload));
+
+    ASSERT_EQ(output.get_len(), shared_output.get_len());
+    ASSERT_TRUE(std::equal(output.get_buf(), output.get_buf() + output.get_len(), shared_output.get_buf()));
+}
+
 TEST_F(SerializerDeserializerTests, DeleteSubmessage)
 {
     dds::xrce::MessageHeader message_header = generate_message_header();
@@ -266,6 +290,37 @@ TEST_F(SerializerDeserializerTests, DeleteSubmessage)
     ASSERT_EQ(delete_payload.request_id(), deserialized_data.request_id());
 }
 
+TEST_F(SerializerDeserializerTests, AgentRepresentationProperties)
+{
+    dds::xrce::Property property;
+    property.name("uxr_nack_window");
+    property.value("64");
+    dds::xrce::AGENT_Representation agent_representation;
+    agent_representation.properties(dds::xrce::PropertySeq{property});
+
+    dds::xrce::AGENT_Representation copied(agent_representation);
+    ASSERT_TRUE(bool(copied.properties()));
+    ASSERT_EQ(1u, copied.properties()->size());
+    ASSERT_EQ("uxr_nack_window", copied.properties()->at(0).name());
+    ASSERT_EQ("64", copied.properties()->at(0).value());
+
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::SubmessageHeader submessage_header;
+    size_t message_size = message_header.getCdrSerializedSize() +
+                          submessage_header.getCdrSerializedSize() +
+                          copied.getCdrSerializedSize();
+
+    OutputMessage output(message_header, message_size);
+    ASSERT_TRUE(output.append_submessage(dds::xrce::STATUS_AGENT, copied));
+
+    dds::xrce::AGENT_Representation deserialized_data;
+    InputMessage input(output.get_buf(), output.get_len());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_TRUE(input.get_payload(deserialized_data));
+    ASSERT_TRUE(bool(deserialized_data.properties()));
+    ASSERT_EQ("64", deserialized_data.properties()->at(0).value());
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
@@ -0,0 +1,111 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/utils/RttEstimator.hpp>
+
+#include <gtest/gtest.h>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+using eprosima::uxr::utils::RttEstimator;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+class RttEstimatorTest : public ::testing::Test
+{
+protected:
+    RttEstimatorTest()
+        : estimator_(milliseconds(200), milliseconds(20), milliseconds(1600))
+    {}
+
+    RttEstimator estimator_;
+};
+
+TEST_F(RttEstimatorTest, initial_condition)
+{
+    ASSERT_FALSE(estimator_.has_sample());
+    ASSERT_EQ(estimator_.rto(), milliseconds(200));
+}
+
+TEST_F(RttEstimatorTest, first_sample)
+{
+    /* SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 * RTTVAR. */
+    estimator_.add_sample(milliseconds(40));
+    ASSERT_TRUE(estimator_.has_sample());
+    ASSERT_EQ(estimator_.srtt(), milliseconds(40));
+    ASSERT_EQ(estimator_.rttvar(), milliseconds(20));
+    ASSERT_EQ(estimator_.rto(), milliseconds(120));
+}
+
+TEST_F(RttEstimatorTest, smoothing)
+{
+    estimator_.add_sample(milliseconds(40));
+    estimator_.add_sample(milliseconds(80));
+
+    /* RTTVAR = 3/4 * 20 + 1/4 * |40 - 80|, SRTT = 7/8 * 40 + 1/8 * 80. */
+    ASSERT_EQ(estimator_.rttvar(), milliseconds(25));
+    ASSERT_EQ(estimator_.srtt(), milliseconds(45));
+    ASSERT_EQ(estimator_.rto(), milliseconds(145));
+
+    /* A steady round-trip time makes the timeout converge to it, but not below the lower bound. */
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator_.add_sample(microseconds(500));
+    }
+    ASSERT_LT(estimator_.srtt(), milliseconds(1));
+    ASSERT_EQ(estimator_.rto(), milliseconds(20));
+}
+
+TEST_F(RttEstimatorTest, rounding)
+{
+    /* The timeout is rounded up to the millisecond. */
+    estimator_.add_sample(microseconds(10100));
+    ASSERT_EQ(estimator_.rto(), milliseconds(31));
+}
+
+TEST_F(RttEstimatorTest, back_off)
+{
+    estimator_.add_sample(milliseconds(40));
+    estimator_.back_off();
+    ASSERT_EQ(estimator_.rto(), milliseconds(240));
+    estimator_.back_off();
+    ASSERT_EQ(estimator_.rto(), milliseconds(480));
+
+    /* Bounded by the upper limit. */
+    for (int i = 0; i < 32; ++i)
+    {
+        estimator_.back_off();
+    }
+    ASSERT_EQ(estimator_.rto(), milliseconds(1600));
+
+    estimator_.reset_back_off();
+    ASSERT_EQ(estimator_.rto(), milliseconds(120));
+
+    /* A new sample also undoes the back-off. */
+    estimator_.back_off();
+    estimator_.add_sample(milliseconds(40));
+    ASSERT_LT(estimator_.rto(), milliseconds(240));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
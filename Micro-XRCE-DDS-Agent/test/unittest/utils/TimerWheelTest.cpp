@@ -0,0 +1,157 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/utils/TimerWheel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+using eprosima::uxr::utils::TimerWheel;
+using std::chrono::milliseconds;
+
+class TimerWheelTest : public ::testing::Test
+{
+protected:
+    TimerWheelTest()
+        : origin_(std::chrono::steady_clock::now())
+        , wheel_(milliseconds(1), origin_)
+    {}
+
+    std::chrono::steady_clock::time_point at(
+            uint64_t ms) const
+    {
+        return origin_ + milliseconds(ms);
+    }
+
+    std::chrono::steady_clock::time_point origin_;
+    TimerWheel<uint32_t> wheel_;
+};
+
+TEST_F(TimerWheelTest, levels)
+{
+    /* One timer per level. */
+    const std::vector<uint64_t> delays{5, 70, 5000, 300000};
+    for (uint32_t i = 0; i < delays.size(); ++i)
+    {
+        ASSERT_TRUE(wheel_.arm(i, milliseconds(delays[i]), at(0)));
+    }
+    ASSERT_EQ(delays.size(), wheel_.size());
+
+    for (uint32_t i = 0; i < delays.size(); ++i)
+    {
+        std::vector<uint32_t> expired;
+        wheel_.advance(at(delays[i] - 1), expired);
+        ASSERT_TRUE(expired.empty());
+        wheel_.advance(at(delays[i]), expired);
+        ASSERT_EQ(std::vector<uint32_t>{i}, expired);
+    }
+    ASSERT_EQ(0u, wheel_.size());
+}
+
+TEST_F(TimerWheelTest, arm_rearm_cancel)
+{
+    ASSERT_TRUE(wheel_.arm(1, milliseconds(10), at(0)));
+    ASSERT_FALSE(wheel_.arm(1, milliseconds(5), at(0)));
+    ASSERT_TRUE(wheel_.arm(2, milliseconds(10), at(0)));
+    ASSERT_TRUE(wheel_.cancel(2));
+    ASSERT_FALSE(wheel_.cancel(2));
+    wheel_.rearm(3, milliseconds(10), at(0));
+    wheel_.rearm(3, milliseconds(100), at(0));
+    ASSERT_EQ(milliseconds(11), wheel_.time_to_next_expiration(at(0)));
+
+    std::vector<uint32_t> expired;
+    wheel_.advance(at(50), expired);
+    ASSERT_EQ(std::vector<uint32_t>{1}, expired);
+
+    expired.clear();
+    wheel_.advance(at(100), expired);
+    ASSERT_EQ(std::vector<uint32_t>{3}, expired);
+    ASSERT_EQ(milliseconds::max(), wheel_.time_to_next_expiration(at(100)));
+}
+
+TEST_F(TimerWheelTest, next_expiration)
+{
+    /* Level 1 timer expiring before the level 0 one armed later. */
+    ASSERT_TRUE(wheel_.arm(0, milliseconds(70), at(0)));
+    std::vector<uint32_t> expired;
+    wheel_.advance(at(60), expired);
+    ASSERT_TRUE(wheel_.arm(1, milliseconds(30), at(60)));
+    ASSERT_GE(milliseconds(11), wheel_.time_to_next_expiration(at(60)));
+
+    wheel_.advance(at(70), expired);
+    ASSERT_EQ(std::vector<uint32_t>{0}, expired);
+    ASSERT_EQ(milliseconds(21), wheel_.time_to_next_expiration(at(70)));
+}
+
+TEST_F(TimerWheelTest, random_timers)
+{
+    constexpr uint32_t timers = 10000;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint64_t> delay_distribution(1, 20000);
+    std::uniform_int_distribution<uint64_t> step_distribution(1, 50);
+
+    std::vector<uint64_t> deadlines(timers);
+    for (uint32_t i = 0; i < timers; ++i)
+    {
+        deadlines[i] = delay_distribution(generator);
+        wheel_.arm(i, milliseconds(deadlines[i]), at(0));
+    }
+
+    /* Every timer expires on the first advance that reaches its deadline. */
+    uint64_t previous = 0;
+    uint64_t now = 0;
+    std::vector<bool> fired(timers, false);
+    while (0 < wheel_.size())
+    {
+        now += step_distribution(generator);
+        std::vector<uint32_t> expired;
+        wheel_.advance(at(now), expired);
+        for (uint32_t key : expired)
+        {
+            ASSERT_FALSE(fired[key]);
+            ASSERT_GT(deadlines[key], previous);
+            ASSERT_LE(deadlines[key], now);
+            fired[key] = true;
+        }
+        previous = now;
+
+        /* The wake-up time is never later than the next deadline. */
+        uint64_t next_deadline = UINT64_MAX;
+        for (uint32_t i = 0; i < timers; ++i)
+        {
+            next_deadline = fired[i] ? next_deadline : std::min(next_deadline, deadlines[i]);
+        }
+        if (UINT64_MAX != next_deadline)
+        {
+            ASSERT_GE(milliseconds(next_deadline - now + 1), wheel_.time_to_next_expiration(at(now)));
+        }
+    }
+    ASSERT_EQ(std::vector<bool>(timers, true), fired);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
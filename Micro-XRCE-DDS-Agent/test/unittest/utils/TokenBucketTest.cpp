@@ -147,6 +147,31 @@ TEST_F(TokenBucketTest, rate_with_empty_bucket)
     ASSERT_EQ(requested_tokens / bunch_size, reading_counter);
 }
 
+TEST_F(TokenBucketTest, set_rate)
+{
+    const size_t rate = 64000;
+    const size_t capacity = 10 * rate;
+    TokenBucket bucket{rate, capacity};
+
+    /* The available tokens are kept up to the new capacity. */
+    bucket.set_rate(2 * rate);
+    ASSERT_EQ(bucket.get_rate(), 2 * rate);
+    ASSERT_EQ(bucket.get_capacity(), 2 * rate);
+    ASSERT_EQ(bucket.get_available_tokens(), 2 * rate);
+
+    std::chrono::milliseconds wait_time;
+    ASSERT_TRUE(bucket.try_consume_tokens(rate, wait_time));
+    bucket.set_rate(rate, capacity);
+    ASSERT_EQ(bucket.get_capacity(), capacity);
+    ASSERT_LE(bucket.get_available_tokens(), 2 * rate);
+
+    /* The tokens are refilled at the new rate. */
+    ASSERT_TRUE(bucket.try_consume_tokens(bucket.get_available_tokens(), wait_time));
+    ASSERT_FALSE(bucket.try_consume_tokens(rate, wait_time));
+    ASSERT_GT(wait_time, std::chrono::milliseconds(900));
+    ASSERT_LE(wait_time, std::chrono::milliseconds(1001));
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
@@ -54,6 +54,7 @@ typedef struct uxrSessionInfo
     uint8_t key[4];
     uint8_t last_requested_status;
     uint16_t last_request_id;
+    uint16_t nack_window;
 
 } uxrSessionInfo;
 
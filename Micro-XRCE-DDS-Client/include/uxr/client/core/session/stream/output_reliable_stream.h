@@ -45,6 +45,13 @@ typedef struct uxrOutputReliableStream
     uint8_t next_heartbeat_tries;           // 下次发送心跳的尝试次数
     bool send_lost;                         // 是否有丢失
 
+    int64_t rtt_timestamp;                  // send time of the message timed for a round-trip sample
+    uxrSeqNum rtt_seq_num;                  // message timed for a round-trip sample
+    bool rtt_sampling;                      // whether a message is being timed
+    int32_t srtt;                           // smoothed round-trip time in 1/8 ms, negative until the first sample
+    int32_t rttvar;                         // round-trip time variation in 1/4 ms
+    int32_t rto;                            // retransmission timeout in ms, doubled on each expiration
+
 } uxrOutputReliableStream;
 
 #ifdef __cplusplus
@@ -0,0 +1,60 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_CLIENT_SHM_TRANSPORT_H_
+#define UXR_CLIENT_SHM_TRANSPORT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // ifdef __cplusplus
+
+#include <uxr/client/core/communication/communication.h>
+#include <uxr/client/config.h>
+#include <uxr/client/visibility.h>
+#include <uxr/client/transport.h>
+
+typedef struct uxrSHMTransport
+{
+    uint8_t buffer[UXR_CONFIG_SHM_TRANSPORT_MTU];
+    uxrCommunication comm;
+    struct uxrSHMPlatform platform;
+} uxrSHMTransport;
+
+/**
+ * @brief Initializes a shared memory transport with an Agent running on the same host.
+ *        The Agent shall have been started with the shm transport, the client takes one of its free slots.
+ * @param transport     The uninitialized transport structure used for managing the transport.
+ *                      This structure must be accesible during the connection.
+ * @param name          The name of the shared memory segment of the Agent, "/uxr_agent" by default.
+ * @return `true` in case of successful initialization. `false` in other case.
+ */
+UXRDLLAPI bool uxr_init_shm_transport(
+        uxrSHMTransport* transport,
+        const char* name);
+
+/**
+ * @brief Closes a shared memory transport, releasing its slot.
+ * @param transport The transport structure.
+ * @return `true` in case of successful closing. `false` in other case.
+ */
+UXRDLLAPI bool uxr_close_shm_transport(
+        uxrSHMTransport* transport);
+
+
+#ifdef __cplusplus
+}
+#endif // ifdef __cplusplus
+
+#endif // UXR_CLIENT_SHM_TRANSPORT_H_
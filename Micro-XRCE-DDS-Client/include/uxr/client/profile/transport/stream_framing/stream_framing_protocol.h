@@ -19,6 +19,8 @@ extern "C"
 {
 #endif // ifdef __cplusplus
 
+#include <uxr/client/config.h>
+
 #include <stdint.h>
 
 #define UXR_FRAMING_BEGIN_FLAG 0x7E
@@ -42,16 +44,16 @@ typedef struct uxrFramingIO
 {
     uxrFramingInputState state;
     uint8_t local_addr;
-    uint8_t rb[42];
-    uint8_t rb_head;
-    uint8_t rb_tail;
+    uint8_t rb[UXR_CONFIG_STREAM_FRAMING_BUFFER_SIZE];
+    uint16_t rb_head;
+    uint16_t rb_tail;
     uint8_t src_addr;
     uint16_t msg_len;
     uint16_t msg_pos;
     uint16_t msg_crc;
     uint16_t cmp_crc;
-    uint8_t wb[42];
-    uint8_t wb_pos;
+    uint8_t wb[UXR_CONFIG_STREAM_FRAMING_BUFFER_SIZE];
+    uint16_t wb_pos;
 
 } uxrFramingIO;
 
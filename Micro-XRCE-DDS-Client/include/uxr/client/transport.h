@@ -52,6 +52,11 @@
 #include <uxr/client/profile/transport/serial/serial_transport.h>
 #endif //UCLIENT_PROFILE_SERIAL
 
+#ifdef UCLIENT_PROFILE_SHM
+#include <uxr/client/profile/transport/shm/shm_transport_posix.h>
+#include <uxr/client/profile/transport/shm/shm_transport.h>
+#endif //UCLIENT_PROFILE_SHM
+
 #ifdef UCLIENT_PROFILE_CUSTOM_TRANSPORT
 #include <uxr/client/profile/transport/custom/custom_transport.h>
 #endif //UCLIENT_PROFILE_CUSTOM_TRANSPORT
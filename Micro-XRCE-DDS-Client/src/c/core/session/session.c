@@ -17,10 +17,14 @@
 #include "../log/log_internal.h"
 #include "../../util/time_internal.h"
 
-#define CREATE_SESSION_MAX_MSG_SIZE (MAX_HEADER_SIZE + SUBHEADER_SIZE + CREATE_CLIENT_PAYLOAD_SIZE)
+#define CREATE_SESSION_MAX_MSG_SIZE (MAX_HEADER_SIZE + SUBHEADER_SIZE + CREATE_CLIENT_MAX_PAYLOAD_SIZE)
 #define DELETE_SESSION_MAX_MSG_SIZE (MAX_HEADER_SIZE + SUBHEADER_SIZE + DELETE_CLIENT_PAYLOAD_SIZE)
 #define HEARTBEAT_MAX_MSG_SIZE      (MAX_HEADER_SIZE + SUBHEADER_SIZE + HEARTBEAT_PAYLOAD_SIZE)
 #define ACKNACK_MAX_MSG_SIZE        (MAX_HEADER_SIZE + SUBHEADER_SIZE + ACKNACK_PAYLOAD_SIZE)
+#define NACK_RANGE_MAX_SIZE         (3 + SUBHEADER_SIZE + ACKNACK_PAYLOAD_SIZE)
+#define NACK_RANGES_MAX             ((UXR_CONFIG_NACK_WINDOW > ACKNACK_BITMAP_WINDOW) ? \
+                                     (UXR_CONFIG_NACK_WINDOW / ACKNACK_BITMAP_WINDOW) - 1 : 0)
+#define ACKNACK_RANGES_MAX_MSG_SIZE (ACKNACK_MAX_MSG_SIZE + NACK_RANGES_MAX * NACK_RANGE_MAX_SIZE)
 #define TIMESTAMP_PAYLOAD_SIZE      8
 #define TIMESTAMP_MAX_MSG_SIZE      (MAX_HEADER_SIZE + SUBHEADER_SIZE + TIMESTAMP_PAYLOAD_SIZE)
 
@@ -88,7 +92,8 @@ static void read_submessage_heartbeat(
         ucdrBuffer* submessage);
 static void read_submessage_acknack(
         uxrSession* session,
-        ucdrBuffer* submessage);
+        ucdrBuffer* submessage,
+        uint8_t flags);
 static void read_submessage_timestamp_reply(
         uxrSession* session,
         ucdrBuffer* submessage);
@@ -139,6 +144,10 @@ void uxr_init_session(
     session->on_time_args = NULL;
     session->time_offset = 0;
     session->synchronized = false;
+#ifdef PERFORMANCE_TESTING
+    session->on_performance = NULL;
+    session->on_performance_args = NULL;
+#endif /* ifdef PERFORMANCE_TESTING */
     // 初始化session_info，这个里面包括了sessionid（81）、以及key还有最后一次request的id以及状态
     uxr_init_session_info(&session->info, 0x81, key);
     // 初始化stream的storage
@@ -545,6 +554,7 @@ void uxr_flash_output_streams(
         {
             uxr_stamp_session_header(&session->info, id.raw, seq_num, buffer);
             send_message(session, buffer, length);
+            uxr_begin_output_rtt_sample(stream, seq_num, uxr_millis());
         }
     }
 }
@@ -594,6 +604,12 @@ bool  listen_message_reliably(
             // 更新心跳时间戳
             if (uxr_update_output_stream_heartbeat_timestamp(stream, timestamp))
             {
+                /* The retransmission timeout expired, resend the oldest message without waiting for the NACK. */
+                uint8_t* buffer; size_t length;
+                if (uxr_prepare_timeout_reliable_buffer_to_send(stream, &buffer, &length))
+                {
+                    send_message(session, buffer, length);
+                }
                 // 写心跳子消息
                 write_submessage_heartbeat(session, id);
             }
@@ -703,9 +719,9 @@ void write_submessage_acknack(
         const uxrSession* session,
         uxrStreamId id)
 {
-    uint8_t acknack_buffer[ACKNACK_MAX_MSG_SIZE];
+    uint8_t acknack_buffer[ACKNACK_RANGES_MAX_MSG_SIZE];
     ucdrBuffer ub;
-    ucdr_init_buffer_origin_offset(&ub, acknack_buffer, ACKNACK_MAX_MSG_SIZE, 0u,
+    ucdr_init_buffer_origin_offset(&ub, acknack_buffer, ACKNACK_RANGES_MAX_MSG_SIZE, 0u,
             uxr_session_header_offset(&session->info));
 
     const uxrInputReliableStream* stream = &session->streams.input_reliable[id.index];
@@ -721,6 +737,26 @@ void write_submessage_acknack(
     payload.stream_id = id.raw;
     (void) uxr_serialize_ACKNACK_Payload(&ub, &payload);
 
+    /* Buffer NACK ranges, one per bitmap beyond the first one with missing messages. */
+    uint16_t nack_window = session->info.nack_window;
+    if (stream->base.history < nack_window)
+    {
+        nack_window = stream->base.history;
+    }
+    uxrSeqNum first_unacked = payload.first_unacked_seq_num;
+    for (uint16_t i = 1; i <= NACK_RANGES_MAX && i * ACKNACK_BITMAP_WINDOW < nack_window; ++i)
+    {
+        payload.first_unacked_seq_num = uxr_seq_num_add(first_unacked, (uint16_t)(i * ACKNACK_BITMAP_WINDOW));
+        nack_bitmap = uxr_compute_nack_range(stream, payload.first_unacked_seq_num);
+        if (0 != nack_bitmap)
+        {
+            payload.nack_bitmap[0] = (uint8_t)(nack_bitmap >> 8);
+            payload.nack_bitmap[1] = (uint8_t)((nack_bitmap << 8) >> 8);
+            uxr_buffer_submessage_header(&ub, SUBMESSAGE_ID_ACKNACK, ACKNACK_PAYLOAD_SIZE, FLAG_NACK_RANGE);
+            (void) uxr_serialize_ACKNACK_Payload(&ub, &payload);
+        }
+    }
+
     /* Stamp message header. */
     uxr_stamp_session_header(&session->info, 0, 0, ub.init);
     send_message(session, acknack_buffer, ucdr_buffer_length(&ub));
@@ -837,7 +873,7 @@ void read_submessage(
             break;
 
         case SUBMESSAGE_ID_ACKNACK:
-            read_submessage_acknack(session, submessage);
+            read_submessage_acknack(session, submessage, flags);
             break;
 
         case SUBMESSAGE_ID_TIMESTAMP_REPLY:
@@ -917,7 +953,8 @@ void read_submessage_heartbeat(
  * */
 void read_submessage_acknack(
         uxrSession* session,
-        ucdrBuffer* submessage)
+        ucdrBuffer* submessage,
+        uint8_t flags)
 {
     ACKNACK_Payload acknack;
     // 反序列化
@@ -928,17 +965,36 @@ void read_submessage_acknack(
     if (stream)
     {   // 从acknack消息中得到nack的位图
         uint16_t nack_bitmap = (uint16_t)(((uint16_t)acknack.nack_bitmap[0] << 8) + acknack.nack_bitmap[1]);
-        // 分析acknack，修改stream信息
-        uxr_process_acknack(stream, nack_bitmap, acknack.first_unacked_seq_num);
-
         uint8_t* buffer; size_t length;
-        // 设置seq_num_it为stream中的last_ack，此时last_ack已经更新
-        uxrSeqNum seq_num_it = uxr_begin_output_nack_buffer_it(stream);
-        // 从上面得到的last_ack开始一条一条重新写进去，一条条重新发。
-        while (uxr_next_reliable_nack_buffer_to_send(stream, &buffer, &length, &seq_num_it))
+        if (ACKNACK_BITMAP_WINDOW < session->info.nack_window)
         {
-            // 发送出去
-            send_message(session, buffer, length);
+            /* Selective repeat: a NACK range is not an acknowledgement, and only the reported messages are resent. */
+            if (0 == (flags & FLAG_NACK_RANGE))
+            {
+                uxr_update_output_rtt(stream, acknack.first_unacked_seq_num, uxr_millis());
+                uxr_process_acknack(stream, nack_bitmap, acknack.first_unacked_seq_num);
+            }
+
+            while (uxr_next_reliable_nack_range_buffer_to_send(stream, &nack_bitmap, acknack.first_unacked_seq_num,
+                    &buffer, &length))
+            {
+                send_message(session, buffer, length);
+            }
+        }
+        else
+        {
+            // 分析acknack，修改stream信息
+            uxr_update_output_rtt(stream, acknack.first_unacked_seq_num, uxr_millis());
+            uxr_process_acknack(stream, nack_bitmap, acknack.first_unacked_seq_num);
+
+            // 设置seq_num_it为stream中的last_ack，此时last_ack已经更新
+            uxrSeqNum seq_num_it = uxr_begin_output_nack_buffer_it(stream);
+            // 从上面得到的last_ack开始一条一条重新写进去，一条条重新发。
+            while (uxr_next_reliable_nack_buffer_to_send(stream, &buffer, &length, &seq_num_it))
+            {
+                // 发送出去
+                send_message(session, buffer, length);
+            }
         }
     }
 }
@@ -959,9 +1015,15 @@ void read_submessage_performance(
         ucdrBuffer* submessage,
         uint16_t length)
 {
-    ucdrBuffer mb_performance;
-    ucdr_init_buffer(&mb_performance, submessage->iterator, length);
-    session->on_performance(session, &mb_performance, session->on_performance_args);
+    if (NULL != session->on_performance)
+    {
+        ucdrBuffer mb_performance;
+        ucdr_init_buffer(&mb_performance, submessage->iterator, length);
+        session->on_performance(session, &mb_performance, session->on_performance_args);
+    }
+
+    /* Skip the payload, the message may carry more submessages after it. */
+    submessage->iterator += length;
 }
 
 #endif /* ifdef PERFORMANCE_TESTING */
@@ -1,9 +1,11 @@
+#include <uxr/client/config.h>
 #include <uxr/client/defines.h>
 #include <uxr/client/core/session/object_id.h>
 #include <uxr/client/core/type/xrce_types.h>
 
 #include "session_info_internal.h"
 #include "submessage_internal.h"
+#include "stream/input_reliable_stream_internal.h"
 #include "../serialization/xrce_header_internal.h"
 
 #include <string.h>
@@ -12,6 +14,9 @@
 
 #define RESERVED_REQUESTS_ID 9
 
+#define NACK_WINDOW_VALUE_STR(window)  NACK_WINDOW_VALUE_STR_(window)
+#define NACK_WINDOW_VALUE_STR_(window) #window
+
 static uint16_t generate_request_id(
         uxrSessionInfo* info);
 
@@ -20,6 +25,10 @@ static void process_delete_session_status(
         uint8_t status,
         uint16_t request_id);
 
+static void read_agent_properties(
+        uxrSessionInfo* info,
+        ucdrBuffer* ub);
+
 //==================================================================
 //                             PUBLIC
 //==================================================================
@@ -36,6 +45,7 @@ void uxr_init_session_info(
     info->key[3] = (uint8_t)((key << 24) >> 24);
     info->last_request_id = RESERVED_REQUESTS_ID;
     info->last_requested_status = UXR_STATUS_NONE;
+    info->nack_window = ACKNACK_BITMAP_WINDOW;
 }
 
 void uxr_buffer_create_session(
@@ -55,9 +65,24 @@ void uxr_buffer_create_session(
     payload.client_representation.optional_properties = false;
     payload.client_representation.mtu = mtu;
 
+    uint16_t payload_size = CREATE_CLIENT_PAYLOAD_SIZE;
+#if UXR_CONFIG_NACK_WINDOW > ACKNACK_BITMAP_WINDOW
+    /* The property makes the payload length variable, it is measured on a scratch buffer. */
+    payload.client_representation.optional_properties = true;
+    payload.client_representation.properties.size = 1;
+    payload.client_representation.properties.data[0].name = (char*)NACK_WINDOW_PROPERTY;
+    payload.client_representation.properties.data[0].value = (char*)NACK_WINDOW_VALUE_STR(UXR_CONFIG_NACK_WINDOW);
+
+    uint8_t payload_buffer[CREATE_CLIENT_MAX_PAYLOAD_SIZE];
+    ucdrBuffer payload_ub;
+    ucdr_init_buffer(&payload_ub, payload_buffer, sizeof(payload_buffer));
+    (void) uxr_serialize_CREATE_CLIENT_Payload(&payload_ub, &payload);
+    payload_size = (uint16_t)ucdr_buffer_length(&payload_ub);
+#endif // if UXR_CONFIG_NACK_WINDOW > ACKNACK_BITMAP_WINDOW
+
     info->last_request_id = UXR_REQUEST_LOGIN;
 
-    (void) uxr_buffer_submessage_header(ub, SUBMESSAGE_ID_CREATE_CLIENT, CREATE_CLIENT_PAYLOAD_SIZE, 0);
+    (void) uxr_buffer_submessage_header(ub, SUBMESSAGE_ID_CREATE_CLIENT, payload_size, 0);
     (void) uxr_serialize_CREATE_CLIENT_Payload(ub, &payload);
 }
 
@@ -86,6 +111,12 @@ void uxr_read_create_session_status(
     STATUS_AGENT_Payload payload;
     (void) uxr_deserialize_STATUS_AGENT_Payload(ub, &payload);
     info->last_requested_status = payload.result.status;
+
+    info->nack_window = ACKNACK_BITMAP_WINDOW;
+    if (payload.agent_info.optional_properties)
+    {
+        read_agent_properties(info, ub);
+    }
 }
 
 void uxr_read_delete_session_status(
@@ -208,3 +239,38 @@ inline void process_delete_session_status(
         info->last_requested_status = status;
     }
 }
+
+void read_agent_properties(
+        uxrSessionInfo* info,
+        ucdrBuffer* ub)
+{
+    /* Only the agreed NACK window is kept, other properties are skipped. */
+    uint32_t size = 0;
+    bool ret = ucdr_deserialize_uint32_t(ub, &size);
+    for (uint32_t i = 0; i < size && ret; ++i)
+    {
+        char name[32];
+        char value[8];
+        ret = ucdr_deserialize_string(ub, name, sizeof(name));
+        ret = ret && ucdr_deserialize_string(ub, value, sizeof(value));
+        if (ret && (0 == strcmp(name, NACK_WINDOW_PROPERTY)))
+        {
+            uint32_t nack_window = 0;
+            for (const char* digit = value; ('0' <= *digit) && ('9' >= *digit); ++digit)
+            {
+                nack_window = nack_window * 10 + (uint32_t)(*digit - '0');
+            }
+
+            /* Never wider than asked, and always whole ACKNACK bitmaps. */
+            if (UXR_CONFIG_NACK_WINDOW < nack_window)
+            {
+                nack_window = UXR_CONFIG_NACK_WINDOW;
+            }
+            nack_window -= nack_window % ACKNACK_BITMAP_WINDOW;
+            if (ACKNACK_BITMAP_WINDOW < nack_window)
+            {
+                info->nack_window = (uint16_t)nack_window;
+            }
+        }
+    }
+}
@@ -24,6 +24,10 @@ extern "C"
 #include "../serialization/xrce_header_internal.h"
 
 #define CREATE_CLIENT_PAYLOAD_SIZE 16
+#define CREATE_CLIENT_MAX_PAYLOAD_SIZE 64
+
+/* CLIENT_Representation property asking the agent for a selective-repeat window wider than one ACKNACK. */
+#define NACK_WINDOW_PROPERTY "uxr_nack_window"
 #define DELETE_CLIENT_PAYLOAD_SIZE 4
 
 #define MIN_HEADER_SIZE 4
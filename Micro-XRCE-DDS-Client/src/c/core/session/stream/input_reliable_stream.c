@@ -12,6 +12,10 @@ static bool check_last_fragment(
         uxrSeqNum* last);
 static uxrSeqNum uxr_get_first_unacked(
         const uxrInputReliableStream* stream);
+static uint16_t compute_nack_bitmap(
+        const uxrInputReliableStream* stream,
+        uxrSeqNum from,
+        uint16_t buffers_to_check);
 static bool on_full_input_buffer(
         ucdrBuffer* ub,
         void* args);
@@ -162,15 +166,27 @@ uint16_t uxr_compute_acknack(
 {
     *from = uxr_get_first_unacked(stream);
     uint16_t buffers_to_ack = uxr_seq_num_sub(stream->last_announced, uxr_seq_num_sub(*from, 1));
-    uint16_t nack_bitmap = 0;
 
-    for (size_t i = 0; i < buffers_to_ack; ++i)
+    return compute_nack_bitmap(stream, *from, buffers_to_ack);
+}
+
+uint16_t uxr_compute_nack_range(
+        const uxrInputReliableStream* stream,
+        uxrSeqNum from)
+{
+    /* Only the announced messages that fit in the history can be reported. */
+    uxrSeqNum last = stream->last_announced;
+    uxrSeqNum last_history = uxr_seq_num_add(stream->last_handled, stream->base.history);
+    if (0 < uxr_seq_num_cmp(last, last_history))
     {
-        uxrSeqNum seq_num = uxr_seq_num_add(*from, (uxrSeqNum)i);
-        if (0 == uxr_get_reliable_buffer_size(&stream->base, seq_num))
-        {
-            nack_bitmap = (uint16_t)(nack_bitmap | (1 << i));
-        }
+        last = last_history;
+    }
+
+    uint16_t nack_bitmap = 0;
+    if (0 >= uxr_seq_num_cmp(from, last))
+    {
+        uint16_t buffers_to_nack = (uint16_t)(uxr_seq_num_sub(last, from) + 1);
+        nack_bitmap = compute_nack_bitmap(stream, from, buffers_to_nack);
     }
 
     return nack_bitmap;
@@ -208,6 +224,29 @@ bool check_last_fragment(
     return found;
 }
 
+uint16_t compute_nack_bitmap(
+        const uxrInputReliableStream* stream,
+        uxrSeqNum from,
+        uint16_t buffers_to_check)
+{
+    if (ACKNACK_BITMAP_WINDOW < buffers_to_check)
+    {
+        buffers_to_check = ACKNACK_BITMAP_WINDOW;
+    }
+
+    uint16_t nack_bitmap = 0;
+    for (uint16_t i = 0; i < buffers_to_check; ++i)
+    {
+        uxrSeqNum seq_num = uxr_seq_num_add(from, i);
+        if (0 == uxr_get_reliable_buffer_size(&stream->base, seq_num))
+        {
+            nack_bitmap = (uint16_t)(nack_bitmap | (1 << i));
+        }
+    }
+
+    return nack_bitmap;
+}
+
 uxrSeqNum uxr_get_first_unacked(
         const uxrInputReliableStream* stream)
 {
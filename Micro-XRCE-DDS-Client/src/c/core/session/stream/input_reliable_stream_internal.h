@@ -27,6 +27,7 @@ extern "C"
 #include <stddef.h>
 
 #define ACKNACK_PAYLOAD_SIZE  5
+#define ACKNACK_BITMAP_WINDOW 16
 
 struct ucdrBuffer;
 
@@ -52,6 +53,9 @@ bool uxr_next_input_reliable_buffer_available(
 uint16_t uxr_compute_acknack(
         const uxrInputReliableStream* stream,
         uxrSeqNum* from);
+uint16_t uxr_compute_nack_range(
+        const uxrInputReliableStream* stream,
+        uxrSeqNum from);
 void uxr_process_heartbeat(
         uxrInputReliableStream* stream,
         uxrSeqNum first_seq_num,
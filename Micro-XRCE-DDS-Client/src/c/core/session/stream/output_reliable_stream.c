@@ -10,34 +10,13 @@
 #include "../submessage_internal.h"
 
 #define MIN_HEARTBEAT_TIME_INTERVAL ((int64_t) UXR_CONFIG_MIN_HEARTBEAT_TIME_INTERVAL) // ms
-#define MAX_HEARTBEAT_TRIES         (sizeof(int64_t) * 8 - 1)
+#define MAX_HEARTBEAT_TIME_INTERVAL ((int64_t) UXR_CONFIG_MAX_HEARTBEAT_TIME_INTERVAL) // ms
+#define MAX_HEARTBEAT_TRIES         UINT8_MAX
+
+#if UXR_CONFIG_MAX_HEARTBEAT_TIME_INTERVAL < UXR_CONFIG_MIN_HEARTBEAT_TIME_INTERVAL
+#error UXR_CONFIG_MAX_HEARTBEAT_TIME_INTERVAL shall not be lower than UXR_CONFIG_MIN_HEARTBEAT_TIME_INTERVAL.
+#endif // if UXR_CONFIG_MAX_HEARTBEAT_TIME_INTERVAL < UXR_CONFIG_MIN_HEARTBEAT_TIME_INTERVAL
 
-//========================test=======================
-/**
- * 如果两值相等 返回0
- * 2 > 1 返回-1
- * 1 > 2 返回 1
- * */
-int uxr_seq_num_cmp(
-        uxrSeqNum seq_num_1,
-        uxrSeqNum seq_num_2)
-{
-    int result;
-    if (seq_num_1 == seq_num_2)
-    {
-        result = 0;
-    }
-    else if ((seq_num_1 < seq_num_2 && (seq_num_2 - seq_num_1) < 1<<15) ||
-            (seq_num_1 > seq_num_2 && (seq_num_1 - seq_num_2) > 1<<15))
-    {
-        result = -1;
-    }
-    else
-    {
-        result = 1;
-    }
-    return result;
-}
 //==================================================================
 //                             PUBLIC
 //==================================================================
@@ -73,6 +52,13 @@ void uxr_reset_output_reliable_stream(
     stream->next_heartbeat_timestamp = INT64_MAX;
     stream->next_heartbeat_tries = 0;
     stream->send_lost = false;
+
+    stream->rtt_timestamp = 0;
+    stream->rtt_seq_num = 0;
+    stream->rtt_sampling = false;
+    stream->srtt = -1;
+    stream->rttvar = 0;
+    stream->rto = (int32_t)MIN_HEARTBEAT_TIME_INTERVAL;
 }
 
 /**
@@ -233,22 +219,28 @@ bool uxr_update_output_stream_heartbeat_timestamp(
         // 如果下次心跳尝试为0(第一次心跳尝试)
         if (0 == stream->next_heartbeat_tries)
         {
-            // 下次心跳尝试时间戳设置为当前时间+最小心跳间隔（1ms）
-            stream->next_heartbeat_timestamp = current_timestamp + MIN_HEARTBEAT_TIME_INTERVAL;
+            /* Armed at the retransmission timeout. */
+            stream->next_heartbeat_timestamp = current_timestamp + stream->rto;
             // 下次心跳尝试设置为1
             stream->next_heartbeat_tries = 1;
         }
         // 否则如果当前时间戳大于等于下次心跳时间戳的话， 
         else if (current_timestamp >= stream->next_heartbeat_timestamp)
         {
-            // 增量设置为 时间间隔 左移 尝试次数
-            int64_t increment = MIN_HEARTBEAT_TIME_INTERVAL << (stream->next_heartbeat_tries % MAX_HEARTBEAT_TRIES);
+            /* The timeout expired: back off until a new round-trip sample (Karn's algorithm). */
+            stream->rto = (int32_t)((2 * (int64_t)stream->rto < MAX_HEARTBEAT_TIME_INTERVAL)
+                    ? 2 * (int64_t)stream->rto
+                    : MAX_HEARTBEAT_TIME_INTERVAL);
+            int64_t increment = stream->rto;
             // 当前时间戳-下次心跳时间戳
             int64_t difference = current_timestamp - stream->next_heartbeat_timestamp;
             // 下次心跳时间戳更新为加上两者较大的数
             stream->next_heartbeat_timestamp += (difference > increment) ? difference : increment;
             // 心跳次数增加
-            stream->next_heartbeat_tries++;
+            if (MAX_HEARTBEAT_TRIES > stream->next_heartbeat_tries)
+            {
+                stream->next_heartbeat_tries++;
+            }
             // 确认
             must_confirm = true;
         }
@@ -262,6 +254,77 @@ bool uxr_update_output_stream_heartbeat_timestamp(
     return must_confirm;
 }
 
+/**
+ * Times the message for a round-trip sample, unless another one is already being timed.
+ * */
+void uxr_begin_output_rtt_sample(
+        uxrOutputReliableStream* stream,
+        uxrSeqNum seq_num,
+        int64_t current_timestamp)
+{
+    if (!stream->rtt_sampling)
+    {
+        stream->rtt_seq_num = seq_num;
+        stream->rtt_timestamp = current_timestamp;
+        stream->rtt_sampling = true;
+    }
+}
+
+/**
+ * Takes the round-trip sample once the timed message is acknowledged, and updates the retransmission
+ * timeout as TCP does (RFC 6298): RTO = SRTT + 4 * RTTVAR, with SRTT and RTTVAR kept scaled by 8 and 4.
+ * */
+void uxr_update_output_rtt(
+        uxrOutputReliableStream* stream,
+        uxrSeqNum first_unacked_seq_num,
+        int64_t current_timestamp)
+{
+    if (stream->rtt_sampling && 0 < uxr_seq_num_cmp(first_unacked_seq_num, stream->rtt_seq_num))
+    {
+        int64_t elapsed = current_timestamp - stream->rtt_timestamp;
+        int32_t rtt = (int32_t)((elapsed < 0) ? 0 : (elapsed < MAX_HEARTBEAT_TIME_INTERVAL)
+                ? elapsed : MAX_HEARTBEAT_TIME_INTERVAL);
+        if (0 > stream->srtt)
+        {
+            stream->srtt = rtt << 3;
+            stream->rttvar = rtt << 1;
+        }
+        else
+        {
+            int32_t error = rtt - (stream->srtt >> 3);
+            stream->srtt += error;
+            stream->rttvar += ((error < 0) ? -error : error) - (stream->rttvar >> 2);
+        }
+
+        int64_t rto = (int64_t)((stream->srtt + 7) >> 3) + stream->rttvar;
+        stream->rto = (int32_t)((rto < MIN_HEARTBEAT_TIME_INTERVAL) ? MIN_HEARTBEAT_TIME_INTERVAL
+                : (rto > MAX_HEARTBEAT_TIME_INTERVAL) ? MAX_HEARTBEAT_TIME_INTERVAL : rto);
+        stream->rtt_sampling = false;
+    }
+}
+
+/**
+ * Takes the oldest message waiting for its acknowledgement, to be resent when the retransmission timeout expires.
+ * */
+bool uxr_prepare_timeout_reliable_buffer_to_send(
+        uxrOutputReliableStream* stream,
+        uint8_t** buffer,
+        size_t* length)
+{
+    uxrSeqNum seq_num = uxr_seq_num_add(stream->last_acknown, 1);
+    bool in_flight = 0 >= uxr_seq_num_cmp(seq_num, stream->last_sent);
+    if (in_flight)
+    {
+        *buffer = uxr_get_reliable_buffer(&stream->base, seq_num);
+        *length = uxr_get_reliable_buffer_size(&stream->base, seq_num);
+        in_flight = *length != stream->offset;
+        /* The acknowledgement of a retransmitted message would be ambiguous. */
+        stream->rtt_sampling = stream->rtt_sampling && !in_flight;
+    }
+
+    return in_flight;
+}
+
 uxrSeqNum uxr_begin_output_nack_buffer_it(
         const uxrOutputReliableStream* stream)
 {
@@ -294,6 +357,7 @@ bool uxr_next_reliable_nack_buffer_to_send(
                 it_updated = *length != stream->offset; // 检查发送的长度是不是不等于stream的offset
             }
         }
+        stream->rtt_sampling = stream->rtt_sampling && !it_updated;
         // 如果此时it_updated为假，说明length和offset已经相等
         if (!it_updated)
         {
@@ -303,6 +367,37 @@ bool uxr_next_reliable_nack_buffer_to_send(
 
     return it_updated;
 }
+/**
+ * Selective repeat: takes the lowest message of the bitmap that is still waiting for its
+ * acknowledgement, clearing the bits it passes over.
+ * */
+bool uxr_next_reliable_nack_range_buffer_to_send(
+        uxrOutputReliableStream* stream,
+        uint16_t* bitmap,
+        uxrSeqNum first_seq_num,
+        uint8_t** buffer,
+        size_t* length)
+{
+    bool it_updated = false;
+    for (uint16_t i = 0; !it_updated && (0 != *bitmap); ++i)
+    {
+        uint16_t mask = (uint16_t)(1 << i);
+        if (0 != (*bitmap & mask))
+        {
+            *bitmap = (uint16_t)(*bitmap & ~mask);
+            uxrSeqNum seq_num = uxr_seq_num_add(first_seq_num, i);
+            if (0 < uxr_seq_num_cmp(seq_num, stream->last_acknown) && 0 >= uxr_seq_num_cmp(seq_num, stream->last_sent))
+            {
+                *buffer = uxr_get_reliable_buffer(&stream->base, seq_num);
+                *length = uxr_get_reliable_buffer_size(&stream->base, seq_num);
+                it_updated = *length != stream->offset;
+            }
+        }
+    }
+    stream->rtt_sampling = stream->rtt_sampling && !it_updated;
+
+    return it_updated;
+}
 /**
  * 
  * */
@@ -49,6 +49,18 @@ bool uxr_prepare_next_reliable_buffer_to_send(
 bool uxr_update_output_stream_heartbeat_timestamp(
         uxrOutputReliableStream* stream,
         int64_t current_timestamp);
+void uxr_begin_output_rtt_sample(
+        uxrOutputReliableStream* stream,
+        uxrSeqNum seq_num,
+        int64_t current_timestamp);
+void uxr_update_output_rtt(
+        uxrOutputReliableStream* stream,
+        uxrSeqNum first_unacked_seq_num,
+        int64_t current_timestamp);
+bool uxr_prepare_timeout_reliable_buffer_to_send(
+        uxrOutputReliableStream* stream,
+        uint8_t** buffer,
+        size_t* length);
 uxrSeqNum uxr_begin_output_nack_buffer_it(
         const uxrOutputReliableStream* stream);
 bool uxr_next_reliable_nack_buffer_to_send(
@@ -56,6 +68,12 @@ bool uxr_next_reliable_nack_buffer_to_send(
         uint8_t** buffer,
         size_t* length,
         uxrSeqNum* seq_num_it);
+bool uxr_next_reliable_nack_range_buffer_to_send(
+        uxrOutputReliableStream* stream,
+        uint16_t* bitmap,
+        uxrSeqNum first_seq_num,
+        uint8_t** buffer,
+        size_t* length);
 void uxr_process_acknack(
         uxrOutputReliableStream* stream,
         uint16_t bitmap,
@@ -49,7 +49,7 @@ typedef enum SubmessageId
     SUBMESSAGE_ID_TIMESTAMP_REPLY   = 15
 #ifdef PERFORMANCE_TESTING
     ,
-    SUBMESSAGE_ID_PERFORMANCE   = 14
+    SUBMESSAGE_ID_PERFORMANCE   = 255
 #endif // ifdef PERFORMANCE_TESTING
 
 } SubmessageId;
@@ -58,6 +58,7 @@ typedef enum SubmessageFlags
 {
     FLAG_ENDIANNESS  =           0x01,
     FLAG_LAST_FRAGMENT =         0x01 << 1,
+    FLAG_NACK_RANGE =            0x01 << 1,
     FLAG_FORMAT_DATA =           0x00,
     FLAG_FORMAT_SAMPLE =         0x02,
     FLAG_FORMAT_DATA_SEQ =       0x08,
@@ -2,6 +2,7 @@
 #include "tcp_transport_internal.h"
 
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
@@ -62,6 +63,9 @@ bool uxr_init_tcp_platform(
             {
                 if (0 == connect(platform->poll_fd.fd, ptr->ai_addr, ptr->ai_addrlen))
                 {
+                    /* The length prefix and the message are separate writes, do not let Nagle hold the latter. */
+                    int nodelay = 1;
+                    (void) setsockopt(platform->poll_fd.fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
                     platform->poll_fd.events = POLLIN;
                     rv = true;
                     break;
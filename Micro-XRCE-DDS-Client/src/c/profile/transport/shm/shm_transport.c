@@ -0,0 +1,106 @@
+#include "shm_transport_internal.h"
+
+/*******************************************************************************
+* Static members.
+*******************************************************************************/
+static uint8_t error_code;
+
+/*******************************************************************************
+* Private function declarations.
+*******************************************************************************/
+static bool send_shm_msg(
+        void* instance,
+        const uint8_t* buf,
+        size_t len);
+static bool recv_shm_msg(
+        void* instance,
+        uint8_t** buf,
+        size_t* len,
+        int timeout);
+static uint8_t get_shm_error(
+        void);
+
+/*******************************************************************************
+* Private function definitions.
+*******************************************************************************/
+static bool send_shm_msg(
+        void* instance,
+        const uint8_t* buf,
+        size_t len)
+{
+    bool rv = false;
+    uxrSHMTransport* transport = (uxrSHMTransport*)instance;
+
+    uint8_t errcode;
+    size_t bytes_sent = uxr_write_shm_data_platform(&transport->platform, buf, len, &errcode);
+    if (0 < bytes_sent)
+    {
+        rv = (bytes_sent == len);
+    }
+    else
+    {
+        error_code = errcode;
+    }
+    return rv;
+}
+
+static bool recv_shm_msg(
+        void* instance,
+        uint8_t** buf,
+        size_t* len,
+        int timeout)
+{
+    bool rv = false;
+    uxrSHMTransport* transport = (uxrSHMTransport*)instance;
+
+    uint8_t errcode;
+    size_t bytes_received = uxr_read_shm_data_platform(&transport->platform,
+                    transport->buffer,
+                    sizeof(transport->buffer),
+                    timeout,
+                    &errcode);
+    if (0 < bytes_received)
+    {
+        *buf = transport->buffer;
+        *len = bytes_received;
+        rv = true;
+    }
+    else
+    {
+        error_code = errcode;
+    }
+    return rv;
+}
+
+static uint8_t get_shm_error(
+        void)
+{
+    return error_code;
+}
+
+/*******************************************************************************
+* Public function definitions.
+*******************************************************************************/
+bool uxr_init_shm_transport(
+        uxrSHMTransport* transport,
+        const char* name)
+{
+    bool rv = false;
+    if (uxr_init_shm_platform(&transport->platform, name))
+    {
+        /* Setup interface. */
+        transport->comm.instance = (void*)transport;
+        transport->comm.send_msg = send_shm_msg;
+        transport->comm.recv_msg = recv_shm_msg;
+        transport->comm.comm_error = get_shm_error;
+        transport->comm.mtu = UXR_CONFIG_SHM_TRANSPORT_MTU;
+        rv = true;
+    }
+    return rv;
+}
+
+bool uxr_close_shm_transport(
+        uxrSHMTransport* transport)
+{
+    return uxr_close_shm_platform(&transport->platform);
+}
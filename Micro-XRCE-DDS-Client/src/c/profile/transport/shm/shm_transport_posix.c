@@ -0,0 +1,300 @@
+#include <uxr/client/profile/transport/shm/shm_transport_posix.h>
+#include "shm_transport_internal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*******************************************************************************
+* Segment layout.
+*
+* It is also defined by the agent in include/uxr/agent/transport/shm/SharedMemoryRing.hpp,
+* both sides shall be kept in sync. The segment holds a header followed by one slot per client,
+* each slot holds the ring towards the agent and the ring towards the client. Every ring has a
+* single producer and a single consumer, records are a 4-byte length followed by the payload
+* padded to 4 bytes, and they may wrap around the end of the ring.
+*******************************************************************************/
+#define SHM_SEGMENT_MAGIC       0x4D535855u
+#define SHM_SEGMENT_VERSION     1u
+#define SHM_RECORD_HEADER_SIZE  4u
+
+struct uxrSHMSegmentHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t ring_size;
+    uint32_t doorbell;
+    uint32_t agent_waiting;
+    uint32_t agent_pid;
+    uint8_t reserved[36];
+};
+
+typedef struct uxrSHMSlotHeader
+{
+    uint32_t owner;
+    uint8_t reserved[60];
+} uxrSHMSlotHeader;
+
+struct uxrSHMRing
+{
+    uint32_t head;
+    uint32_t seq;
+    uint32_t waiting;
+    uint8_t producer_pad[52];
+    uint32_t tail;
+    uint8_t consumer_pad[60];
+};
+
+/*******************************************************************************
+* Private function definitions.
+*******************************************************************************/
+static inline size_t slot_stride(
+        uint32_t ring_size)
+{
+    return sizeof(uxrSHMSlotHeader) + 2 * (sizeof(struct uxrSHMRing) + ring_size);
+}
+
+static inline uxrSHMSlotHeader* slot_at(
+        uxrSHMPlatform* platform,
+        uint32_t index)
+{
+    return (uxrSHMSlotHeader*)(platform->segment + sizeof(struct uxrSHMSegmentHeader)
+           + index * slot_stride(platform->ring_size));
+}
+
+static inline uint8_t* ring_data(
+        struct uxrSHMRing* ring)
+{
+    return (uint8_t*)ring + sizeof(struct uxrSHMRing);
+}
+
+static inline uint32_t record_size(
+        size_t len)
+{
+    return (uint32_t)(SHM_RECORD_HEADER_SIZE + ((len + 3) & ~(size_t)3));
+}
+
+static void futex_wait(
+        uint32_t* word,
+        uint32_t expected,
+        int timeout)
+{
+    struct timespec ts;
+    ts.tv_sec = timeout / 1000;
+    ts.tv_nsec = (timeout % 1000) * 1000000L;
+    (void) syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static void futex_wake(
+        uint32_t* word)
+{
+    (void) syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static bool claim_slot(
+        uxrSHMPlatform* platform)
+{
+    uint32_t pid = (uint32_t)getpid();
+    for (uint32_t i = 0; i < platform->header->slot_count; ++i)
+    {
+        uxrSHMSlotHeader* slot = slot_at(platform, i);
+        uint32_t owner = __atomic_load_n(&slot->owner, __ATOMIC_ACQUIRE);
+
+        /* Slots of crashed clients are taken over, never the ones of this process. */
+        bool available = (0 == owner)
+                || ((pid != owner) && (-1 == kill((pid_t)owner, 0)) && (ESRCH == errno));
+        if (available
+                && __atomic_compare_exchange_n(&slot->owner, &owner, pid, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            platform->slot = i;
+            platform->to_agent = (struct uxrSHMRing*)((uint8_t*)slot + sizeof(uxrSHMSlotHeader));
+            platform->to_client = (struct uxrSHMRing*)(ring_data(platform->to_agent) + platform->ring_size);
+
+            /* Discard what the agent sent to the previous owner. */
+            __atomic_store_n(&platform->to_client->tail,
+                    __atomic_load_n(&platform->to_client->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t ring_read(
+        uxrSHMPlatform* platform,
+        uint8_t* buf,
+        size_t len)
+{
+    struct uxrSHMRing* ring = platform->to_client;
+    const uint32_t mask = platform->ring_size - 1;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (head == tail)
+    {
+        return 0;
+    }
+
+    uint8_t* data = ring_data(ring);
+    uint32_t record_len;
+    memcpy(&record_len, data + (tail & mask), sizeof(record_len));
+    if ((record_len > (platform->ring_size - SHM_RECORD_HEADER_SIZE)) || (record_size(record_len) > (head - tail)))
+    {
+        /* Corrupted ring, resynchronize with the agent. */
+        __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    size_t rv = 0;
+    if (record_len <= len)
+    {
+        uint32_t offset = (tail + SHM_RECORD_HEADER_SIZE) & mask;
+        size_t first = platform->ring_size - offset;
+        first = (record_len < first) ? record_len : first;
+        memcpy(buf, data + offset, first);
+        memcpy(buf + first, data, record_len - first);
+        rv = record_len;
+    }
+    __atomic_store_n(&ring->tail, tail + record_size(record_len), __ATOMIC_RELEASE);
+    return rv;
+}
+
+/*******************************************************************************
+* Public function definitions.
+*******************************************************************************/
+bool uxr_init_shm_platform(
+        uxrSHMPlatform* platform,
+        const char* name)
+{
+    bool rv = false;
+    platform->segment = NULL;
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (-1 != fd)
+    {
+        struct stat st;
+        void* segment = MAP_FAILED;
+        if ((0 == fstat(fd, &st)) && ((size_t)st.st_size >= sizeof(struct uxrSHMSegmentHeader)))
+        {
+            segment = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+
+        if (MAP_FAILED != segment)
+        {
+            platform->segment = (uint8_t*)segment;
+            platform->segment_size = (size_t)st.st_size;
+            platform->header = (struct uxrSHMSegmentHeader*)segment;
+            platform->ring_size = platform->header->ring_size;
+
+            bool valid = (SHM_SEGMENT_MAGIC == __atomic_load_n(&platform->header->magic, __ATOMIC_ACQUIRE))
+                    && (SHM_SEGMENT_VERSION == platform->header->version)
+                    && (0 == kill((pid_t)platform->header->agent_pid, 0))
+                    && (0 != platform->ring_size)
+                    && (0 == (platform->ring_size & (platform->ring_size - 1)))
+                    && (platform->segment_size >= sizeof(struct uxrSHMSegmentHeader)
+                    + platform->header->slot_count * slot_stride(platform->ring_size));
+            rv = valid && claim_slot(platform);
+            if (!rv)
+            {
+                munmap(platform->segment, platform->segment_size);
+                platform->segment = NULL;
+            }
+        }
+    }
+    return rv;
+}
+
+bool uxr_close_shm_platform(
+        uxrSHMPlatform* platform)
+{
+    if (NULL == platform->segment)
+    {
+        return true;
+    }
+
+    __atomic_store_n(&slot_at(platform, platform->slot)->owner, 0, __ATOMIC_RELEASE);
+    bool rv = (0 == munmap(platform->segment, platform->segment_size));
+    platform->segment = NULL;
+    return rv;
+}
+
+size_t uxr_write_shm_data_platform(
+        uxrSHMPlatform* platform,
+        const uint8_t* buf,
+        size_t len,
+        uint8_t* errcode)
+{
+    struct uxrSHMRing* ring = platform->to_agent;
+    const uint32_t mask = platform->ring_size - 1;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t size = record_size(len);
+
+    /* The agent clears the magic when it stops. */
+    if ((SHM_SEGMENT_MAGIC != __atomic_load_n(&platform->header->magic, __ATOMIC_ACQUIRE))
+            || (size > platform->ring_size))
+    {
+        *errcode = 1;
+        return 0;
+    }
+    if ((platform->ring_size - (head - tail)) < size)
+    {
+        /* The agent does not keep up, the message is dropped as a full socket buffer would. */
+        *errcode = 0;
+        return 0;
+    }
+
+    uint8_t* data = ring_data(ring);
+    uint32_t record_len = (uint32_t)len;
+    memcpy(data + (head & mask), &record_len, sizeof(record_len));
+    uint32_t offset = (head + SHM_RECORD_HEADER_SIZE) & mask;
+    size_t first = platform->ring_size - offset;
+    first = (len < first) ? len : first;
+    memcpy(data + offset, buf, first);
+    memcpy(data, buf + first, len - first);
+    __atomic_store_n(&ring->head, head + size, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&platform->header->doorbell, 1, __ATOMIC_SEQ_CST);
+    if (0 != __atomic_load_n(&platform->header->agent_waiting, __ATOMIC_SEQ_CST))
+    {
+        futex_wake(&platform->header->doorbell);
+    }
+
+    *errcode = 0;
+    return len;
+}
+
+size_t uxr_read_shm_data_platform(
+        uxrSHMPlatform* platform,
+        uint8_t* buf,
+        size_t len,
+        int timeout,
+        uint8_t* errcode)
+{
+    struct uxrSHMRing* ring = platform->to_client;
+    size_t rv = ring_read(platform, buf, len);
+    if ((0 == rv) && (0 < timeout))
+    {
+        /* Announce the wait before the last look at the ring, the agent wakes up the futex after writing. */
+        __atomic_store_n(&ring->waiting, 1, __ATOMIC_SEQ_CST);
+        uint32_t seq = __atomic_load_n(&ring->seq, __ATOMIC_SEQ_CST);
+        rv = ring_read(platform, buf, len);
+        if (0 == rv)
+        {
+            futex_wait(&ring->seq, seq, timeout);
+            rv = ring_read(platform, buf, len);
+        }
+        __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+    }
+
+    *errcode = 0;
+    return rv;
+}
@@ -37,9 +37,6 @@ void uxr_update_crc(
 bool uxr_get_next_octet(
         uxrFramingIO* framing_io,
         uint8_t* octet);
-bool uxr_add_next_octet(
-        uxrFramingIO* framing_io,
-        uint8_t octet);
 
 typedef size_t (* uxr_write_cb)(
         void*,
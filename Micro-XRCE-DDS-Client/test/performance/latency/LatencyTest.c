@@ -0,0 +1,429 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/client/client.h>
+#include <uxr/client/util/time.h>
+#include <ucdr/microcdr.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define WARMUP_SAMPLES      100
+#define DEFAULT_SAMPLES     10000
+#define DEFAULT_PAYLOAD     64
+#define ECHO_TIMEOUT        1000
+#define THROUGHPUT_WINDOW   8
+#define THROUGHPUT_TIMEOUT  100
+
+/* Message header (session, stream, sequence number), submessage header and PERFORMANCE timestamp. */
+#define PERFORMANCE_OVERHEAD 16
+
+typedef struct Benchmark
+{
+    int64_t* rtts;
+    uint32_t samples;
+    uint32_t echoes;
+    int64_t last_sent;
+    bool echoed;
+    bool recording;
+
+} Benchmark;
+
+typedef struct CustomArgs
+{
+    const char* ip;
+    const char* port;
+    struct pollfd poll_fd;
+
+} CustomArgs;
+
+static void on_performance(
+        uxrSession* session,
+        ucdrBuffer* mb,
+        void* args)
+{
+    (void) session;
+
+    Benchmark* benchmark = (Benchmark*)args;
+    const int64_t now = uxr_nanos();
+    uint32_t epoch_time_lsb;
+    uint32_t epoch_time_msb;
+    if (ucdr_deserialize_uint32_t(mb, &epoch_time_lsb) && ucdr_deserialize_uint32_t(mb, &epoch_time_msb))
+    {
+        const int64_t epoch_time = (int64_t)(((uint64_t)epoch_time_msb << 32) | epoch_time_lsb);
+        ++benchmark->echoes;
+
+        /* Late echoes of lost samples do not count as round trips. */
+        if (epoch_time == benchmark->last_sent)
+        {
+            if (benchmark->recording)
+            {
+                benchmark->rtts[benchmark->samples++] = now - epoch_time;
+            }
+            benchmark->echoed = true;
+        }
+    }
+}
+
+static int compare_rtts(
+        const void* a,
+        const void* b)
+{
+    const int64_t lhs = *(const int64_t*)a;
+    const int64_t rhs = *(const int64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static double percentile_us(
+        const int64_t* sorted_rtts,
+        uint32_t count,
+        uint32_t per_thousand)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * per_thousand + 999) / 1000);
+    return (0 == rank) ? 0.0 : (double)sorted_rtts[rank - 1] / 1000.0;
+}
+
+/* Custom transport over a UDP socket, talking to the UDP server of the agent. */
+static bool custom_open(
+        uxrCustomTransport* transport)
+{
+    CustomArgs* args = (CustomArgs*)transport->args;
+    bool rv = false;
+
+    args->poll_fd.fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (-1 != args->poll_fd.fd)
+    {
+        struct addrinfo hints;
+        struct addrinfo* result;
+        struct addrinfo* ptr;
+
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        if (0 == getaddrinfo(args->ip, args->port, &hints, &result))
+        {
+            for (ptr = result; ptr != NULL; ptr = ptr->ai_next)
+            {
+                if (0 == connect(args->poll_fd.fd, ptr->ai_addr, ptr->ai_addrlen))
+                {
+                    args->poll_fd.events = POLLIN;
+                    rv = true;
+                    break;
+                }
+            }
+            freeaddrinfo(result);
+        }
+    }
+    return rv;
+}
+
+static bool custom_close(
+        uxrCustomTransport* transport)
+{
+    CustomArgs* args = (CustomArgs*)transport->args;
+    return (-1 == args->poll_fd.fd) ? true : (0 == close(args->poll_fd.fd));
+}
+
+static size_t custom_write(
+        uxrCustomTransport* transport,
+        const uint8_t* buf,
+        size_t len,
+        uint8_t* errcode)
+{
+    CustomArgs* args = (CustomArgs*)transport->args;
+    size_t rv = 0;
+    ssize_t bytes_sent = send(args->poll_fd.fd, (const void*)buf, len, 0);
+    if (-1 != bytes_sent)
+    {
+        rv = (size_t)bytes_sent;
+        *errcode = 0;
+    }
+    else
+    {
+        *errcode = 1;
+    }
+    return rv;
+}
+
+static size_t custom_read(
+        uxrCustomTransport* transport,
+        uint8_t* buf,
+        size_t len,
+        int timeout,
+        uint8_t* errcode)
+{
+    CustomArgs* args = (CustomArgs*)transport->args;
+    size_t rv = 0;
+    int poll_rv = poll(&args->poll_fd, 1, timeout);
+    if (0 < poll_rv)
+    {
+        ssize_t bytes_received = recv(args->poll_fd.fd, (void*)buf, len, 0);
+        if (-1 != bytes_received)
+        {
+            rv = (size_t)bytes_received;
+            *errcode = 0;
+        }
+        else
+        {
+            *errcode = 1;
+        }
+    }
+    else
+    {
+        *errcode = (0 == poll_rv) ? 0 : 1;
+    }
+    return rv;
+}
+
+static bool wait_echo(
+        uxrSession* session,
+        Benchmark* benchmark,
+        int timeout)
+{
+    const int64_t start = uxr_millis();
+    int remaining_time = timeout;
+    while (!benchmark->echoed && (0 < remaining_time))
+    {
+        (void) uxr_run_session_until_timeout(session, remaining_time);
+        remaining_time = timeout - (int)(uxr_millis() - start);
+    }
+    return benchmark->echoed;
+}
+
+static void print_help(
+        const char* program)
+{
+    printf("usage: %s <transport> [samples] [payload]\n", program);
+    printf("  transport:\n");
+    printf("    udp <ip> <port>\n");
+    printf("    tcp <ip> <port>\n");
+    printf("    serial <device>      (e.g. the pseudoterminal opened by the agent)\n");
+    printf("    custom <ip> <port>   (custom transport over UDP)\n");
+    printf("    shm <name>           (shared memory segment of the agent, e.g. /uxr_agent)\n");
+    printf("  samples: round trips measured, %d by default.\n", DEFAULT_SAMPLES);
+    printf("  payload: bytes echoed besides the timestamp, %d by default.\n", DEFAULT_PAYLOAD);
+}
+
+int main(
+        int args,
+        char** argv)
+{
+    uxrUDPTransport udp;
+    uxrTCPTransport tcp;
+    uxrSerialTransport serial;
+    uxrCustomTransport custom;
+    uxrSHMTransport shm;
+    CustomArgs custom_args;
+    uxrCommunication* comm = NULL;
+    size_t mtu = 0;
+    int args_index = 0;
+
+    if (args >= 4 && 0 == strcmp(argv[1], "udp"))
+    {
+        if (!uxr_init_udp_transport(&udp, UXR_IPv4, argv[2], argv[3]))
+        {
+            printf("Can not create an UDP connection\n");
+            return 1;
+        }
+        comm = &udp.comm;
+        mtu = UXR_CONFIG_UDP_TRANSPORT_MTU;
+        args_index = 4;
+    }
+    else if (args >= 4 && 0 == strcmp(argv[1], "tcp"))
+    {
+        if (!uxr_init_tcp_transport(&tcp, UXR_IPv4, argv[2], argv[3]))
+        {
+            printf("Can not create a TCP connection\n");
+            return 1;
+        }
+        comm = &tcp.comm;
+        mtu = UXR_CONFIG_TCP_TRANSPORT_MTU;
+        args_index = 4;
+    }
+    else if (args >= 3 && 0 == strcmp(argv[1], "serial"))
+    {
+        int fd = open(argv[2], O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (-1 != fd)
+        {
+            struct termios attrs;
+            if (0 == tcgetattr(fd, &attrs))
+            {
+                cfmakeraw(&attrs);
+                (void) tcsetattr(fd, TCSANOW, &attrs);
+            }
+        }
+        if (!uxr_init_serial_transport(&serial, fd, 0, 1))
+        {
+            printf("Can not create a serial connection\n");
+            return 1;
+        }
+        comm = &serial.comm;
+        mtu = UXR_CONFIG_SERIAL_TRANSPORT_MTU;
+        args_index = 3;
+    }
+    else if (args >= 4 && 0 == strcmp(argv[1], "custom"))
+    {
+        custom_args.ip = argv[2];
+        custom_args.port = argv[3];
+        custom_args.poll_fd.fd = -1;
+        uxr_set_custom_transport_callbacks(&custom, false, custom_open, custom_close, custom_write, custom_read);
+        if (!uxr_init_custom_transport(&custom, &custom_args))
+        {
+            printf("Can not create a custom connection\n");
+            return 1;
+        }
+        comm = &custom.comm;
+        mtu = UXR_CONFIG_CUSTOM_TRANSPORT_MTU;
+        args_index = 4;
+    }
+    else if (args >= 3 && 0 == strcmp(argv[1], "shm"))
+    {
+        if (!uxr_init_shm_transport(&shm, argv[2]))
+        {
+            printf("Can not create a shared memory connection\n");
+            return 1;
+        }
+        comm = &shm.comm;
+        mtu = UXR_CONFIG_SHM_TRANSPORT_MTU;
+        args_index = 3;
+    }
+    else
+    {
+        print_help(argv[0]);
+        return 1;
+    }
+
+    uint32_t samples = (args_index < args) ? (uint32_t)atoi(argv[args_index++]) : DEFAULT_SAMPLES;
+    uint16_t payload = (args_index < args) ? (uint16_t)atoi(argv[args_index++]) : DEFAULT_PAYLOAD;
+    if ((0 == samples) || (mtu < PERFORMANCE_OVERHEAD) || (payload > mtu - PERFORMANCE_OVERHEAD))
+    {
+        printf("Invalid arguments: samples must be positive and payload at most %u bytes\n",
+                (unsigned)(mtu - PERFORMANCE_OVERHEAD));
+        return 1;
+    }
+
+    // Session
+    uxrSession session;
+    Benchmark benchmark;
+    memset(&benchmark, 0, sizeof(benchmark));
+    uxr_init_session(&session, comm, 0xCCCCDDDD);
+    uxr_set_performance_callback(&session, on_performance, &benchmark);
+    if (!uxr_create_session(&session))
+    {
+        printf("Error at create session\n");
+        return 1;
+    }
+
+    // Streams
+    uint8_t* output_buffer = (uint8_t*)malloc(mtu);
+    uint8_t* payload_buffer = (uint8_t*)calloc(1, (0 == payload) ? 1 : payload);
+    benchmark.rtts = (int64_t*)malloc(samples * sizeof(int64_t));
+    if ((NULL == output_buffer) || (NULL == payload_buffer) || (NULL == benchmark.rtts))
+    {
+        printf("Out of memory\n");
+        return 1;
+    }
+    uxrStreamId output_stream = uxr_create_output_best_effort_stream(&session, output_buffer, mtu);
+    (void) uxr_create_input_best_effort_stream(&session);
+
+    // Latency: one PERFORMANCE submessage in flight, echoed by the agent on the same stream.
+    uint32_t lost = 0;
+    for (uint32_t i = 0; i < WARMUP_SAMPLES + samples; ++i)
+    {
+        benchmark.recording = (WARMUP_SAMPLES <= i);
+        benchmark.echoed = false;
+        benchmark.last_sent = uxr_nanos();
+        if ((!uxr_buffer_performance(&session, output_stream, (uint64_t)benchmark.last_sent,
+                payload_buffer, payload, true) || !wait_echo(&session, &benchmark, ECHO_TIMEOUT)) &&
+                benchmark.recording)
+        {
+            ++lost;
+        }
+    }
+
+    // Throughput: a window of submessages in flight, the whole window lost after a while without echoes.
+    benchmark.recording = false;
+    benchmark.echoes = 0;
+    benchmark.last_sent = 0;
+    uint32_t sent = 0;
+    uint32_t in_flight = 0;
+    const int64_t throughput_start = uxr_nanos();
+    while (sent < samples || 0 < in_flight)
+    {
+        if (sent < samples && THROUGHPUT_WINDOW > in_flight &&
+                uxr_buffer_performance(&session, output_stream, (uint64_t)uxr_nanos(), payload_buffer, payload, true))
+        {
+            ++sent;
+            ++in_flight;
+            uxr_flash_output_streams(&session);
+        }
+        else
+        {
+            const uint32_t echoes = benchmark.echoes;
+            (void) uxr_run_session_until_timeout(&session, THROUGHPUT_TIMEOUT);
+            const uint32_t received = benchmark.echoes - echoes;
+            in_flight = (0 == received) ? 0 : ((received < in_flight) ? in_flight - received : 0);
+        }
+    }
+    const double throughput_seconds = (double)(uxr_nanos() - throughput_start) / 1e9;
+
+    // Report
+    qsort(benchmark.rtts, benchmark.samples, sizeof(int64_t), compare_rtts);
+    const double messages_per_second = (double)benchmark.echoes / throughput_seconds;
+    printf("transport: %s, payload: %u B, samples: %u, lost: %u\n", argv[1], (unsigned)payload, samples, lost);
+    printf("rtt p50: %.1f us, p99: %.1f us, p999: %.1f us\n",
+            percentile_us(benchmark.rtts, benchmark.samples, 500),
+            percentile_us(benchmark.rtts, benchmark.samples, 990),
+            percentile_us(benchmark.rtts, benchmark.samples, 999));
+    printf("throughput: %.0f msg/s, %.3f MB/s (%u/%u echoed)\n",
+            messages_per_second,
+            messages_per_second * (payload + 8) / 1e6,
+            benchmark.echoes, sent);
+
+    uxr_delete_session(&session);
+    free(benchmark.rtts);
+    free(payload_buffer);
+    free(output_buffer);
+
+    if (0 == strcmp(argv[1], "udp"))
+    {
+        uxr_close_udp_transport(&udp);
+    }
+    else if (0 == strcmp(argv[1], "tcp"))
+    {
+        uxr_close_tcp_transport(&tcp);
+    }
+    else if (0 == strcmp(argv[1], "serial"))
+    {
+        uxr_close_serial_transport(&serial);
+    }
+    else if (0 == strcmp(argv[1], "shm"))
+    {
+        uxr_close_shm_transport(&shm);
+    }
+    else
+    {
+        uxr_close_custom_transport(&custom);
+    }
+
+    return 0;
+}
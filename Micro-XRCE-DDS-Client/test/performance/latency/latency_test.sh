@@ -0,0 +1,38 @@
+#!/bin/sh
+# Runs the latency benchmark against a local agent over every transport.
+# usage: latency_test.sh <MicroXRCEAgent> <latency_test> [samples] [payload]
+
+AGENT=$1
+BENCHMARK=$2
+shift 2
+
+run_agent() {
+    "$AGENT" "$@" -m ced > /dev/null 2>&1 &
+    AGENT_PID=$!
+    sleep 1
+}
+
+stop_agent() {
+    kill $AGENT_PID
+    wait $AGENT_PID 2> /dev/null || true
+}
+
+run_agent udp4 -p 8888
+"$BENCHMARK" udp 127.0.0.1 8888 "$@"
+"$BENCHMARK" custom 127.0.0.1 8888 "$@"
+stop_agent
+
+run_agent tcp4 -p 8888
+"$BENCHMARK" tcp 127.0.0.1 8888 "$@"
+stop_agent
+
+# The agent logs the pseudoterminal only when built with the logger, look for the new one instead.
+PTS_BEFORE=$(ls /dev/pts)
+run_agent pseudoterminal
+DEV=/dev/pts/$(ls /dev/pts | grep -vxF "$PTS_BEFORE" | head -n 1)
+"$BENCHMARK" serial "$DEV" "$@"
+stop_agent
+
+run_agent shm -n /uxr_latency_test
+"$BENCHMARK" shm /uxr_latency_test "$@"
+stop_agent
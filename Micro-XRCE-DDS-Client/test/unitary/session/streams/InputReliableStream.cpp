@@ -274,3 +274,29 @@ TEST_F(InputReliableStreamTest, FragmentationJumpToNextBufferLastPosition)
     EXPECT_EQ(slot_0 + capacity - 1, ub.final);
     EXPECT_EQ(size_t(0), uxr_get_reliable_buffer_size(&stream.base, 0));
 }
+
+TEST_F(InputReliableStreamTest, ComputeNackRange)
+{
+    const uint16_t wide_history = 64;
+    uint8_t wide_buffer[wide_history * 32];
+    uxrInputReliableStream wide_stream;
+    uxr_init_input_reliable_stream(&wide_stream, wide_buffer, sizeof(wide_buffer), wide_history,
+            on_get_fragmentation_info);
+
+    bool message_stored;
+    (void) uxr_receive_reliable_message(&wide_stream, 40, message, 8, &message_stored);
+    ASSERT_TRUE(message_stored);
+
+    uxrSeqNum first_unacked;
+    EXPECT_EQ(0xFFFF, uxr_compute_acknack(&wide_stream, &first_unacked));
+    EXPECT_EQ(uxrSeqNum(0), first_unacked);
+    EXPECT_EQ(0xFFFF, uxr_compute_nack_range(&wide_stream, 16));
+    EXPECT_EQ(0x00FF, uxr_compute_nack_range(&wide_stream, 32));
+    EXPECT_EQ(0x0000, uxr_compute_nack_range(&wide_stream, 48));
+
+    /* Announced messages beyond the history are not reported. */
+    uxr_process_heartbeat(&wide_stream, 0, 100);
+    EXPECT_EQ(0xFEFF, uxr_compute_nack_range(&wide_stream, 32));
+    EXPECT_EQ(0xFFFF, uxr_compute_nack_range(&wide_stream, 48));
+    EXPECT_EQ(0x0000, uxr_compute_nack_range(&wide_stream, 64));
+}
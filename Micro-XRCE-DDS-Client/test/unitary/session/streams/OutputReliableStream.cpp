@@ -502,3 +502,66 @@ TEST_F(OutputReliableStreamTest, GetAvailableSeqNum)
     ASSERT_FALSE(uxr_prepare_reliable_buffer_to_write(&stream, MAX_SUBMESSAGE_SIZE, &ub));
     EXPECT_EQ(get_available_free_slots(&stream), 0);
 }
+
+TEST_F(OutputReliableStreamTest, RoundTripTimeSample)
+{
+    ucdrBuffer ub;
+    (void) uxr_prepare_reliable_buffer_to_write(&stream, SUBMESSAGE_SIZE, &ub);
+    uint8_t* message; size_t length; uxrSeqNum seq_num;
+    (void) uxr_prepare_next_reliable_buffer_to_send(&stream, &message, &length, &seq_num);
+    uxr_begin_output_rtt_sample(&stream, seq_num, 100);
+    EXPECT_TRUE(stream.rtt_sampling);
+
+    /* Not acknowledged yet. */
+    uxr_update_output_rtt(&stream, uxrSeqNum(0), 120);
+    EXPECT_TRUE(stream.rtt_sampling);
+    EXPECT_EQ(MIN_HEARTBEAT_TIME_INTERVAL, stream.rto);
+
+    /* SRTT = 40, RTTVAR = 20, RTO = SRTT + 4 * RTTVAR. */
+    uxr_update_output_rtt(&stream, uxrSeqNum(1), 140);
+    EXPECT_FALSE(stream.rtt_sampling);
+    EXPECT_EQ(40 << 3, stream.srtt);
+    EXPECT_EQ(20 << 2, stream.rttvar);
+    EXPECT_EQ(120, stream.rto);
+
+    (void) uxr_prepare_reliable_buffer_to_write(&stream, SUBMESSAGE_SIZE, &ub);
+    (void) uxr_prepare_next_reliable_buffer_to_send(&stream, &message, &length, &seq_num);
+    uxr_begin_output_rtt_sample(&stream, seq_num, 200);
+    uxr_update_output_rtt(&stream, uxrSeqNum(2), 280);
+
+    /* RTTVAR = 3/4 * 20 + 1/4 * |40 - 80|, SRTT = 7/8 * 40 + 1/8 * 80. */
+    EXPECT_EQ(45 << 3, stream.srtt);
+    EXPECT_EQ(25 << 2, stream.rttvar);
+    EXPECT_EQ(145, stream.rto);
+
+    /* The heartbeat is armed at the retransmission timeout. */
+    uxr_process_acknack(&stream, 0, uxrSeqNum(1));
+    (void) uxr_update_output_stream_heartbeat_timestamp(&stream, 300);
+    EXPECT_EQ(300 + 145, stream.next_heartbeat_timestamp);
+}
+
+TEST_F(OutputReliableStreamTest, RoundTripTimeRetransmission)
+{
+    uint8_t* slot_0 = uxr_get_reliable_buffer(&stream.base, 0);
+    ucdrBuffer ub;
+    (void) uxr_prepare_reliable_buffer_to_write(&stream, SUBMESSAGE_SIZE, &ub);
+    uint8_t* message; size_t length; uxrSeqNum seq_num;
+    (void) uxr_prepare_next_reliable_buffer_to_send(&stream, &message, &length, &seq_num);
+    uxr_begin_output_rtt_sample(&stream, seq_num, 0);
+    (void) uxr_update_output_stream_heartbeat_timestamp(&stream, 0);
+
+    /* The timeout expires: the oldest message is resent and the timeout backed off. */
+    ASSERT_TRUE(uxr_update_output_stream_heartbeat_timestamp(&stream, MIN_HEARTBEAT_TIME_INTERVAL));
+    EXPECT_EQ(MIN_HEARTBEAT_TIME_INTERVAL * 2, stream.rto);
+    uint8_t* lost_message; size_t lost_length;
+    ASSERT_TRUE(uxr_prepare_timeout_reliable_buffer_to_send(&stream, &lost_message, &lost_length));
+    EXPECT_EQ(slot_0, lost_message);
+    EXPECT_EQ(OFFSET + SUBMESSAGE_SIZE, lost_length);
+
+    /* The acknowledgement of a retransmitted message gives no sample, the back-off is kept. */
+    EXPECT_FALSE(stream.rtt_sampling);
+    uxr_update_output_rtt(&stream, uxrSeqNum(1), 1000);
+    uxr_process_acknack(&stream, 0, uxrSeqNum(1));
+    EXPECT_EQ(MIN_HEARTBEAT_TIME_INTERVAL * 2, stream.rto);
+    ASSERT_FALSE(uxr_prepare_timeout_reliable_buffer_to_send(&stream, &lost_message, &lost_length));
+}
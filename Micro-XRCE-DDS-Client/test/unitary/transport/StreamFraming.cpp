@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+extern "C"
+{
+#include <c/util/time.c>
+#include <c/profile/transport/stream_framing/stream_framing_protocol.c>
+}
+
+class StreamFramingTest : public testing::Test
+{
+public:
+    StreamFramingTest()
+        : wire_pos_(0)
+    {
+        uxr_init_framing_io(&writer_, 1);
+        uxr_init_framing_io(&reader_, 0);
+    }
+
+    static size_t write_data(
+            void* instance,
+            const uint8_t* buf,
+            size_t len,
+            uint8_t* /*errcode*/)
+    {
+        StreamFramingTest* test = static_cast<StreamFramingTest*>(instance);
+        test->wire_.insert(test->wire_.end(), buf, buf + len);
+        return len;
+    }
+
+    static size_t read_data(
+            void* instance,
+            uint8_t* buf,
+            size_t len,
+            int /*timeout*/,
+            uint8_t* /*errcode*/)
+    {
+        /* Odd chunks, so that frames and escape sequences are split across reads. */
+        StreamFramingTest* test = static_cast<StreamFramingTest*>(instance);
+        size_t available = std::min(std::min(len, size_t(37)), test->wire_.size() - test->wire_pos_);
+        std::copy(test->wire_.begin() + ptrdiff_t(test->wire_pos_),
+                test->wire_.begin() + ptrdiff_t(test->wire_pos_ + available), buf);
+        test->wire_pos_ += available;
+        return available;
+    }
+
+protected:
+    uxrFramingIO writer_;
+    uxrFramingIO reader_;
+    std::vector<uint8_t> wire_;
+    size_t wire_pos_;
+};
+
+TEST_F(StreamFramingTest, CrcCheckValue)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint16_t crc = 0;
+    update_crc_buffer(&crc, check, sizeof(check));
+    EXPECT_EQ(0xBB3D, crc);
+}
+
+TEST_F(StreamFramingTest, CrcCrossCheck)
+{
+    std::vector<uint8_t> data(300);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 167 + (i >> 3));
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+        for (size_t len = 0; len + offset <= data.size(); ++len)
+        {
+            uint16_t expected = uint16_t(offset * 0x1021);
+            for (size_t i = 0; i < len; ++i)
+            {
+                uxr_update_crc(&expected, data[offset + i]);
+            }
+            uint16_t computed = uint16_t(offset * 0x1021);
+            update_crc_buffer(&computed, data.data() + offset, len);
+            ASSERT_EQ(expected, computed);
+        }
+    }
+}
+
+TEST_F(StreamFramingTest, CrcBenchmark)
+{
+    const size_t rounds = 50;
+    std::vector<uint8_t> data(1 << 20);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 167);
+    }
+
+    uint16_t octet_crc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (uint8_t octet : data)
+        {
+            uxr_update_crc(&octet_crc, octet);
+        }
+    }
+    std::chrono::duration<double> octet_elapsed = std::chrono::steady_clock::now() - start;
+
+    uint16_t block_crc = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        update_crc_buffer(&block_crc, data.data(), data.size());
+    }
+    std::chrono::duration<double> block_elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(octet_crc, block_crc);
+    std::cout << "[ BENCHMARK] crc16 octet at a time: " << double(rounds * data.size()) / octet_elapsed.count() / 1e6
+              << " MB/s, block: " << double(rounds * data.size()) / block_elapsed.count() / 1e6 << " MB/s" << std::endl;
+}
+
+TEST_F(StreamFramingTest, RoundTrip)
+{
+    std::vector<std::vector<uint8_t>> payloads;
+    uint8_t errcode = 0;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        /* Plenty of flag and escape octets, and frames larger than the framing buffers. */
+        std::vector<uint8_t> payload(1 + i * 23 % 700);
+        for (size_t j = 0; j < payload.size(); ++j)
+        {
+            payload[j] = (0 == j % 3) ? UXR_FRAMING_BEGIN_FLAG : (0 == j % 5) ? UXR_FRAMING_ESC_FLAG : uint8_t(i + j);
+        }
+        ASSERT_EQ(payload.size(), uxr_write_framed_msg(&writer_, write_data, this,
+                payload.data(), payload.size(), 0, &errcode));
+        payloads.push_back(payload);
+    }
+
+    uint8_t buf[1024];
+    for (const auto& payload : payloads)
+    {
+        uint8_t remote_addr = 0xFF;
+        size_t len = 0;
+        while ((0 == len) && (wire_pos_ < wire_.size() || reader_.rb_head != reader_.rb_tail))
+        {
+            len = uxr_read_framed_msg(&reader_, read_data, this, buf, sizeof(buf), &remote_addr, 0, &errcode);
+        }
+        ASSERT_EQ(payload.size(), len);
+        EXPECT_EQ(1, remote_addr);
+        EXPECT_TRUE(std::equal(payload.begin(), payload.end(), buf));
+    }
+}